@@ -68,9 +68,9 @@ namespace Falcor
         }
     }
 
-    CopyContext::ReadTextureTask::SharedPtr CopyContext::asyncReadTextureSubresource(const Texture* pTexture, uint32_t subresourceIndex)
+    CopyContext::ReadTextureTask::SharedPtr CopyContext::asyncReadTextureSubresource(const Texture* pTexture, uint32_t subresourceIndex, const Buffer::SharedPtr& pReadbackBuffer)
     {
-        return CopyContext::ReadTextureTask::create(this, pTexture, subresourceIndex);
+        return CopyContext::ReadTextureTask::create(this, pTexture, subresourceIndex, pReadbackBuffer);
     }
 
     std::vector<uint8_t> CopyContext::readTextureSubresource(const Texture* pTexture, uint32_t subresourceIndex)
@@ -79,6 +79,11 @@ namespace Falcor
         return pTask->getData();
     }
 
+    bool CopyContext::ReadTextureTask::isReady() const
+    {
+        return mpFence->getGpuValue() >= mpFence->getCpuValue() - 1;
+    }
+
     bool CopyContext::resourceBarrier(const Resource* pResource, Resource::State newState, const ResourceViewInfo* pViewInfo)
     {
         const Texture* pTexture = dynamic_cast<const Texture*>(pResource);
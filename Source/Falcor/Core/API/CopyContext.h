@@ -50,8 +50,20 @@ namespace Falcor
         {
         public:
             using SharedPtr = std::shared_ptr<ReadTextureTask>;
-            static SharedPtr create(CopyContext* pCtx, const Texture* pTexture, uint32_t subresourceIndex);
+            static SharedPtr create(CopyContext* pCtx, const Texture* pTexture, uint32_t subresourceIndex, const Buffer::SharedPtr& pReadbackBuffer = nullptr);
+
+            /** Check if the copy has completed on the GPU. Does not block.
+            */
+            bool isReady() const;
+
+            /** Get the texture data. Blocks until the copy has completed on the GPU.
+            */
             std::vector<uint8_t> getData();
+
+            /** Get the readback buffer the texture is copied into.
+                The buffer can be passed to a subsequent read once the data of this task has been retrieved.
+            */
+            const Buffer::SharedPtr& getBuffer() const { return mpBuffer; }
         private:
             ReadTextureTask() = default;
             GpuFence::SharedPtr mpFence;
@@ -136,8 +148,11 @@ namespace Falcor
         std::vector<uint8_t> readTextureSubresource(const Texture* pTexture, uint32_t subresourceIndex);
 
         /** Read texture data Asynchronously
+            \param[in] pTexture Texture to read from.
+            \param[in] subresourceIndex Subresource to read.
+            \param[in] pReadbackBuffer Optional readback buffer to copy into. Used if it is CPU readable and large enough, otherwise a new buffer is created.
         */
-        ReadTextureTask::SharedPtr asyncReadTextureSubresource(const Texture* pTexture, uint32_t subresourceIndex);
+        ReadTextureTask::SharedPtr asyncReadTextureSubresource(const Texture* pTexture, uint32_t subresourceIndex, const Buffer::SharedPtr& pReadbackBuffer = nullptr);
 
         /** Get the low-level context data
         */
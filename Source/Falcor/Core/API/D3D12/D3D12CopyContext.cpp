@@ -143,7 +143,7 @@ namespace Falcor
         pBuffer->unmap();
     }
 
-    CopyContext::ReadTextureTask::SharedPtr CopyContext::ReadTextureTask::create(CopyContext* pCtx, const Texture* pTexture, uint32_t subresourceIndex)
+    CopyContext::ReadTextureTask::SharedPtr CopyContext::ReadTextureTask::create(CopyContext* pCtx, const Texture* pTexture, uint32_t subresourceIndex, const Buffer::SharedPtr& pReadbackBuffer)
     {
         SharedPtr pThis = SharedPtr(new ReadTextureTask);
         pThis->mpContext = pCtx;
@@ -155,8 +155,15 @@ namespace Falcor
         ID3D12Device* pDevice = gpDevice->getApiHandle();
         pDevice->GetCopyableFootprints(&texDesc, subresourceIndex, 1, 0, &footprint, &pThis->mRowCount, &rowSize, &size);
 
-        //Create buffer
-        pThis->mpBuffer = Buffer::create(size, Buffer::BindFlags::None, Buffer::CpuAccess::Read, nullptr);
+        //Create buffer, or reuse the one passed in if it fits
+        if (pReadbackBuffer && pReadbackBuffer->getCpuAccess() == Buffer::CpuAccess::Read && pReadbackBuffer->getSize() >= size)
+        {
+            pThis->mpBuffer = pReadbackBuffer;
+        }
+        else
+        {
+            pThis->mpBuffer = Buffer::create(size, Buffer::BindFlags::None, Buffer::CpuAccess::Read, nullptr);
+        }
 
         //Copy from texture to buffer
         D3D12_TEXTURE_COPY_LOCATION srcLoc = { pTexture->getApiHandle(), D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX, subresourceIndex };
@@ -466,4 +466,16 @@ namespace Falcor
                 ? D3D12_RAYTRACING_ACCELERATION_STRUCTURE_COPY_MODE_COMPACT
                 : D3D12_RAYTRACING_ACCELERATION_STRUCTURE_COPY_MODE_CLONE);
     }
+
+    void RenderContext::serializeAccelerationStructure(uint64_t destAddress, RtAccelerationStructure* source)
+    {
+        FALCOR_GET_COM_INTERFACE(getLowLevelData()->getCommandList(), ID3D12GraphicsCommandList4, pList4);
+        pList4->CopyRaytracingAccelerationStructure(destAddress, source->getGpuAddress(), D3D12_RAYTRACING_ACCELERATION_STRUCTURE_COPY_MODE_SERIALIZE);
+    }
+
+    void RenderContext::deserializeAccelerationStructure(RtAccelerationStructure* dest, uint64_t sourceAddress)
+    {
+        FALCOR_GET_COM_INTERFACE(getLowLevelData()->getCommandList(), ID3D12GraphicsCommandList4, pList4);
+        pList4->CopyRaytracingAccelerationStructure(dest->getGpuAddress(), sourceAddress, D3D12_RAYTRACING_ACCELERATION_STRUCTURE_COPY_MODE_DESERIALIZE);
+    }
 }
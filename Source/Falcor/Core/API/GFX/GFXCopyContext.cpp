@@ -106,7 +106,7 @@ namespace Falcor
         }
     }
 
-    CopyContext::ReadTextureTask::SharedPtr CopyContext::ReadTextureTask::create(CopyContext* pCtx, const Texture* pTexture, uint32_t subresourceIndex)
+    CopyContext::ReadTextureTask::SharedPtr CopyContext::ReadTextureTask::create(CopyContext* pCtx, const Texture* pTexture, uint32_t subresourceIndex, const Buffer::SharedPtr& pReadbackBuffer)
     {
         SharedPtr pThis = SharedPtr(new ReadTextureTask);
         pThis->mpContext = pCtx;
@@ -123,8 +123,15 @@ namespace Falcor
         uint64_t rowCount =  (pTexture->getHeight(mipLevel) + formatInfo.blockHeight - 1) / formatInfo.blockHeight;
         uint64_t size = pTexture->getDepth(mipLevel) * rowCount * pThis->mRowSize;
 
-        //Create buffer
-        pThis->mpBuffer = Buffer::create(size, Buffer::BindFlags::None, Buffer::CpuAccess::Read, nullptr);
+        //Create buffer, or reuse the one passed in if it fits
+        if (pReadbackBuffer && pReadbackBuffer->getCpuAccess() == Buffer::CpuAccess::Read && pReadbackBuffer->getSize() >= size)
+        {
+            pThis->mpBuffer = pReadbackBuffer;
+        }
+        else
+        {
+            pThis->mpBuffer = Buffer::create(size, Buffer::BindFlags::None, Buffer::CpuAccess::Read, nullptr);
+        }
 
         //Copy from texture to buffer
         pCtx->resourceBarrier(pTexture, Resource::State::CopySource);
@@ -386,4 +386,18 @@ namespace Falcor
         rtEncoder->copyAccelerationStructure(dest->getApiHandle(), source->getApiHandle(), getGFXAcclerationStructureCopyMode(mode));
         mCommandsPending = true;
     }
+
+    void RenderContext::serializeAccelerationStructure(uint64_t destAddress, RtAccelerationStructure* source)
+    {
+        auto rtEncoder = getLowLevelData()->getApiData()->getRayTracingCommandEncoder();
+        rtEncoder->serializeAccelerationStructure(destAddress, source->getApiHandle());
+        mCommandsPending = true;
+    }
+
+    void RenderContext::deserializeAccelerationStructure(RtAccelerationStructure* dest, uint64_t sourceAddress)
+    {
+        auto rtEncoder = getLowLevelData()->getApiData()->getRayTracingCommandEncoder();
+        rtEncoder->deserializeAccelerationStructure(dest->getApiHandle(), sourceAddress);
+        mCommandsPending = true;
+    }
 }
@@ -241,6 +241,20 @@ namespace Falcor
         /** Copy an acceleration structure.
         */
         void copyAccelerationStructure(RtAccelerationStructure* dest, RtAccelerationStructure* source, RtAccelerationStructureCopyMode mode);
+
+        /** Serialize an acceleration structure into a buffer.
+            The data starts with a RtSerializedAccelerationStructureHeader and can be stored across application runs.
+            \param[in] destAddress GPU address to write the serialized data to. The buffer needs to be in unordered access state.
+            \param[in] source Acceleration structure to serialize.
+        */
+        void serializeAccelerationStructure(uint64_t destAddress, RtAccelerationStructure* source);
+
+        /** Deserialize an acceleration structure from a buffer.
+            Use RtAccelerationStructure::isSerializedDataCompatible() to check the data before deserializing it.
+            \param[in] dest Acceleration structure to deserialize into. Needs to be at least the deserialized size stored in the header.
+            \param[in] sourceAddress GPU address of the serialized data. The buffer needs to be in non-pixel shader resource state.
+        */
+        void deserializeAccelerationStructure(RtAccelerationStructure* dest, uint64_t sourceAddress);
     private:
         RenderContext(CommandQueueHandle queue);
 
@@ -26,6 +26,9 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "RtAccelerationStructure.h"
+#include "Device.h"
+#include "Core/API/API.h"
+#include <cstring>
 
 namespace Falcor
 {
@@ -58,6 +61,44 @@ namespace Falcor
         return mDesc.mBuffer->getGpuAddress() + mDesc.mOffset;
     }
 
+    bool RtAccelerationStructure::isSerializedDataCompatible(const RtSerializedAccelerationStructureHeader& header)
+    {
+#if defined(FALCOR_D3D12) || FALCOR_GFX_D3D12
+        static_assert(sizeof(RtSerializedAccelerationStructureHeader) == sizeof(D3D12_SERIALIZED_RAYTRACING_ACCELERATION_STRUCTURE_HEADER));
+
+        D3D12_SERIALIZED_DATA_DRIVER_MATCHING_IDENTIFIER identifier;
+        std::memcpy(&identifier, header.driverMatchingIdentifier, sizeof(identifier));
+        FALCOR_GET_COM_INTERFACE(gpDevice->getD3D12Handle(), ID3D12Device5, pDevice5);
+        return pDevice5->CheckDriverMatchingIdentifier(D3D12_SERIALIZED_DATA_RAYTRACING_ACCELERATION_STRUCTURE, &identifier) == D3D12_DRIVER_MATCHING_IDENTIFIER_COMPATIBLE_WITH_DEVICE;
+#else
+        // There is no compatibility check for other device types. Never reuse serialized data.
+        return false;
+#endif
+    }
+
+    std::vector<uint8_t> RtAccelerationStructure::getDeviceIdentifier()
+    {
+#if defined(FALCOR_D3D12) || FALCOR_GFX_D3D12
+        // Identify the adapter by its PCI ids and the user-mode driver by its version.
+        LUID luid = gpDevice->getD3D12Handle()->GetAdapterLuid();
+        IDXGIFactory4Ptr pFactory;
+        IDXGIAdapter1Ptr pAdapter;
+        DXGI_ADAPTER_DESC1 desc = {};
+        LARGE_INTEGER driverVersion = {};
+        if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&pFactory))) || FAILED(pFactory->EnumAdapterByLuid(luid, IID_PPV_ARGS(&pAdapter))) ||
+            FAILED(pAdapter->GetDesc1(&desc)) || FAILED(pAdapter->CheckInterfaceSupport(__uuidof(IDXGIDevice), &driverVersion)))
+        {
+            return {};
+        }
+
+        const uint32_t identifier[] = { desc.VendorId, desc.DeviceId, desc.SubSysId, desc.Revision, (uint32_t)driverVersion.LowPart, (uint32_t)driverVersion.HighPart };
+        return std::vector<uint8_t>(reinterpret_cast<const uint8_t*>(identifier), reinterpret_cast<const uint8_t*>(identifier) + sizeof(identifier));
+#else
+        // Serialized data is never reused on other device types, see isSerializedDataCompatible().
+        return {};
+#endif
+    }
+
     RtInstanceDesc& RtInstanceDesc::setTransform(const rmcv::mat4& matrix)
     {
         std::memcpy(transform, &matrix, sizeof(transform));
@@ -33,6 +33,7 @@
 #include "Utils/Math/Matrix/Matrix.h"
 #include "Core/Macros.h"
 #include <cstdint>
+#include <vector>
 
 namespace Falcor
 {
@@ -168,6 +169,17 @@ namespace Falcor
         const RtGeometryDesc* geometryDescs;
     };
 
+    /** Header at the start of serialized acceleration structure data.
+        The layout is the same for D3D12 (D3D12_SERIALIZED_RAYTRACING_ACCELERATION_STRUCTURE_HEADER) and Vulkan.
+    */
+    struct RtSerializedAccelerationStructureHeader
+    {
+        uint8_t driverMatchingIdentifier[32];                   ///< Identifies the driver and device that serialized the data.
+        uint64_t serializedSizeInBytesIncludingHeader;          ///< Size of the serialized data including this header.
+        uint64_t deserializedSizeInBytes;                       ///< Size required for the acceleration structure when deserialized.
+        uint64_t numBottomLevelAccelerationStructurePointers;   ///< Number of BLAS pointers following the header (top-level only).
+    };
+
     /** Abstract the API acceleration structure object.
         An acceleration structure object is a wrapper around a buffer resource that stores the contents
         of an acceleration structure. It does not own the backing buffer resource, which is similar to
@@ -227,6 +239,18 @@ namespace Falcor
 
         static RtAccelerationStructurePrebuildInfo getPrebuildInfo(const RtAccelerationStructureBuildInputs& inputs);
 
+        /** Check if serialized acceleration structure data can be deserialized on the current device.
+            \param[in] header Header of the serialized data.
+            \return True if the driver and device that serialized the data are compatible with the current ones.
+        */
+        static bool isSerializedDataCompatible(const RtSerializedAccelerationStructureHeader& header);
+
+        /** Get an identifier of the adapter and driver of the current device.
+            Serialized acceleration structures can only be reused if the identifier matches, so it can be used to key persisted data.
+            \return The identifier, or an empty vector if serialized data cannot be reused on the current device.
+        */
+        static std::vector<uint8_t> getDeviceIdentifier();
+
         ~RtAccelerationStructure();
 
         bool apiInit();
@@ -33,10 +33,12 @@
 
 #include <gtk/gtk.h>
 
+#include <cstdio>
 #include <iostream>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/resource.h>
 #include <pwd.h>
 #include <dlfcn.h>
 
@@ -482,13 +484,21 @@ namespace Falcor
 
     size_t getCurrentRSS()
     {
-        FALCOR_UNIMPLEMENTED();
-        return 0;
+        // The second field of statm is the resident set size in pages.
+        long pages = 0;
+        if (FILE* pFile = fopen("/proc/self/statm", "r"))
+        {
+            if (fscanf(pFile, "%*s%ld", &pages) != 1) pages = 0;
+            fclose(pFile);
+        }
+        return (size_t)pages * (size_t)sysconf(_SC_PAGESIZE);
     }
 
     size_t getPeakRSS()
     {
-        FALCOR_UNIMPLEMENTED();
-        return 0;
+        // The max resident set size is reported in kilobytes.
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+        return (size_t)usage.ru_maxrss * 1024;
     }
 }
@@ -54,5 +54,26 @@ namespace Falcor
     */
     static const char kRenderPassGBufferAdjustShadingNormals[] = "_gbufferAdjustShadingNormals";
 
+    /** Per-pixel variance estimate of the accumulated image (Texture::SharedPtr).
+        RGB holds the variance of the accumulated average, alpha the luminance of the accumulated average.
+        Written by AccumulatePass, so passes executing before it see the estimate of the previous frame.
+    */
+    static const char kRenderPassVarianceEstimate[] = "_varianceEstimate";
+
+    /** Per-tile convergence state of the accumulated image (Texture::SharedPtr, or nullptr if not tracked).
+        Each texel holds the relative error (x) and a converged flag (y) of a tile of kRenderPassConvergenceTileSize pixels.
+        Written by AccumulatePass. Passes executing before it may skip converged tiles, as their samples are no longer accumulated.
+    */
+    static const char kRenderPassConvergenceMask[] = "_convergenceMask";
+
+    /** Size of the tiles in kRenderPassConvergenceMask in pixels (uint32_t).
+    */
+    static const char kRenderPassConvergenceTileSize[] = "_convergenceTileSize";
+
+    /** Maximum per-pixel sample count supported by passes consuming a sample count input (e.g. PathTracer).
+        Passes producing sample counts must not exceed it, as larger counts are clamped by the consumer.
+    */
+    static const uint32_t kRenderPassMaxSampleCount = 16;
+
     FALCOR_ENUM_CLASS_OPERATORS(RenderPassRefreshFlags);
 }
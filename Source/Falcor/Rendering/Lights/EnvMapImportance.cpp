@@ -0,0 +1,352 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "EnvMapImportance.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Core/API/RenderContext.h"
+#include "Scene/SceneCache.h"
+#include "Utils/BinaryFileStream.h"
+#include "Utils/Logger.h"
+#include "Utils/NumericRange.h"
+#include <glm/gtc/integer.hpp>
+#include <algorithm>
+#include <cstring>
+#include <execution>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        const char kShaderFilenameImportanceMap[] = "Rendering/Lights/EnvMapSamplerSetup.cs.slang";
+        const char kShaderFilenameLuminance[] = "Rendering/Lights/EnvMapImportanceSetup.cs.slang";
+
+        // The defaults are 512x512 @ 64spp in the resampling step.
+        const uint32_t kDefaultDimension = 512;
+        const uint32_t kDefaultSpp = 64;
+
+        /** Cache directory (subdirectory in the scene cache directory).
+        */
+        const char kCacheDirectory[] = "EnvMap";
+
+        /** Specifies the current cache file version.
+            This needs to be incremented every time the file format or the luminance computation changes!
+        */
+        const uint32_t kCacheVersion = 2;
+        const char kCacheMagic[8] = { 'F', 'a', 'l', 'c', 'o', 'r', 'E', '$' };
+
+        const size_t kHashBlockSize = 1 * 1024 * 1024;
+
+        /** Importance data created so far. Entries expire when the last consumer releases the data.
+        */
+        std::vector<std::weak_ptr<EnvMapImportance>> sImportanceCache;
+    }
+
+    EnvMapImportance::SharedPtr EnvMapImportance::get(RenderContext* pRenderContext, const Texture::SharedPtr& pEnvMap)
+    {
+        checkArgument(pEnvMap != nullptr, "'pEnvMap' must be a valid texture");
+
+        // Remove expired entries.
+        sImportanceCache.erase(std::remove_if(sImportanceCache.begin(), sImportanceCache.end(), [](const auto& p) { return p.expired(); }), sImportanceCache.end());
+
+        // Reuse the data if it was created for the same texture.
+        for (const auto& pEntry : sImportanceCache)
+        {
+            auto pImportance = pEntry.lock();
+            if (pImportance && pImportance->mpEnvMap.lock() == pEnvMap) return pImportance;
+        }
+
+        // Reuse the data if it was created for a texture with identical content.
+        auto key = computeKey(pEnvMap);
+        if (key)
+        {
+            for (const auto& pEntry : sImportanceCache)
+            {
+                auto pImportance = pEntry.lock();
+                if (pImportance && pImportance->mKey == key) return pImportance;
+            }
+        }
+
+        auto pImportance = SharedPtr(new EnvMapImportance(pRenderContext, pEnvMap, key));
+        sImportanceCache.push_back(pImportance);
+        return pImportance;
+    }
+
+    bool EnvMapImportance::isReady()
+    {
+        if (mpAliasTable) return true;
+
+        FALCOR_ASSERT(mpFence && mpReadbackBuffer);
+        if (mpFence->getGpuValue() < mFenceValue) return false;
+        for (const auto& pTask : mImportanceMapReadTasks)
+        {
+            if (!pTask->isReady()) return false;
+        }
+
+        std::vector<std::vector<uint8_t>> importanceMips;
+        for (const auto& pTask : mImportanceMapReadTasks) importanceMips.push_back(pTask->getData());
+
+        const float* pLuminance = reinterpret_cast<const float*>(mpReadbackBuffer->map(Buffer::MapType::Read));
+        createAliasTable(pLuminance);
+        if (mKey) writeCache(pLuminance, importanceMips);
+        mpReadbackBuffer->unmap();
+
+        mpReadbackBuffer = nullptr;
+        mpFence = nullptr;
+        mImportanceMapReadTasks.clear();
+        return true;
+    }
+
+    void EnvMapImportance::waitForData()
+    {
+        if (mpAliasTable) return;
+
+        FALCOR_ASSERT(mpFence);
+        mpFence->syncCpu(mFenceValue);
+        bool ready = isReady();
+        FALCOR_ASSERT(ready);
+    }
+
+    EnvMapImportance::EnvMapImportance(RenderContext* pRenderContext, const Texture::SharedPtr& pEnvMap, const std::optional<Key>& key)
+        : mpEnvMap(pEnvMap)
+        , mKey(key)
+        , mDimensions(pEnvMap->getWidth(), pEnvMap->getHeight())
+    {
+        // Use the persisted importance map and luminance table if available.
+        if (readCache(pRenderContext)) return;
+
+        // Create hierarchical importance map for EnvMapSampler. This is entirely computed on the GPU.
+        createImportanceMap(pRenderContext, pEnvMap, kDefaultDimension, kDefaultSpp);
+
+        // Read back the importance map mips so they can be persisted with the luminance table.
+        if (mKey)
+        {
+            for (uint32_t mip = 0; mip < mpImportanceMap->getMipCount(); mip++)
+            {
+                mImportanceMapReadTasks.push_back(pRenderContext->asyncReadTextureSubresource(mpImportanceMap.get(), mpImportanceMap->getSubresourceIndex(0, mip)));
+            }
+        }
+
+        computeLuminanceTable(pRenderContext, pEnvMap);
+    }
+
+    void EnvMapImportance::createImportanceMap(RenderContext* pRenderContext, const Texture::SharedPtr& pEnvMap, uint32_t dimension, uint32_t samples)
+    {
+        FALCOR_ASSERT(isPowerOf2(dimension));
+        FALCOR_ASSERT(isPowerOf2(samples));
+
+        // We create log2(N)+1 mips from NxN...1x1 texels resolution.
+        uint32_t mips = glm::log2(dimension) + 1;
+        FALCOR_ASSERT((1u << (mips - 1)) == dimension);
+        FALCOR_ASSERT(mips > 1 && mips <= 12);     // Shader constant limits max resolution, increase if needed.
+
+        // Create importance map. We have to set the RTV flag to be able to use generateMips().
+        mpImportanceMap = Texture::create2D(dimension, dimension, ResourceFormat::R32Float, 1, mips, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::RenderTarget | Resource::BindFlags::UnorderedAccess);
+        FALCOR_ASSERT(mpImportanceMap);
+
+        auto pSetupPass = ComputePass::create(kShaderFilenameImportanceMap, "main");
+        pSetupPass["gEnvMap"] = pEnvMap;
+        pSetupPass["gImportanceMap"] = mpImportanceMap;
+
+        uint32_t samplesX = std::max(1u, (uint32_t)std::sqrt(samples));
+        uint32_t samplesY = samples / samplesX;
+        FALCOR_ASSERT(samples == samplesX * samplesY);
+
+        pSetupPass["CB"]["outputDim"] = uint2(dimension);
+        pSetupPass["CB"]["outputDimInSamples"] = uint2(dimension * samplesX, dimension * samplesY);
+        pSetupPass["CB"]["numSamples"] = uint2(samplesX, samplesY);
+        pSetupPass["CB"]["invSamples"] = 1.f / (samplesX * samplesY);
+
+        // Execute setup pass to compute the square importance map (base mip).
+        pSetupPass->execute(pRenderContext, dimension, dimension);
+
+        // Populate mip hierarchy. We rely on the default mip generation for this.
+        mpImportanceMap->generateMips(pRenderContext);
+    }
+
+    void EnvMapImportance::computeLuminanceTable(RenderContext* pRenderContext, const Texture::SharedPtr& pEnvMap)
+    {
+        uint32_t texelCount = mDimensions.x * mDimensions.y;
+        mpLuminanceTable = Buffer::createTyped<float>(texelCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+
+        auto pLuminancePass = ComputePass::create(kShaderFilenameLuminance, "main");
+        pLuminancePass["gEnvMap"] = pEnvMap;
+        pLuminancePass["gLuminance"] = mpLuminanceTable;
+        pLuminancePass["CB"]["gDim"] = mDimensions;
+        pLuminancePass["CB"]["gSingleChannel"] = getFormatChannelCount(pEnvMap->getFormat()) == 1;
+        pLuminancePass->execute(pRenderContext, mDimensions.x, mDimensions.y);
+
+        // Copy the luminance table to a staging buffer and signal a fence once the copy is done.
+        // The alias table is created on the CPU when the data is available, see isReady().
+        mpReadbackBuffer = Buffer::create(mpLuminanceTable->getSize(), Resource::BindFlags::None, Buffer::CpuAccess::Read, nullptr);
+        pRenderContext->copyBufferRegion(mpReadbackBuffer.get(), 0, mpLuminanceTable.get(), 0, mpLuminanceTable->getSize());
+        pRenderContext->flush(false);
+
+        mpFence = GpuFence::create();
+        mFenceValue = mpFence->gpuSignal(pRenderContext->getLowLevelData()->getCommandQueue());
+    }
+
+    void EnvMapImportance::createAliasTable(const float* luminance)
+    {
+        FALCOR_ASSERT(luminance);
+
+        const uint32_t width = mDimensions.x;
+        const uint32_t height = mDimensions.y;
+        const float dPhi = 2.f * (float)M_PI / width;
+        const float dTheta = (float)M_PI / height;
+
+        // Weight each texel by its luminance and the solid angle it subtends in the lat-long parameterization.
+        std::vector<float> weights((size_t)width * height);
+        auto range = NumericRange<uint32_t>(0, height);
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t y)
+        {
+            float theta = ((y + 0.5f) / height) * (float)M_PI;
+            float diffSolidAngle = dPhi * dTheta * std::sin(theta);
+            size_t offset = (size_t)y * width;
+            for (uint32_t x = 0; x < width; x++) weights[offset + x] = diffSolidAngle * luminance[offset + x];
+        });
+
+        std::mt19937 rng;
+        mpAliasTable = AliasTable::create(std::move(weights), rng);
+    }
+
+    bool EnvMapImportance::readCache(RenderContext* pRenderContext)
+    {
+        if (!mKey) return false;
+
+        auto path = getCachePath();
+        if (!std::filesystem::exists(path)) return false;
+
+        BinaryFileStream stream(path, BinaryFileStream::Mode::Read);
+        char magic[sizeof(kCacheMagic)];
+        uint32_t version = 0;
+        uint2 dimensions;
+        stream.read(magic, sizeof(magic));
+        stream >> version >> dimensions;
+        if (stream.isFail() || std::memcmp(magic, kCacheMagic, sizeof(kCacheMagic)) != 0 || version != kCacheVersion || dimensions != mDimensions)
+        {
+            logWarning("Ignoring invalid environment map cache file '{}'.", path);
+            return false;
+        }
+
+        std::vector<float> luminance((size_t)mDimensions.x * mDimensions.y);
+        stream.read(luminance.data(), luminance.size() * sizeof(float));
+
+        // The importance map is stored as its dimension followed by all mips from NxN down to 1x1 texels.
+        uint32_t importanceDim = 0;
+        uint32_t importanceMips = 0;
+        stream >> importanceDim >> importanceMips;
+        if (stream.isFail() || importanceDim != kDefaultDimension || importanceMips != glm::log2(kDefaultDimension) + 1)
+        {
+            logWarning("Failed to read environment map cache file '{}'.", path);
+            return false;
+        }
+
+        std::vector<std::vector<float>> mipData(importanceMips);
+        for (uint32_t mip = 0; mip < importanceMips; mip++)
+        {
+            uint32_t mipDim = importanceDim >> mip;
+            mipData[mip].resize((size_t)mipDim * mipDim);
+            stream.read(mipData[mip].data(), mipData[mip].size() * sizeof(float));
+        }
+        if (stream.isFail())
+        {
+            logWarning("Failed to read environment map cache file '{}'.", path);
+            return false;
+        }
+
+        mpImportanceMap = Texture::create2D(importanceDim, importanceDim, ResourceFormat::R32Float, 1, importanceMips, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::RenderTarget | Resource::BindFlags::UnorderedAccess);
+        FALCOR_ASSERT(mpImportanceMap);
+        for (uint32_t mip = 0; mip < importanceMips; mip++)
+        {
+            pRenderContext->updateSubresourceData(mpImportanceMap.get(), mpImportanceMap->getSubresourceIndex(0, mip), mipData[mip].data());
+        }
+
+        mpLuminanceTable = Buffer::createTyped<float>((uint32_t)luminance.size(), Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, luminance.data());
+        createAliasTable(luminance.data());
+        return true;
+    }
+
+    void EnvMapImportance::writeCache(const float* luminance, const std::vector<std::vector<uint8_t>>& importanceMips) const
+    {
+        FALCOR_ASSERT(mKey);
+        FALCOR_ASSERT(mpImportanceMap && importanceMips.size() == mpImportanceMap->getMipCount());
+
+        auto path = getCachePath();
+        std::filesystem::create_directories(path.parent_path());
+
+        BinaryFileStream stream(path, BinaryFileStream::Mode::Write);
+        stream.write(kCacheMagic, sizeof(kCacheMagic));
+        stream << kCacheVersion << mDimensions;
+        stream.write(luminance, (size_t)mDimensions.x * mDimensions.y * sizeof(float));
+        stream << mpImportanceMap->getWidth() << mpImportanceMap->getMipCount();
+        for (const auto& mip : importanceMips) stream.write(mip.data(), mip.size());
+        if (stream.isFail())
+        {
+            logWarning("Failed to write environment map cache file '{}'.", path);
+            stream.remove();
+        }
+    }
+
+    std::filesystem::path EnvMapImportance::getCachePath() const
+    {
+        FALCOR_ASSERT(mKey);
+
+        std::stringstream ss;
+        ss << std::hex << std::setfill('0');
+        for (auto c : *mKey) ss << std::setw(2) << (int)c;
+        return SceneCache::getCacheDirectory() / kCacheDirectory / ss.str();
+    }
+
+    std::optional<EnvMapImportance::Key> EnvMapImportance::computeKey(const Texture::SharedPtr& pEnvMap)
+    {
+        // Only textures loaded from file have content we can hash without reading back the texture.
+        const auto& path = pEnvMap->getSourcePath();
+        if (path.empty() || !std::filesystem::exists(path)) return {};
+
+        std::ifstream fs(path, std::ios_base::binary);
+        if (!fs.good()) return {};
+
+        SHA1 sha1;
+        std::vector<char> block(kHashBlockSize);
+        while (fs)
+        {
+            fs.read(block.data(), block.size());
+            sha1.update(block.data(), (size_t)fs.gcount());
+        }
+
+        // Include the texture properties as the same file can be loaded in different formats.
+        uint32_t properties[3] = { pEnvMap->getWidth(), pEnvMap->getHeight(), (uint32_t)pEnvMap->getFormat() };
+        sha1.update(properties, sizeof(properties));
+
+        return sha1.finalize();
+    }
+}
@@ -0,0 +1,131 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Buffer.h"
+#include "Core/API/CopyContext.h"
+#include "Core/API/Texture.h"
+#include "Core/API/GpuFence.h"
+#include "RenderGraph/BasePasses/ComputePass.h"
+#include "Utils/CryptoUtils.h"
+#include "Utils/Math/Vector.h"
+#include "Utils/Sampling/AliasTable.h"
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+namespace Falcor
+{
+    class RenderContext;
+
+    /** Importance sampling data for an environment map.
+        Holds all data derived from an environment map texture that is needed by light samplers:
+        - Hierarchical importance map over the octahedral domain (used by EnvMapSampler).
+        - Per-texel luminance table of the lat-long map.
+        - Alias table over the lat-long texels, weighted by luminance and solid angle.
+
+        The data is computed once per texture content and shared between all consumers.
+        Textures loaded from file are keyed by a hash of the file content, and the luminance
+        table and importance map mips are persisted in the scene cache directory so subsequent
+        runs skip both the GPU setup passes and the readback.
+        Otherwise the luminance table is computed on the GPU and read back asynchronously;
+        the alias table becomes available once isReady() returns true.
+    */
+    class FALCOR_API EnvMapImportance
+    {
+    public:
+        using SharedPtr = std::shared_ptr<EnvMapImportance>;
+        using Key = SHA1::MD;
+
+        /** Get the importance data for an environment map texture.
+            Returns a shared object if importance data for the same texture (or a texture with identical content) exists.
+            \param[in] pRenderContext A render-context that will be used for processing.
+            \param[in] pEnvMap The environment map texture (lat-long).
+            \return The importance data.
+        */
+        static SharedPtr get(RenderContext* pRenderContext, const Texture::SharedPtr& pEnvMap);
+
+        /** Check if the alias table is available.
+            This does not block. If the GPU has finished computing the luminance table, the alias table is created.
+            \return True if all data is available.
+        */
+        bool isReady();
+
+        /** Block until the alias table is available.
+        */
+        void waitForData();
+
+        /** Get the hierarchical importance map. The base mip is the full resolution, the last mip is 1x1 texels.
+        */
+        const Texture::SharedPtr& getImportanceMap() const { return mpImportanceMap; }
+
+        /** Get the per-texel luminance of the environment map (mip 0). Stored in scanline order.
+        */
+        const Buffer::SharedPtr& getLuminanceTable() const { return mpLuminanceTable; }
+
+        /** Get the alias table for sampling texels proportional to luminance times solid angle.
+            \return The alias table or nullptr if isReady() has not returned true yet.
+        */
+        const AliasTable::SharedPtr& getAliasTable() const { return mpAliasTable; }
+
+        /** Get the dimensions of the environment map texture in texels.
+        */
+        uint2 getDimensions() const { return mDimensions; }
+
+        /** Get the content key. Only set for textures loaded from file.
+        */
+        const std::optional<Key>& getKey() const { return mKey; }
+
+    private:
+        EnvMapImportance(RenderContext* pRenderContext, const Texture::SharedPtr& pEnvMap, const std::optional<Key>& key);
+
+        void createImportanceMap(RenderContext* pRenderContext, const Texture::SharedPtr& pEnvMap, uint32_t dimension, uint32_t samples);
+        void computeLuminanceTable(RenderContext* pRenderContext, const Texture::SharedPtr& pEnvMap);
+        void createAliasTable(const float* luminance);
+
+        bool readCache(RenderContext* pRenderContext);
+        void writeCache(const float* luminance, const std::vector<std::vector<uint8_t>>& importanceMips) const;
+        std::filesystem::path getCachePath() const;
+
+        static std::optional<Key> computeKey(const Texture::SharedPtr& pEnvMap);
+
+        std::weak_ptr<Texture>  mpEnvMap;           ///< Source texture. Only used to find existing data for the same texture.
+        std::optional<Key>      mKey;               ///< Content key, or empty if the texture has no source file.
+        uint2                   mDimensions;        ///< Dimensions of the environment map in texels.
+
+        Texture::SharedPtr      mpImportanceMap;    ///< Hierarchical importance map (luminance).
+        Buffer::SharedPtr       mpLuminanceTable;   ///< Per-texel luminance of the lat-long map.
+        AliasTable::SharedPtr   mpAliasTable;       ///< Alias table for sampling texels.
+
+        // Pending readback of the luminance table.
+        Buffer::SharedPtr       mpReadbackBuffer;   ///< Staging buffer for the luminance table.
+        GpuFence::SharedPtr     mpFence;            ///< Fence signaled when the readback copy has finished.
+        uint64_t                mFenceValue = 0;    ///< Fence value to wait for.
+        std::vector<CopyContext::ReadTextureTask::SharedPtr> mImportanceMapReadTasks; ///< Pending readback of the importance map mips. Only used for textures with a key.
+    };
+}
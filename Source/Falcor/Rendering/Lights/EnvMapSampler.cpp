@@ -28,20 +28,9 @@
 #include "EnvMapSampler.h"
 #include "Core/Assert.h"
 #include "Core/API/RenderContext.h"
-#include "RenderGraph/BasePasses/ComputePass.h"
-#include <glm/gtc/integer.hpp>
 
 namespace Falcor
 {
-    namespace
-    {
-        const char kShaderFilenameSetup[] = "Rendering/Lights/EnvMapSamplerSetup.cs.slang";
-
-        // The defaults are 512x512 @ 64spp in the resampling step.
-        const uint32_t kDefaultDimension = 512;
-        const uint32_t kDefaultSpp = 64;
-    }
-
     EnvMapSampler::SharedPtr EnvMapSampler::create(RenderContext* pRenderContext, EnvMap::SharedPtr pEnvMap)
     {
         return SharedPtr(new EnvMapSampler(pRenderContext, pEnvMap));
@@ -51,13 +40,15 @@ namespace Falcor
     {
         FALCOR_ASSERT(var.isValid());
 
+        const auto& pImportanceMap = mpImportance->getImportanceMap();
+
         // Set variables.
-        float2 invDim = 1.f / float2(mpImportanceMap->getWidth(), mpImportanceMap->getHeight());
-        var["importanceBaseMip"] = mpImportanceMap->getMipCount() - 1; // The base mip is 1x1 texels
+        float2 invDim = 1.f / float2(pImportanceMap->getWidth(), pImportanceMap->getHeight());
+        var["importanceBaseMip"] = pImportanceMap->getMipCount() - 1; // The base mip is 1x1 texels
         var["importanceInvDim"] = invDim;
 
         // Bind resources.
-        var["importanceMap"] = mpImportanceMap;
+        var["importanceMap"] = pImportanceMap;
         var["importanceSampler"] = mpImportanceSampler;
     }
 
@@ -66,55 +57,13 @@ namespace Falcor
     {
         FALCOR_ASSERT(pEnvMap);
 
-        // Create compute program for the setup phase.
-        mpSetupPass = ComputePass::create(kShaderFilenameSetup, "main");
-
         // Create sampler.
         Sampler::Desc samplerDesc;
         samplerDesc.setFilterMode(Sampler::Filter::Point, Sampler::Filter::Point, Sampler::Filter::Point);
         samplerDesc.setAddressingMode(Sampler::AddressMode::Clamp, Sampler::AddressMode::Clamp, Sampler::AddressMode::Clamp);
         mpImportanceSampler = Sampler::create(samplerDesc);
 
-        // Create hierarchical importance map for sampling.
-        if (!createImportanceMap(pRenderContext, kDefaultDimension, kDefaultSpp))
-        {
-            throw RuntimeError("Failed to create importance map");
-        }
-    }
-
-    bool EnvMapSampler::createImportanceMap(RenderContext* pRenderContext, uint32_t dimension, uint32_t samples)
-    {
-        FALCOR_ASSERT(isPowerOf2(dimension));
-        FALCOR_ASSERT(isPowerOf2(samples));
-
-        // We create log2(N)+1 mips from NxN...1x1 texels resolution.
-        uint32_t mips = glm::log2(dimension) + 1;
-        FALCOR_ASSERT((1u << (mips - 1)) == dimension);
-        FALCOR_ASSERT(mips > 1 && mips <= 12);     // Shader constant limits max resolution, increase if needed.
-
-        // Create importance map. We have to set the RTV flag to be able to use generateMips().
-        mpImportanceMap = Texture::create2D(dimension, dimension, ResourceFormat::R32Float, 1, mips, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::RenderTarget | Resource::BindFlags::UnorderedAccess);
-        FALCOR_ASSERT(mpImportanceMap);
-
-        mpSetupPass["gEnvMap"] = mpEnvMap->getEnvMap();
-        mpSetupPass["gImportanceMap"] = mpImportanceMap;
-
-        uint32_t samplesX = std::max(1u, (uint32_t)std::sqrt(samples));
-        uint32_t samplesY = samples / samplesX;
-        FALCOR_ASSERT(samples == samplesX * samplesY);
-
-        mpSetupPass["CB"]["outputDim"] = uint2(dimension);
-        mpSetupPass["CB"]["outputDimInSamples"] = uint2(dimension * samplesX, dimension * samplesY);
-        mpSetupPass["CB"]["numSamples"] = uint2(samplesX, samplesY);
-        mpSetupPass["CB"]["invSamples"] = 1.f / (samplesX * samplesY);
-
-        // Execute setup pass to compute the square importance map (base mip).
-        mpSetupPass->execute(pRenderContext, dimension, dimension);
-
-        // Populate mip hierarchy. We rely on the default mip generation for this.
-        mpImportanceMap->generateMips(pRenderContext);
-
-        return true;
+        // Get hierarchical importance map for sampling. This is shared with other samplers using the same environment map.
+        mpImportance = EnvMapImportance::get(pRenderContext, mpEnvMap->getEnvMap());
     }
-
 }
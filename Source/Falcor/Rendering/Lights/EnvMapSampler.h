@@ -30,7 +30,7 @@
 #include "Core/API/Texture.h"
 #include "Core/API/Sampler.h"
 #include "Scene/Lights/EnvMap.h"
-#include "RenderGraph/BasePasses/ComputePass.h"
+#include "EnvMapImportance.h"
 #include <memory>
 
 namespace Falcor
@@ -60,18 +60,18 @@ namespace Falcor
 
         const EnvMap::SharedPtr& getEnvMap() const { return mpEnvMap; }
 
-        const Texture::SharedPtr& getImportanceMap() const { return mpImportanceMap; }
+        const Texture::SharedPtr& getImportanceMap() const { return mpImportance->getImportanceMap(); }
+
+        /** Get the importance data shared with other light samplers using the same environment map.
+        */
+        const EnvMapImportance::SharedPtr& getImportance() const { return mpImportance; }
 
     protected:
         EnvMapSampler(RenderContext* pRenderContext, EnvMap::SharedPtr pEnvMap);
 
-        bool createImportanceMap(RenderContext* pRenderContext, uint32_t dimension, uint32_t samples);
-
         EnvMap::SharedPtr       mpEnvMap;           ///< Environment map.
 
-        ComputePass::SharedPtr  mpSetupPass;        ///< Compute pass for creating the importance map.
-
-        Texture::SharedPtr      mpImportanceMap;    ///< Hierarchical importance map (luminance).
+        EnvMapImportance::SharedPtr mpImportance;   ///< Importance data, including the hierarchical importance map (luminance).
         Sampler::SharedPtr      mpImportanceSampler;
     };
 }
@@ -347,6 +347,7 @@ namespace Falcor
         var["prevCameraV"] = mPrevCameraData.cameraV;
         var["prevCameraW"] = mPrevCameraData.cameraW;
         var["prevCameraJitter"] = float2(mPrevCameraData.jitterX, mPrevCameraData.jitterY);
+        var["prevCameraCropOffset"] = mPrevCameraData.cropOffset;
 
         // Setup textures and other buffers needed by the RTXDI bridge
         var["lightInfo"] = mpLightInfoBuffer;
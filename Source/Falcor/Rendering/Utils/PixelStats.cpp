@@ -27,8 +27,14 @@
  **************************************************************************/
 #include "PixelStats.h"
 #include "Core/API/RenderContext.h"
+#include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
 #include "Utils/Scripting/ScriptBindings.h"
+#include <json/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
 #include <sstream>
 #include <iomanip>
 
@@ -37,6 +43,28 @@ namespace Falcor
     namespace
     {
         const char kComputeRayCountFilename[] = "Rendering/Utils/PixelStats.cs.slang";
+
+        using Stats = PixelStats::Stats;
+
+        // Stats fields by name, used for summaries and export.
+        const std::pair<const char*, uint32_t Stats::*> kCountFields[] =
+        {
+            { "visibilityRays", &Stats::visibilityRays },
+            { "closestHitRays", &Stats::closestHitRays },
+            { "totalRays", &Stats::totalRays },
+            { "pathVertices", &Stats::pathVertices },
+            { "volumeLookups", &Stats::volumeLookups },
+        };
+
+        const std::pair<const char*, float Stats::*> kAverageFields[] =
+        {
+            { "avgVisibilityRays", &Stats::avgVisibilityRays },
+            { "avgClosestHitRays", &Stats::avgClosestHitRays },
+            { "avgTotalRays", &Stats::avgTotalRays },
+            { "avgPathLength", &Stats::avgPathLength },
+            { "avgPathVertices", &Stats::avgPathVertices },
+            { "avgVolumeLookups", &Stats::avgVolumeLookups },
+        };
     }
 
     PixelStats::SharedPtr PixelStats::create()
@@ -51,17 +79,19 @@ namespace Falcor
 
     void PixelStats::beginFrame(RenderContext* pRenderContext, const uint2& frameDim)
     {
-        // Prepare state.
+        // Pick up readbacks that have completed in the meantime.
         FALCOR_ASSERT(!mRunning);
+        retireReadbacks(kMaxPendingReadbacks);
+
+        // Prepare state.
         mRunning = true;
-        mWaitingForData = false;
         mFrameDim = frameDim;
 
-        // Mark previously stored data as invalid. The config may have changed, so this is the safe bet.
-        mStats = Stats();
-        mStatsValid = false;
+        // Mark the per-pixel data as invalid. The config may have changed, so this is the safe bet.
+        // The stats read back so far stay valid, they describe earlier frames.
         mStatsBuffersValid = false;
         mRayCountTextureValid = false;
+        if (!mEnabled) mStatsValid = false;
 
         if (mEnabled)
         {
@@ -69,7 +99,6 @@ namespace Falcor
             if (!mpParallelReduction)
             {
                 mpParallelReduction = ComputeParallelReduction::create();
-                mpReductionResult = Buffer::create((kRayTypeCount + 3) * sizeof(uint4), ResourceBindFlags::None, Buffer::CpuAccess::Read);
             }
 
             // Prepare stats buffers.
@@ -104,21 +133,38 @@ namespace Falcor
             // Create fence first time we need it.
             if (!mpFence) mpFence = GpuFence::create();
 
+            // Make room in the ring of readbacks. This only waits if the GPU is more than kMaxPendingReadbacks frames behind.
+            retireReadbacks(kMaxPendingReadbacks - 1);
+
+            PendingReadback readback;
+            if (!mFreeReductionResults.empty())
+            {
+                readback.pResult = mFreeReductionResults.back();
+                mFreeReductionResults.pop_back();
+            }
+            else
+            {
+                readback.pResult = Buffer::create((kRayTypeCount + 3) * sizeof(uint4), ResourceBindFlags::None, Buffer::CpuAccess::Read);
+            }
+            const auto& pResult = readback.pResult;
+
             // Sum of the per-pixel counters. The results are copied to a GPU buffer.
             for (uint32_t i = 0; i < kRayTypeCount; i++)
             {
-                mpParallelReduction->execute<uint4>(pRenderContext, mpStatsRayCount[i], ComputeParallelReduction::Type::Sum, nullptr, mpReductionResult, i * sizeof(uint4));
+                mpParallelReduction->execute<uint4>(pRenderContext, mpStatsRayCount[i], ComputeParallelReduction::Type::Sum, nullptr, pResult, i * sizeof(uint4));
             }
-            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsPathLength, ComputeParallelReduction::Type::Sum, nullptr, mpReductionResult, kRayTypeCount * sizeof(uint4));
-            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsPathVertexCount, ComputeParallelReduction::Type::Sum, nullptr, mpReductionResult, (kRayTypeCount + 1) * sizeof(uint4));
-            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsVolumeLookupCount, ComputeParallelReduction::Type::Sum, nullptr, mpReductionResult, (kRayTypeCount + 2) * sizeof(uint4));
+            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsPathLength, ComputeParallelReduction::Type::Sum, nullptr, pResult, kRayTypeCount * sizeof(uint4));
+            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsPathVertexCount, ComputeParallelReduction::Type::Sum, nullptr, pResult, (kRayTypeCount + 1) * sizeof(uint4));
+            mpParallelReduction->execute<uint4>(pRenderContext, mpStatsVolumeLookupCount, ComputeParallelReduction::Type::Sum, nullptr, pResult, (kRayTypeCount + 2) * sizeof(uint4));
 
             // Submit command list and insert signal.
             pRenderContext->flush(false);
-            mpFence->gpuSignal(pRenderContext->getLowLevelData()->getCommandQueue());
+            readback.fenceValue = mpFence->gpuSignal(pRenderContext->getLowLevelData()->getCommandQueue());
+            readback.frame = mFrameCount++;
+            readback.frameDim = mFrameDim;
+            mPendingReadbacks.push_back(readback);
 
             mStatsBuffersValid = true;
-            mWaitingForData = true;
         }
     }
 
@@ -150,7 +196,7 @@ namespace Falcor
         widget.tooltip("Collects ray tracing traversal stats on the GPU.\nNote that this option slows down the performance.");
 
         // Fetch data and show stats if available.
-        copyStatsToCPU();
+        retireReadbacks(kMaxPendingReadbacks);
         if (mStatsValid)
         {
             widget.text("Stats:");
@@ -181,11 +227,40 @@ namespace Falcor
 
             if (mEnableLogging) logInfo("\n" + oss.str());
         }
+
+        if (auto group = widget.group("History"))
+        {
+            if (group.var("History size", mHistorySize, 1u)) setHistorySize(mHistorySize);
+            group.tooltip("Maximum number of frames kept in the history.");
+            group.var("Summary window", mSummaryWindow, 1u);
+            group.tooltip("Number of most recent frames summarized below.");
+
+            const StatsSummary summary = getHistorySummary(mSummaryWindow);
+            if (summary.frameCount > 0)
+            {
+                std::ostringstream oss;
+                oss << std::fixed << std::setprecision(3) << "min / avg / max over " << summary.frameCount << " frames:\n";
+                for (const auto& [name, field] : kAverageFields)
+                {
+                    oss << name << ": " << summary.min.*field << " / " << summary.avg.*field << " / " << summary.max.*field << "\n";
+                }
+                group.text(oss.str());
+            }
+
+            group.text(std::to_string(mHistory.size()) + " frames in history");
+            if (group.button("Clear")) clearHistory();
+            if (group.button("Export", true))
+            {
+                FileDialogFilterVec filters { { "csv", "CSV" }, { "json", "JSON" } };
+                std::filesystem::path path;
+                if (saveFileDialog(filters, path)) exportHistory(path);
+            }
+        }
     }
 
     bool PixelStats::getStats(PixelStats::Stats& stats)
     {
-        copyStatsToCPU();
+        retireReadbacks(kMaxPendingReadbacks);
         if (!mStatsValid)
         {
             logWarning("PixelStats::getStats() - Stats are not valid. Ignoring.");
@@ -247,42 +322,146 @@ namespace Falcor
         return mStatsBuffersValid ? mpStatsVolumeLookupCount : nullptr;
     }
 
-    void PixelStats::copyStatsToCPU()
+    void PixelStats::flush()
     {
         FALCOR_ASSERT(!mRunning);
-        if (mWaitingForData)
+        retireReadbacks(0);
+    }
+
+    void PixelStats::setHistorySize(uint32_t size)
+    {
+        mHistorySize = std::max(size, 1u);
+        while (mHistory.size() > mHistorySize) mHistory.pop_front();
+    }
+
+    PixelStats::StatsSummary PixelStats::getHistorySummary(uint32_t window) const
+    {
+        StatsSummary summary;
+        const size_t count = (window == 0 || window > mHistory.size()) ? mHistory.size() : window;
+        if (count == 0) return summary;
+
+        summary.frameCount = (uint32_t)count;
+        summary.min = summary.max = mHistory.back();
+
+        double countSums[std::size(kCountFields)] = {};
+        double averageSums[std::size(kAverageFields)] = {};
+
+        for (auto it = mHistory.end() - count; it != mHistory.end(); ++it)
         {
-            // Wait for signal.
-            mpFence->syncCpu();
-            mWaitingForData = false;
+            for (size_t i = 0; i < std::size(kCountFields); i++)
+            {
+                const auto field = kCountFields[i].second;
+                summary.min.*field = std::min(summary.min.*field, (*it).*field);
+                summary.max.*field = std::max(summary.max.*field, (*it).*field);
+                countSums[i] += (*it).*field;
+            }
+            for (size_t i = 0; i < std::size(kAverageFields); i++)
+            {
+                const auto field = kAverageFields[i].second;
+                summary.min.*field = std::min(summary.min.*field, (*it).*field);
+                summary.max.*field = std::max(summary.max.*field, (*it).*field);
+                averageSums[i] += (*it).*field;
+            }
+        }
+
+        for (size_t i = 0; i < std::size(kCountFields); i++) summary.avg.*kCountFields[i].second = (uint32_t)std::round(countSums[i] / count);
+        for (size_t i = 0; i < std::size(kAverageFields); i++) summary.avg.*kAverageFields[i].second = (float)(averageSums[i] / count);
+
+        summary.min.frame = (mHistory.end() - count)->frame;
+        summary.max.frame = mHistory.back().frame;
+        summary.avg.frame = mHistory.back().frame;
+
+        return summary;
+    }
+
+    void PixelStats::exportHistory(const std::filesystem::path& path) const
+    {
+        const std::string ext = path.extension().string();
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open()) throw RuntimeError("Failed to open file '{}' for writing.", path);
+
+        if (ext == ".csv")
+        {
+            file << "frame";
+            for (const auto& [name, field] : kCountFields) file << "," << name;
+            for (const auto& [name, field] : kAverageFields) file << "," << name;
+            file << "\n";
+
+            for (const auto& stats : mHistory)
+            {
+                file << stats.frame;
+                for (const auto& [name, field] : kCountFields) file << "," << stats.*field;
+                for (const auto& [name, field] : kAverageFields) file << "," << stats.*field;
+                file << "\n";
+            }
+        }
+        else if (ext == ".json")
+        {
+            nlohmann::json frames = nlohmann::json::array();
+            for (const auto& stats : mHistory)
+            {
+                nlohmann::json frame;
+                frame["frame"] = stats.frame;
+                for (const auto& [name, field] : kCountFields) frame[name] = stats.*field;
+                for (const auto& [name, field] : kAverageFields) frame[name] = stats.*field;
+                frames.push_back(frame);
+            }
+            file << frames.dump(4) << std::endl;
+        }
+        else
+        {
+            throw ArgumentError("Unsupported file extension '{}'. Expected '.csv' or '.json'.", ext);
+        }
+    }
 
-            if (mEnabled)
+    void PixelStats::retireReadbacks(size_t maxPending)
+    {
+        FALCOR_ASSERT(!mRunning);
+
+        while (!mPendingReadbacks.empty())
+        {
+            PendingReadback& readback = mPendingReadbacks.front();
+
+            // Only wait for the GPU if more than maxPending readbacks would remain in flight.
+            if (mpFence->getGpuValue() < readback.fenceValue)
             {
-                // Map the stats buffer.
-                const uint4* result = static_cast<const uint4*>(mpReductionResult->map(Buffer::MapType::Read));
-                FALCOR_ASSERT(result);
-
-                const uint32_t totalPathLength = result[kRayTypeCount].x;
-                const uint32_t totalPathVertices = result[kRayTypeCount + 1].x;
-                const uint32_t totalVolumeLookups = result[kRayTypeCount + 2].x;
-                const uint32_t numPixels = mFrameDim.x * mFrameDim.y;
-                FALCOR_ASSERT(numPixels > 0);
-
-                mStats.visibilityRays = result[(uint32_t)PixelStatsRayType::Visibility].x;
-                mStats.closestHitRays = result[(uint32_t)PixelStatsRayType::ClosestHit].x;
-                mStats.totalRays = mStats.visibilityRays + mStats.closestHitRays;
-                mStats.pathVertices = totalPathVertices;
-                mStats.volumeLookups = totalVolumeLookups;
-                mStats.avgVisibilityRays = (float)mStats.visibilityRays / numPixels;
-                mStats.avgClosestHitRays = (float)mStats.closestHitRays / numPixels;
-                mStats.avgTotalRays = (float)mStats.totalRays / numPixels;
-                mStats.avgPathLength = (float)totalPathLength / numPixels;
-                mStats.avgPathVertices = (float)totalPathVertices / numPixels;
-                mStats.avgVolumeLookups = (float)totalVolumeLookups / numPixels;
-
-                mpReductionResult->unmap();
-                mStatsValid = true;
+                if (mPendingReadbacks.size() <= maxPending) break;
+                mpFence->syncCpu(readback.fenceValue);
             }
+
+            // Map the stats buffer.
+            const uint4* result = static_cast<const uint4*>(readback.pResult->map(Buffer::MapType::Read));
+            FALCOR_ASSERT(result);
+
+            const uint32_t totalPathLength = result[kRayTypeCount].x;
+            const uint32_t totalPathVertices = result[kRayTypeCount + 1].x;
+            const uint32_t totalVolumeLookups = result[kRayTypeCount + 2].x;
+            const uint32_t numPixels = readback.frameDim.x * readback.frameDim.y;
+            FALCOR_ASSERT(numPixels > 0);
+
+            Stats stats;
+            stats.frame = readback.frame;
+            stats.visibilityRays = result[(uint32_t)PixelStatsRayType::Visibility].x;
+            stats.closestHitRays = result[(uint32_t)PixelStatsRayType::ClosestHit].x;
+            stats.totalRays = stats.visibilityRays + stats.closestHitRays;
+            stats.pathVertices = totalPathVertices;
+            stats.volumeLookups = totalVolumeLookups;
+            stats.avgVisibilityRays = (float)stats.visibilityRays / numPixels;
+            stats.avgClosestHitRays = (float)stats.closestHitRays / numPixels;
+            stats.avgTotalRays = (float)stats.totalRays / numPixels;
+            stats.avgPathLength = (float)totalPathLength / numPixels;
+            stats.avgPathVertices = (float)totalPathVertices / numPixels;
+            stats.avgVolumeLookups = (float)totalVolumeLookups / numPixels;
+
+            readback.pResult->unmap();
+
+            mStats = stats;
+            mStatsValid = true;
+            mHistory.push_back(stats);
+            while (mHistory.size() > mHistorySize) mHistory.pop_front();
+
+            mFreeReductionResults.push_back(readback.pResult);
+            mPendingReadbacks.pop_front();
         }
     }
 
@@ -290,23 +469,29 @@ namespace Falcor
     {
         pybind11::dict d;
 
-        d["visibilityRays"] = visibilityRays;
-        d["closestHitRays"] = closestHitRays;
-        d["totalRays"] = totalRays;
-        d["pathVertices"] = pathVertices;
-        d["volumeLookups"] = volumeLookups;
-        d["avgVisibilityRays"] = avgVisibilityRays;
-        d["avgClosestHitRays"] = avgClosestHitRays;
-        d["avgTotalRays"] = avgTotalRays;
-        d["avgPathLength"] = avgPathLength;
-        d["avgPathVertices"] = avgPathVertices;
-        d["avgVolumeLookups"] = avgVolumeLookups;
+        d["frame"] = frame;
+        for (const auto& [name, field] : kCountFields) d[name] = this->*field;
+        for (const auto& [name, field] : kAverageFields) d[name] = this->*field;
+
+        return d;
+    }
+
+    pybind11::dict PixelStats::StatsSummary::toPython() const
+    {
+        pybind11::dict d;
+
+        d["min"] = min.toPython();
+        d["avg"] = avg.toPython();
+        d["max"] = max.toPython();
+        d["frameCount"] = frameCount;
 
         return d;
     }
 
     FALCOR_SCRIPT_BINDING(PixelStats)
     {
+        using namespace pybind11::literals;
+
         pybind11::class_<PixelStats, PixelStats::SharedPtr> pixelStats(m, "PixelStats");
         pixelStats.def_property("enabled", &PixelStats::isEnabled, &PixelStats::setEnabled);
         pixelStats.def_property_readonly("stats", [](PixelStats* pPixelStats) {
@@ -314,5 +499,15 @@ namespace Falcor
             pPixelStats->getStats(stats);
             return stats.toPython();
         });
+        pixelStats.def_property("historySize", &PixelStats::getHistorySize, &PixelStats::setHistorySize);
+        pixelStats.def_property_readonly("history", [](PixelStats* pPixelStats) {
+            pybind11::list history;
+            for (const auto& stats : pPixelStats->getHistory()) history.append(stats.toPython());
+            return history;
+        });
+        pixelStats.def("getSummary", [](PixelStats* pPixelStats, uint32_t window) { return pPixelStats->getHistorySummary(window).toPython(); }, "window"_a = 0);
+        pixelStats.def("exportHistory", &PixelStats::exportHistory, "path"_a);
+        pixelStats.def("clearHistory", &PixelStats::clearHistory);
+        pixelStats.def("flush", &PixelStats::flush);
     }
 }
@@ -34,6 +34,8 @@
 #include "RenderGraph/BasePasses/ComputePass.h"
 #include "Utils/UI/Gui.h"
 #include "Utils/Algorithm/ComputeParallelReduction.h"
+#include <deque>
+#include <filesystem>
 #include <memory>
 
 namespace Falcor
@@ -42,13 +44,19 @@ namespace Falcor
 
         Per-pixel stats are logged in buffers on the GPU, which are immediately ready for consumption
         after end() is called. These stats are summarized in a reduction pass, which are
-        available in getStats() or printStats() after async readback to the CPU.
+        available in getStats() after async readback to the CPU.
+
+        Readbacks are never waited on while rendering. The reduction results of up to kMaxPendingReadbacks
+        frames are in flight at a time, so the stats returned by getStats() lag a few frames behind.
+        The stats of every frame are appended to a bounded history, which can be summarized over a
+        window of frames and exported to CSV or JSON.
     */
     class FALCOR_API PixelStats
     {
     public:
         struct Stats
         {
+            uint64_t frame = 0;                 ///< Index of the frame the stats were collected in, counting frames with stats enabled.
             uint32_t visibilityRays = 0;
             uint32_t closestHitRays = 0;
             uint32_t totalRays = 0;
@@ -66,6 +74,22 @@ namespace Falcor
             pybind11::dict toPython() const;
         };
 
+        /** Component-wise minimum, average and maximum of the stats over a number of frames.
+        */
+        struct StatsSummary
+        {
+            Stats    min;
+            Stats    avg;
+            Stats    max;
+            uint32_t frameCount = 0;            ///< Number of frames summarized.
+
+            /** Convert to python dict.
+            */
+            pybind11::dict toPython() const;
+        };
+
+        static constexpr size_t kMaxPendingReadbacks = 4;   ///< Maximum number of frames whose stats are in flight.
+
         using SharedPtr = std::shared_ptr<PixelStats>;
         virtual ~PixelStats() = default;
 
@@ -84,12 +108,41 @@ namespace Falcor
 
         void renderUI(Gui::Widgets& widget);
 
-        /** Fetches the latest stats generated by begin()/end().
+        /** Fetches the latest stats that have been read back to the CPU. This does not wait for the GPU,
+            so the stats are typically from a frame a few frames before the last call to endFrame().
             \param[out] stats The stats are copied here.
             \return True if stats are available, false otherwise.
         */
         bool getStats(PixelStats::Stats& stats);
 
+        /** Wait for all pending readbacks and add their stats to the history.
+        */
+        void flush();
+
+        /** Get the stats of the frames read back so far, oldest first.
+        */
+        const std::deque<Stats>& getHistory() const { return mHistory; }
+
+        /** Clear the stats history.
+        */
+        void clearHistory() { mHistory.clear(); }
+
+        /** Set the maximum number of frames kept in the history. Older frames are discarded.
+        */
+        void setHistorySize(uint32_t size);
+        uint32_t getHistorySize() const { return mHistorySize; }
+
+        /** Summarize the most recent frames in the history.
+            \param[in] window Number of frames to summarize. If zero or larger than the history, the whole history is summarized.
+            \return Component-wise min/avg/max of the stats.
+        */
+        StatsSummary getHistorySummary(uint32_t window = 0) const;
+
+        /** Export the stats history to a file.
+            \param[in] path File path. The format is chosen by the extension, either '.csv' or '.json'.
+        */
+        void exportHistory(const std::filesystem::path& path) const;
+
         /** Returns the per-pixel ray count texture or nullptr if not available.
             \param[in] pRenderContext The render context.
             \return Texture in R32Uint format containing per-pixel ray counts, or nullptr if not available.
@@ -113,28 +166,43 @@ namespace Falcor
 
     protected:
         PixelStats();
-        void copyStatsToCPU();
+        void retireReadbacks(size_t maxPending);
         void computeRayCountTexture(RenderContext* pRenderContext);
 
         static const uint32_t kRayTypeCount = (uint32_t)PixelStatsRayType::Count;
 
         // Internal state
         ComputeParallelReduction::SharedPtr mpParallelReduction;            ///< Helper for parallel reduction on the GPU.
-        Buffer::SharedPtr                   mpReductionResult;              ///< Results buffer for stats readback (CPU mappable).
         GpuFence::SharedPtr                 mpFence;                        ///< GPU fence for sychronizing readback.
 
+        /** Reduction results of a frame in flight.
+        */
+        struct PendingReadback
+        {
+            Buffer::SharedPtr               pResult;                        ///< Results buffer for stats readback (CPU mappable).
+            uint64_t                        fenceValue = 0;                 ///< Fence value signaled when the results are available.
+            uint64_t                        frame = 0;                      ///< Frame index of the stats.
+            uint2                           frameDim = { 0, 0 };            ///< Frame dimensions of the stats.
+        };
+
+        std::deque<PendingReadback>         mPendingReadbacks;              ///< Readbacks in submission order.
+        std::vector<Buffer::SharedPtr>      mFreeReductionResults;          ///< Results buffers of retired readbacks, reused for new ones.
+
         // Configuration
         bool                                mEnabled = false;               ///< Enable pixel statistics.
         bool                                mEnableLogging = false;         ///< Enable printing to logfile.
+        uint32_t                            mHistorySize = 4096;            ///< Maximum number of frames in the history.
+        uint32_t                            mSummaryWindow = 60;            ///< Number of frames summarized in the UI.
 
         // Runtime data
         bool                                mRunning = false;               ///< True inbetween begin() / end() calls.
-        bool                                mWaitingForData = false;        ///< True if we are waiting for data to become available on the GPU.
         uint2                               mFrameDim = { 0, 0 };           ///< Frame dimensions at last call to begin().
+        uint64_t                            mFrameCount = 0;                ///< Number of frames with stats enabled.
 
         bool                                mStatsValid = false;            ///< True if stats have been read back and are valid.
         bool                                mRayCountTextureValid = false;  ///< True if total ray count texture is valid.
-        Stats                               mStats;                         ///< Traversal stats.
+        Stats                               mStats;                         ///< Traversal stats of the latest frame read back.
+        std::deque<Stats>                   mHistory;                       ///< Traversal stats of past frames, oldest first.
 
         Texture::SharedPtr                  mpStatsRayCount[kRayTypeCount]; ///< Buffers for per-pixel ray count stats.
         Texture::SharedPtr                  mpStatsRayCountTotal;           ///< Buffer for per-pixel total ray count. Only generated if getRayCountTexture() is called.
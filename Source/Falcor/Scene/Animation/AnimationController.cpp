@@ -397,11 +397,10 @@ namespace Falcor
     {
         if (staticVertexData.empty()) return;
 
-        // We always copy the static data, to initialize the non-skinned vertices.
+        // The vertex buffer has already been initialized with the static data by the scene.
         FALCOR_ASSERT(mpScene->getMeshVao());
         const Buffer::SharedPtr& pVB = mpScene->getMeshVao()->getVertexBuffer(Scene::kStaticDataBufferIndex);
         FALCOR_ASSERT(pVB->getSize() == staticVertexData.size() * sizeof(staticVertexData[0]));
-        pVB->setBlob(staticVertexData.data(), 0, pVB->getSize());
 
         if (!skinningVertexData.empty())
         {
@@ -95,6 +95,8 @@ namespace Falcor
         if (mPrevData.farZ != mData.farZ)               mChanges |= Changes::Frustum;
         if (mPrevData.frameHeight != mData.frameHeight) mChanges |= Changes::Frustum;
         if (mPrevData.frameWidth != mData.frameWidth)   mChanges |= Changes::Frustum;
+        if (mPrevData.cropOffset != mData.cropOffset)   mChanges |= Changes::Frustum;
+        if (mPrevData.cropScale != mData.cropScale)     mChanges |= Changes::Frustum;
 
         // Jitter
         if (mPrevData.jitterX != mData.jitterX) mChanges |= Changes::Jitter;
@@ -151,6 +153,15 @@ namespace Falcor
                 }
             }
 
+            // Restrict the projection to the crop window by mapping the window to the full NDC range.
+            // The crop is applied before the jitter, so that the jitter is relative to the pixels of the cropped frame.
+            const float2 cropScale = mCropSize;
+            const float2 cropCenter = float2(2.f * mCropOffset.x + mCropSize.x - 1.f, 1.f - 2.f * mCropOffset.y - mCropSize.y);
+            rmcv::mat4 cropMat = rmcv::scale(float3(1.f / cropScale.x, 1.f / cropScale.y, 1.f)) * rmcv::translate(float3(-cropCenter.x, -cropCenter.y, 0.f));
+            mData.projMat = cropMat * mData.projMat;
+            mData.cropOffset = cropCenter / cropScale;
+            mData.cropScale = cropScale;
+
             // Build jitter matrix
             // (jitterX and jitterY are expressed as subpixel quantities divided by the screen resolution
             //  for instance to apply an offset of half pixel along the X axis we set jitterX = 0.5f / Width)
@@ -189,6 +200,10 @@ namespace Falcor
             const float vlen = mData.focalDistance * std::tan(fovY * 0.5f);
             mData.cameraV *= vlen;
 
+            // Scale the image plane to the crop window. The window offset is applied in the ray generation.
+            mData.cameraU *= cropScale.x;
+            mData.cameraV *= cropScale.y;
+
             mDirty = false;
         }
     }
@@ -295,6 +310,14 @@ namespace Falcor
         setJitterInternal(jitterX, jitterY);
     }
 
+    void Camera::setCropWindow(const float2& offset, const float2& size)
+    {
+        if (!(size.x > 0.f && size.y > 0.f)) throw ArgumentError("Camera crop window size must be positive, got ({}, {}).", size.x, size.y);
+        mCropOffset = offset;
+        mCropSize = size;
+        mDirty = true;
+    }
+
     void Camera::setJitterInternal(float jitterX, float jitterY)
     {
         mData.jitterX = jitterX;
@@ -320,7 +343,7 @@ namespace Falcor
         float2 p = (float2(pixel) + float2(0.5f, 0.5f)) / float2(frameDim);
         if (applyJitter) p += float2(-mData.jitterX, mData.jitterY);
 
-        float2 ndc = float2(2.0f, -2.0f) * p + float2(-1.0f, 1.0f);
+        float2 ndc = float2(2.0f, -2.0f) * p + float2(-1.0f, 1.0f) + mData.cropOffset;
 
         // Compute the normalized ray direction assuming a pinhole camera.
         ray.dir = glm::normalize(ndc.x * mData.cameraU + ndc.y * mData.cameraV + mData.cameraW);
@@ -431,6 +454,8 @@ namespace Falcor
         camera.def_property(kPosition.c_str(), &Camera::getPosition, &Camera::setPosition);
         camera.def_property(kTarget.c_str(), &Camera::getTarget, &Camera::setTarget);
         camera.def_property(kUp.c_str(), &Camera::getUpVector, &Camera::setUpVector);
+        camera.def("setCropWindow", &Camera::setCropWindow, "offset"_a, "size"_a);
+        camera.def("resetCropWindow", &Camera::resetCropWindow);
         camera.def(pybind11::init(&Camera::create), "name"_a = "");
     }
 }
@@ -192,6 +192,21 @@ namespace Falcor
         float getJitterX() const { return mData.jitterX; }
         float getJitterY() const { return mData.jitterY; }
 
+        /** Set the crop window, i.e., the part of the image plane that is rendered into the frame.
+            The projection and the camera rays are restricted to the window, which is used for rendering large images in tiles.
+            The window may extend beyond the image plane.
+            \param[in] offset Top-left corner of the window in normalized image coordinates with origin in the top-left corner.
+            \param[in] size Size of the window in normalized image coordinates. A size of (1,1) covers the full image plane.
+        */
+        void setCropWindow(const float2& offset, const float2& size);
+
+        /** Reset the crop window to the full image plane.
+        */
+        void resetCropWindow() { setCropWindow(float2(0.f), float2(1.f)); }
+
+        const float2& getCropOffset() const { return mCropOffset; }
+        const float2& getCropSize() const { return mCropSize; }
+
         /** Compute pixel spread in screen space -- to be used with RayCones for texture level-of-detail.
             \param[in] winHeightPixels Window height in pixels
             \return the pixel spread angle in screen space
@@ -301,6 +316,8 @@ namespace Falcor
 
         std::string mName;
         bool mPreserveHeight = true;    ///< If true, preserve frame height on change of aspect ratio. Otherwise, preserve width.
+        float2 mCropOffset = float2(0.f); ///< Top-left corner of the crop window in normalized image coordinates.
+        float2 mCropSize = float2(1.f);   ///< Size of the crop window in normalized image coordinates.
 
         void calculateCameraParameters() const;
         mutable CameraData mData;
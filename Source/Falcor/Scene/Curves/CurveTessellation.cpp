@@ -31,8 +31,12 @@
 #include "Utils/Math/MathHelpers.h"
 #include "Utils/Math/CubicSpline.h"
 #include "Utils/Math/Matrix/Matrix.h"
+#include "Utils/NumericRange.h"
 #include <glm/gtx/quaternion.hpp>
+#include <algorithm>
 #include <cmath>
+#include <execution>
+#include <numeric>
 
 namespace Falcor
 {
@@ -62,10 +66,6 @@ namespace Falcor
         CubicSpline<float3> optSplinePoints;
         CubicSpline<float>  optSplineWidths;
         CubicSpline<float2> optSplineUVs;
-
-        CubicSpline<float3> splinePoints;
-        CubicSpline<float>  splineWidths;
-        CubicSpline<float2> splineUVs;
     };
 
     namespace
@@ -74,6 +74,9 @@ namespace Falcor
         // To achieve curveWidth on average, however, we need to scale the initial curveWidth by 1.11 (the number was deducted numerically).
         const float kMeshCompensationScale = 1.11f;
 
+        // Number of strands tessellated by one parallel task, the strand scratch arrays and spline caches are shared within a task.
+        const uint32_t kStrandsPerTask = 256;
+
         float4 transformSphere(const rmcv::mat4& xform, const float4& sphere)
         {
             // Spheres are represented as (center.x, center.y, center.z, radius).
@@ -91,11 +94,17 @@ namespace Falcor
 #endif
         }
 
+        // The widths of the optimized strand are scaled by widthScale.
         void optimizeStrandGeometry(CubicSplineCache& splineCache, const CurveArrays& curveArrays, StrandArrays& strandArrays, StrandArrays& optimizedStrandArrays, uint32_t pointOffset, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand, float widthScale)
         {
             strandArrays.controlPoints.clear();
             strandArrays.UVs.clear();
             strandArrays.widths.clear();
+            optimizedStrandArrays.controlPoints.clear();
+            optimizedStrandArrays.UVs.clear();
+            optimizedStrandArrays.widths.clear();
+            optimizedStrandArrays.vertexCount = 0;
+            if (strandArrays.vertexCount == 0) return;
 
             // Optimize geometry by removing duplicates.
             for (uint32_t j = 0; j < strandArrays.vertexCount - 1; j++)
@@ -115,6 +124,13 @@ namespace Falcor
 
             optimizedStrandArrays.vertexCount = static_cast<uint32_t>(strandArrays.controlPoints.size());
 
+            // Strands that collapse to a single point are skipped.
+            if (optimizedStrandArrays.vertexCount < 2)
+            {
+                optimizedStrandArrays.vertexCount = 0;
+                return;
+            }
+
             const CubicSpline<float3>& splinePoints = splineCache.optSplinePoints.setup(strandArrays.controlPoints.data(), optimizedStrandArrays.vertexCount);
             const CubicSpline<float>& splineWidths = splineCache.optSplineWidths.setup(strandArrays.widths.data(), optimizedStrandArrays.vertexCount);
 
@@ -127,7 +143,7 @@ namespace Falcor
                     {
                         float t = (float)k / (float)subdivPerSegment;
                         optimizedStrandArrays.controlPoints.push_back(splinePoints.interpolate(j, t));
-                        optimizedStrandArrays.widths.push_back(kMeshCompensationScale * widthScale * splineWidths.interpolate(j, t));
+                        optimizedStrandArrays.widths.push_back(widthScale * splineWidths.interpolate(j, t));
                     }
                     tmpCount++;
                 }
@@ -135,7 +151,7 @@ namespace Falcor
 
             // Always keep the last vertex.
             optimizedStrandArrays.controlPoints.push_back(splinePoints.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
-            optimizedStrandArrays.widths.push_back(kMeshCompensationScale * widthScale * splineWidths.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
+            optimizedStrandArrays.widths.push_back(widthScale * splineWidths.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
 
             // Texture coordinates.
             if (curveArrays.UVs)
@@ -191,7 +207,7 @@ namespace Falcor
             t = glm::rotate(rotQuat, t);
         }
 
-        void updateMeshResultBuffers(CurveTessellation::MeshResult& result, const CurveArrays& curveArrays, StrandArrays& optimizedStrandArrays, const float3& fwd, const float3& s, const float3& t, uint32_t pointCountPerCrossSection, const float& widthScale, uint32_t j)
+        void updateMeshResultBuffers(CurveTessellation::MeshResult& result, const CurveArrays& curveArrays, const StrandArrays& optimizedStrandArrays, const float3& fwd, const float3& s, const float3& t, uint32_t pointCountPerCrossSection, uint32_t meshVertexOffset, uint32_t j)
         {
             // Mesh vertices, normals, tangents, and texCrds (if any).
             for (uint32_t k = 0; k < pointCountPerCrossSection; k++)
@@ -199,180 +215,405 @@ namespace Falcor
                 float phi = (float)k / (float)pointCountPerCrossSection * (float)M_PI * 2.f;
                 float3 vNormal = std::cos(phi) * s + std::sin(phi) * t;
 
+                uint32_t vertexIndex = meshVertexOffset + j * pointCountPerCrossSection + k;
                 float curveRadius = 0.5f * optimizedStrandArrays.widths[j];
-                result.vertices.push_back(optimizedStrandArrays.controlPoints[j] + curveRadius * vNormal);
-                result.normals.push_back(vNormal);
-                result.tangents.push_back(float4(fwd.x, fwd.y, fwd.z, 1));
-                result.radii.push_back(curveRadius);
+                result.vertices[vertexIndex] = optimizedStrandArrays.controlPoints[j] + curveRadius * vNormal;
+                result.normals[vertexIndex] = vNormal;
+                result.tangents[vertexIndex] = float4(fwd.x, fwd.y, fwd.z, 1);
+                result.radii[vertexIndex] = curveRadius;
 
                 if (curveArrays.UVs)
                 {
-                    result.texCrds.push_back(optimizedStrandArrays.UVs[j]);
+                    result.texCrds[vertexIndex] = optimizedStrandArrays.UVs[j];
                 }
             }
         }
 
-        void connectFaceVertices(CurveTessellation::MeshResult& result, uint32_t meshVertexOffset, uint32_t pointCountPerCrossSection, uint32_t quadCountLimit, uint32_t nextCrossSectionVertexOffset, uint32_t multiplier, uint32_t j)
+        void connectFaceVertices(CurveTessellation::MeshResult& result, uint32_t faceOffset, uint32_t meshVertexOffset, uint32_t pointCountPerCrossSection, uint32_t quadCountLimit, uint32_t nextCrossSectionVertexOffset, uint32_t multiplier, uint32_t j)
         {
-            for (uint32_t k = 0; k < quadCountLimit; k++)
+            uint32_t face = faceOffset + 2 * j * quadCountLimit;
+            for (uint32_t k = 0; k < quadCountLimit; k++, face += 2)
             {
-                result.faceVertexCounts.push_back(3);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + k);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-
-                result.faceVertexCounts.push_back(3);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + k);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + k);
+                uint32_t* pIndices = result.faceVertexIndices.data() + 3 * face;
+
+                result.faceVertexCounts[face] = 3;
+                pIndices[0] = meshVertexOffset + multiplier * j * pointCountPerCrossSection + k;
+                pIndices[1] = meshVertexOffset + multiplier * j * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection;
+                pIndices[2] = meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection;
+
+                result.faceVertexCounts[face + 1] = 3;
+                pIndices[3] = meshVertexOffset + multiplier * j * pointCountPerCrossSection + k;
+                pIndices[4] = meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection;
+                pIndices[5] = meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + k;
             }
         }
-    }
 
-    CurveTessellation::SweptSphereResult CurveTessellation::convertToLinearSweptSphere(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t degree, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, const rmcv::mat4& xform)
-    {
-        SweptSphereResult result;
+        // Deviation of a strand point from the segment between two kept points, as the distance plus the radius difference.
+        float computeSimplificationError(const StrandArrays& strand, uint32_t first, uint32_t last, uint32_t i)
+        {
+            const float3& a = strand.controlPoints[first];
+            const float3 ab = strand.controlPoints[last] - a;
+            const float lengthSq = glm::dot(ab, ab);
+            const float t = lengthSq > 0.f ? clamp(glm::dot(strand.controlPoints[i] - a, ab) / lengthSq, 0.f, 1.f) : 0.f;
+
+            const float distance = glm::length(strand.controlPoints[i] - (a + t * ab));
+            const float radiusDifference = 0.5f * std::abs(strand.widths[i] - lerp(strand.widths[first], strand.widths[last], t));
+            return distance + radiusDifference;
+        }
 
-        // Only support linear tube segments now.
-        // TODO: Add quadratic or cubic tube segments if necessary.
-        FALCOR_ASSERT(degree == 1);
-        result.degree = degree;
+        // Douglas-Peucker simplification of a tessellated strand, the end points are always kept.
+        void simplifyStrand(StrandArrays& strand, float tolerance, std::vector<uint8_t>& keep, std::vector<std::pair<uint32_t, uint32_t>>& stack)
+        {
+            const uint32_t pointCount = (uint32_t)strand.controlPoints.size();
+            if (pointCount <= 2) return;
+
+            keep.assign(pointCount, 0);
+            keep[0] = keep[pointCount - 1] = 1;
+            stack.clear();
+            stack.emplace_back(0, pointCount - 1);
+
+            while (!stack.empty())
+            {
+                auto [first, last] = stack.back();
+                stack.pop_back();
+
+                float maxError = 0.f;
+                uint32_t maxIndex = first;
+                for (uint32_t i = first + 1; i < last; i++)
+                {
+                    float error = computeSimplificationError(strand, first, last, i);
+                    if (error > maxError)
+                    {
+                        maxError = error;
+                        maxIndex = i;
+                    }
+                }
+
+                if (maxError > tolerance)
+                {
+                    keep[maxIndex] = 1;
+                    stack.emplace_back(first, maxIndex);
+                    stack.emplace_back(maxIndex, last);
+                }
+            }
 
-        uint32_t pointCounts = 0;
-        uint32_t segCounts = 0;
-        uint32_t maxVertexCountsPerStrand = 0;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
+            uint32_t keptCount = 0;
+            for (uint32_t i = 0; i < pointCount; i++)
+            {
+                if (!keep[i]) continue;
+                strand.controlPoints[keptCount] = strand.controlPoints[i];
+                strand.widths[keptCount] = strand.widths[i];
+                if (!strand.UVs.empty()) strand.UVs[keptCount] = strand.UVs[i];
+                keptCount++;
+            }
+            strand.controlPoints.resize(keptCount);
+            strand.widths.resize(keptCount);
+            if (!strand.UVs.empty()) strand.UVs.resize(keptCount);
+        }
+
+        uint32_t hashStrandIndex(uint32_t i)
         {
-            uint32_t tmpPointCount = div_round_up(subdivPerSegment * (vertexCountsPerStrand[i] - 1), keepOneEveryXVerticesPerStrand) + 1;
-            pointCounts += tmpPointCount;
-            segCounts += tmpPointCount - 1;
-            maxVertexCountsPerStrand = std::max(maxVertexCountsPerStrand, vertexCountsPerStrand[i]);
+            // PCG hash, see Jarzynski and Olano 2020, "Hash Functions for GPU Rendering".
+            uint32_t state = i * 747796405u + 2891336453u;
+            uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+            return (word >> 22u) ^ word;
         }
-        result.indices.reserve(segCounts);
-        result.points.reserve(pointCounts);
-        result.radius.reserve(pointCounts);
-        result.texCrds.reserve(pointCounts);
 
-        uint32_t pointOffset = 0;
+        /** Select the strands to tessellate.
+            \param[out] widthScale Scaled by the width compensation of the error driven mode.
+            \return Indices of the selected strands.
+        */
+        std::vector<uint32_t> selectStrands(uint32_t strandCount, const CurveTessellation::StrandLOD& lod, float& widthScale)
+        {
+            std::vector<uint32_t> strands;
 
-        StrandArrays strandArrays;
-        strandArrays.controlPoints.reserve(maxVertexCountsPerStrand);
-        strandArrays.widths.reserve(maxVertexCountsPerStrand);
-        strandArrays.UVs.reserve(maxVertexCountsPerStrand);
-        CurveArrays curveArrays(controlPoints, widths, UVs);
+            if (lod.mode == CurveTessellation::StrandLODMode::Stride)
+            {
+                FALCOR_ASSERT(lod.keepOneEveryXStrands > 0);
+                strands.reserve(div_round_up(strandCount, lod.keepOneEveryXStrands));
+                for (uint32_t i = 0; i < strandCount; i += lod.keepOneEveryXStrands) strands.push_back(i);
+                return strands;
+            }
 
-        StrandArrays optimizedStrandArrays;
-        CubicSplineCache splineCache;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
+            // Keep a spatially uncorrelated subset of the strands, selected by hashing the strand index.
+            const double threshold = std::clamp((double)lod.strandFraction, 0.0, 1.0) * 4294967296.0;
+            for (uint32_t i = 0; i < strandCount; i++)
+            {
+                if ((double)hashStrandIndex(i) < threshold) strands.push_back(i);
+            }
+            if (strands.empty() && strandCount > 0) strands.push_back(0);
+
+            // Scale the widths so that the kept strands cover roughly the same area as all strands.
+            if (!strands.empty()) widthScale *= std::sqrt((float)strandCount / (float)strands.size());
+            return strands;
+        }
+
+        struct StrandSelection
         {
-            optimizedStrandArrays.controlPoints.clear();
-            optimizedStrandArrays.UVs.clear();
-            optimizedStrandArrays.widths.clear();
-            optimizedStrandArrays.vertexCount = 0;
-            strandArrays.vertexCount = vertexCountsPerStrand[i];
+            const std::vector<uint32_t>& strands;       ///< Indices of the selected strands.
+            std::vector<uint32_t> controlPointOffsets;  ///< Offsets of all strands into the control point arrays.
+            const uint32_t* vertexCountsPerStrand;
+            CurveArrays curveArrays;
+            uint32_t subdivPerSegment;
+            CurveTessellation::StrandLOD lod;
+            float widthScale;
+
+            StrandSelection(const std::vector<uint32_t>& strands, uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const CurveArrays& curveArrays, uint32_t subdivPerSegment, const CurveTessellation::StrandLOD& lod, float widthScale)
+                : strands(strands)
+                , vertexCountsPerStrand(vertexCountsPerStrand)
+                , curveArrays(curveArrays)
+                , subdivPerSegment(subdivPerSegment)
+                , lod(lod)
+                , widthScale(widthScale)
+            {
+                controlPointOffsets.resize(strandCount);
+                std::exclusive_scan(vertexCountsPerStrand, vertexCountsPerStrand + strandCount, controlPointOffsets.begin(), 0u);
 
-            optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, pointOffset, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
+                if (lod.mode == CurveTessellation::StrandLODMode::ErrorDriven) this->lod.keepOneEveryXVerticesPerStrand = 1;
+                FALCOR_ASSERT(this->lod.keepOneEveryXVerticesPerStrand > 0);
+            }
+        };
 
-            const CubicSpline<float3>& splinePoints = splineCache.splinePoints.setup(strandArrays.controlPoints.data(), optimizedStrandArrays.vertexCount);
-            const CubicSpline<float>& splineWidths = splineCache.splineWidths.setup(strandArrays.widths.data(), optimizedStrandArrays.vertexCount);
+        // Scratch data shared by the strands tessellated in one parallel task.
+        struct TessellationScratch
+        {
+            StrandArrays strandArrays;
+            CubicSplineCache splineCache;
+            std::vector<uint8_t> keep;
+            std::vector<std::pair<uint32_t, uint32_t>> stack;
+        };
+
+        // Tessellate the selected strand s, simplified in error driven mode.
+        void tessellateStrand(const StrandSelection& selection, uint32_t s, TessellationScratch& scratch, StrandArrays& optimizedStrandArrays)
+        {
+            const uint32_t i = selection.strands[s];
+            scratch.strandArrays.vertexCount = selection.vertexCountsPerStrand[i];
 
-            uint32_t tmpCount = 0;
-            for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+            optimizeStrandGeometry(scratch.splineCache, selection.curveArrays, scratch.strandArrays, optimizedStrandArrays, selection.controlPointOffsets[i], selection.subdivPerSegment, selection.lod.keepOneEveryXVerticesPerStrand, selection.widthScale);
+
+            if (selection.lod.mode == CurveTessellation::StrandLODMode::ErrorDriven) simplifyStrand(optimizedStrandArrays, selection.lod.tolerance, scratch.keep, scratch.stack);
+        }
+
+        /** Count the tessellated points of the selected strands, used to allocate the results before the strands are written.
+            Stride mode counts are computed from the control points directly.
+            Error driven mode tessellates and simplifies each strand once and keeps the results back to back in one array per task.
+            \param[in] selection Selected strands and tessellation parameters.
+            \param[out] taskStrands Error driven mode: tessellated strands per task. Stride mode: empty.
+            \return Number of tessellated points per selected strand.
+        */
+        std::vector<uint32_t> countTessellatedPoints(const StrandSelection& selection, std::vector<StrandArrays>& taskStrands)
+        {
+            const uint32_t strandCount = (uint32_t)selection.strands.size();
+            std::vector<uint32_t> pointCounts(strandCount);
+            taskStrands.clear();
+
+            if (selection.lod.mode == CurveTessellation::StrandLODMode::ErrorDriven)
             {
-                for (uint32_t k = 0; k < subdivPerSegment; k++)
+                taskStrands.resize(div_round_up(strandCount, kStrandsPerTask));
+
+                auto range = NumericRange<uint32_t>(0, (uint32_t)taskStrands.size());
+                std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t task)
                 {
-                    if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                    {
-                        float t = (float)k / (float)subdivPerSegment;
-                        result.indices.push_back((uint32_t)result.points.size());
+                    TessellationScratch scratch;
+                    StrandArrays strand;
+                    StrandArrays& taskStrand = taskStrands[task];
 
-                        // Pre-transform curve points.
-                        float4 sph = transformSphere(xform, float4(splinePoints.interpolate(j, t), splineWidths.interpolate(j, t) * 0.5f * widthScale));
+                    const uint32_t end = std::min((task + 1) * kStrandsPerTask, strandCount);
+                    for (uint32_t s = task * kStrandsPerTask; s < end; s++)
+                    {
+                        tessellateStrand(selection, s, scratch, strand);
+                        pointCounts[s] = (uint32_t)strand.controlPoints.size();
 
-                        result.points.push_back(sph.xyz);
-                        result.radius.push_back(sph.w);
+                        taskStrand.controlPoints.insert(taskStrand.controlPoints.end(), strand.controlPoints.begin(), strand.controlPoints.end());
+                        taskStrand.widths.insert(taskStrand.widths.end(), strand.widths.begin(), strand.widths.end());
+                        taskStrand.UVs.insert(taskStrand.UVs.end(), strand.UVs.begin(), strand.UVs.end());
                     }
-                    tmpCount++;
-                }
+                });
+                return pointCounts;
             }
 
-            // Always keep the last vertex.
-            float4 sph = transformSphere(xform, float4(splinePoints.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f), splineWidths.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f) * 0.5f * widthScale));
-            result.points.push_back(sph.xyz);
-            result.radius.push_back(sph.w);
+            auto range = NumericRange<uint32_t>(0, strandCount);
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t s)
+            {
+                const uint32_t i = selection.strands[s];
+                const uint32_t vertexCount = selection.vertexCountsPerStrand[i];
+                if (vertexCount == 0) return;
+
+                // Same duplicate removal as in optimizeStrandGeometry().
+                const float3* pControlPoints = selection.curveArrays.controlPoints + selection.controlPointOffsets[i];
+                uint32_t uniqueCount = 1;
+                for (uint32_t j = 0; j < vertexCount - 1; j++)
+                {
+                    if (pControlPoints[j] != pControlPoints[j + 1]) uniqueCount++;
+                }
+                if (uniqueCount < 2) return;
 
-            // Texture coordinates.
-            if (UVs)
+                // Kept sub-segment start points plus the last vertex.
+                pointCounts[s] = div_round_up((uniqueCount - 1) * selection.subdivPerSegment, selection.lod.keepOneEveryXVerticesPerStrand) + 1;
+            });
+
+            return pointCounts;
+        }
+
+        /** Pass each tessellated strand to a callback, in parallel over the tasks.
+            Strands of the error driven mode are taken from the task arrays, which are released once a task is done.
+            Stride mode strands are tessellated here, so only one tessellated strand per task is kept.
+            \param[in] selection Selected strands and tessellation parameters.
+            \param[in] pointCounts Number of tessellated points per selected strand.
+            \param[in,out] taskStrands Tessellated strands per task from countTessellatedPoints().
+            \param[in] func Callback taking the index into the selected strands and the tessellated strand, widths are scaled by widthScale.
+        */
+        template<typename F>
+        void forEachTessellatedStrand(const StrandSelection& selection, const std::vector<uint32_t>& pointCounts, std::vector<StrandArrays>& taskStrands, F func)
+        {
+            const uint32_t strandCount = (uint32_t)selection.strands.size();
+
+            auto range = NumericRange<uint32_t>(0, div_round_up(strandCount, kStrandsPerTask));
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t task)
             {
-                const CubicSpline<float2>& splineUVs = splineCache.splineUVs.setup(strandArrays.UVs.data(), optimizedStrandArrays.vertexCount);
-                tmpCount = 0;
-                for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
+                StrandArrays strand;
+                const uint32_t end = std::min((task + 1) * kStrandsPerTask, strandCount);
+
+                if (!taskStrands.empty())
                 {
-                    for (uint32_t k = 0; k < subdivPerSegment; k++)
+                    StrandArrays& taskStrand = taskStrands[task];
+                    size_t offset = 0;
+                    for (uint32_t s = task * kStrandsPerTask; s < end; s++)
                     {
-                        if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
-                        {
-                            float t = (float)k / (float)subdivPerSegment;
-                            result.texCrds.push_back(splineUVs.interpolate(j, t));
-                        }
-                        tmpCount++;
+                        const size_t count = pointCounts[s];
+                        strand.controlPoints.assign(taskStrand.controlPoints.begin() + offset, taskStrand.controlPoints.begin() + offset + count);
+                        strand.widths.assign(taskStrand.widths.begin() + offset, taskStrand.widths.begin() + offset + count);
+                        if (!taskStrand.UVs.empty()) strand.UVs.assign(taskStrand.UVs.begin() + offset, taskStrand.UVs.begin() + offset + count);
+                        offset += count;
+
+                        func(s, strand);
                     }
+                    taskStrand = StrandArrays();
+                    return;
                 }
 
-                // Always keep the last vertex.
-                result.texCrds.push_back(splineUVs.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
-            }
+                TessellationScratch scratch;
+                for (uint32_t s = task * kStrandsPerTask; s < end; s++)
+                {
+                    tessellateStrand(selection, s, scratch, strand);
+                    FALCOR_ASSERT(strand.controlPoints.size() == pointCounts[s]);
+                    func(s, strand);
+                }
+            });
+        }
 
-            for (uint32_t j = i; j < std::min(strandCount, i + keepOneEveryXStrands); j++) pointOffset += vertexCountsPerStrand[j];
+        // Exclusive prefix sum of the counts. Returns the total count.
+        uint32_t computeOffsets(const std::vector<uint32_t>& counts, std::vector<uint32_t>& offsets)
+        {
+            offsets.resize(counts.size());
+            std::exclusive_scan(counts.begin(), counts.end(), offsets.begin(), 0u);
+            return counts.empty() ? 0 : offsets.back() + counts.back();
         }
+    }
+
+    CurveTessellation::SweptSphereResult CurveTessellation::convertToLinearSweptSphere(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t degree, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, const rmcv::mat4& xform)
+    {
+        StrandLOD lod;
+        lod.keepOneEveryXStrands = keepOneEveryXStrands;
+        lod.keepOneEveryXVerticesPerStrand = keepOneEveryXVerticesPerStrand;
+        return convertToLinearSweptSphere(strandCount, vertexCountsPerStrand, controlPoints, widths, UVs, degree, subdivPerSegment, lod, widthScale, xform);
+    }
+
+    CurveTessellation::SweptSphereResult CurveTessellation::convertToLinearSweptSphere(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t degree, uint32_t subdivPerSegment, const StrandLOD& lod, float widthScale, const rmcv::mat4& xform)
+    {
+        SweptSphereResult result;
+
+        // Only support linear tube segments now.
+        // TODO: Add quadratic or cubic tube segments if necessary.
+        FALCOR_ASSERT(degree == 1);
+        result.degree = degree;
+
+        std::vector<uint32_t> strands = selectStrands(strandCount, lod, widthScale);
+        StrandSelection selection(strands, strandCount, vertexCountsPerStrand, CurveArrays(controlPoints, widths, UVs), subdivPerSegment, lod, widthScale);
+
+        // Output offsets of the strands.
+        std::vector<StrandArrays> taskStrands;
+        std::vector<uint32_t> pointCounts = countTessellatedPoints(selection, taskStrands);
+        std::vector<uint32_t> segCounts(strands.size());
+        for (size_t s = 0; s < strands.size(); s++) segCounts[s] = pointCounts[s] > 0 ? pointCounts[s] - 1 : 0;
+
+        std::vector<uint32_t> pointOffsets, segOffsets;
+        const uint32_t pointCount = computeOffsets(pointCounts, pointOffsets);
+        const uint32_t segCount = computeOffsets(segCounts, segOffsets);
+
+        result.indices.resize(segCount);
+        result.points.resize(pointCount);
+        result.radius.resize(pointCount);
+        if (UVs) result.texCrds.resize(pointCount);
+
+        // Write the tessellated strands to the results.
+        forEachTessellatedStrand(selection, pointCounts, taskStrands, [&](uint32_t s, const StrandArrays& strand)
+        {
+            const uint32_t pointOffset = pointOffsets[s];
+
+            for (uint32_t j = 0; j < pointCounts[s]; j++)
+            {
+                if (j < segCounts[s]) result.indices[segOffsets[s] + j] = pointOffset + j;
+
+                // Pre-transform curve points.
+                float4 sph = transformSphere(xform, float4(strand.controlPoints[j], strand.widths[j] * 0.5f));
+                result.points[pointOffset + j] = sph.xyz;
+                result.radius[pointOffset + j] = sph.w;
+
+                // Texture coordinates.
+                if (UVs) result.texCrds[pointOffset + j] = strand.UVs[j];
+            }
+        });
 
         return result;
     }
 
     CurveTessellation::MeshResult CurveTessellation::convertToPolytube(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, uint32_t pointCountPerCrossSection)
+    {
+        StrandLOD lod;
+        lod.keepOneEveryXStrands = keepOneEveryXStrands;
+        lod.keepOneEveryXVerticesPerStrand = keepOneEveryXVerticesPerStrand;
+        return convertToPolytube(strandCount, vertexCountsPerStrand, controlPoints, widths, UVs, subdivPerSegment, lod, widthScale, pointCountPerCrossSection);
+    }
+
+    CurveTessellation::MeshResult CurveTessellation::convertToPolytube(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t subdivPerSegment, const StrandLOD& lod, float widthScale, uint32_t pointCountPerCrossSection)
     {
         MeshResult result;
-        uint32_t vertexCounts = 0;
-        uint32_t faceCounts = 0;
-        uint32_t maxVertexCountsPerStrand = 0;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
+
+        std::vector<uint32_t> strands = selectStrands(strandCount, lod, widthScale);
+        CurveArrays curveArrays(controlPoints, widths, UVs);
+        StrandSelection selection(strands, strandCount, vertexCountsPerStrand, curveArrays, subdivPerSegment, lod, kMeshCompensationScale * widthScale);
+
+        // Output offsets of the strands.
+        std::vector<StrandArrays> taskStrands;
+        std::vector<uint32_t> pointCounts = countTessellatedPoints(selection, taskStrands);
+        std::vector<uint32_t> vertexCounts(strands.size());
+        std::vector<uint32_t> faceCounts(strands.size());
+        for (size_t s = 0; s < strands.size(); s++)
         {
-            uint32_t tmpPointCount = div_round_up(subdivPerSegment * (vertexCountsPerStrand[i] - 1), keepOneEveryXVerticesPerStrand) + 1;
-            vertexCounts += pointCountPerCrossSection * tmpPointCount;
-            faceCounts += 2 * pointCountPerCrossSection * (tmpPointCount - 1);
-            maxVertexCountsPerStrand = std::max(maxVertexCountsPerStrand, vertexCountsPerStrand[i]);
+            const uint32_t pointCount = pointCounts[s];
+            vertexCounts[s] = pointCountPerCrossSection * pointCount;
+            faceCounts[s] = pointCount > 0 ? 2 * pointCountPerCrossSection * (pointCount - 1) : 0;
         }
-        result.vertices.reserve(vertexCounts);
-        result.normals.reserve(vertexCounts);
-        result.tangents.reserve(vertexCounts);
-        result.texCrds.reserve(vertexCounts);
-        result.radii.reserve(vertexCounts);
-        result.faceVertexCounts.reserve(faceCounts);
-        result.faceVertexIndices.reserve(faceCounts * 3);
-
-        uint32_t pointOffset = 0;
-        uint32_t meshVertexOffset = 0;
-
-        StrandArrays strandArrays;
-        strandArrays.controlPoints.reserve(maxVertexCountsPerStrand);
-        strandArrays.widths.reserve(maxVertexCountsPerStrand);
-        strandArrays.UVs.reserve(maxVertexCountsPerStrand);
-        CurveArrays curveArrays(controlPoints, widths, UVs);
 
-        StrandArrays optimizedStrandArrays;
-        CubicSplineCache splineCache;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
-        {
-            optimizedStrandArrays.controlPoints.clear();
-            optimizedStrandArrays.UVs.clear();
-            optimizedStrandArrays.widths.clear();
-            optimizedStrandArrays.vertexCount = 0;
+        std::vector<uint32_t> vertexOffsets, faceOffsets;
+        const uint32_t vertexCount = computeOffsets(vertexCounts, vertexOffsets);
+        const uint32_t faceCount = computeOffsets(faceCounts, faceOffsets);
 
-            strandArrays.vertexCount = vertexCountsPerStrand[i];
+        result.vertices.resize(vertexCount);
+        result.normals.resize(vertexCount);
+        result.tangents.resize(vertexCount);
+        if (UVs) result.texCrds.resize(vertexCount);
+        result.radii.resize(vertexCount);
+        result.faceVertexCounts.resize(faceCount);
+        result.faceVertexIndices.resize(faceCount * 3);
 
-            optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, pointOffset, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
+        // Write the tessellated strands to the results.
+        forEachTessellatedStrand(selection, pointCounts, taskStrands, [&](uint32_t strandIndex, const StrandArrays& optimizedStrandArrays)
+        {
+            if (optimizedStrandArrays.controlPoints.empty()) return;
 
-            for (uint32_t j = i; j < std::min(strandCount, i + keepOneEveryXStrands); j++) pointOffset += vertexCountsPerStrand[j];
+            const uint32_t meshVertexOffset = vertexOffsets[strandIndex];
 
             // Build the initial frame.
             float3 fwd, s, t;
@@ -386,20 +627,17 @@ namespace Falcor
                 updateCurveFrame(optimizedStrandArrays, fwd, s, t, j);
 
                 // Mesh vertices, normals, tangents, and texCrds (if any).
-                updateMeshResultBuffers(result, curveArrays, optimizedStrandArrays, fwd, s, t, pointCountPerCrossSection, widthScale, j);
+                updateMeshResultBuffers(result, curveArrays, optimizedStrandArrays, fwd, s, t, pointCountPerCrossSection, meshVertexOffset, j);
 
                 // Mesh faces.
                 if (j < optimizedStrandArrays.controlPoints.size() - 1)
                 {
                     uint32_t quadCountLimit = pointCountPerCrossSection;
-                    connectFaceVertices(result, meshVertexOffset, pointCountPerCrossSection, quadCountLimit, 1, 1, j);
+                    connectFaceVertices(result, faceOffsets[strandIndex], meshVertexOffset, pointCountPerCrossSection, quadCountLimit, 1, 1, j);
                 }
             }
+        });
 
-            meshVertexOffset += pointCountPerCrossSection * (uint32_t)optimizedStrandArrays.controlPoints.size();
-        }
         return result;
     }
-
-
 }
@@ -36,6 +36,23 @@ namespace Falcor
     class FALCOR_API CurveTessellation
     {
     public:
+        // Strand level of detail
+
+        enum class StrandLODMode : uint32_t
+        {
+            Stride,         ///< Keep one of every X strands and one of every X vertices per strand.
+            ErrorDriven,    ///< Simplify each strand to a geometric tolerance and keep a fraction of the strands, with width compensation.
+        };
+
+        struct StrandLOD
+        {
+            StrandLODMode mode = StrandLODMode::Stride;
+            uint32_t keepOneEveryXStrands = 1;              ///< Stride mode: keep one of every X curve strands.
+            uint32_t keepOneEveryXVerticesPerStrand = 1;    ///< Stride mode: keep one of every X vertices in each curve strand.
+            float tolerance = 0.f;                          ///< Error driven mode: maximum deviation (distance plus radius difference) of the simplified strands from the tessellated strands, in curve space.
+            float strandFraction = 1.f;                     ///< Error driven mode: fraction of the strands to keep. Widths are scaled by the square root of the removed strand ratio to preserve coverage.
+        };
+
         // Swept spheres
 
         struct SweptSphereResult
@@ -63,6 +80,21 @@ namespace Falcor
         */
         static SweptSphereResult convertToLinearSweptSphere(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t degree, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, const rmcv::mat4& xform);
 
+        /** Convert cubic B-splines to a couple of linear swept sphere segments. Strands are tessellated in parallel.
+            \param[in] strandCount Number of curve strands.
+            \param[in] vertexCountsPerStrand Number of control points per strand.
+            \param[in] controlPoints Array of control points.
+            \param[in] widths Array of curve widths, i.e., diameters of swept spheres.
+            \param[in] UVs Array of texture coordinates.
+            \param[in] degree Polynomial degree of strand (linear -- cubic).
+            \param[in] subdivPerSegment Number of sub-segments within each cubic bspline segment (defined by 4 control points).
+            \param[in] lod Strand level of detail.
+            \param[in] widthScale Global scaling factor for curve width (normally set to 1.0).
+            \param[in] xform Row-major 4x4 transformation matrix. We apply pre-transformation to curve geometry.
+            \return Linear swept sphere segments.
+        */
+        static SweptSphereResult convertToLinearSweptSphere(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t degree, uint32_t subdivPerSegment, const StrandLOD& lod, float widthScale, const rmcv::mat4& xform);
+
         // Tessellated mesh
 
         struct MeshResult
@@ -91,6 +123,20 @@ namespace Falcor
         */
         static MeshResult convertToPolytube(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, uint32_t pointCountPerCrossSection);
 
+        /** Tessellate cubic B-splines to a triangular mesh. Strands are tessellated in parallel.
+            \param[in] strandCount Number of curve strands.
+            \param[in] vertexCountsPerStrand Number of control points per strand.
+            \param[in] controlPoints Array of control points.
+            \param[in] widths Array of curve widths, i.e., diameters of swept spheres.
+            \param[in] UVs Array of texture coordinates.
+            \param[in] subdivPerSegment Number of sub-segments within each cubic bspline segment (defined by 4 control points).
+            \param[in] lod Strand level of detail.
+            \param[in] widthScale Global scaling factor for curve width (normally set to 1.0).
+            \param[in] pointCountPerCrossSection Number of points sampled at each cross-section.
+            \return Tessellated mesh.
+        */
+        static MeshResult convertToPolytube(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t subdivPerSegment, const StrandLOD& lod, float widthScale, uint32_t pointCountPerCrossSection);
+
 
     private:
         CurveTessellation() = default;
@@ -84,6 +84,12 @@ namespace Falcor
         uint32_t kCurveKeepOneEveryXStrands = 1;
         // Skip some hair vertices, if necessary for memory/perf reasons.
         uint32_t kCurveKeepOneEveryXVerticesPerStrand = 1;
+        // Strand level of detail mode, either "stride" (uses the two settings above) or "errorDriven".
+        const char kCurveLODMode[] = "stride";
+        // Error driven LOD: maximum deviation of the simplified strands, in curve space.
+        float kCurveLODTolerance = 0.f;
+        // Error driven LOD: fraction of the hair strands to keep, the widths are compensated.
+        float kCurveLODStrandFraction = 1.f;
 
         // Default curve material parameters.
         const float kDefaultCurveIOR = 1.55f;
@@ -622,6 +628,30 @@ namespace Falcor
             return true;
         }
 
+        // Get the strand level of detail of a curve asset from the curves:* attributes.
+        CurveTessellation::StrandLOD getCurveStrandLOD(const std::string& curveName)
+        {
+            const auto& settings = gpFramework->getSettings();
+
+            CurveTessellation::StrandLOD lod;
+            lod.keepOneEveryXStrands = settings.getAttribute(curveName, "curves:keepOneEveryXStrands", kCurveKeepOneEveryXStrands);
+            lod.keepOneEveryXVerticesPerStrand = settings.getAttribute(curveName, "curves:keepOneEveryXVerticesPerStrand", kCurveKeepOneEveryXVerticesPerStrand);
+
+            std::string mode = settings.getAttribute(curveName, "curves:lodMode", std::string(kCurveLODMode));
+            if (mode == "errorDriven")
+            {
+                lod.mode = CurveTessellation::StrandLODMode::ErrorDriven;
+                lod.tolerance = settings.getAttribute(curveName, "curves:lodTolerance", kCurveLODTolerance);
+                lod.strandFraction = settings.getAttribute(curveName, "curves:lodStrandFraction", kCurveLODStrandFraction);
+            }
+            else if (mode != "stride")
+            {
+                logWarning("Curve '{}' has unknown LOD mode '{}', using 'stride'.", curveName, mode);
+            }
+
+            return lod;
+        }
+
         // Convert a UsdGeomBasisCurves into a CurveGeomData (curve primitive).
         bool convertToCurveGeomData(const UsdGeomBasisCurves& usdCurve, const UsdTimeCode& timeCode, ImporterContext& ctx, CurveGeomData& geomOut)
         {
@@ -645,16 +675,16 @@ namespace Falcor
             const float2* pUsdUVs = usdUVs.empty() ? nullptr : (float2*)usdUVs.data();
 
             uint32_t subdivPerSegment                = gpFramework->getSettings().getAttribute(curveName, "curves:subdivPerSegment", kCurveSubdivPerSegment);
-            uint32_t keepOneEveryXStrands            = gpFramework->getSettings().getAttribute(curveName, "curves:keepOneEveryXStrands", kCurveKeepOneEveryXStrands);
-            uint32_t keepOneEveryXVerticesPerStrand  = gpFramework->getSettings().getAttribute(curveName, "curves:keepOneEveryXVerticesPerStrand", kCurveKeepOneEveryXVerticesPerStrand);
+            CurveTessellation::StrandLOD lod         = getCurveStrandLOD(curveName);
 
             // Perceptually, it is a good practice to increase width of hair strands if we render less of them than anticipated.
-            float widthScale = std::sqrt((float)keepOneEveryXStrands);
+            // The error driven LOD mode compensates the widths during tessellation.
+            float widthScale = lod.mode == CurveTessellation::StrandLODMode::Stride ? std::sqrt((float)lod.keepOneEveryXStrands) : 1.f;
 
             // Convert to linear swept sphere segments.
             CurveTessellation::SweptSphereResult result = CurveTessellation::convertToLinearSweptSphere(strandCount, reinterpret_cast<const uint32_t*>(usdCurveVertexCounts.data()),
                 (float3*)usdPoints.data(), usdCurveWidths.data(), pUsdUVs, 1,
-                subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand, widthScale, rmcv::identity<rmcv::mat4x4>());
+                subdivPerSegment, lod, widthScale, rmcv::identity<rmcv::mat4x4>());
 
             // Copy data.
             geomOut.id = curveName;
@@ -700,18 +730,18 @@ namespace Falcor
             const float2* pUsdUVs = usdUVs.empty() ? nullptr : (float2*)usdUVs.data();
 
             uint32_t subdivPerSegment                = gpFramework->getSettings().getAttribute(curveName, "curves:subdivPerSegment", kCurveSubdivPerSegment);
-            uint32_t keepOneEveryXStrands            = gpFramework->getSettings().getAttribute(curveName, "curves:keepOneEveryXStrands", kCurveKeepOneEveryXStrands);
-            uint32_t keepOneEveryXVerticesPerStrand  = gpFramework->getSettings().getAttribute(curveName, "curves:keepOneEveryXVerticesPerStrand", kCurveKeepOneEveryXVerticesPerStrand);
+            CurveTessellation::StrandLOD lod         = getCurveStrandLOD(curveName);
 
             // Perceptually, it is a good practice to increase width of hair strands if we render less of them than anticipated.
-            float widthScale = std::sqrt((float)keepOneEveryXStrands);
+            // The error driven LOD mode compensates the widths during tessellation.
+            float widthScale = lod.mode == CurveTessellation::StrandLODMode::Stride ? std::sqrt((float)lod.keepOneEveryXStrands) : 1.f;
 
             // Tessellation into mesh.
             CurveTessellation::MeshResult result;
 
             if (tessellationMode == CurveTessellationMode::PolyTube)
             {
-                result = CurveTessellation::convertToPolytube(strandCount, reinterpret_cast<const uint32_t*>(usdCurveVertexCounts.data()), (float3*)usdPoints.data(), usdCurveWidths.data(), pUsdUVs, subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand, widthScale, 4);
+                result = CurveTessellation::convertToPolytube(strandCount, reinterpret_cast<const uint32_t*>(usdCurveVertexCounts.data()), (float3*)usdPoints.data(), usdCurveWidths.data(), pUsdUVs, subdivPerSegment, lod, widthScale, 4);
             }
             else
             {
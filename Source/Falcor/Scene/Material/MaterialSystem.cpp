@@ -30,6 +30,7 @@
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
+#include <algorithm>
 #include <numeric>
 
 namespace Falcor
@@ -102,7 +103,8 @@ namespace Falcor
             const auto& pMaterial = mMaterials[materialID];
             if (auto materialGroup = widget.group(label))
             {
-                if (pMaterial->renderUI(materialGroup)) uploadMaterial(materialID);
+                // Modified materials mark themselves dirty and are uploaded on the next call to update().
+                pMaterial->renderUI(materialGroup);
             }
         };
 
@@ -230,8 +232,8 @@ namespace Falcor
             pMaterial->setDefaultTextureSampler(mpDefaultTextureSampler);
         }
 
-        pMaterial->registerUpdateCallback([this](auto flags) { mMaterialUpdates |= flags; });
         mMaterials.push_back(pMaterial);
+        registerMaterialCallback(materialID.get());
         mMaterialsChanged = true;
 
         // Update metadata.
@@ -293,6 +295,11 @@ namespace Falcor
         {
             mMaterials = uniqueMaterials;
             mMaterialsChanged = true;
+
+            // Material IDs have changed. Re-register the update callbacks so materials mark the correct IDs dirty.
+            // The pending dirty IDs are stale, but all materials are uploaded on the next update anyway.
+            mDirtyMaterialIDs.clear();
+            for (uint32_t materialID = 0; materialID < (uint32_t)mMaterials.size(); ++materialID) registerMaterialCallback(materialID);
         }
 
         return removed;
@@ -367,6 +374,7 @@ namespace Falcor
     Material::UpdateFlags MaterialSystem::update(bool forceUpdate)
     {
         Material::UpdateFlags flags = Material::UpdateFlags::None;
+        mDisplacementChangedMaterialIDs.clear();
 
         // Update metadata if materials changed.
         if (mMaterialsChanged)
@@ -394,21 +402,42 @@ namespace Falcor
             forceUpdate = true; // Trigger full upload of all materials
         }
 
-        // Update all materials.
-        if (forceUpdate || mMaterialUpdates != Material::UpdateFlags::None)
+        // Update materials.
+        // Only materials that have marked themselves dirty since the last update are visited, unless a full update is forced.
+        if (forceUpdate || !mDirtyMaterialIDs.empty())
         {
-            for (uint32_t materialID = 0; materialID < (uint32_t)mMaterials.size(); ++materialID)
+            std::vector<uint32_t> materialIDs;
+            if (forceUpdate)
+            {
+                materialIDs.resize(mMaterials.size());
+                std::iota(materialIDs.begin(), materialIDs.end(), 0);
+            }
+            else
+            {
+                materialIDs.assign(mDirtyMaterialIDs.begin(), mDirtyMaterialIDs.end());
+            }
+            mDirtyMaterialIDs.clear();
+
+            std::vector<uint32_t> uploadIDs;
+            uploadIDs.reserve(materialIDs.size());
+            for (uint32_t materialID : materialIDs)
             {
-                auto& pMaterial = mMaterials[materialID];
-                const auto materialUpdates = pMaterial->update(this);
+                FALCOR_ASSERT(materialID < mMaterials.size());
+                const auto materialUpdates = mMaterials[materialID]->update(this);
 
                 if (forceUpdate || materialUpdates != Material::UpdateFlags::None)
                 {
-                    uploadMaterial(materialID);
-
+                    uploadIDs.push_back(materialID);
                     flags |= materialUpdates;
                 }
+
+                if (is_set(materialUpdates, Material::UpdateFlags::DisplacementChanged))
+                {
+                    mDisplacementChangedMaterialIDs.push_back(materialID);
+                }
             }
+
+            uploadMaterials(uploadIDs);
         }
 
         // Update samplers.
@@ -454,7 +483,6 @@ namespace Falcor
         mSamplersChanged = false;
         mBuffersChanged = false;
         mMaterialsChanged = false;
-        mMaterialUpdates = Material::UpdateFlags::None;
 
         return flags;
     }
@@ -572,15 +600,48 @@ namespace Falcor
         mpMaterialsBlock["materialCount"] = getMaterialCount();
     }
 
-    void MaterialSystem::uploadMaterial(const uint32_t materialID)
+    void MaterialSystem::registerMaterialCallback(const uint32_t materialID)
     {
         FALCOR_ASSERT(materialID < mMaterials.size());
-        const auto& pMaterial = mMaterials[materialID];
-        FALCOR_ASSERT(pMaterial);
+        mMaterials[materialID]->registerUpdateCallback([this, materialID](auto flags) {
+            if (flags != Material::UpdateFlags::None) mDirtyMaterialIDs.insert(materialID);
+        });
+    }
 
-        // TODO: On initial upload of materials, we could improve this by not having separate calls to setElement()
-        // but instead prepare a buffer containing all data.
+    void MaterialSystem::uploadMaterials(const std::vector<uint32_t>& materialIDs)
+    {
+        if (materialIDs.empty()) return;
         FALCOR_ASSERT(mpMaterialDataBuffer);
-        mpMaterialDataBuffer->setElement(materialID, pMaterial->getDataBlob());
+        FALCOR_ASSERT(std::is_sorted(materialIDs.begin(), materialIDs.end()));
+
+        // Pack the data blobs of all materials into a single staging buffer and record the
+        // destination ranges, merging consecutive material IDs into contiguous ranges.
+        struct Range
+        {
+            uint32_t firstID;
+            uint32_t count;
+            uint32_t stagingOffset;
+        };
+        std::vector<Range> ranges;
+        std::vector<MaterialDataBlob> stagingData;
+        stagingData.reserve(materialIDs.size());
+
+        for (uint32_t materialID : materialIDs)
+        {
+            FALCOR_ASSERT(materialID < mMaterials.size());
+            if (!ranges.empty() && ranges.back().firstID + ranges.back().count == materialID) ranges.back().count++;
+            else ranges.push_back({ materialID, 1, (uint32_t)stagingData.size() });
+
+            stagingData.push_back(mMaterials[materialID]->getDataBlob());
+        }
+
+        // Upload everything with one staging allocation and one copy per contiguous range.
+        auto pStaging = Buffer::create(stagingData.size() * sizeof(MaterialDataBlob), Resource::BindFlags::None, Buffer::CpuAccess::Write, stagingData.data());
+        auto pRenderContext = gpDevice->getRenderContext();
+        for (const auto& range : ranges)
+        {
+            pRenderContext->copyBufferRegion(mpMaterialDataBuffer.get(), (uint64_t)range.firstID * sizeof(MaterialDataBlob),
+                pStaging.get(), (uint64_t)range.stagingOffset * sizeof(MaterialDataBlob), (uint64_t)range.count * sizeof(MaterialDataBlob));
+        }
     }
 }
@@ -94,6 +94,11 @@ namespace Falcor
         */
         Material::UpdateFlags update(bool forceUpdate);
 
+        /** Get the IDs of the materials whose displacement parameters changed in the last call to update().
+            \return Sorted list of material IDs.
+        */
+        const std::vector<uint32_t>& getDisplacementChangedMaterialIDs() const { return mDisplacementChangedMaterialIDs; }
+
         /** Get shader defines.
             These need to be set before binding the material system parameter block.
             \return List of shader defines.
@@ -220,7 +225,8 @@ namespace Falcor
 
         void updateUI();
         void createParameterBlock();
-        void uploadMaterial(const uint32_t materialID);
+        void registerMaterialCallback(const uint32_t materialID);
+        void uploadMaterials(const std::vector<uint32_t>& materialIDs);
 
         std::vector<Material::SharedPtr> mMaterials;                ///< List of all materials.
         std::vector<uint32_t> mMaterialCountByType;                 ///< Number of materials of each type, indexed by MaterialType.
@@ -236,7 +242,8 @@ namespace Falcor
         bool mSamplersChanged = false;                              ///< Flag indicating if samplers were added/removed since last update.
         bool mBuffersChanged = false;                               ///< Flag indicating if buffers were added/removed since last update.
         bool mMaterialsChanged = false;                             ///< Flag indicating if materials were added/removed since last update. Per-material updates are tracked by each material's update flags.
-        Material::UpdateFlags mMaterialUpdates = Material::UpdateFlags::None; ///< Material updates across all materials since last update.
+        std::set<uint32_t> mDirtyMaterialIDs;                       ///< IDs of materials that were modified since last update. Materials register themselves here via their update callback.
+        std::vector<uint32_t> mDisplacementChangedMaterialIDs;      ///< IDs of materials whose displacement parameters changed in the last update.
 
         // GPU resources
         GpuFence::SharedPtr mpFence;
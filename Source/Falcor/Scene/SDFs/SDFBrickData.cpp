@@ -0,0 +1,448 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SDFBrickData.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kFileMagic = 0x42464453; // 'SDFB'
+        const uint32_t kFileVersion = 1;
+
+        struct FileHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t gridWidth;
+            uint32_t brickWidth;
+            uint32_t valueFormat;
+            float narrowBandWidth;
+            uint32_t brickCount;
+        };
+
+        int32_t getMaxQuantizedValue(SDFBrickData::ValueFormat valueFormat)
+        {
+            return valueFormat == SDFBrickData::ValueFormat::Int16 ? INT16_MAX : INT8_MAX;
+        }
+
+        /** Appends all bricks with a given z brick coordinate to the brick data.
+            \param[in,out] data The brick data.
+            \param[in] pSlices Dense z-slices of corner values, starting at the z coordinate of the layer.
+            \param[in] brickZ The z brick coordinate of the layer.
+        */
+        void appendBrickLayer(SDFBrickData& data, const float* pSlices, uint32_t brickZ)
+        {
+            const uint32_t gridWidth = data.gridWidth;
+            const uint32_t gridWidthInValues = gridWidth + 1;
+            const uint32_t brickWidth = data.brickWidth;
+            const uint32_t brickWidthInValues = brickWidth + 1;
+            const uint32_t bricksPerAxis = data.getBricksPerAxis();
+            const uint32_t zBegin = brickZ * brickWidth;
+
+            std::vector<float> brickValues(data.getBrickValueCount());
+            std::vector<uint8_t> quantizedValues(data.getBrickByteSize());
+
+            for (uint32_t brickY = 0; brickY < bricksPerAxis; brickY++)
+            {
+                for (uint32_t brickX = 0; brickX < bricksPerAxis; brickX++)
+                {
+                    const uint3 brickOrigin = uint3(brickX, brickY, brickZ) * brickWidth;
+
+                    // Gather the corner values of the brick, corners outside of the grid are set to the maximum distance.
+                    for (uint32_t z = 0; z < brickWidthInValues; z++)
+                    {
+                        for (uint32_t y = 0; y < brickWidthInValues; y++)
+                        {
+                            for (uint32_t x = 0; x < brickWidthInValues; x++)
+                            {
+                                uint3 c = brickOrigin + uint3(x, y, z);
+                                bool outside = c.x > gridWidth || c.y > gridWidth || c.z > gridWidth;
+                                brickValues[x + brickWidthInValues * (y + brickWidthInValues * z)] = outside ? data.narrowBandWidth : pSlices[c.x + gridWidthInValues * (c.y + gridWidthInValues * (c.z - zBegin))];
+                            }
+                        }
+                    }
+
+                    // The brick is stored if any voxel inside the grid contains the surface.
+                    bool hasSurface = SDFBrickData::brickContainsSurface(brickValues.data(), brickWidth, glm::min(uint3(brickWidth), uint3(gridWidth) - brickOrigin));
+
+                    const uint32_t virtualBrickID = brickX + bricksPerAxis * (brickY + bricksPerAxis * brickZ);
+                    if (!hasSurface)
+                    {
+                        if (brickValues[0] < 0.f) data.setBrickInside(virtualBrickID);
+                        continue;
+                    }
+
+                    data.quantizeBrick(brickValues.data(), quantizedValues.data());
+                    data.appendBrick(virtualBrickID, quantizedValues.data());
+                }
+            }
+        }
+    }
+
+    void SDFBrickData::init(uint32_t gridWidth, uint32_t brickWidth, ValueFormat valueFormat, float narrowBandWidth)
+    {
+        this->gridWidth = gridWidth;
+        this->brickWidth = brickWidth;
+        this->valueFormat = valueFormat;
+        this->narrowBandWidth = narrowBandWidth > 0.f ? narrowBandWidth : std::sqrt(3.f) / gridWidth;
+
+        uint32_t bricksPerAxis = getBricksPerAxis();
+        size_t virtualBrickCount = size_t(bricksPerAxis) * bricksPerAxis * bricksPerAxis;
+        brickIDs.clear();
+        values.clear();
+        insideMask.assign((virtualBrickCount + 7) / 8, 0);
+    }
+
+    void SDFBrickData::quantizeBrick(const float* pValues, uint8_t* pDst) const
+    {
+        const float maxValue = float(getMaxQuantizedValue(valueFormat));
+        const size_t bytesPerValue = size_t(valueFormat);
+
+        for (uint32_t i = 0; i < getBrickValueCount(); i++)
+        {
+            float scaled = std::clamp(pValues[i] / narrowBandWidth, -1.f, 1.f) * maxValue;
+            int32_t quantized = int32_t(scaled >= 0.f ? scaled + 0.5f : scaled - 0.5f);
+
+            if (valueFormat == ValueFormat::Int16)
+            {
+                int16_t v = int16_t(quantized);
+                std::memcpy(pDst, &v, sizeof(int16_t));
+            }
+            else
+            {
+                int8_t v = int8_t(quantized);
+                std::memcpy(pDst, &v, sizeof(int8_t));
+            }
+            pDst += bytesPerValue;
+        }
+    }
+
+    void SDFBrickData::appendBrick(uint32_t virtualBrickID, const uint8_t* pQuantizedValues)
+    {
+        FALCOR_ASSERT(brickIDs.empty() || brickIDs.back() < virtualBrickID);
+        brickIDs.push_back(virtualBrickID);
+        values.insert(values.end(), pQuantizedValues, pQuantizedValues + getBrickByteSize());
+    }
+
+    int32_t SDFBrickData::findBrick(uint32_t virtualBrickID) const
+    {
+        auto it = std::lower_bound(brickIDs.begin(), brickIDs.end(), virtualBrickID);
+        if (it == brickIDs.end() || *it != virtualBrickID) return -1;
+        return int32_t(it - brickIDs.begin());
+    }
+
+    float SDFBrickData::getBrickValue(uint32_t brickIndex, const uint3& localCoords) const
+    {
+        const uint32_t brickWidthInValues = brickWidth + 1;
+        const size_t valueIndex = size_t(brickIndex) * getBrickValueCount() + localCoords.x + brickWidthInValues * (localCoords.y + brickWidthInValues * localCoords.z);
+
+        int32_t quantized;
+        if (valueFormat == ValueFormat::Int16)
+        {
+            int16_t v;
+            std::memcpy(&v, values.data() + valueIndex * sizeof(int16_t), sizeof(int16_t));
+            quantized = v;
+        }
+        else
+        {
+            quantized = int8_t(values[valueIndex]);
+        }
+
+        return float(quantized) / float(getMaxQuantizedValue(valueFormat)) * narrowBandWidth;
+    }
+
+    float SDFBrickData::getCornerValue(const uint3& coords) const
+    {
+        // A corner on a brick boundary is shared by up to eight bricks, look for any of them that is stored.
+        const uint32_t bricksPerAxis = getBricksPerAxis();
+        const uint3 maxBrickCoords = coords / brickWidth;
+        const uint3 onBoundary = uint3(coords.x % brickWidth == 0, coords.y % brickWidth == 0, coords.z % brickWidth == 0);
+
+        uint32_t fallbackVirtualBrickID = UINT32_MAX;
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            const uint3 offset = uint3((i >> 2) & 1, (i >> 1) & 1, i & 1);
+            if (offset.x > onBoundary.x || offset.y > onBoundary.y || offset.z > onBoundary.z) continue;
+            if (offset.x > maxBrickCoords.x || offset.y > maxBrickCoords.y || offset.z > maxBrickCoords.z) continue;
+
+            const uint3 brickCoords = maxBrickCoords - offset;
+            if (brickCoords.x >= bricksPerAxis || brickCoords.y >= bricksPerAxis || brickCoords.z >= bricksPerAxis) continue;
+
+            const uint32_t virtualBrickID = brickCoords.x + bricksPerAxis * (brickCoords.y + bricksPerAxis * brickCoords.z);
+            int32_t brickIndex = findBrick(virtualBrickID);
+            if (brickIndex >= 0) return getBrickValue(uint32_t(brickIndex), coords - brickCoords * brickWidth);
+
+            if (fallbackVirtualBrickID == UINT32_MAX) fallbackVirtualBrickID = virtualBrickID;
+        }
+
+        if (fallbackVirtualBrickID == UINT32_MAX) return narrowBandWidth;
+        return isBrickInside(fallbackVirtualBrickID) ? -narrowBandWidth : narrowBandWidth;
+    }
+
+    std::vector<float> SDFBrickData::createDenseValues() const
+    {
+        const uint32_t gridWidthInValues = gridWidth + 1;
+        const uint32_t brickWidthInValues = brickWidth + 1;
+        const uint32_t bricksPerAxis = getBricksPerAxis();
+        std::vector<float> cornerValues(size_t(gridWidthInValues) * gridWidthInValues * gridWidthInValues);
+
+        auto forEachCorner = [&](const uint3& brickCoords, auto func)
+        {
+            const uint3 brickOrigin = brickCoords * brickWidth;
+            const uint3 end = glm::min(uint3(brickWidthInValues), uint3(gridWidthInValues) - brickOrigin);
+            for (uint32_t z = 0; z < end.z; z++)
+            {
+                for (uint32_t y = 0; y < end.y; y++)
+                {
+                    for (uint32_t x = 0; x < end.x; x++)
+                    {
+                        const uint3 c = brickOrigin + uint3(x, y, z);
+                        cornerValues[c.x + size_t(gridWidthInValues) * (c.y + size_t(gridWidthInValues) * c.z)] = func(uint3(x, y, z));
+                    }
+                }
+            }
+        };
+
+        // Fill empty bricks with the narrow band distance first, stored bricks then overwrite the corners they share with them.
+        for (uint32_t z = 0; z < bricksPerAxis; z++)
+        {
+            for (uint32_t y = 0; y < bricksPerAxis; y++)
+            {
+                for (uint32_t x = 0; x < bricksPerAxis; x++)
+                {
+                    const uint32_t virtualBrickID = x + bricksPerAxis * (y + bricksPerAxis * z);
+                    const float value = isBrickInside(virtualBrickID) ? -narrowBandWidth : narrowBandWidth;
+                    forEachCorner(uint3(x, y, z), [value](const uint3&) { return value; });
+                }
+            }
+        }
+
+        for (uint32_t brickIndex = 0; brickIndex < getBrickCount(); brickIndex++)
+        {
+            uint32_t virtualBrickID = brickIDs[brickIndex];
+            const uint3 brickCoords = uint3(virtualBrickID % bricksPerAxis, (virtualBrickID / bricksPerAxis) % bricksPerAxis, virtualBrickID / (bricksPerAxis * bricksPerAxis));
+            forEachCorner(brickCoords, [&](const uint3& localCoords) { return getBrickValue(brickIndex, localCoords); });
+        }
+
+        return cornerValues;
+    }
+
+    bool SDFBrickData::write(const std::filesystem::path& path) const
+    {
+        std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            logWarning("SDFBrickData::write() file '{}' could not be opened!", path);
+            return false;
+        }
+
+        FileHeader header = { kFileMagic, kFileVersion, gridWidth, brickWidth, (uint32_t)valueFormat, narrowBandWidth, getBrickCount() };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(brickIDs.data()), brickIDs.size() * sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(insideMask.data()), insideMask.size());
+        file.write(reinterpret_cast<const char*>(values.data()), values.size());
+
+        if (!file.good())
+        {
+            logWarning("SDFBrickData::write() failed to write '{}'!", path);
+            return false;
+        }
+        return true;
+    }
+
+    bool SDFBrickData::read(const std::filesystem::path& path, SDFBrickData& data)
+    {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if (!file.is_open())
+        {
+            logWarning("SDFBrickData::read() file '{}' could not be opened!", path);
+            return false;
+        }
+
+        FileHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!file.good() || header.magic != kFileMagic)
+        {
+            logWarning("SDFBrickData::read() file '{}' is not an SDF brick file!", path);
+            return false;
+        }
+
+        if (header.version != kFileVersion)
+        {
+            logWarning("SDFBrickData::read() file '{}' has unsupported version {}!", path, header.version);
+            return false;
+        }
+
+        ValueFormat valueFormat = ValueFormat(header.valueFormat);
+        if (header.gridWidth == 0 || header.brickWidth == 0 || (valueFormat != ValueFormat::Int8 && valueFormat != ValueFormat::Int16) || !(header.narrowBandWidth > 0.f))
+        {
+            logWarning("SDFBrickData::read() file '{}' has an invalid header!", path);
+            return false;
+        }
+
+        data.init(header.gridWidth, header.brickWidth, valueFormat, header.narrowBandWidth);
+
+        const uint32_t bricksPerAxis = data.getBricksPerAxis();
+        if (uint64_t(header.brickCount) > uint64_t(bricksPerAxis) * bricksPerAxis * bricksPerAxis)
+        {
+            logWarning("SDFBrickData::read() file '{}' has an invalid brick count!", path);
+            return false;
+        }
+
+        data.brickIDs.resize(header.brickCount);
+        data.values.resize(size_t(header.brickCount) * data.getBrickValueCount() * size_t(valueFormat));
+        file.read(reinterpret_cast<char*>(data.brickIDs.data()), data.brickIDs.size() * sizeof(uint32_t));
+        file.read(reinterpret_cast<char*>(data.insideMask.data()), data.insideMask.size());
+        file.read(reinterpret_cast<char*>(data.values.data()), data.values.size());
+
+        if (!file.good())
+        {
+            logWarning("SDFBrickData::read() file '{}' is truncated!", path);
+            return false;
+        }
+
+        // Brick IDs must be strictly increasing, this also rejects duplicate IDs.
+        if (std::adjacent_find(data.brickIDs.begin(), data.brickIDs.end(), [](uint32_t a, uint32_t b) { return a >= b; }) != data.brickIDs.end())
+        {
+            logWarning("SDFBrickData::read() file '{}' has unsorted or duplicate brick IDs!", path);
+            return false;
+        }
+
+        if (!data.brickIDs.empty() && uint64_t(data.brickIDs.back()) >= uint64_t(bricksPerAxis) * bricksPerAxis * bricksPerAxis)
+        {
+            logWarning("SDFBrickData::read() file '{}' has out of range brick IDs!", path);
+            return false;
+        }
+
+        return true;
+    }
+
+    SDFBrickData SDFBrickData::createFromValues(const float* pCornerValues, uint32_t gridWidth, uint32_t brickWidth, ValueFormat valueFormat, float narrowBandWidth)
+    {
+        checkArgument(gridWidth > 0 && brickWidth > 0, "'gridWidth' ({}) and 'brickWidth' ({}) must be larger than zero", gridWidth, brickWidth);
+
+        SDFBrickData data;
+        data.init(gridWidth, brickWidth, valueFormat, narrowBandWidth);
+
+        const size_t sliceValueCount = size_t(gridWidth + 1) * (gridWidth + 1);
+        for (uint32_t brickZ = 0; brickZ < data.getBricksPerAxis(); brickZ++)
+        {
+            appendBrickLayer(data, pCornerValues + brickZ * brickWidth * sliceValueCount, brickZ);
+        }
+
+        return data;
+    }
+
+    bool SDFBrickData::convertDenseFile(const std::filesystem::path& srcPath, const std::filesystem::path& dstPath, uint32_t brickWidth, ValueFormat valueFormat, float narrowBandWidth)
+    {
+        checkArgument(brickWidth > 0, "'brickWidth' must be larger than zero");
+
+        std::ifstream file(srcPath, std::ios::in | std::ios::binary);
+        if (!file.is_open())
+        {
+            logWarning("SDFBrickData::convertDenseFile() file '{}' could not be opened!", srcPath);
+            return false;
+        }
+
+        uint32_t gridWidth = 0;
+        file.read(reinterpret_cast<char*>(&gridWidth), sizeof(uint32_t));
+        if (!file.good() || gridWidth == 0)
+        {
+            logWarning("SDFBrickData::convertDenseFile() file '{}' is not a valid SDF grid file!", srcPath);
+            return false;
+        }
+
+        SDFBrickData data;
+        data.init(gridWidth, brickWidth, valueFormat, narrowBandWidth);
+
+        // Only the slices overlapped by one layer of bricks are kept in memory at a time.
+        const uint32_t gridWidthInValues = gridWidth + 1;
+        const size_t sliceValueCount = size_t(gridWidthInValues) * gridWidthInValues;
+        std::vector<float> slices(sliceValueCount * (brickWidth + 1));
+
+        for (uint32_t brickZ = 0; brickZ < data.getBricksPerAxis(); brickZ++)
+        {
+            const uint32_t zBegin = brickZ * brickWidth;
+            const uint32_t sliceCount = std::min(brickWidth + 1, gridWidthInValues - zBegin);
+
+            file.seekg(std::streamoff(sizeof(uint32_t)) + std::streamoff(zBegin) * std::streamoff(sliceValueCount * sizeof(float)));
+            file.read(reinterpret_cast<char*>(slices.data()), sliceCount * sliceValueCount * sizeof(float));
+            if (!file.good())
+            {
+                logWarning("SDFBrickData::convertDenseFile() file '{}' is truncated!", srcPath);
+                return false;
+            }
+
+            appendBrickLayer(data, slices.data(), brickZ);
+        }
+
+        logInfo("Converted SDF grid '{}' ({}^3 voxels) to {} of {} bricks.", srcPath, gridWidth, data.getBrickCount(), uint64_t(data.getBricksPerAxis()) * data.getBricksPerAxis() * data.getBricksPerAxis());
+        return data.write(dstPath);
+    }
+
+    bool SDFBrickData::brickContainsSurface(const float* pValues, uint32_t brickWidth, const uint3& voxelCount)
+    {
+        const uint32_t brickWidthInValues = brickWidth + 1;
+        for (uint32_t z = 0; z < voxelCount.z; z++)
+        {
+            for (uint32_t y = 0; y < voxelCount.y; y++)
+            {
+                for (uint32_t x = 0; x < voxelCount.x; x++)
+                {
+                    float cornerValues[8];
+                    for (uint32_t i = 0; i < 8; i++)
+                    {
+                        uint3 c = uint3(x + ((i >> 2) & 1), y + ((i >> 1) & 1), z + (i & 1));
+                        cornerValues[i] = pValues[c.x + brickWidthInValues * (c.y + brickWidthInValues * c.z)];
+                    }
+                    if (containsSurface(cornerValues)) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool SDFBrickData::containsSurface(const float cornerValues[8])
+    {
+        bool anyInside = false;
+        bool anyOutside = false;
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            anyInside |= cornerValues[i] <= 0.f;
+            anyOutside |= cornerValues[i] >= 0.f;
+        }
+        return anyInside && anyOutside;
+    }
+}
@@ -0,0 +1,185 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <filesystem>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Sparse, narrow-band representation of SDF grid values, stored as a set of quantized bricks.
+
+        The grid is split into bricks of NxNxN voxels (N = brickWidth). Only bricks where at least one voxel contains the surface are stored,
+        each as (N+1)^3 corner values quantized to 8 or 16 bit snorms relative to the narrow band width. Bricks that are not stored only
+        record whether they lie inside or outside of the surface. Corners outside of the grid (in bricks at the far edges of the grid) are stored as the maximum value.
+
+        The data can be loaded directly by the SDFSBS and SDFSVS grids without ever creating the dense grid of corner values.
+
+        File layout (.sdfb):
+            Header      Magic 'SDFB', version, grid width, brick width, value format, narrow band width and brick count.
+            Brick IDs   brickCount x uint32_t, sorted virtual brick IDs (x + n * (y + n * z)), where n is the number of bricks per axis.
+            Inside mask (n^3 + 7) / 8 bytes, one bit per virtual brick, set if the brick is not stored and lies inside the surface.
+            Values      brickCount x (N+1)^3 x (1 or 2) bytes, ordered like the brick IDs, x fastest within a brick.
+    */
+    struct FALCOR_API SDFBrickData
+    {
+        enum class ValueFormat : uint32_t
+        {
+            Int8 = 1,   ///< Values are stored as 8 bit snorms.
+            Int16 = 2,  ///< Values are stored as 16 bit snorms.
+        };
+
+        static constexpr uint32_t kDefaultBrickWidth = 7;
+
+        uint32_t gridWidth = 0;                     ///< Width of the grid in voxels.
+        uint32_t brickWidth = 0;                    ///< Width of a brick in voxels.
+        ValueFormat valueFormat = ValueFormat::Int8;
+        float narrowBandWidth = 0.f;                ///< Distance (in the [-0.5, 0.5]^3 grid space) represented by the largest quantized value.
+        std::vector<uint32_t> brickIDs;             ///< Sorted virtual IDs of the stored bricks.
+        std::vector<uint8_t> insideMask;            ///< One bit per virtual brick, set if a brick that is not stored lies inside the surface.
+        std::vector<uint8_t> values;                ///< Quantized corner values of the stored bricks.
+
+        /** Returns the number of (virtual) bricks along each axis of the grid.
+        */
+        uint32_t getBricksPerAxis() const { return brickWidth > 0 ? (gridWidth + brickWidth - 1) / brickWidth : 0; }
+
+        /** Returns the number of corner values stored per brick.
+        */
+        uint32_t getBrickValueCount() const { return (brickWidth + 1) * (brickWidth + 1) * (brickWidth + 1); }
+
+        /** Returns the byte size of the quantized values of one brick.
+        */
+        size_t getBrickByteSize() const { return getBrickValueCount() * size_t(valueFormat); }
+
+        /** Returns the number of stored bricks.
+        */
+        uint32_t getBrickCount() const { return (uint32_t)brickIDs.size(); }
+
+        /** Returns the byte size of the stored data.
+        */
+        size_t getSize() const { return brickIDs.size() * sizeof(uint32_t) + insideMask.size() + values.size(); }
+
+        /** Reset to a grid without stored bricks, where all bricks are outside of the surface.
+            \param[in] gridWidth The grid width in voxels.
+            \param[in] brickWidth The brick width in voxels.
+            \param[in] valueFormat The format used to store the values.
+            \param[in] narrowBandWidth The narrow band width in grid space, if zero, the length of one voxel diagonal is used.
+        */
+        void init(uint32_t gridWidth, uint32_t brickWidth, ValueFormat valueFormat, float narrowBandWidth);
+
+        /** Quantize the corner values of a brick.
+            \param[in] pValues The (brickWidth + 1)^3 corner values of the brick, x fastest.
+            \param[out] pDst Destination of getBrickByteSize() bytes.
+        */
+        void quantizeBrick(const float* pValues, uint8_t* pDst) const;
+
+        /** Append a stored brick. Bricks must be appended in increasing order of their virtual brick IDs.
+            \param[in] virtualBrickID The virtual brick ID.
+            \param[in] pQuantizedValues The quantized values of the brick, see quantizeBrick().
+        */
+        void appendBrick(uint32_t virtualBrickID, const uint8_t* pQuantizedValues);
+
+        /** Mark a brick that is not stored as inside of the surface.
+        */
+        void setBrickInside(uint32_t virtualBrickID) { insideMask[virtualBrickID >> 3] |= uint8_t(1u << (virtualBrickID & 7)); }
+
+        /** Find a stored brick.
+            \param[in] virtualBrickID The virtual brick ID (x + n * (y + n * z)).
+            \return Index of the brick in the list of stored bricks, or -1 if the brick is not stored.
+        */
+        int32_t findBrick(uint32_t virtualBrickID) const;
+
+        /** Check if a brick that is not stored lies inside the surface.
+        */
+        bool isBrickInside(uint32_t virtualBrickID) const { return (insideMask[virtualBrickID >> 3] >> (virtualBrickID & 7)) & 1; }
+
+        /** Get a decoded corner value of a stored brick.
+            \param[in] brickIndex Index of the brick in the list of stored bricks.
+            \param[in] localCoords Corner coordinates local to the brick, in [0, brickWidth]^3.
+            \return Signed distance in grid space.
+        */
+        float getBrickValue(uint32_t brickIndex, const uint3& localCoords) const;
+
+        /** Get a decoded corner value of the grid. Corners that are not part of any stored brick are set to +/- the narrow band width.
+            \param[in] coords Corner coordinates, in [0, gridWidth]^3.
+            \return Signed distance in grid space.
+        */
+        float getCornerValue(const uint3& coords) const;
+
+        /** Decode the bricks into a dense grid of (gridWidth + 1)^3 corner values, using the layout expected by SDFGrid::setValues().
+        */
+        std::vector<float> createDenseValues() const;
+
+        /** Write the brick data to a .sdfb file.
+            \param[in] path The path of the file.
+            \return true if the file could be written, otherwise false.
+        */
+        bool write(const std::filesystem::path& path) const;
+
+        /** Read brick data from a .sdfb file.
+            \param[in] path The path of the file.
+            \param[out] data The brick data.
+            \return true if the file could be read, otherwise false.
+        */
+        static bool read(const std::filesystem::path& path, SDFBrickData& data);
+
+        /** Create brick data from a dense grid of corner values.
+            \param[in] pCornerValues (gridWidth + 1)^3 corner values, x fastest.
+            \param[in] gridWidth The grid width in voxels.
+            \param[in] brickWidth The brick width in voxels.
+            \param[in] valueFormat The format used to store the values.
+            \param[in] narrowBandWidth The narrow band width in grid space, if zero, the length of one voxel diagonal is used.
+            \return The brick data.
+        */
+        static SDFBrickData createFromValues(const float* pCornerValues, uint32_t gridWidth, uint32_t brickWidth = kDefaultBrickWidth, ValueFormat valueFormat = ValueFormat::Int8, float narrowBandWidth = 0.f);
+
+        /** Convert a dense .sdfg file to a .sdfb file. The dense file is streamed one layer of bricks at a time and is never fully loaded into memory.
+            \param[in] srcPath The path of the .sdfg file.
+            \param[in] dstPath The path of the .sdfb file.
+            \param[in] brickWidth The brick width in voxels.
+            \param[in] valueFormat The format used to store the values.
+            \param[in] narrowBandWidth The narrow band width in grid space, if zero, the length of one voxel diagonal is used.
+            \return true if the file could be converted, otherwise false.
+        */
+        static bool convertDenseFile(const std::filesystem::path& srcPath, const std::filesystem::path& dstPath, uint32_t brickWidth = kDefaultBrickWidth, ValueFormat valueFormat = ValueFormat::Int8, float narrowBandWidth = 0.f);
+
+        /** Check if a voxel contains the surface, matches SDFVoxelCommon::containsSurface().
+            \param[in] cornerValues The eight corner values of the voxel.
+        */
+        static bool containsSurface(const float cornerValues[8]);
+
+        /** Check if any voxel of a brick contains the surface.
+            \param[in] pValues The (brickWidth + 1)^3 corner values of the brick, x fastest.
+            \param[in] brickWidth The brick width in voxels.
+            \param[in] voxelCount The number of voxels along each axis to check, voxels outside of the grid are skipped.
+        */
+        static bool brickContainsSurface(const float* pValues, uint32_t brickWidth, const uint3& voxelCount);
+    };
+}
@@ -30,10 +30,12 @@
 #include "SparseVoxelSet/SDFSVS.h"
 #include "SparseBrickSet/SDFSBS.h"
 #include "SparseVoxelOctree/SDFSVO.h"
+#include "SDFMeshConverter.h"
 #include "Core/Assert.h"
 #include "Core/Errors.h"
 #include "Core/API/Device.h"
 #include "Core/API/RenderContext.h"
+#include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Scripting/ScriptBindings.h"
@@ -342,11 +344,40 @@ namespace Falcor
         setValuesInternal(cornerValues);
     }
 
+    void SDFGrid::setBricks(const SDFBrickData& brickData)
+    {
+        // All types except SBS need to have a gridWidth that is a power of 2.
+        Type type = getType();
+        if (type != Type::SparseBrickSet)
+        {
+            checkArgument(isPowerOf2(brickData.gridWidth), "'gridWidth' ({}) must be a power of 2 for SDFGrid type of {}", brickData.gridWidth, getTypeName(type));
+        }
+
+        mGridWidth = brickData.gridWidth;
+        setBricksInternal(brickData);
+
+        mInitializedWithPrimitives = false;
+    }
+
+    void SDFGrid::setBricksInternal(const SDFBrickData& brickData)
+    {
+        setValuesInternal(brickData.createDenseValues());
+    }
+
     bool SDFGrid::loadValuesFromFile(const std::filesystem::path& path)
     {
         std::filesystem::path fullPath;
         if (findFileInDataDirectories(path, fullPath))
         {
+            if (hasExtension(fullPath, "sdfb"))
+            {
+                SDFBrickData brickData;
+                if (!SDFBrickData::read(fullPath, brickData)) return false;
+
+                setBricks(brickData);
+                return true;
+            }
+
             std::ifstream file(fullPath, std::ios::in | std::ios::binary);
 
             if (file.is_open())
@@ -448,17 +479,25 @@ namespace Falcor
         pFence->syncCpu();
         const float* pValues = reinterpret_cast<const float*>(pValuesStagingBuffer->map(Buffer::MapType::Read));
 
-        std::ofstream file(path, std::ios::out | std::ios::binary);
-
-        if (file.is_open())
+        bool success = true;
+        if (hasExtension(path, "sdfb"))
+        {
+            success = SDFBrickData::createFromValues(pValues, mGridWidth).write(path);
+        }
+        else
         {
-            file.write(reinterpret_cast<const char*>(&mGridWidth), sizeof(uint32_t));
-            file.write(reinterpret_cast<const char*>(pValues), valueCount * sizeof(float));
-            file.close();
+            std::ofstream file(path, std::ios::out | std::ios::binary);
+
+            if (file.is_open())
+            {
+                file.write(reinterpret_cast<const char*>(&mGridWidth), sizeof(uint32_t));
+                file.write(reinterpret_cast<const char*>(pValues), valueCount * sizeof(float));
+                file.close();
+            }
         }
 
         pValuesStagingBuffer->unmap();
-        return true;
+        return success;
     }
 
     uint32_t SDFGrid::loadPrimitivesFromFile(const std::filesystem::path& path, uint32_t gridWidth, const std::filesystem::path& dir)
@@ -606,6 +645,9 @@ namespace Falcor
     {
         using namespace pybind11::literals;
 
+        FALCOR_SCRIPT_BINDING_DEPENDENCY(TriangleMesh)
+        FALCOR_SCRIPT_BINDING_DEPENDENCY(Transform)
+
         auto createSBS = [](const pybind11::kwargs& args)
         {
             uint32_t brickWidth = 7;
@@ -636,6 +678,40 @@ namespace Falcor
             return SDFGrid::SharedPtr(SDFSBS::create(brickWidth, compressed, defaultGridWidth));
         };
 
+        pybind11::enum_<SDFBrickData::ValueFormat> valueFormat(m, "SDFBrickValueFormat");
+        valueFormat.value("Int8", SDFBrickData::ValueFormat::Int8);
+        valueFormat.value("Int16", SDFBrickData::ValueFormat::Int16);
+
+        pybind11::enum_<SDFMeshConverter::SignMethod> signMethod(m, "SDFMeshSignMethod");
+        signMethod.value("WindingNumber", SDFMeshConverter::SignMethod::WindingNumber);
+        signMethod.value("PseudoNormal", SDFMeshConverter::SignMethod::PseudoNormal);
+
+        auto createMeshConverterOptions = [](uint32_t gridWidth, uint32_t brickWidth, SDFMeshConverter::SignMethod signMethod, float narrowBandWidth, SDFBrickData::ValueFormat valueFormat)
+        {
+            SDFMeshConverter::Options options;
+            options.gridWidth = gridWidth;
+            options.brickWidth = brickWidth;
+            options.valueFormat = valueFormat;
+            options.signMethod = signMethod;
+            options.narrowBandWidth = narrowBandWidth;
+            return options;
+        };
+
+        // Returns the transform that places the grid on top of the mesh.
+        auto loadValuesFromMesh = [createMeshConverterOptions](SDFGrid& grid, const TriangleMesh::SharedPtr& pMesh, uint32_t gridWidth, uint32_t brickWidth, SDFMeshConverter::SignMethod signMethod, float narrowBandWidth, SDFBrickData::ValueFormat valueFormat)
+        {
+            auto options = createMeshConverterOptions(gridWidth, brickWidth, signMethod, narrowBandWidth, valueFormat);
+            auto pConverter = SDFMeshConverter::create(pMesh);
+            grid.setBricks(pConverter->convert(options));
+            return pConverter->getGridTransform(options);
+        };
+
+        auto convertMeshToFile = [createMeshConverterOptions](const TriangleMesh::SharedPtr& pMesh, const std::filesystem::path& dstPath, uint32_t gridWidth, uint32_t brickWidth, SDFMeshConverter::SignMethod signMethod, float narrowBandWidth, SDFBrickData::ValueFormat valueFormat)
+        {
+            auto options = createMeshConverterOptions(gridWidth, brickWidth, signMethod, narrowBandWidth, valueFormat);
+            return SDFMeshConverter::create(pMesh)->convert(options).write(dstPath);
+        };
+
         pybind11::class_<SDFGrid, SDFGrid::SharedPtr> sdfGrid(m, "SDFGrid");
         sdfGrid.def_static("createNDGrid", [](float narrowBandThickness) { return SDFGrid::SharedPtr(NDSDFGrid::create(narrowBandThickness)); }, "narrowBandThickness"_a);
         sdfGrid.def_static("createSVS", [](){ return SDFGrid::SharedPtr(SDFSVS::create()); });
@@ -643,8 +719,11 @@ namespace Falcor
         sdfGrid.def_static("createSVO", [](){ return SDFGrid::SharedPtr(SDFSVO::create()); });
         sdfGrid.def("loadValuesFromFile", &SDFGrid::loadValuesFromFile, "path"_a);
         sdfGrid.def("loadPrimitivesFromFile", &SDFGrid::loadPrimitivesFromFile, "path"_a, "gridWidth"_a, "dir"_a = "");
+        sdfGrid.def("loadValuesFromMesh", loadValuesFromMesh, "mesh"_a, "gridWidth"_a, "brickWidth"_a = SDFBrickData::kDefaultBrickWidth, "signMethod"_a = SDFMeshConverter::SignMethod::WindingNumber, "narrowBandWidth"_a = 0.f, "valueFormat"_a = SDFBrickData::ValueFormat::Int8);
         sdfGrid.def("generateCheeseValues", &SDFGrid::generateCheeseValues, "gridWidth"_a, "seed"_a);
         sdfGrid.def_property("name", &SDFGrid::getName, &SDFGrid::setName);
+        sdfGrid.def_static("convertValuesFile", &SDFBrickData::convertDenseFile, "srcPath"_a, "dstPath"_a, "brickWidth"_a = SDFBrickData::kDefaultBrickWidth, "valueFormat"_a = SDFBrickData::ValueFormat::Int8, "narrowBandWidth"_a = 0.f);
+        sdfGrid.def_static("convertMeshToFile", convertMeshToFile, "mesh"_a, "dstPath"_a, "gridWidth"_a, "brickWidth"_a = SDFBrickData::kDefaultBrickWidth, "signMethod"_a = SDFMeshConverter::SignMethod::WindingNumber, "narrowBandWidth"_a = 0.f, "valueFormat"_a = SDFBrickData::ValueFormat::Int8);
     }
 
     void SDFGrid::createEvaluatePrimitivesPass(bool writeToTexture3D, bool mergeWithSDField)
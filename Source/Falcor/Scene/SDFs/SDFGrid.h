@@ -30,6 +30,7 @@
 #include "Core/API/Buffer.h"
 #include "Core/API/Texture.h"
 #include "Scene/SDFs/SDF3DPrimitiveCommon.slang"
+#include "Scene/SDFs/SDFBrickData.h"
 #include "RenderGraph/BasePasses/ComputePass.h"
 #include <memory>
 #include <vector>
@@ -122,8 +123,14 @@ namespace Falcor
         */
         void setValues(const std::vector<float>& cornerValues, uint32_t gridWidth);
 
+        /** Set the signed distance values of the SDF grid from sparse brick data.
+            \param[in] brickData The brick data, see SDFBrickData.
+        */
+        void setBricks(const SDFBrickData& brickData);
+
         /** Set the signed distance values of the SDF grid from a file.
-            \param[in] path The path of a .sdfg file.
+            Sparse brick files (.sdfb) are loaded directly into the SDFSBS and SDFSVS representations, other grid types decode them to a dense grid.
+            \param[in] path The path of a .sdfg or .sdfb file.
             \return true if the values could be set, otherwise false.
         */
         bool loadValuesFromFile(const std::filesystem::path& path);
@@ -135,7 +142,7 @@ namespace Falcor
         void generateCheeseValues(uint32_t gridWidth, uint32_t seed);
 
         /** Evaluates the SDF grid primitives on to a grid and writes the grid to a file.
-            \param[in] path A path to the file that should store the values.
+            \param[in] path A path to the file that should store the values. If the extension is .sdfb, the grid is stored as sparse bricks, otherwise as a dense .sdfg file.
             \return true if the values could be written, otherwise false.
         */
         bool writeValuesFromPrimitivesToFile(const std::filesystem::path& path, RenderContext* pRenderContext = nullptr);
@@ -197,6 +204,11 @@ namespace Falcor
         */
         virtual void createResources(RenderContext* pRenderContext = nullptr, bool deleteScratchData = true) = 0;
 
+        /** Finishes the GPU data structures after the work recorded by createResources() has completed on the GPU.
+            Grids that size their data from GPU results read them back here, the caller is expected to have synchronized with the GPU.
+        */
+        virtual void finalizeResources(RenderContext* pRenderContext) {}
+
         /** Returns an AABB buffer that can be used to create an accelerations strucure using this SDF grid.
         */
         virtual const Buffer::SharedPtr& getAABBBuffer() const = 0;
@@ -236,6 +248,11 @@ namespace Falcor
     protected:
         virtual void setValuesInternal(const std::vector<float>& cornerValues) = 0;
 
+        /** Set the values of the SDF grid from sparse brick data. mGridWidth has already been set to the grid width of the brick data.
+            The default implementation decodes the bricks to a dense grid and calls setValuesInternal().
+        */
+        virtual void setBricksInternal(const SDFBrickData& brickData);
+
         void createEvaluatePrimitivesPass(bool writeToTexture3D, bool mergeWithSDField);
 
         void updatePrimitivesBuffer();
@@ -0,0 +1,549 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SDFMeshConverter.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Utils/Logger.h"
+#include "Utils/NumericRange.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <algorithm>
+#include <execution>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kMaxTrianglesPerLeaf = 4;
+        const uint32_t kMaxStackSize = 64;
+
+        // Nodes further away than kWindingNumberBeta times their radius are approximated by a dipole, see Barill et al. 2018, "Fast Winding Numbers for Soups and Clouds".
+        const float kWindingNumberBeta = 2.f;
+
+        const float kInvFourPi = 0.25f / float(M_PI);
+
+        float distanceSq(const AABB& bounds, const float3& p)
+        {
+            float3 d = glm::max(glm::max(bounds.minPoint - p, p - bounds.maxPoint), float3(0.f));
+            return glm::dot(d, d);
+        }
+
+        /** Closest point on a triangle, see Ericson, "Real-Time Collision Detection", 5.1.5.
+            The feature is set to 0 for the face, 1-3 for the vertices a, b, c and 4-6 for the edges ab, bc, ca.
+        */
+        float3 closestPointOnTriangle(const float3& p, const float3& a, const float3& b, const float3& c, uint32_t& feature)
+        {
+            const float3 ab = b - a;
+            const float3 ac = c - a;
+            const float3 ap = p - a;
+            const float d1 = glm::dot(ab, ap);
+            const float d2 = glm::dot(ac, ap);
+            if (d1 <= 0.f && d2 <= 0.f) { feature = 1; return a; }
+
+            const float3 bp = p - b;
+            const float d3 = glm::dot(ab, bp);
+            const float d4 = glm::dot(ac, bp);
+            if (d3 >= 0.f && d4 <= d3) { feature = 2; return b; }
+
+            const float vc = d1 * d4 - d3 * d2;
+            if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f) { feature = 4; return a + ab * (d1 / (d1 - d3)); }
+
+            const float3 cp = p - c;
+            const float d5 = glm::dot(ab, cp);
+            const float d6 = glm::dot(ac, cp);
+            if (d6 >= 0.f && d5 <= d6) { feature = 3; return c; }
+
+            const float vb = d5 * d2 - d1 * d6;
+            if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f) { feature = 6; return a + ac * (d2 / (d2 - d6)); }
+
+            const float va = d3 * d6 - d5 * d4;
+            if (va <= 0.f && d4 - d3 >= 0.f && d5 - d6 >= 0.f) { feature = 5; return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6))); }
+
+            const float denom = 1.f / (va + vb + vc);
+            feature = 0;
+            return a + ab * (vb * denom) + ac * (vc * denom);
+        }
+
+        /** Signed solid angle of a triangle seen from the origin, see Van Oosterom and Strackee 1983.
+        */
+        float computeSolidAngle(const float3& a, const float3& b, const float3& c)
+        {
+            const float la = glm::length(a);
+            const float lb = glm::length(b);
+            const float lc = glm::length(c);
+            const float numerator = glm::dot(a, glm::cross(b, c));
+            const float denominator = la * lb * lc + glm::dot(a, b) * lc + glm::dot(a, c) * lb + glm::dot(b, c) * la;
+            return 2.f * std::atan2(numerator, denominator);
+        }
+
+        float computeAngle(const float3& u, const float3& v)
+        {
+            return std::acos(std::clamp(glm::dot(glm::normalize(u), glm::normalize(v)), -1.f, 1.f));
+        }
+
+        struct BrickRow
+        {
+            std::vector<uint32_t> brickIDs;
+            std::vector<uint8_t> values;
+            std::vector<uint32_t> insideBrickIDs;
+        };
+    }
+
+    SDFMeshConverter::SharedPtr SDFMeshConverter::create(const std::vector<float3>& positions, const std::vector<uint32_t>& indices, bool frontFaceCW)
+    {
+        return SharedPtr(new SDFMeshConverter(positions, indices, frontFaceCW));
+    }
+
+    SDFMeshConverter::SharedPtr SDFMeshConverter::create(const TriangleMesh::SharedPtr& pMesh)
+    {
+        checkArgument(pMesh != nullptr, "'pMesh' must not be null");
+
+        std::vector<float3> positions;
+        positions.reserve(pMesh->getVertices().size());
+        for (const auto& vertex : pMesh->getVertices()) positions.push_back(vertex.position);
+
+        return create(positions, pMesh->getIndices(), pMesh->getFrontFaceCW());
+    }
+
+    SDFMeshConverter::SDFMeshConverter(const std::vector<float3>& positions, const std::vector<uint32_t>& indices, bool frontFaceCW)
+    {
+        checkArgument(indices.size() % 3 == 0, "'indices' size ({}) must be a multiple of 3", indices.size());
+
+        // Weld vertices with identical positions, so that pseudo normals can be computed across triangles.
+        std::vector<uint32_t> sortedVertices(positions.size());
+        std::iota(sortedVertices.begin(), sortedVertices.end(), 0);
+        std::sort(sortedVertices.begin(), sortedVertices.end(), [&](uint32_t l, uint32_t r)
+        {
+            return std::tie(positions[l].x, positions[l].y, positions[l].z) < std::tie(positions[r].x, positions[r].y, positions[r].z);
+        });
+
+        std::vector<uint32_t> vertexRemap(positions.size());
+        for (size_t i = 0; i < sortedVertices.size(); i++)
+        {
+            const float3& position = positions[sortedVertices[i]];
+            if (i == 0 || position != positions[sortedVertices[i - 1]]) mPositions.push_back(position);
+            vertexRemap[sortedVertices[i]] = (uint32_t)mPositions.size() - 1;
+        }
+
+        // Gather the triangles with counter-clockwise winding, degenerate triangles are dropped.
+        uint32_t degenerateCount = 0;
+        mTriangles.reserve(indices.size() / 3);
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            checkArgument(indices[i] < positions.size() && indices[i + 1] < positions.size() && indices[i + 2] < positions.size(), "Triangle {} has an out of range vertex index", i / 3);
+
+            uint3 triangle = uint3(vertexRemap[indices[i]], vertexRemap[indices[i + 1]], vertexRemap[indices[i + 2]]);
+            if (frontFaceCW) std::swap(triangle.y, triangle.z);
+
+            const float3 n = glm::cross(mPositions[triangle.y] - mPositions[triangle.x], mPositions[triangle.z] - mPositions[triangle.x]);
+            if (glm::dot(n, n) <= 0.f)
+            {
+                degenerateCount++;
+                continue;
+            }
+            mTriangles.push_back(triangle);
+        }
+
+        if (mTriangles.empty()) throw RuntimeError("SDFMeshConverter: Mesh has no valid triangles.");
+        if (degenerateCount > 0) logWarning("SDFMeshConverter: Ignoring {} degenerate triangles.", degenerateCount);
+
+        for (const auto& position : mPositions) mBounds.include(position);
+
+        buildBVH();
+        computePseudoNormals();
+    }
+
+    void SDFMeshConverter::buildBVH()
+    {
+        std::vector<float3> centroids(mTriangles.size());
+        std::vector<uint32_t> order(mTriangles.size());
+        for (uint32_t i = 0; i < (uint32_t)mTriangles.size(); i++)
+        {
+            const uint3& triangle = mTriangles[i];
+            centroids[i] = (mPositions[triangle.x] + mPositions[triangle.y] + mPositions[triangle.z]) / 3.f;
+            order[i] = i;
+        }
+
+        mNodes.clear();
+        mNodes.reserve(2 * (mTriangles.size() / kMaxTrianglesPerLeaf + 1));
+        buildNode(0, (uint32_t)mTriangles.size(), order, centroids);
+
+        // Store the triangles in the order referenced by the leaves.
+        std::vector<uint3> triangles(mTriangles.size());
+        for (size_t i = 0; i < order.size(); i++) triangles[i] = mTriangles[order[i]];
+        mTriangles = std::move(triangles);
+    }
+
+    uint32_t SDFMeshConverter::buildNode(uint32_t begin, uint32_t end, std::vector<uint32_t>& order, const std::vector<float3>& centroids)
+    {
+        const uint32_t nodeIndex = (uint32_t)mNodes.size();
+        mNodes.emplace_back();
+
+        AABB bounds;
+        AABB centroidBounds;
+        for (uint32_t i = begin; i < end; i++)
+        {
+            const uint3& triangle = mTriangles[order[i]];
+            bounds.include(mPositions[triangle.x]).include(mPositions[triangle.y]).include(mPositions[triangle.z]);
+            centroidBounds.include(centroids[order[i]]);
+        }
+
+        if (end - begin <= kMaxTrianglesPerLeaf)
+        {
+            BVHNode& node = mNodes[nodeIndex];
+            node.first = begin;
+            node.count = end - begin;
+
+            float3 weightedCenter = float3(0.f);
+            for (uint32_t i = begin; i < end; i++)
+            {
+                const uint3& triangle = mTriangles[order[i]];
+                const float3 areaNormal = 0.5f * glm::cross(mPositions[triangle.y] - mPositions[triangle.x], mPositions[triangle.z] - mPositions[triangle.x]);
+                const float area = glm::length(areaNormal);
+                node.areaNormal += areaNormal;
+                node.area += area;
+                weightedCenter += area * centroids[order[i]];
+            }
+            node.center = node.area > 0.f ? weightedCenter / node.area : bounds.center();
+        }
+        else
+        {
+            // Split at the median centroid along the longest axis.
+            const float3 extent = centroidBounds.extent();
+            const uint32_t axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+            const uint32_t mid = begin + (end - begin) / 2;
+            std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end, [&](uint32_t l, uint32_t r) { return centroids[l][axis] < centroids[r][axis]; });
+
+            const uint32_t leftIndex = buildNode(begin, mid, order, centroids);
+            const uint32_t rightIndex = buildNode(mid, end, order, centroids);
+            FALCOR_ASSERT(leftIndex == nodeIndex + 1);
+
+            const BVHNode& left = mNodes[leftIndex];
+            const BVHNode& right = mNodes[rightIndex];
+            BVHNode& node = mNodes[nodeIndex];
+            node.first = rightIndex;
+            node.count = 0;
+            node.areaNormal = left.areaNormal + right.areaNormal;
+            node.area = left.area + right.area;
+            node.center = node.area > 0.f ? (left.area * left.center + right.area * right.center) / node.area : bounds.center();
+        }
+
+        BVHNode& node = mNodes[nodeIndex];
+        node.bounds = bounds;
+        node.radius = glm::length(glm::max(glm::abs(bounds.minPoint - node.center), glm::abs(bounds.maxPoint - node.center)));
+        return nodeIndex;
+    }
+
+    void SDFMeshConverter::computePseudoNormals()
+    {
+        // Pseudo normals, see Baerentzen and Aanaes 2005, "Signed Distance Computation Using the Angle Weighted Pseudonormal".
+        mFaceNormals.resize(mTriangles.size());
+        mVertexNormals.assign(mPositions.size(), float3(0.f));
+        mEdgeNormals.resize(3 * mTriangles.size());
+
+        std::unordered_map<uint64_t, float3> edgeNormals;
+        edgeNormals.reserve(3 * mTriangles.size() / 2);
+        auto getEdgeKey = [](uint32_t v0, uint32_t v1) { return (uint64_t(std::min(v0, v1)) << 32) | std::max(v0, v1); };
+
+        for (size_t i = 0; i < mTriangles.size(); i++)
+        {
+            const uint3& triangle = mTriangles[i];
+            const float3 a = mPositions[triangle.x];
+            const float3 b = mPositions[triangle.y];
+            const float3 c = mPositions[triangle.z];
+            const float3 n = glm::normalize(glm::cross(b - a, c - a));
+            mFaceNormals[i] = n;
+
+            mVertexNormals[triangle.x] += computeAngle(b - a, c - a) * n;
+            mVertexNormals[triangle.y] += computeAngle(c - b, a - b) * n;
+            mVertexNormals[triangle.z] += computeAngle(a - c, b - c) * n;
+
+            for (uint32_t e = 0; e < 3; e++) edgeNormals[getEdgeKey(triangle[e], triangle[(e + 1) % 3])] += n;
+        }
+
+        for (size_t i = 0; i < mTriangles.size(); i++)
+        {
+            const uint3& triangle = mTriangles[i];
+            for (uint32_t e = 0; e < 3; e++) mEdgeNormals[3 * i + e] = edgeNormals[getEdgeKey(triangle[e], triangle[(e + 1) % 3])];
+        }
+    }
+
+    bool SDFMeshConverter::findClosest(const float3& p, float maxDistSq, ClosestHit& hit) const
+    {
+        hit.distSq = maxDistSq;
+        bool found = false;
+
+        uint32_t stack[kMaxStackSize];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0)
+        {
+            const uint32_t nodeIndex = stack[--stackSize];
+            const BVHNode& node = mNodes[nodeIndex];
+            if (distanceSq(node.bounds, p) >= hit.distSq) continue;
+
+            if (node.count > 0)
+            {
+                for (uint32_t i = node.first; i < node.first + node.count; i++)
+                {
+                    const uint3& triangle = mTriangles[i];
+                    uint32_t feature;
+                    const float3 q = closestPointOnTriangle(p, mPositions[triangle.x], mPositions[triangle.y], mPositions[triangle.z], feature);
+                    const float distSq = glm::dot(q - p, q - p);
+                    if (distSq < hit.distSq)
+                    {
+                        hit.distSq = distSq;
+                        hit.point = q;
+                        hit.triangle = i;
+                        hit.feature = feature;
+                        found = true;
+                    }
+                }
+            }
+            else
+            {
+                // Visit the closer child first.
+                uint32_t nearIndex = nodeIndex + 1;
+                uint32_t farIndex = node.first;
+                float nearDistSq = distanceSq(mNodes[nearIndex].bounds, p);
+                float farDistSq = distanceSq(mNodes[farIndex].bounds, p);
+                if (farDistSq < nearDistSq)
+                {
+                    std::swap(nearIndex, farIndex);
+                    std::swap(nearDistSq, farDistSq);
+                }
+
+                FALCOR_ASSERT(stackSize + 2 <= kMaxStackSize);
+                if (farDistSq < hit.distSq) stack[stackSize++] = farIndex;
+                if (nearDistSq < hit.distSq) stack[stackSize++] = nearIndex;
+            }
+        }
+
+        return found;
+    }
+
+    float3 SDFMeshConverter::getPseudoNormal(const ClosestHit& hit) const
+    {
+        if (hit.feature == 0) return mFaceNormals[hit.triangle];
+        if (hit.feature <= 3) return mVertexNormals[mTriangles[hit.triangle][hit.feature - 1]];
+        return mEdgeNormals[3 * hit.triangle + hit.feature - 4];
+    }
+
+    float SDFMeshConverter::evalDistance(const float3& p) const
+    {
+        ClosestHit hit;
+        findClosest(p, std::numeric_limits<float>::infinity(), hit);
+        return std::sqrt(hit.distSq);
+    }
+
+    float SDFMeshConverter::evalSignedDistance(const float3& p, SignMethod signMethod) const
+    {
+        ClosestHit hit;
+        findClosest(p, std::numeric_limits<float>::infinity(), hit);
+
+        bool inside = signMethod == SignMethod::WindingNumber ? evalWindingNumber(p) > 0.5f : glm::dot(p - hit.point, getPseudoNormal(hit)) < 0.f;
+        float distance = std::sqrt(hit.distSq);
+        return inside ? -distance : distance;
+    }
+
+    bool SDFMeshConverter::isInside(const float3& p, SignMethod signMethod) const
+    {
+        return evalSignedDistance(p, signMethod) < 0.f;
+    }
+
+    float SDFMeshConverter::evalWindingNumber(const float3& p) const
+    {
+        float solidAngle = 0.f;
+
+        uint32_t stack[kMaxStackSize];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0)
+        {
+            const uint32_t nodeIndex = stack[--stackSize];
+            const BVHNode& node = mNodes[nodeIndex];
+
+            // Far away nodes are approximated by a dipole at their center.
+            const float3 d = node.center - p;
+            const float distSq = glm::dot(d, d);
+            if (distSq > kWindingNumberBeta * kWindingNumberBeta * node.radius * node.radius)
+            {
+                solidAngle += glm::dot(d, node.areaNormal) / (distSq * std::sqrt(distSq));
+                continue;
+            }
+
+            if (node.count > 0)
+            {
+                for (uint32_t i = node.first; i < node.first + node.count; i++)
+                {
+                    const uint3& triangle = mTriangles[i];
+                    solidAngle += computeSolidAngle(mPositions[triangle.x] - p, mPositions[triangle.y] - p, mPositions[triangle.z] - p);
+                }
+            }
+            else
+            {
+                FALCOR_ASSERT(stackSize + 2 <= kMaxStackSize);
+                stack[stackSize++] = node.first;
+                stack[stackSize++] = nodeIndex + 1;
+            }
+        }
+
+        return solidAngle * kInvFourPi;
+    }
+
+    float SDFMeshConverter::computeGridScale(const Options& options) const
+    {
+        // The mesh is fitted to the grid with a margin of the narrow band and one voxel on each side.
+        const float narrowBandWidth = options.narrowBandWidth > 0.f ? options.narrowBandWidth : std::sqrt(3.f) / options.gridWidth;
+        const float fittedWidth = 1.f - 2.f * (narrowBandWidth + 1.f / options.gridWidth);
+        checkArgument(fittedWidth > 0.f, "'narrowBandWidth' ({}) is too large for a grid width of {}", narrowBandWidth, options.gridWidth);
+
+        const float3 extent = mBounds.extent();
+        const float maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+        return fittedWidth / maxExtent;
+    }
+
+    Transform SDFMeshConverter::getGridTransform(const Options& options) const
+    {
+        Transform transform;
+        transform.setTranslation(mBounds.center());
+        transform.setScaling(float3(1.f / computeGridScale(options)));
+        return transform;
+    }
+
+    SDFBrickData SDFMeshConverter::convert(const Options& options) const
+    {
+        checkArgument(options.gridWidth > 0, "'gridWidth' must be larger than zero");
+        checkArgument(options.brickWidth > 0, "'brickWidth' must be larger than zero");
+
+        auto startTime = CpuTimer::getCurrentTimePoint();
+
+        SDFBrickData data;
+        data.init(options.gridWidth, options.brickWidth, options.valueFormat, options.narrowBandWidth);
+
+        const uint32_t gridWidth = options.gridWidth;
+        const uint32_t brickWidth = options.brickWidth;
+        const uint32_t brickWidthInValues = brickWidth + 1;
+        const uint32_t bricksPerAxis = data.getBricksPerAxis();
+        const float narrowBandWidth = data.narrowBandWidth;
+
+        // Grid space positions are mapped to mesh space with gridToMeshScale, mesh space distances back with scale.
+        const float scale = computeGridScale(options);
+        const float gridToMeshScale = 1.f / scale;
+        const float3 meshCenter = mBounds.center();
+        auto getMeshPosition = [&](const float3& corner) { return meshCenter + (corner / float(gridWidth) - 0.5f) * gridToMeshScale; };
+
+        // A brick can only contain the surface if the surface is closer to its center than half of its diagonal. One voxel is added as a safety margin.
+        const float candidateDistance = (0.5f * std::sqrt(3.f) * brickWidth + 1.f) / gridWidth * gridToMeshScale;
+        const float candidateDistSq = candidateDistance * candidateDistance;
+
+        std::vector<BrickRow> rows(size_t(bricksPerAxis) * bricksPerAxis);
+        auto range = NumericRange<uint32_t>(0, bricksPerAxis * bricksPerAxis);
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t rowIndex)
+        {
+            BrickRow& row = rows[rowIndex];
+            const uint32_t brickY = rowIndex % bricksPerAxis;
+            const uint32_t brickZ = rowIndex / bricksPerAxis;
+
+            std::vector<float> brickValues(data.getBrickValueCount());
+            std::vector<uint8_t> quantizedValues(data.getBrickByteSize());
+
+            // Consecutive bricks far away from the surface share the same sign, so it is only computed for the first one.
+            bool hasEmptySign = false;
+            bool emptyInside = false;
+
+            for (uint32_t brickX = 0; brickX < bricksPerAxis; brickX++)
+            {
+                const uint3 brickOrigin = uint3(brickX, brickY, brickZ) * brickWidth;
+                const uint32_t virtualBrickID = brickX + bricksPerAxis * rowIndex;
+                const float3 brickCenter = getMeshPosition(float3(brickOrigin) + 0.5f * float(brickWidth));
+
+                ClosestHit hit;
+                if (!findClosest(brickCenter, candidateDistSq, hit))
+                {
+                    if (!hasEmptySign)
+                    {
+                        emptyInside = isInside(brickCenter, options.signMethod);
+                        hasEmptySign = true;
+                    }
+                    if (emptyInside) row.insideBrickIDs.push_back(virtualBrickID);
+                    continue;
+                }
+                hasEmptySign = false;
+
+                // Evaluate the corner values of the brick, corners outside of the grid are set to the maximum distance.
+                for (uint32_t z = 0; z < brickWidthInValues; z++)
+                {
+                    for (uint32_t y = 0; y < brickWidthInValues; y++)
+                    {
+                        for (uint32_t x = 0; x < brickWidthInValues; x++)
+                        {
+                            uint3 c = brickOrigin + uint3(x, y, z);
+                            float& value = brickValues[x + brickWidthInValues * (y + brickWidthInValues * z)];
+                            if (c.x > gridWidth || c.y > gridWidth || c.z > gridWidth)
+                            {
+                                value = narrowBandWidth;
+                                continue;
+                            }
+                            value = std::clamp(evalSignedDistance(getMeshPosition(float3(c)), options.signMethod) * scale, -narrowBandWidth, narrowBandWidth);
+                        }
+                    }
+                }
+
+                bool hasSurface = SDFBrickData::brickContainsSurface(brickValues.data(), brickWidth, glm::min(uint3(brickWidth), uint3(gridWidth) - brickOrigin));
+                if (!hasSurface)
+                {
+                    if (brickValues[0] < 0.f) row.insideBrickIDs.push_back(virtualBrickID);
+                    continue;
+                }
+
+                data.quantizeBrick(brickValues.data(), quantizedValues.data());
+                row.brickIDs.push_back(virtualBrickID);
+                row.values.insert(row.values.end(), quantizedValues.begin(), quantizedValues.end());
+            }
+        });
+
+        // Rows are ordered by their virtual brick IDs, so the bricks can be appended in order.
+        const size_t brickByteSize = data.getBrickByteSize();
+        for (const auto& row : rows)
+        {
+            for (size_t i = 0; i < row.brickIDs.size(); i++) data.appendBrick(row.brickIDs[i], row.values.data() + i * brickByteSize);
+            for (uint32_t virtualBrickID : row.insideBrickIDs) data.setBrickInside(virtualBrickID);
+        }
+
+        double duration = CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint());
+        logInfo("Converted mesh with {} triangles to a {}^3 SDF grid with {} of {} bricks in {:.1f} ms.", mTriangles.size(), gridWidth, data.getBrickCount(), uint64_t(bricksPerAxis) * bricksPerAxis * bricksPerAxis, duration);
+
+        return data;
+    }
+}
@@ -0,0 +1,154 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SDFBrickData.h"
+#include "Core/Macros.h"
+#include "Scene/Transform.h"
+#include "Scene/TriangleMesh.h"
+#include "Utils/Math/AABB.h"
+#include "Utils/Math/Vector.h"
+#include <memory>
+#include <vector>
+
+namespace Falcor
+{
+    /** CPU converter from triangle meshes to sparse, narrow-band SDF bricks.
+
+        A BVH is built over the mesh triangles and used for closest point queries. The sign of the distance is either computed from the
+        generalized winding number, which is robust to holes and self intersections, or from angle weighted pseudo normals, which is cheaper
+        but requires a closed, manifold mesh. The mesh is uniformly scaled to fit the [-0.5, 0.5]^3 grid space with a margin of the narrow band width.
+
+        Only bricks close to the surface evaluate their corner values, the conversion runs in parallel over rows of bricks and
+        produces an SDFBrickData object directly, without creating the dense grid of corner values.
+    */
+    class FALCOR_API SDFMeshConverter
+    {
+    public:
+        using SharedPtr = std::shared_ptr<SDFMeshConverter>;
+
+        enum class SignMethod : uint32_t
+        {
+            WindingNumber,  ///< Inside if the generalized winding number is larger than 0.5.
+            PseudoNormal,   ///< Sign of the distance along the angle weighted pseudo normal of the closest feature.
+        };
+
+        struct Options
+        {
+            uint32_t gridWidth = 256;                                           ///< Width of the grid in voxels.
+            uint32_t brickWidth = SDFBrickData::kDefaultBrickWidth;             ///< Width of a brick in voxels.
+            SDFBrickData::ValueFormat valueFormat = SDFBrickData::ValueFormat::Int8;
+            float narrowBandWidth = 0.f;                                        ///< Narrow band width in grid space, if zero, the length of one voxel diagonal is used.
+            SignMethod signMethod = SignMethod::WindingNumber;
+        };
+
+        /** Create a converter for an indexed triangle mesh.
+            \param[in] positions Vertex positions.
+            \param[in] indices Triangle indices, three per triangle.
+            \param[in] frontFaceCW True if front facing triangles are wound clockwise.
+            \return A new object, or throws an exception if the mesh has no valid triangles.
+        */
+        static SharedPtr create(const std::vector<float3>& positions, const std::vector<uint32_t>& indices, bool frontFaceCW = false);
+
+        /** Create a converter for a triangle mesh.
+            \param[in] pMesh The triangle mesh.
+            \return A new object, or throws an exception if the mesh has no valid triangles.
+        */
+        static SharedPtr create(const TriangleMesh::SharedPtr& pMesh);
+
+        /** Convert the mesh to sparse SDF bricks.
+            \param[in] options The conversion options.
+            \return The brick data.
+        */
+        SDFBrickData convert(const Options& options) const;
+
+        /** Get the transform that places a grid created with the given options on top of the mesh.
+        */
+        Transform getGridTransform(const Options& options) const;
+
+        /** Compute the unsigned distance from a point to the mesh.
+            \param[in] p Point in mesh space.
+            \return Distance in mesh space.
+        */
+        float evalDistance(const float3& p) const;
+
+        /** Compute the signed distance from a point to the mesh, negative inside.
+            \param[in] p Point in mesh space.
+            \param[in] signMethod The method used to compute the sign.
+            \return Signed distance in mesh space.
+        */
+        float evalSignedDistance(const float3& p, SignMethod signMethod) const;
+
+        /** Compute the generalized winding number of the mesh at a point.
+            \param[in] p Point in mesh space.
+            \return Winding number, approximately 1 inside and 0 outside of closed meshes.
+        */
+        float evalWindingNumber(const float3& p) const;
+
+        const AABB& getBounds() const { return mBounds; }
+        uint32_t getTriangleCount() const { return (uint32_t)mTriangles.size(); }
+        uint32_t getBVHNodeCount() const { return (uint32_t)mNodes.size(); }
+
+    private:
+        SDFMeshConverter(const std::vector<float3>& positions, const std::vector<uint32_t>& indices, bool frontFaceCW);
+
+        struct BVHNode
+        {
+            AABB bounds;
+            uint32_t first = 0;         ///< First triangle for leaves, index of the right child for interior nodes (the left child follows the node).
+            uint32_t count = 0;         ///< Triangle count for leaves, zero for interior nodes.
+            float3 center;              ///< Area weighted center of the triangles, used by the winding number approximation.
+            float3 areaNormal;          ///< Sum of the area weighted triangle normals.
+            float area = 0.f;           ///< Total area of the triangles.
+            float radius = 0.f;         ///< Radius around the center that bounds the node.
+        };
+
+        struct ClosestHit
+        {
+            float distSq;               ///< Squared distance to the closest point.
+            float3 point;               ///< The closest point.
+            uint32_t triangle;          ///< Index of the closest triangle.
+            uint32_t feature;           ///< Closest feature of the triangle, 0 for the face, 1-3 for vertices and 4-6 for edges.
+        };
+
+        void buildBVH();
+        uint32_t buildNode(uint32_t begin, uint32_t end, std::vector<uint32_t>& order, const std::vector<float3>& centroids);
+        void computePseudoNormals();
+        bool findClosest(const float3& p, float maxDistSq, ClosestHit& hit) const;
+        float3 getPseudoNormal(const ClosestHit& hit) const;
+        bool isInside(const float3& p, SignMethod signMethod) const;
+        float computeGridScale(const Options& options) const;
+
+        std::vector<float3> mPositions;
+        std::vector<uint3> mTriangles;
+        std::vector<float3> mFaceNormals;       ///< Unit normals per triangle.
+        std::vector<float3> mVertexNormals;     ///< Angle weighted pseudo normals per vertex.
+        std::vector<float3> mEdgeNormals;       ///< Pseudo normals per triangle edge (ab, bc, ca).
+        std::vector<BVHNode> mNodes;
+        AABB mBounds;
+    };
+}
@@ -29,8 +29,12 @@
 #include "Core/API/Device.h"
 #include "Core/API/RenderContext.h"
 #include "Core/API/IndirectCommands.h"
+#include "Utils/Logger.h"
+#include "Utils/Math/Common.h"
 #include "Utils/Math/MathHelpers.h"
 #include "Scene/SDFs/SDFVoxelTypes.slang"
+#include <algorithm>
+#include <cstring>
 
 namespace Falcor
 {
@@ -51,6 +55,8 @@ namespace Falcor
         const std::string kComputeIntervalSDFieldFromGridShaderName = "Scene/SDFs/SparseBrickSet/SDFSBSComputeIntervalSDFieldFromGrid.cs.slang";
         const std::string kExpandSDFieldShaderName = "Scene/SDFs/SparseBrickSet/SDFSBSExpandSDFieldData.cs.slang";
 
+        const std::string kCompressBricksShaderName = "Scene/SDFs/SparseBrickSet/SDFSBSCompressBricks.cs.slang";
+
         const bool kEnableCoarseBrickPruning = true;
         const bool kEnableFineBrickPruning = true;
 
@@ -88,6 +94,17 @@ namespace Falcor
 
     SDFGrid::UpdateFlags SDFSBS::update(RenderContext* pRenderContext)
     {
+        // Grids loaded from sparse brick data have no value texture that primitives can be merged with.
+        if (mLoadedFromBricks)
+        {
+            if (mPrimitivesDirty)
+            {
+                logWarning("SDFSBS::update() primitives are ignored for grids loaded from sparse brick data.");
+                mPrimitivesDirty = false;
+            }
+            return UpdateFlags::None;
+        }
+
         // No update is performed if the SDF grid isn't dirty or isn't constructed from primitives and should not be created as an empty grid.
         bool isEmpty = mPrimitives.empty() && !mpSDFGridTexture && !mWasEmpty;
         if ((!mPrimitivesDirty || (mPrimitives.empty() && !mHasGridRepresentation)) && !isEmpty) return UpdateFlags::None;
@@ -112,7 +129,12 @@ namespace Falcor
             mSDField.clear();
         }
 
-        if (!mPrimitives.empty())
+        if (mLoadedFromBricks)
+        {
+            if (!mPrimitives.empty()) logWarning("SDFSBS::createResources() primitives are ignored for grids loaded from sparse brick data.");
+            createResourcesFromBricks(pRenderContext, deleteScratchData);
+        }
+        else if (!mPrimitives.empty())
         {
             createResourcesFromPrimitivesAndSDField(pRenderContext, deleteScratchData);
         }
@@ -343,6 +365,68 @@ namespace Falcor
         mWasEmpty = false;
     }
 
+    void SDFSBS::createResourcesFromBricks(RenderContext* pRenderContext, bool deleteScratchData)
+    {
+        // The CPU data is released after the resources have been created if scratch data is deleted.
+        if (mBrickTexels.empty())
+        {
+            FALCOR_ASSERT(mpBrickTexture && mpIndirectionTexture && mpBrickAABBsBuffer);
+            return;
+        }
+
+        mVirtualBricksPerAxis = div_round_up(mGridWidth, mBrickWidth);
+
+        mpIndirectionTexture = Texture::create3D(mVirtualBricksPerAxis, mVirtualBricksPerAxis, mVirtualBricksPerAxis, ResourceFormat::R32Uint, 1, mBrickIndirection.data(), ResourceBindFlags::ShaderResource);
+        mpIndirectionTexture->setName("SDFSBS::IndirectionTextureValues");
+
+        mpBrickAABBsBuffer = Buffer::createStructured(sizeof(AABB), mBrickCount, ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, mBrickAABBs.data(), false);
+
+        const uint32_t textureWidth = mBrickTextureDimensions.x;
+        const uint32_t textureHeight = mBrickTextureDimensions.y;
+
+        if (mCompressed)
+        {
+            // Compress the bricks on the GPU, using the same encoder as the other build paths.
+            if (!mpCompressBricksPass)
+            {
+                Program::Desc desc;
+                desc.addShaderLibrary(kCompressBricksShaderName).csEntry("main");
+                mpCompressBricksPass = ComputePass::create(desc);
+            }
+
+            Texture::SharedPtr pUncompressedBrickTexture = Texture::create2D(textureWidth, textureHeight, ResourceFormat::R8Snorm, 1, 1, mBrickTexels.data(), ResourceBindFlags::ShaderResource);
+            mpBrickTexture = Texture::create2D(textureWidth, textureHeight, ResourceFormat::BC4Snorm, 1, 1);
+            mpBrickScratchTexture = Texture::create2D(textureWidth / 4, textureHeight / 4, ResourceFormat::RG32Int, 1, 1, nullptr, Resource::BindFlags::UnorderedAccess);
+
+            auto paramBlock = mpCompressBricksPass["gParamBlock"];
+            paramBlock["blockCount"] = uint2(textureWidth / 4, textureHeight / 4);
+            paramBlock["uncompressedBricks"] = pUncompressedBrickTexture;
+            paramBlock["compressedBricks"] = mpBrickScratchTexture;
+            mpCompressBricksPass->execute(pRenderContext, textureWidth / 4, textureHeight / 4);
+
+            pRenderContext->copyResource(mpBrickTexture.get(), mpBrickScratchTexture.get());
+        }
+        else
+        {
+            mpBrickTexture = Texture::create2D(textureWidth, textureHeight, ResourceFormat::R8Snorm, 1, 1, mBrickTexels.data(), ResourceBindFlags::ShaderResource);
+        }
+
+        if (deleteScratchData)
+        {
+            mpCompressBricksPass.reset();
+            mpBrickScratchTexture.reset();
+
+            mBrickTexels.clear();
+            mBrickTexels.shrink_to_fit();
+            mBrickAABBs.clear();
+            mBrickAABBs.shrink_to_fit();
+            mBrickIndirection.clear();
+            mBrickIndirection.shrink_to_fit();
+        }
+
+        mWasEmpty = false;
+    }
+
     SDFGrid::UpdateFlags SDFSBS::createResourcesFromPrimitivesAndSDField(RenderContext* pRenderContext, bool deleteScratchData)
     {
         // Assume AABBs will change.
@@ -966,6 +1050,11 @@ namespace Falcor
 
     void SDFSBS::setValuesInternal(const std::vector<float>& cornerValues)
     {
+        mLoadedFromBricks = false;
+        mBrickTexels.clear();
+        mBrickAABBs.clear();
+        mBrickIndirection.clear();
+
         uint32_t gridWidthInValues = mGridWidth + 1;
         uint32_t valueCount = gridWidthInValues * gridWidthInValues * gridWidthInValues;
         mSDField.resize(valueCount);
@@ -980,6 +1069,134 @@ namespace Falcor
         }
     }
 
+    void SDFSBS::setBricksInternal(const SDFBrickData& brickData)
+    {
+        const uint32_t virtualBricksPerAxis = div_round_up(mGridWidth, mBrickWidth);
+        const uint32_t brickWidthInValues = mBrickWidth + 1;
+        const uint32_t brickValueCount = brickWidthInValues * brickWidthInValues * brickWidthInValues;
+        const float normalizationMultipler = 2.0f * mGridWidth / glm::root_three<float>();
+
+        // If the brick widths match, the stored bricks map directly to bricks of the SBS. Otherwise, the values are resampled into
+        // the bricks of the SBS that overlap the stored bricks, as these are the only ones that can contain the surface.
+        const bool sameBrickWidth = brickData.brickWidth == mBrickWidth;
+        std::vector<uint32_t> candidateIDs;
+        if (sameBrickWidth)
+        {
+            candidateIDs = brickData.brickIDs;
+        }
+        else
+        {
+            const uint32_t srcBricksPerAxis = brickData.getBricksPerAxis();
+            for (uint32_t srcID : brickData.brickIDs)
+            {
+                const uint3 srcCoords = uint3(srcID % srcBricksPerAxis, (srcID / srcBricksPerAxis) % srcBricksPerAxis, srcID / (srcBricksPerAxis * srcBricksPerAxis));
+                const uint3 voxelMin = srcCoords * brickData.brickWidth;
+                const uint3 voxelMax = glm::min(voxelMin + brickData.brickWidth, uint3(mGridWidth)) - 1u;
+                const uint3 minCoords = voxelMin / mBrickWidth;
+                const uint3 maxCoords = voxelMax / mBrickWidth;
+
+                for (uint32_t z = minCoords.z; z <= maxCoords.z; z++)
+                {
+                    for (uint32_t y = minCoords.y; y <= maxCoords.y; y++)
+                    {
+                        for (uint32_t x = minCoords.x; x <= maxCoords.x; x++)
+                        {
+                            candidateIDs.push_back(x + virtualBricksPerAxis * (y + virtualBricksPerAxis * z));
+                        }
+                    }
+                }
+            }
+
+            std::sort(candidateIDs.begin(), candidateIDs.end());
+            candidateIDs.erase(std::unique(candidateIDs.begin(), candidateIDs.end()), candidateIDs.end());
+        }
+
+        mBrickIndirection.assign(size_t(virtualBricksPerAxis) * virtualBricksPerAxis * virtualBricksPerAxis, UINT32_MAX);
+        mBrickAABBs.clear();
+
+        std::vector<int8_t> brickValues;
+        brickValues.reserve(candidateIDs.size() * brickValueCount);
+        std::vector<float> values(brickValueCount);
+
+        for (size_t i = 0; i < candidateIDs.size(); i++)
+        {
+            const uint32_t virtualBrickID = candidateIDs[i];
+            const uint3 brickCoords = uint3(virtualBrickID % virtualBricksPerAxis, (virtualBrickID / virtualBricksPerAxis) % virtualBricksPerAxis, virtualBrickID / (virtualBricksPerAxis * virtualBricksPerAxis));
+            const uint3 brickOrigin = brickCoords * mBrickWidth;
+
+            for (uint32_t z = 0; z < brickWidthInValues; z++)
+            {
+                for (uint32_t y = 0; y < brickWidthInValues; y++)
+                {
+                    for (uint32_t x = 0; x < brickWidthInValues; x++)
+                    {
+                        const uint3 c = brickOrigin + uint3(x, y, z);
+                        float normalizedValue = 1.0f;
+                        if (c.x <= mGridWidth && c.y <= mGridWidth && c.z <= mGridWidth)
+                        {
+                            float distance = sameBrickWidth ? brickData.getBrickValue((uint32_t)i, uint3(x, y, z)) : brickData.getCornerValue(c);
+                            normalizedValue = glm::clamp(distance * normalizationMultipler, -1.0f, 1.0f);
+                        }
+                        values[x + brickWidthInValues * (y + brickWidthInValues * z)] = normalizedValue;
+                    }
+                }
+            }
+
+            if (!sameBrickWidth && !SDFBrickData::brickContainsSurface(values.data(), mBrickWidth, glm::min(uint3(mBrickWidth), uint3(mGridWidth) - brickOrigin))) continue;
+
+            mBrickIndirection[virtualBrickID] = (uint32_t)mBrickAABBs.size();
+
+            float3 brickAABBMin = -0.5f + float3(brickOrigin) / float(mGridWidth);
+            float3 brickAABBMax = glm::min(brickAABBMin + float(mBrickWidth) / float(mGridWidth), float3(0.5f));
+            mBrickAABBs.push_back(AABB(brickAABBMin, brickAABBMax));
+
+            for (float normalizedValue : values)
+            {
+                float integerScale = normalizedValue * float(INT8_MAX);
+                brickValues.push_back(integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f));
+            }
+        }
+
+        // If the grid has no surface, create one brick with no surface to make the renderer happy.
+        if (mBrickAABBs.empty())
+        {
+            mBrickIndirection[0] = 0;
+            mBrickAABBs.push_back(AABB(float3(-0.5f), glm::min(float3(-0.5f + float(mBrickWidth) / float(mGridWidth)), float3(0.5f))));
+            brickValues.assign(brickValueCount, INT8_MAX);
+        }
+
+        mBrickCount = (uint32_t)mBrickAABBs.size();
+
+        // Lay out the bricks in the brick texture in the same way as createResourcesFromSDField().
+        uint32_t bricksAlongX = (uint32_t)std::ceil(std::sqrt((float)mBrickCount / brickWidthInValues));
+        uint32_t bricksAlongY = (uint32_t)std::ceil((float)mBrickCount / bricksAlongX);
+        mBricksPerAxis = uint2(bricksAlongX, bricksAlongY);
+        mBrickTextureDimensions = uint2(brickWidthInValues * brickWidthInValues * bricksAlongX, brickWidthInValues * bricksAlongY);
+
+        mBrickTexels.assign(size_t(mBrickTextureDimensions.x) * mBrickTextureDimensions.y, 0);
+        for (uint32_t brickID = 0; brickID < mBrickCount; brickID++)
+        {
+            const uint2 brickTextureCoords = uint2(brickID % bricksAlongX, brickID / bricksAlongX) * uint2(brickWidthInValues * brickWidthInValues, brickWidthInValues);
+            const int8_t* pSrc = brickValues.data() + size_t(brickID) * brickValueCount;
+
+            for (uint32_t z = 0; z < brickWidthInValues; z++)
+            {
+                for (uint32_t y = 0; y < brickWidthInValues; y++)
+                {
+                    int8_t* pDst = mBrickTexels.data() + size_t(brickTextureCoords.y + y) * mBrickTextureDimensions.x + brickTextureCoords.x + z * brickWidthInValues;
+                    std::memcpy(pDst, pSrc + brickWidthInValues * (y + brickWidthInValues * z), brickWidthInValues);
+                }
+            }
+        }
+
+        logInfo("Loaded {} SDF bricks ({} stored in file) for a grid of width {}.", mBrickCount, brickData.getBrickCount(), mGridWidth);
+
+        mSDField.clear();
+        mpSDFGridTexture.reset();
+        mHasGridRepresentation = false;
+        mLoadedFromBricks = true;
+    }
+
     void SDFSBS::createSDFGridTexture(RenderContext* pRenderContext, const std::vector<int16_t>& sdField)
     {
         checkArgument(!sdField.empty(), "Cannot create SDF grid texture from empty values vector");
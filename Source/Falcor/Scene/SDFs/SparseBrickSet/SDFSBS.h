@@ -30,6 +30,7 @@
 #include "Scene/SDFs/SDFGrid.h"
 #include "RenderGraph/BasePasses/ComputePass.h"
 #include "Utils/Algorithm/PrefixSum.h"
+#include "Utils/Math/AABB.h"
 
 namespace Falcor
 {
@@ -70,6 +71,7 @@ namespace Falcor
 
     protected:
         void createResourcesFromSDField(RenderContext* pRenderContext, bool deleteScratchData);
+        void createResourcesFromBricks(RenderContext* pRenderContext, bool deleteScratchData);
         SDFGrid::UpdateFlags createResourcesFromPrimitivesAndSDField(RenderContext* pRenderContext, bool deleteScratchData);
 
         void expandSDFGridTexture(RenderContext* pRenderContext, bool deleteScratchData, uint32_t oldGridWidthInSDField, uint32_t gridWidthInSDField);
@@ -78,6 +80,7 @@ namespace Falcor
         void allocatePrimitiveBits();
 
         virtual void setValuesInternal(const std::vector<float>& cornerValues) override;
+        virtual void setBricksInternal(const SDFBrickData& brickData) override;
 
         void createSDFGridTexture(RenderContext* pRenderContext, const std::vector<int16_t>& sdField);
 
@@ -91,6 +94,9 @@ namespace Falcor
 
         // CPU data.
         std::vector<int16_t> mSDField;
+        std::vector<int8_t> mBrickTexels;               ///< Brick texture texels, set if the grid was loaded from sparse brick data.
+        std::vector<AABB> mBrickAABBs;                  ///< Brick AABBs, set if the grid was loaded from sparse brick data.
+        std::vector<uint32_t> mBrickIndirection;        ///< Indirection texture values, set if the grid was loaded from sparse brick data.
 
         // Specs.
         uint32_t mDefaultGridWidth = 0;                 ///< The grid width used if the grid was not loaded from a file (it is empty).
@@ -108,6 +114,7 @@ namespace Falcor
         uint32_t mCurrentBakedPrimitiveCount = 0;
         bool mWasEmpty = false;
         bool mBuildEmptyGrid = false;
+        bool mLoadedFromBricks = false;                 ///< True if the grid was loaded from sparse brick data, it is then built without a value texture and cannot be edited.
 
         // GPU data.
         Buffer::SharedPtr mpBrickAABBsBuffer;           ///< A compact buffer containing AABBs for each brick.
@@ -122,6 +129,7 @@ namespace Falcor
         ComputePass::SharedPtr mpResetBrickValidityPass;
         ComputePass::SharedPtr mpCopyIndirectionBufferPass;
         ComputePass::SharedPtr mpCreateBricksFromSDFieldPass;
+        ComputePass::SharedPtr mpCompressBricksPass;
 
         // Compute passes used to build the SBS from primitives.
         ComputePass::SharedPtr mpCreateRootChunksFromPrimitives;
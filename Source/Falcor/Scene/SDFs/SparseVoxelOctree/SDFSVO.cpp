@@ -26,10 +26,15 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "SDFSVO.h"
+#include "Core/Assert.h"
 #include "Core/API/Device.h"
 #include "Core/API/RenderContext.h"
+#include "Core/API/IndirectCommands.h"
+#include "Utils/NumericRange.h"
 #include "Utils/Math/MathHelpers.h"
 #include "Scene/SDFs/SDFVoxelTypes.slang"
+#include <execution>
+#include <numeric>
 
 namespace Falcor
 {
@@ -37,10 +42,10 @@ namespace Falcor
 
     namespace
     {
-        const std::string kSDFCountSurfaceVoxelsShaderName = "Scene/SDFs/SDFSurfaceVoxelCounter.cs.slang";
         const std::string kSDFSVOBuildLevelFromTextureShaderName = "Scene/SDFs/SparseVoxelOctree/SDFSVOBuildLevelFromTexture.cs.slang";
         const std::string kSDFSVOBuildOctreeFromLevelsShaderName = "Scene/SDFs/SparseVoxelOctree/SDFSVOBuildOctreeFromLevels.cs.slang";
         const std::string kSDFSVOLocationCodeSorterShaderName = "Scene/SDFs/SparseVoxelOctree/SDFSVOLocationCodeSorter.cs.slang";
+        const std::string kSDFSVOWriteBuildArgsShaderName = "Scene/SDFs/SparseVoxelOctree/SDFSVOWriteBuildArgs.cs.slang";
         const std::string kSDFSVOWriteSVOOffsetsShaderName = "Scene/SDFs/SparseVoxelOctree/SDFSVOWriteSVOOffsets.cs.slang";
         const std::string kSDFSVOBuildOctreeShaderName = "Scene/SDFs/SparseVoxelOctree/SDFSVOBuildOctree.cs.slang";
 
@@ -79,7 +84,7 @@ namespace Falcor
 
     uint32_t SDFSVO::getMaxPrimitiveIDBits() const
     {
-        return bitScanReverse(mSVOElementCount - 1) + 1;
+        return bitScanReverse(std::max(mSVOElementCount, 2u) - 1) + 1;
     }
 
     void SDFSVO::createResources(RenderContext* pRenderContext, bool deleteScratchData)
@@ -99,55 +104,14 @@ namespace Falcor
             mpSDFGridTexture = Texture::create3D(mGridWidth + 1, mGridWidth + 1, mGridWidth + 1, ResourceFormat::R8Snorm, 1, mValues.data());
         }
 
-        if (!mpCountSurfaceVoxelsPass)
-        {
-            Program::Desc desc;
-            desc.addShaderLibrary(kSDFCountSurfaceVoxelsShaderName).csEntry("main").setShaderModel("6_5");
-            mpCountSurfaceVoxelsPass = ComputePass::create(desc);
-        }
-
-        if (!mpSurfaceVoxelCounter)
-        {
-            mpReadbackFence = GpuFence::create();
-
-            static const uint32_t zero = 0;
-            mpSurfaceVoxelCounter = Buffer::create(sizeof(uint32_t), Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, &zero);
-            mpSurfaceVoxelCounterStagingBuffer = Buffer::create(sizeof(uint32_t), Resource::BindFlags::None, Buffer::CpuAccess::Read);
-        }
-        else
-        {
-            pRenderContext->clearUAV(mpSurfaceVoxelCounter->getUAV().get(), uint4(0));
-        }
-
-        uint32_t finestLevelVoxelCount = 0;
-
-        // Count the number of surface containing voxels in the texture.
-        {
-            mpCountSurfaceVoxelsPass["CB"]["gGridWidth"] = mGridWidth;
-            mpCountSurfaceVoxelsPass["gSDFGrid"] = mpSDFGridTexture;
-            mpCountSurfaceVoxelsPass["gTotalVoxelCount"] = mpSurfaceVoxelCounter;
-            mpCountSurfaceVoxelsPass->execute(pRenderContext, mGridWidth, mGridWidth, mGridWidth);
-
-            // Copy surface containing voxels count to staging buffer.
-            pRenderContext->copyResource(mpSurfaceVoxelCounterStagingBuffer.get(), mpSurfaceVoxelCounter.get());
-            pRenderContext->flush(false);
-            mpReadbackFence->gpuSignal(pRenderContext->getLowLevelData()->getCommandQueue());
-
-            // Copy surface containing voxels count from staging buffer to CPU.
-            mpReadbackFence->syncCpu();
-            const uint32_t* pSurfaceContainingVoxels = reinterpret_cast<const uint32_t*>(mpSurfaceVoxelCounterStagingBuffer->map(Buffer::MapType::Read));
-            std::memcpy(&finestLevelVoxelCount, pSurfaceContainingVoxels, sizeof(uint32_t));
-            mpSurfaceVoxelCounterStagingBuffer->unmap();
-        }
-
-        uint32_t worstCaseTotalVoxels = 0;
-
         // Calculate worst case total voxel count across all levels.
+        // The finest level voxel count is known from setValuesInternal(), so no GPU readback is required to size the scratch data.
+        uint32_t worstCaseTotalVoxels = 0;
         for (uint32_t l = 0; l < mLevelCount; l++)
         {
             uint32_t levelWidth = 1 << l;
             uint32_t levelVoxelMax = levelWidth * levelWidth * levelWidth;
-            worstCaseTotalVoxels += glm::min(finestLevelVoxelCount, levelVoxelMax);
+            worstCaseTotalVoxels += glm::min(mFinestLevelVoxelCount, levelVoxelMax);
         }
 
         // Create the hash table that will store all voxels during the building process.
@@ -172,18 +136,15 @@ namespace Falcor
             mpBuildFinestLevelFromDistanceTexturePass = ComputePass::create(desc, Program::DefineList({ {"FINEST_LEVEL_PASS", "1"} }));
         }
 
-        // Create voxels for the bottom level.
+        // Allocate or clear the buffer holding the voxel count of each level, the counts are accumulated by the level building passes.
+        if (!mpVoxelCountPerLevelBuffer || mpVoxelCountPerLevelBuffer->getSize() != sizeof(uint32_t) * mLevelCount)
         {
-            auto cbVar = mpBuildFinestLevelFromDistanceTexturePass["CB"];
-            cbVar["gLevel"] = (mLevelCount - 1);
-            cbVar["gNumLevels"] = mLevelCount;
-            cbVar["gLevelWidth"] = mGridWidth;
-            mpBuildFinestLevelFromDistanceTexturePass["gSDFGrid"] = mpSDFGridTexture;
-            mpBuildFinestLevelFromDistanceTexturePass["gLocationCodes"] = mpLocationCodesBuffer;
-            auto hashTableVar = mpBuildFinestLevelFromDistanceTexturePass["gVoxelHashTable"];
-            hashTableVar["buffer"] = mpHashTableBuffer;
-            hashTableVar["capacity"] = hashTableCapacity;
-            mpBuildFinestLevelFromDistanceTexturePass->execute(pRenderContext, mGridWidth, mGridWidth, mGridWidth);
+            std::vector<uint32_t> zeros(mLevelCount, 0);
+            mpVoxelCountPerLevelBuffer = Buffer::create(sizeof(uint32_t) * mLevelCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, zeros.data());
+        }
+        else
+        {
+            pRenderContext->clearUAV(mpVoxelCountPerLevelBuffer->getUAV().get(), uint4(0));
         }
 
         // Create the building pass for the other levels.
@@ -194,12 +155,19 @@ namespace Falcor
             mpBuildLevelFromDistanceTexturePass = ComputePass::create(desc, Program::DefineList({ {"FINEST_LEVEL_PASS", "0"} }));
         }
 
-        // Allocate a buffer that will hold the voxel count for each level except the bottom level (as we already obtained that previously).
-        std::vector<uint32_t> voxelCountsPerLevel(mLevelCount, 0);
-        voxelCountsPerLevel.back() = finestLevelVoxelCount;
+        // Create voxels for the bottom level.
         {
-            mpVoxelCountPerLevelBuffer = Buffer::create(sizeof(uint32_t) * (mLevelCount - 1), Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, voxelCountsPerLevel.data());
-            mpVoxelCountPerLevelStagingBuffer = Buffer::create(sizeof(uint32_t) * (mLevelCount - 1), Resource::BindFlags::None, Buffer::CpuAccess::Read);
+            auto cbVar = mpBuildFinestLevelFromDistanceTexturePass["CB"];
+            cbVar["gLevel"] = (mLevelCount - 1);
+            cbVar["gNumLevels"] = mLevelCount;
+            cbVar["gLevelWidth"] = mGridWidth;
+            mpBuildFinestLevelFromDistanceTexturePass["gSDFGrid"] = mpSDFGridTexture;
+            mpBuildFinestLevelFromDistanceTexturePass["gLocationCodes"] = mpLocationCodesBuffer;
+            auto hashTableVar = mpBuildFinestLevelFromDistanceTexturePass["gVoxelHashTable"];
+            hashTableVar["buffer"] = mpHashTableBuffer;
+            hashTableVar["capacity"] = hashTableCapacity;
+            mpBuildFinestLevelFromDistanceTexturePass["gVoxelCounts"] = mpVoxelCountPerLevelBuffer;
+            mpBuildFinestLevelFromDistanceTexturePass->execute(pRenderContext, mGridWidth, mGridWidth, mGridWidth);
         }
 
         // Create voxels for all the other levels, a voxel is only created if a child voxel has been created for that voxel.
@@ -224,10 +192,29 @@ namespace Falcor
             }
         }
 
-        // Copy child count to staging buffer.
-        pRenderContext->copyResource(mpVoxelCountPerLevelStagingBuffer.get(), mpVoxelCountPerLevelBuffer.get());
-        pRenderContext->flush(false);
-        mpReadbackFence->gpuSignal(pRenderContext->getLowLevelData()->getCommandQueue());
+        // Sum the level counts and write the indirect arguments for the passes that run over all SVO voxels.
+        {
+            if (!mpWriteBuildArgsPass)
+            {
+                Program::Desc desc;
+                desc.addShaderLibrary(kSDFSVOWriteBuildArgsShaderName).csEntry("main").setShaderModel("6_5");
+                mpWriteBuildArgsPass = ComputePass::create(desc);
+            }
+
+            if (!mpBuildInfoBuffer)
+            {
+                mpBuildInfoBuffer = Buffer::create(2 * sizeof(uint32_t), Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+                mpBuildArgsBuffer = Buffer::create(2 * sizeof(DispatchArguments), Resource::BindFlags::IndirectArg | Resource::BindFlags::UnorderedAccess);
+            }
+
+            auto cbVar = mpWriteBuildArgsPass["CB"];
+            cbVar["gNumLevels"] = mLevelCount;
+            cbVar["gHashTableCapacity"] = hashTableCapacity;
+            mpWriteBuildArgsPass["gVoxelCounts"] = mpVoxelCountPerLevelBuffer;
+            mpWriteBuildArgsPass["gBuildInfo"] = mpBuildInfoBuffer;
+            mpWriteBuildArgsPass["gBuildArgs"] = mpBuildArgsBuffer;
+            mpWriteBuildArgsPass->execute(pRenderContext, 1, 1);
+        }
 
         // Sort the location codes.
         {
@@ -296,20 +283,6 @@ namespace Falcor
             }
         }
 
-        // Copy child count from staging buffer to CPU.
-        mpReadbackFence->syncCpu();
-        const uint32_t* pVoxelCountPerLevel = reinterpret_cast<const uint32_t*>(mpVoxelCountPerLevelStagingBuffer->map(Buffer::MapType::Read));
-        std::memcpy(voxelCountsPerLevel.data(), pVoxelCountPerLevel, sizeof(uint32_t) * (mLevelCount - 1));
-        mpVoxelCountPerLevelStagingBuffer->unmap();
-
-        // Calculate the total number of voxels in the octree.
-        mSVOElementCount = 0;
-        for (uint32_t l = 0; l < mLevelCount; l++)
-        {
-            mSVOElementCount += voxelCountsPerLevel[l];
-        }
-
-
         // Write the sorted location code addresses into the hash table.
         {
             if (!mpWriteSVOOffsetsPass)
@@ -319,24 +292,22 @@ namespace Falcor
                 mpWriteSVOOffsetsPass = ComputePass::create(desc);
             }
 
-            auto cbVar = mpWriteSVOOffsetsPass["CB"];
-            cbVar["gLocationCodeStartOffset"] = hashTableCapacity - mSVOElementCount;
-            cbVar["gVoxelCount"] = mSVOElementCount;
             auto hashTableVar = mpWriteSVOOffsetsPass["gVoxelHashTable"];
             hashTableVar["buffer"] = mpHashTableBuffer;
             hashTableVar["capacity"] = hashTableCapacity;
             mpWriteSVOOffsetsPass["gLocationCodes"] = mpLocationCodesBuffer;
+            mpWriteSVOOffsetsPass["gBuildInfo"] = mpBuildInfoBuffer;
 
-            mpWriteSVOOffsetsPass->execute(pRenderContext, mSVOElementCount, 1);
+            mpWriteSVOOffsetsPass->executeIndirect(pRenderContext, mpBuildArgsBuffer.get(), 0);
         }
 
         // Build the octree from the sorted location codes and hash table.
         {
-            //// Create or reallocate a buffer for the SVO if required.
-            uint32_t requiredSVOSize = mSVOElementCount * sizeof(SDFSVOVoxel);
-            if (!mpSVOBuffer || mpSVOBuffer->getSize() < requiredSVOSize)
+            // Create or reallocate the scratch buffer for the SVO if required, the exact voxel count is only known on the GPU so it is sized for the worst case.
+            uint32_t requiredSVOSize = std::max(worstCaseTotalVoxels, 1u) * sizeof(SDFSVOVoxel);
+            if (!mpSVOScratchBuffer || mpSVOScratchBuffer->getSize() < requiredSVOSize)
             {
-                mpSVOBuffer = Buffer::create(requiredSVOSize);
+                mpSVOScratchBuffer = Buffer::create(requiredSVOSize);
             }
 
             if (!mpBuildOctreePass)
@@ -348,36 +319,62 @@ namespace Falcor
 
             // Build the SVO from the levels hash table.
             {
-                auto cbVar = mpBuildOctreePass["CB"];
-                cbVar["gLocationCodeStartOffset"] = hashTableCapacity - mSVOElementCount;
-                cbVar["gVoxelCount"] = mSVOElementCount;
                 auto hashTableVar = mpBuildOctreePass["gVoxelHashTable"];
                 hashTableVar["buffer"] = mpHashTableBuffer;
                 hashTableVar["capacity"] = hashTableCapacity;
                 mpBuildOctreePass["gLocationCodes"] = mpLocationCodesBuffer;
-                mpBuildOctreePass["gSVO"] = mpSVOBuffer;
+                mpBuildOctreePass["gBuildInfo"] = mpBuildInfoBuffer;
+                mpBuildOctreePass["gSVO"] = mpSVOScratchBuffer;
 
-                mpBuildOctreePass->execute(pRenderContext, mSVOElementCount, 1);
+                mpBuildOctreePass->executeIndirect(pRenderContext, mpBuildArgsBuffer.get(), sizeof(DispatchArguments));
             }
+
+            // Use the scratch buffer until finalizeResources() has copied the SVO to an exactly sized buffer.
+            mpSVOBuffer = mpSVOScratchBuffer;
+            mSVOElementCount = worstCaseTotalVoxels;
         }
 
+        // Copy the total voxel count to the CPU, it is read in finalizeResources() after the caller has synchronized with the GPU.
+        if (!mpSVOElementCountReadbackBuffer)
+        {
+            mpSVOElementCountReadbackBuffer = Buffer::create(sizeof(uint32_t), Resource::BindFlags::None, Buffer::CpuAccess::Read);
+        }
+        pRenderContext->copyBufferRegion(mpSVOElementCountReadbackBuffer.get(), 0, mpBuildInfoBuffer.get(), 0, sizeof(uint32_t));
+
         if (deleteScratchData)
         {
-            mpCountSurfaceVoxelsPass.reset();
             mpBuildFinestLevelFromDistanceTexturePass.reset();
             mpBuildLevelFromDistanceTexturePass.reset();
             mpSortLocationCodesPass.reset();
+            mpWriteBuildArgsPass.reset();
             mpWriteSVOOffsetsPass.reset();
             mpBuildOctreePass.reset();
             mpSDFGridTexture.reset();
-            mpSurfaceVoxelCounter.reset();
-            mpSurfaceVoxelCounterStagingBuffer.reset();
+            mpVoxelCountPerLevelBuffer.reset();
+            mpBuildInfoBuffer.reset();
+            mpBuildArgsBuffer.reset();
             mpHashTableBuffer.reset();
             mpLocationCodesBuffer.reset();
-            mpReadbackFence.reset();
+            mpSVOScratchBuffer.reset();
         }
     }
 
+    void SDFSVO::finalizeResources(RenderContext* pRenderContext)
+    {
+        if (!mpSVOElementCountReadbackBuffer) return;
+
+        mSVOElementCount = *reinterpret_cast<const uint32_t*>(mpSVOElementCountReadbackBuffer->map(Buffer::MapType::Read));
+        mpSVOElementCountReadbackBuffer->unmap();
+        mpSVOElementCountReadbackBuffer.reset();
+
+        // Copy the SVO from the worst case sized buffer to an exactly sized one.
+        uint32_t svoSize = std::max(mSVOElementCount, 1u) * sizeof(SDFSVOVoxel);
+        FALCOR_ASSERT(mpSVOBuffer && mpSVOBuffer->getSize() >= svoSize);
+        Buffer::SharedPtr pSVOBuffer = Buffer::create(svoSize);
+        pRenderContext->copyBufferRegion(pSVOBuffer.get(), 0, mpSVOBuffer.get(), 0, svoSize);
+        mpSVOBuffer = pSVOBuffer;
+    }
+
     void SDFSVO::setShaderData(const ShaderVar& var) const
     {
         if (!mpSVOBuffer) throw RuntimeError("SDFSVO::setShaderData() can't be called before calling SDFSVO::createResources()!");
@@ -402,5 +399,31 @@ namespace Falcor
             float integerScale = normalizedValue * float(INT8_MAX);
             mValues[v] = integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
         }
+
+        // Count the surface containing voxels of the finest level, this is used to size the scratch data when building the SVO.
+        // Uses the same test as SDFVoxelCommon::containsSurface() on the quantized values, so it matches the GPU exactly.
+        std::vector<uint32_t> sliceVoxelCounts(mGridWidth, 0);
+        auto range = NumericRange<uint32_t>(0, mGridWidth);
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t z)
+        {
+            uint32_t count = 0;
+            for (uint32_t y = 0; y < mGridWidth; y++)
+            {
+                for (uint32_t x = 0; x < mGridWidth; x++)
+                {
+                    bool anyInside = false;
+                    bool anyOutside = false;
+                    for (uint32_t c = 0; c < 8; c++)
+                    {
+                        uint32_t v = (x + (c & 1)) + gridWidthInValues * ((y + ((c >> 1) & 1)) + gridWidthInValues * (z + (c >> 2)));
+                        anyInside |= mValues[v] <= 0;
+                        anyOutside |= mValues[v] >= 0;
+                    }
+                    if (anyInside && anyOutside) count++;
+                }
+            }
+            sliceVoxelCounts[z] = count;
+        });
+        mFinestLevelVoxelCount = std::accumulate(sliceVoxelCounts.begin(), sliceVoxelCounts.end(), 0u);
     }
 }
@@ -54,6 +54,7 @@ namespace Falcor
         virtual Type getType() const override { return Type::SparseVoxelOctree; }
 
         virtual void createResources(RenderContext* pRenderContext, bool deleteScratchData = true) override;
+        virtual void finalizeResources(RenderContext* pRenderContext) override;
 
         virtual const Buffer::SharedPtr& getAABBBuffer() const override { return spSDFSVOGridUnitAABBBuffer; }
         virtual uint32_t getAABBCount() const override { return 1; }
@@ -71,7 +72,8 @@ namespace Falcor
 
         // Specs.
         uint32_t mLevelCount = 0;
-        uint32_t mSVOElementCount = 0;
+        uint32_t mFinestLevelVoxelCount = 0;    ///< Number of surface containing voxels at the finest level, counted on the CPU when the values are set.
+        uint32_t mSVOElementCount = 0;          ///< Number of voxels in the SVO, an upper bound until finalizeResources() has read back the exact count.
         uint32_t mVirtualGridWidth = 0;
         uint32_t mSVOIndexBitCount = 0;
 
@@ -82,21 +84,21 @@ namespace Falcor
         static Buffer::SharedPtr spSDFSVOGridUnitAABBBuffer;
 
         // Compute passes used to build the SVO.
-        ComputePass::SharedPtr mpCountSurfaceVoxelsPass;
         ComputePass::SharedPtr mpBuildFinestLevelFromDistanceTexturePass;
         ComputePass::SharedPtr mpBuildLevelFromDistanceTexturePass;
         ComputePass::SharedPtr mpSortLocationCodesPass;
+        ComputePass::SharedPtr mpWriteBuildArgsPass;
         ComputePass::SharedPtr mpWriteSVOOffsetsPass;
         ComputePass::SharedPtr mpBuildOctreePass;
 
         // Scratch data used for building.
         Texture::SharedPtr mpSDFGridTexture;
-        Buffer::SharedPtr mpSurfaceVoxelCounter;
-        Buffer::SharedPtr mpSurfaceVoxelCounterStagingBuffer;
         Buffer::SharedPtr mpVoxelCountPerLevelBuffer;
-        Buffer::SharedPtr mpVoxelCountPerLevelStagingBuffer;
+        Buffer::SharedPtr mpBuildInfoBuffer;        ///< Total voxel count and location code start offset, computed on the GPU.
+        Buffer::SharedPtr mpBuildArgsBuffer;        ///< Indirect dispatch arguments for the passes that run over all SVO voxels.
         Buffer::SharedPtr mpHashTableBuffer;
         Buffer::SharedPtr mpLocationCodesBuffer;
-        GpuFence::SharedPtr mpReadbackFence;
+        Buffer::SharedPtr mpSVOScratchBuffer;       ///< SVO sized for the worst case voxel count, copied to an exactly sized buffer in finalizeResources().
+        Buffer::SharedPtr mpSVOElementCountReadbackBuffer;
     };
 }
@@ -37,6 +37,12 @@ namespace Falcor
     {
         const std::string kSDFCountSurfaceVoxelsShaderName = "Scene/SDFs/SDFSurfaceVoxelCounter.cs.slang";
         const std::string kSDFSVSVoxelizerShaderName = "Scene/SDFs/SparseVoxelSet/SDFSVSVoxelizer.cs.slang";
+
+        int8_t quantizeSnorm8(float value)
+        {
+            float integerScale = value * float(INT8_MAX);
+            return integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
+        }
     }
 
     SDFSVS::SharedPtr SDFSVS::create()
@@ -61,6 +67,25 @@ namespace Falcor
             throw RuntimeError("An SDFSVS instance cannot be created from primitives!");
         }
 
+        // Grids loaded from sparse brick data have already been voxelized on the CPU.
+        if (mLoadedFromBricks)
+        {
+            if (mVoxels.empty() && mpVoxelBuffer && mpVoxelAABBBuffer) return;
+
+            mVoxelCount = (uint32_t)mVoxels.size();
+            mpVoxelAABBBuffer = Buffer::createStructured(sizeof(AABB), mVoxelCount, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, mVoxelAABBs.data(), false);
+            mpVoxelBuffer = Buffer::createStructured(sizeof(SDFSVSVoxel), mVoxelCount, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, mVoxels.data(), false);
+
+            if (deleteScratchData)
+            {
+                mVoxels.clear();
+                mVoxels.shrink_to_fit();
+                mVoxelAABBs.clear();
+                mVoxelAABBs.shrink_to_fit();
+            }
+            return;
+        }
+
         if (mpSDFGridTexture && mpSDFGridTexture->getWidth() == mGridWidth + 1)
         {
             pRenderContext->updateTextureData(mpSDFGridTexture.get(), mValues.data());
@@ -174,6 +199,10 @@ namespace Falcor
 
     void SDFSVS::setValuesInternal(const std::vector<float>& cornerValues)
     {
+        mLoadedFromBricks = false;
+        mVoxels.clear();
+        mVoxelAABBs.clear();
+
         uint32_t gridWidthInValues = mGridWidth + 1;
         uint32_t valueCount = gridWidthInValues * gridWidthInValues * gridWidthInValues;
         mValues.resize(valueCount);
@@ -187,4 +216,110 @@ namespace Falcor
             mValues[v] = integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
         }
     }
+
+    void SDFSVS::setBricksInternal(const SDFBrickData& brickData)
+    {
+        // Voxelize each stored brick on the CPU, this gives the same voxels as SDFSVSVoxelizer.cs.slang without creating the dense grid.
+        // Each brick is decoded together with an apron of one value below and two values above, which covers the 4x4x4 values
+        // stored per voxel as well as the corners of all neighboring voxels.
+        const int32_t gridWidth = (int32_t)mGridWidth;
+        const uint32_t brickWidth = brickData.brickWidth;
+        const uint32_t bricksPerAxis = brickData.getBricksPerAxis();
+        const uint32_t localWidth = brickWidth + 3;
+        const float normalizationMultipler = 2.0f * mGridWidth / glm::root_three<float>();
+
+        mValues.clear();
+        mVoxels.clear();
+        mVoxelAABBs.clear();
+
+        std::vector<int8_t> localValues(localWidth * localWidth * localWidth);
+        auto loadLocal = [&](const int3& l) { return localValues[l.x + localWidth * (l.y + localWidth * l.z)]; };
+
+        auto voxelContainsSurface = [&](const int3& voxelCoords, const int3& l)
+        {
+            if (glm::any(glm::lessThan(voxelCoords, int3(0))) || glm::any(glm::greaterThanEqual(voxelCoords, int3(gridWidth)))) return false;
+
+            float cornerValues[8];
+            for (uint32_t i = 0; i < 8; i++)
+            {
+                cornerValues[i] = float(loadLocal(l + int3((i >> 2) & 1, (i >> 1) & 1, i & 1)));
+            }
+            return SDFBrickData::containsSurface(cornerValues);
+        };
+
+        for (uint32_t brickIndex = 0; brickIndex < brickData.getBrickCount(); brickIndex++)
+        {
+            const uint32_t virtualBrickID = brickData.brickIDs[brickIndex];
+            const int3 brickCoords = int3(virtualBrickID % bricksPerAxis, (virtualBrickID / bricksPerAxis) % bricksPerAxis, virtualBrickID / (bricksPerAxis * bricksPerAxis));
+            const int3 brickOrigin = brickCoords * int32_t(brickWidth);
+
+            // Decode the brick and its apron. Values outside of the grid are treated as outside of the surface.
+            for (uint32_t z = 0; z < localWidth; z++)
+            {
+                for (uint32_t y = 0; y < localWidth; y++)
+                {
+                    for (uint32_t x = 0; x < localWidth; x++)
+                    {
+                        const int3 c = brickOrigin + int3(x, y, z) - 1;
+                        float distance = 1.0f / normalizationMultipler;
+                        if (glm::all(glm::greaterThanEqual(c, int3(0))) && glm::all(glm::lessThanEqual(c, int3(gridWidth))))
+                        {
+                            const int3 brickLocal = c - brickOrigin;
+                            bool inBrick = glm::all(glm::greaterThanEqual(brickLocal, int3(0))) && glm::all(glm::lessThanEqual(brickLocal, int3(brickWidth)));
+                            distance = inBrick ? brickData.getBrickValue(brickIndex, uint3(brickLocal)) : brickData.getCornerValue(uint3(c));
+                        }
+                        localValues[x + localWidth * (y + localWidth * z)] = quantizeSnorm8(glm::clamp(distance * normalizationMultipler, -1.0f, 1.0f));
+                    }
+                }
+            }
+
+            for (uint32_t z = 0; z < brickWidth; z++)
+            {
+                for (uint32_t y = 0; y < brickWidth; y++)
+                {
+                    for (uint32_t x = 0; x < brickWidth; x++)
+                    {
+                        const int3 voxelCoords = brickOrigin + int3(x, y, z);
+                        const int3 l = int3(x, y, z) + 1;
+                        if (!voxelContainsSurface(voxelCoords, l)) continue;
+
+                        float3 p = float3(voxelCoords) - float(mGridWidth) * 0.5f;
+                        mVoxelAABBs.push_back(AABB(p / float(mGridWidth), (p + 1.0f) / float(mGridWidth)));
+
+                        SDFSVSVoxel voxel = {};
+                        for (int32_t sx = 0; sx < 4; sx++)
+                        {
+                            for (int32_t sy = 0; sy < 4; sy++)
+                            {
+                                uint32_t packedValues = 0;
+                                for (int32_t sz = 0; sz < 4; sz++)
+                                {
+                                    packedValues |= uint32_t(uint8_t(loadLocal(l + int3(sx, sy, sz) - 1))) << (8 * sz);
+                                }
+                                voxel.packedValuesSlices[sx][sy] = packedValues;
+                            }
+                        }
+
+                        for (int32_t nx = 0; nx <= 2; nx++)
+                        {
+                            for (int32_t ny = 0; ny <= 2; ny++)
+                            {
+                                for (int32_t nz = 0; nz <= 2; nz++)
+                                {
+                                    const int3 offset = int3(nx, ny, nz) - 1;
+                                    if (voxelContainsSurface(voxelCoords + offset, l + offset)) voxel.validNeighborsMask |= 1u << (nz + 3 * (ny + 3 * nx));
+                                }
+                            }
+                        }
+
+                        mVoxels.push_back(voxel);
+                    }
+                }
+            }
+        }
+
+        logInfo("Created {} SDF voxels from {} bricks for a grid of width {}.", mVoxels.size(), brickData.getBrickCount(), mGridWidth);
+
+        mLoadedFromBricks = true;
+    }
 }
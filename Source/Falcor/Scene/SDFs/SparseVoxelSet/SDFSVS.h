@@ -28,6 +28,7 @@
 #pragma once
 
 #include "Scene/SDFs/SDFGrid.h"
+#include "Scene/SDFs/SDFVoxelTypes.slang"
 #include "Core/API/Buffer.h"
 #include "Core/API/Texture.h"
 #include "RenderGraph/BasePasses/ComputePass.h"
@@ -59,12 +60,16 @@ namespace Falcor
 
     protected:
         virtual void setValuesInternal(const std::vector<float>& cornerValues) override;
+        virtual void setBricksInternal(const SDFBrickData& brickData) override;
 
     private:
         SDFSVS() = default;
 
         // CPU data.
         std::vector<int8_t> mValues;
+        std::vector<SDFSVSVoxel> mVoxels;       ///< Voxels created on the CPU, set if the grid was loaded from sparse brick data.
+        std::vector<AABB> mVoxelAABBs;          ///< Voxel AABBs created on the CPU, set if the grid was loaded from sparse brick data.
+        bool mLoadedFromBricks = false;
 
         // Specs.
         Buffer::SharedPtr mpVoxelAABBBuffer;
@@ -28,6 +28,7 @@
 #include "Scene.h"
 #include "SceneDefines.slangh"
 #include "SceneBuilder.h"
+#include "SceneCache.h"
 #include "Importer.h"
 #include "Curves/CurveConfig.h"
 #include "SDFs/SDFGrid.h"
@@ -37,15 +38,21 @@
 #include "SDFs/SparseVoxelSet/SDFSVS.h"
 #include "Core/API/Device.h"
 #include "Core/API/RenderContext.h"
+#include "Core/API/GpuTimer.h"
 #include "Core/API/IndirectCommands.h"
+#include "Utils/BinaryFileStream.h"
+#include "Utils/ChunkedBufferUploader.h"
 #include "Utils/StringUtils.h"
 #include "Utils/Math/Common.h"
+#include "Utils/Math/FalcorMath.h"
 #include "Utils/Math/MathHelpers.h"
 #include "Utils/Timing/Profiler.h"
 #include "Utils/UI/InputTypes.h"
 #include "Utils/Scripting/ScriptWriter.h"
 
+#include <cstring>
 #include <fstream>
+#include <iomanip>
 #include <numeric>
 #include <sstream>
 
@@ -61,6 +68,16 @@ namespace Falcor
         // The target is max 0.5GB intermediate memory per BLAS group. Note that this is not a strict limit.
         const size_t kMaxBLASBuildMemory = 1ull << 29;
 
+        /** BLAS cache directory (subdirectory in the scene cache directory).
+        */
+        const char kBlasCacheDirectory[] = "Blas";
+
+        /** Specifies the current BLAS cache file version.
+            This needs to be incremented every time the file format or the BLAS build inputs change!
+        */
+        const uint32_t kBlasCacheVersion = 2;
+        const char kBlasCacheMagic[8] = { 'F', 'a', 'l', 'c', 'o', 'r', 'B', '$' };
+
         const std::string kParameterBlockName = "gScene";
         const std::string kGeometryInstanceBufferName = "geometryInstances";
         const std::string kMeshBufferName = "meshes";
@@ -90,6 +107,9 @@ namespace Falcor
         const std::string kLightProfile = "lightProfile";
         const std::string kAnimated = "animated";
         const std::string kRenderSettings = "renderSettings";
+        const std::string kInstanceCulling = "instanceCulling";
+        const std::string kAddInstanceLodChain = "addInstanceLodChain";
+        const std::string kClearInstanceLodChains = "clearInstanceLodChains";
         const std::string kUpdateCallback = "updateCallback";
         const std::string kEnvMap = "envMap";
         const std::string kMaterials = "materials";
@@ -192,7 +212,7 @@ namespace Falcor
         setSDFGridConfig();
 
         // Create vertex array objects for meshes and curves.
-        createMeshVao(sceneData.meshDrawCount, sceneData.meshIndexData, sceneData.meshStaticData, sceneData.meshSkinningData);
+        createMeshVao(sceneData.meshDrawCount, sceneData.meshIndexData, sceneData.meshStaticData, sceneData.pMeshIndexBuffer, sceneData.pMeshStaticBuffer);
         createCurveVao(mCurveIndexData, mCurveStaticData);
 
         // Create animation controller.
@@ -391,37 +411,56 @@ namespace Falcor
         pContext->raytrace(pProgram, pVars.get(), dispatchDims.x, dispatchDims.y, dispatchDims.z);
     }
 
-    void Scene::createMeshVao(uint32_t drawCount, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData, const std::vector<SkinningVertexData>& skinningData)
+    Buffer::SharedPtr Scene::createMeshIndexBuffer(size_t indexCount)
     {
-        if (drawCount == 0) return;
-
-        // Create the index buffer.
-        size_t ibSize = sizeof(uint32_t) * indexData.size();
+        size_t ibSize = sizeof(uint32_t) * indexCount;
         if (ibSize > std::numeric_limits<uint32_t>::max())
         {
             throw RuntimeError("Index buffer size exceeds 4GB");
         }
 
-        Buffer::SharedPtr pIB;
-        if (ibSize > 0)
-        {
-            ResourceBindFlags ibBindFlags = Resource::BindFlags::Index | ResourceBindFlags::ShaderResource;
-            pIB = Buffer::create(ibSize, ibBindFlags, Buffer::CpuAccess::None, indexData.data());
-        }
+        ResourceBindFlags ibBindFlags = Resource::BindFlags::Index | ResourceBindFlags::ShaderResource;
+        return Buffer::create(ibSize, ibBindFlags, Buffer::CpuAccess::None, nullptr);
+    }
 
-        // Create the vertex data structured buffer.
-        const size_t vertexCount = (uint32_t)staticData.size();
+    Buffer::SharedPtr Scene::createMeshStaticBuffer(size_t vertexCount)
+    {
         size_t staticVbSize = sizeof(PackedStaticVertexData) * vertexCount;
         if (staticVbSize > std::numeric_limits<uint32_t>::max())
         {
             throw RuntimeError("Vertex buffer size exceeds 4GB");
         }
 
-        Buffer::SharedPtr pStaticBuffer;
-        if (vertexCount > 0)
+        ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess | ResourceBindFlags::Vertex;
+        return Buffer::createStructured(sizeof(PackedStaticVertexData), (uint32_t)vertexCount, vbBindFlags, Buffer::CpuAccess::None, nullptr, false);
+    }
+
+    void Scene::createMeshVao(uint32_t drawCount, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData, Buffer::SharedPtr pIB, Buffer::SharedPtr pStaticBuffer)
+    {
+        if (drawCount == 0) return;
+
+        // Create the index and vertex data buffers, unless the data was already streamed to the GPU by the scene builder.
+        // The host data is uploaded through a small ring of upload chunks to bound the amount of staging memory.
+        FALCOR_ASSERT(!pIB || indexData.empty());
+        FALCOR_ASSERT(!pStaticBuffer || staticData.empty());
+
+        if (!indexData.empty() || !staticData.empty())
         {
-            ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess | ResourceBindFlags::Vertex;
-            pStaticBuffer = Buffer::createStructured(sizeof(PackedStaticVertexData), (uint32_t)vertexCount, vbBindFlags, Buffer::CpuAccess::None, nullptr, false);
+            ChunkedBufferUploader uploader(gpDevice->getRenderContext());
+
+            if (!indexData.empty())
+            {
+                pIB = createMeshIndexBuffer(indexData.size());
+                uploader.write(pIB, 0, indexData.data(), pIB->getSize());
+            }
+
+            if (!staticData.empty())
+            {
+                pStaticBuffer = createMeshStaticBuffer(staticData.size());
+                uploader.write(pStaticBuffer, 0, staticData.data(), pStaticBuffer->getSize());
+            }
+
+            uploader.flush();
         }
 
         Vao::BufferVec pVBs(kVertexBufferCount);
@@ -616,9 +655,19 @@ namespace Falcor
             mSDFGridConfig.implementationData.SVO.svoIndexBitCount = 0;
         }
 
+        // Record the building of all grids before synchronizing once, grids that need no readbacks are then built back to back on the GPU.
+        RenderContext* pRenderContext = gpDevice->getRenderContext();
+        std::vector<GpuTimer::SharedPtr> buildTimers;
+        buildTimers.reserve(mSDFGrids.size());
+
         for (const SDFGrid::SharedPtr& pSDFGrid : mSDFGrids)
         {
-            pSDFGrid->createResources(gpDevice->getRenderContext());
+            GpuTimer::SharedPtr pTimer = GpuTimer::create();
+            pTimer->begin();
+            pSDFGrid->createResources(pRenderContext);
+            pTimer->end();
+            pTimer->resolve();
+            buildTimers.push_back(pTimer);
 
             if (mSDFGridConfig.implementation == SDFGrid::Type::SparseBrickSet)
             {
@@ -632,6 +681,17 @@ namespace Falcor
                 mSDFGridConfig.implementationData.SVO.svoIndexBitCount = std::max(mSDFGridConfig.implementationData.SVO.svoIndexBitCount, pSVO->getSVOIndexBitCount());
             }
         }
+
+        if (!mSDFGrids.empty())
+        {
+            pRenderContext->flush(true);
+
+            for (size_t i = 0; i < mSDFGrids.size(); i++)
+            {
+                mSDFGrids[i]->finalizeResources(pRenderContext);
+                logInfo("Built SDF grid {} (grid width {}) in {:.2f} ms.", i, mSDFGrids[i]->getGridWidth(), buildTimers[i]->getElapsedTime());
+            }
+        }
     }
 
     void Scene::initResources()
@@ -769,11 +829,13 @@ namespace Falcor
     {
         if (mGeometryInstanceData.empty()) return;
 
-        bool dataChanged = false;
         const auto& globalMatrices = mpAnimationController->getGlobalMatrices();
 
-        for (auto& inst : mGeometryInstanceData)
+        if (forceUpdate) mGeometryInstanceDirtyRanges.markAllDirty(mGeometryInstanceData.size());
+
+        for (size_t i = 0; i < mGeometryInstanceData.size(); i++)
         {
+            auto& inst = mGeometryInstanceData[i];
             if (inst.getType() == GeometryType::TriangleMesh || inst.getType() == GeometryType::DisplacedTriangleMesh)
             {
                 uint32_t prevFlags = inst.flags;
@@ -793,15 +855,12 @@ namespace Falcor
                 if (isWorldFrontFaceCW) inst.flags |= (uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
                 else inst.flags &= ~(uint32_t)GeometryInstanceFlags::IsWorldFrontFaceCW;
 
-                dataChanged |= (inst.flags != prevFlags);
+                if (inst.flags != prevFlags) mGeometryInstanceDirtyRanges.markDirty(i);
             }
         }
 
-        if (forceUpdate || dataChanged)
-        {
-            uint32_t byteSize = (uint32_t)(mGeometryInstanceData.size() * sizeof(GeometryInstanceData));
-            mpGeometryInstancesBuffer->setBlob(mGeometryInstanceData.data(), 0, byteSize);
-        }
+        // Upload only the instances that changed.
+        mUploadedBytes += mGeometryInstanceDirtyRanges.upload(mpGeometryInstancesBuffer.get(), mGeometryInstanceData.data(), sizeof(GeometryInstanceData));
     }
 
     Scene::UpdateFlags Scene::updateRaytracingAABBData(bool forceUpdate)
@@ -832,9 +891,6 @@ namespace Falcor
         mRtAABBRaw.resize(totalAABBCount);
         uint32_t offset = 0;
 
-        size_t firstUpdated = std::numeric_limits<size_t>::max();
-        size_t lastUpdated = 0;
-
         if (forceUpdate)
         {
             // Compute AABBs of curve segments.
@@ -842,8 +898,7 @@ namespace Falcor
             {
                 // Track range of updated AABBs.
                 // TODO: Per-curve flag to indicate changes. For now assume all curves need updating.
-                firstUpdated = std::min(firstUpdated, (size_t)offset);
-                lastUpdated = std::max(lastUpdated, (size_t)offset + curve.indexCount);
+                mRtAABBDirtyRanges.markDirty(offset, offset + curve.indexCount);
 
                 const auto* indexData = &mCurveIndexData[curve.ibOffset];
                 const auto* staticData = &mCurveStaticData[curve.vbOffset];
@@ -872,8 +927,7 @@ namespace Falcor
             mCustomPrimitiveAABBOffset = offset;
 
             // Track range of updated AABBs.
-            firstUpdated = std::min(firstUpdated, (size_t)offset);
-            lastUpdated = std::max(lastUpdated, (size_t)offset + customAABBCount);
+            mRtAABBDirtyRanges.markDirty(offset, offset + customAABBCount);
 
             for (auto& aabb : mCustomPrimitiveAABBs)
             {
@@ -893,16 +947,16 @@ namespace Falcor
             // Bind the new buffer to the scene.
             FALCOR_ASSERT(mpSceneBlock);
             mpSceneBlock->setBuffer(kProceduralPrimAABBBufferName, mpRtAABBBuffer);
+
+            mUploadedBytes += mpRtAABBBuffer->getSize();
+            mRtAABBDirtyRanges.clear();
         }
-        else if (firstUpdated < lastUpdated)
+        else
         {
-            size_t bytes = sizeof(RtAABB) * mRtAABBRaw.size();
-            FALCOR_ASSERT(mpRtAABBBuffer && mpRtAABBBuffer->getSize() >= bytes);
+            FALCOR_ASSERT(mpRtAABBBuffer && mpRtAABBBuffer->getSize() >= sizeof(RtAABB) * mRtAABBRaw.size());
 
-            // Update the modified range of the GPU buffer.
-            size_t offset = firstUpdated * sizeof(RtAABB);
-            bytes = (lastUpdated - firstUpdated) * sizeof(RtAABB);
-            mpRtAABBBuffer->setBlob(mRtAABBRaw.data() + firstUpdated, offset, bytes);
+            // Update the modified ranges of the GPU buffer.
+            mUploadedBytes += mRtAABBDirtyRanges.upload(mpRtAABBBuffer.get(), mRtAABBRaw.data(), sizeof(RtAABB));
         }
 
         return flags;
@@ -912,11 +966,14 @@ namespace Falcor
     {
         if (!hasGeometryType(GeometryType::DisplacedTriangleMesh)) return UpdateFlags::None;
 
-        // For now we assume that displaced meshes are static.
+        mSceneStats.displacedMeshUpdateCount = 0;
+
         // Create AABB and AABB update task buffers.
+        // The AABB layout is fixed, only the AABB contents change when displaced meshes are updated.
         if (!mDisplacement.pAABBBuffer)
         {
             mDisplacement.meshData.resize(mMeshDesc.size());
+            mDisplacement.dirtyMeshes.assign(mMeshDesc.size(), false);
             mDisplacement.updateTasks.clear();
 
             uint32_t AABBOffset = 0;
@@ -933,6 +990,7 @@ namespace Falcor
 
                 uint32_t AABBCount = mesh.getTriangleCount();
                 mDisplacement.meshData[meshID] = { AABBOffset, AABBCount };
+                mDisplacement.dirtyMeshes[meshID] = true;
                 AABBOffset += AABBCount;
 
                 DisplacementUpdateTask task;
@@ -947,38 +1005,71 @@ namespace Falcor
 
             FALCOR_ASSERT(mDisplacement.updateTasks.size() < std::numeric_limits<uint32_t>::max());
             mDisplacement.pUpdateTasksBuffer = Buffer::createStructured((uint32_t)sizeof(DisplacementUpdateTask), (uint32_t)mDisplacement.updateTasks.size(), ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, mDisplacement.updateTasks.data());
+            mDisplacement.pDirtyTaskIndicesBuffer = Buffer::createStructured(sizeof(uint32_t), (uint32_t)mDisplacement.updateTasks.size(), ResourceBindFlags::ShaderResource);
+
+            mSceneStats.displacedMeshCount = mDisplacement.updateTasks.size();
         }
 
         FALCOR_ASSERT(!mDisplacement.updateTasks.empty());
 
+        // Meshes with skinning or vertex animations need new AABBs whenever their vertices changed.
+        if (forceUpdate || is_set(mUpdates, UpdateFlags::MeshesChanged))
+        {
+            for (const auto& task : mDisplacement.updateTasks)
+            {
+                if (forceUpdate || mMeshDesc[task.meshID].isDynamic()) mDisplacement.dirtyMeshes[task.meshID] = true;
+            }
+        }
+
         // We cannot access the scene parameter block until its finalized.
         if (!mFinalized) return UpdateFlags::None;
 
         // Update the AABB data.
+        // The first update initializes the AABBs of all displaced meshes, later updates only change the AABBs of the dirty meshes.
+        const bool initialUpdate = !mDisplacement.pUpdatePass;
         if (!mDisplacement.pUpdatePass)
         {
             mDisplacement.pUpdatePass = ComputePass::create("Scene/Displacement/DisplacementUpdate.cs.slang", "main", getSceneDefines());
-            mDisplacement.needsUpdate = true;
         }
 
-        if (mDisplacement.needsUpdate)
+        // Gather the update tasks of all dirty meshes so that they run in a single dispatch.
+        std::vector<uint32_t> dirtyTaskIndices;
+        for (uint32_t taskIndex = 0; taskIndex < (uint32_t)mDisplacement.updateTasks.size(); ++taskIndex)
         {
-            // TODO: Only update objects with modified materials.
+            const uint32_t meshID = mDisplacement.updateTasks[taskIndex].meshID;
+            if (mDisplacement.dirtyMeshes[meshID])
+            {
+                dirtyTaskIndices.push_back(taskIndex);
+                mDisplacement.dirtyMeshes[meshID] = false;
+            }
+        }
 
+        if (!dirtyTaskIndices.empty())
+        {
             FALCOR_PROFILE("updateDisplacement");
 
+            mDisplacement.pDirtyTaskIndicesBuffer->setBlob(dirtyTaskIndices.data(), 0, dirtyTaskIndices.size() * sizeof(uint32_t));
+            mUploadedBytes += dirtyTaskIndices.size() * sizeof(uint32_t);
+
             mDisplacement.pUpdatePass->getVars()->setParameterBlock(kParameterBlockName, mpSceneBlock);
 
             auto var = mDisplacement.pUpdatePass->getRootVar()["CB"];
-            var["gTaskCount"] = (uint32_t)mDisplacement.updateTasks.size();
+            var["gTaskCount"] = (uint32_t)dirtyTaskIndices.size();
             var["gTasks"] = mDisplacement.pUpdateTasksBuffer;
+            var["gTaskIndices"] = mDisplacement.pDirtyTaskIndicesBuffer;
             var["gAABBs"] = mDisplacement.pAABBBuffer;
 
-            mDisplacement.pUpdatePass->execute(gpDevice->getRenderContext(), uint3(DisplacementUpdateTask::kThreadCount, (uint32_t)mDisplacement.updateTasks.size(), 1));
+            mDisplacement.pUpdatePass->execute(gpDevice->getRenderContext(), uint3(DisplacementUpdateTask::kThreadCount, (uint32_t)dirtyTaskIndices.size(), 1));
 
-            mCustomPrimitivesChanged = true; // Trigger a BVH update.
-            mDisplacement.needsUpdate = false;
-            return UpdateFlags::DisplacementChanged;
+            mSceneStats.displacedMeshUpdateCount = dirtyTaskIndices.size();
+
+            // The AABB layout is fixed, so a refit of the BLASes with procedural primitives is sufficient after the initial update.
+            if (initialUpdate)
+            {
+                mCustomPrimitivesChanged = true; // Trigger a full BVH build.
+                return UpdateFlags::DisplacementChanged;
+            }
+            return UpdateFlags::DisplacementChanged | UpdateFlags::CustomPrimitivesMoved;
         }
 
         return UpdateFlags::None;
@@ -1296,8 +1387,93 @@ namespace Falcor
             s.blasOpaqueGeometryCount += opaque;
         }
 
-        if (mpBlasScratch) s.blasScratchMemoryInBytes += mpBlasScratch->getSize();
+        s.blasTransientScratchMemoryInBytes = mBlasTransientScratchByteSize;
+
+        if (mpBlasUpdateScratch) s.blasScratchMemoryInBytes += mpBlasUpdateScratch->getSize();
         if (mpBlasStaticWorldMatrices) s.blasScratchMemoryInBytes += mpBlasStaticWorldMatrices->getSize();
+
+        // Compute spatial stats for the mesh group BLASes.
+        // Each TLAS instance of a group is bounded in world space by transforming the group's object space bounds.
+        // Overlap between instances increases the number of BLASes a ray has to traverse, so we track it per group.
+        s.blasMeshGroups.clear();
+        s.blasMeshGroups.resize(mMeshGroups.size());
+        s.blasSAHCost = 0.0;
+        s.blasOverlapRatio = 0.0;
+
+        // The instance bounds are kept for evaluating the overlap stats on demand (see updateBlasOverlapStats()).
+        mBlasInstanceBounds.clear();
+        mBlasOverlapStatsValid = false;
+
+        const auto& globalMatrices = mpAnimationController->getGlobalMatrices();
+        const double sceneArea = mSceneBB.valid() ? mSceneBB.area() : 0.0;
+
+        for (uint32_t i = 0; i < (uint32_t)mMeshGroups.size(); i++)
+        {
+            const auto& meshList = mMeshGroups[i].meshList;
+            auto& g = s.blasMeshGroups[i];
+            FALCOR_ASSERT(!meshList.empty());
+
+            AABB groupBB;
+            g.meshCount = meshList.size();
+            for (auto meshID : meshList)
+            {
+                groupBB |= mMeshBBs[meshID.get()];
+                g.triangleCount += mMeshDesc[meshID.get()].getTriangleCount();
+            }
+
+            // The instances of the first mesh identify the TLAS instances of the group (see fillInstanceDesc()).
+            // Static groups are pre-transformed to world space.
+            for (uint32_t instanceID : mMeshIdToInstanceIds[meshList[0].get()])
+            {
+                AABB bb = mMeshGroups[i].isStatic ? groupBB : groupBB.transform(globalMatrices[mGeometryInstanceData[instanceID].globalMatrixID]);
+                if (!bb.valid()) continue;
+
+                g.instanceCount++;
+                g.surfaceArea += bb.area();
+                if (sceneArea > 0.0) g.sahCost += bb.area() / sceneArea * g.triangleCount;
+                mBlasInstanceBounds.push_back({ bb, i });
+            }
+        }
+
+        for (const auto& g : s.blasMeshGroups) s.blasSAHCost += g.sahCost;
+    }
+
+    void Scene::updateBlasOverlapStats()
+    {
+        if (mBlasOverlapStatsValid) return;
+        mBlasOverlapStatsValid = true;
+
+        // The pairwise overlap is quadratic in the number of overlapping instances in the worst case,
+        // so it is only evaluated when the stats are requested and not on every BLAS build.
+        FALCOR_PROFILE("updateBlasOverlapStats");
+
+        auto& s = mSceneStats;
+        for (auto& g : s.blasMeshGroups) g.overlapArea = 0.0;
+
+        // Find overlapping instances by sweeping along the x-axis.
+        auto& instanceBounds = mBlasInstanceBounds;
+        std::sort(instanceBounds.begin(), instanceBounds.end(), [](const BlasInstanceBounds& a, const BlasInstanceBounds& b) { return a.bounds.minPoint.x < b.bounds.minPoint.x; });
+        for (size_t i = 0; i < instanceBounds.size(); i++)
+        {
+            const auto& a = instanceBounds[i];
+            for (size_t j = i + 1; j < instanceBounds.size() && instanceBounds[j].bounds.minPoint.x <= a.bounds.maxPoint.x; j++)
+            {
+                const auto& b = instanceBounds[j];
+                AABB overlap = a.bounds & b.bounds;
+                if (!overlap.valid()) continue;
+
+                s.blasMeshGroups[a.groupIndex].overlapArea += overlap.area();
+                s.blasMeshGroups[b.groupIndex].overlapArea += overlap.area();
+            }
+        }
+
+        double totalArea = 0.0, totalOverlapArea = 0.0;
+        for (const auto& g : s.blasMeshGroups)
+        {
+            totalArea += g.surfaceArea;
+            totalOverlapArea += g.overlapArea;
+        }
+        s.blasOverlapRatio = totalArea > 0.0 ? totalOverlapArea / totalArea : 0.0;
     }
 
     void Scene::updateRaytracingTLASStats()
@@ -1318,6 +1494,8 @@ namespace Falcor
             if (tlas.pInstanceDescs) s.tlasScratchMemoryInBytes += tlas.pInstanceDescs->getSize();
         }
         if (mpTlasScratch) s.tlasScratchMemoryInBytes += mpTlasScratch->getSize();
+
+        s.tlasInactiveInstanceCount = std::count(mTlasInstanceActive.begin(), mTlasInstanceActive.end(), 0);
     }
 
     void Scene::updateLightStats()
@@ -1442,6 +1620,7 @@ namespace Falcor
         }
 
         // Update changed lights.
+        // The light data is copied into a CPU buffer, and the modified ranges are uploaded at once.
         uint32_t activeLightIndex = 0;
         mActiveLights.clear();
 
@@ -1450,17 +1629,20 @@ namespace Falcor
             if (!light->isActive()) continue;
 
             mActiveLights.push_back(light);
+            if (mActiveLightData.size() < mActiveLights.size()) mActiveLightData.resize(mActiveLights.size());
 
             auto changes = light->getChanges();
             if (changes != Light::Changes::None || is_set(combinedChanges, Light::Changes::Active) || forceUpdate)
             {
-                // TODO: This is slow since the buffer is not CPU writable. Copy into CPU buffer and upload once instead.
-                mpLightsBuffer->setElement(activeLightIndex, light->getData());
+                mActiveLightData[activeLightIndex] = light->getData();
+                mActiveLightDirtyRanges.markDirty(activeLightIndex);
             }
 
             activeLightIndex++;
         }
 
+        if (mpLightsBuffer) mUploadedBytes += mActiveLightDirtyRanges.upload(mpLightsBuffer.get(), mActiveLightData.data(), sizeof(LightData));
+
         if (combinedChanges != Light::Changes::None || forceUpdate)
         {
             mpSceneBlock["lightCount"] = (uint32_t)mActiveLights.size();
@@ -1504,6 +1686,8 @@ namespace Falcor
         }
 
         // Upload volumes and clear updates.
+        // The volume data is copied into a CPU buffer, and the modified ranges are uploaded at once.
+        mGridVolumeData.resize(mGridVolumes.size());
         uint32_t volumeIndex = 0;
         for (const auto& pGridVolume : mGridVolumes)
         {
@@ -1520,12 +1704,15 @@ namespace Falcor
                     data.transform = data.transform * densityGrid->getTransform();
                     data.invTransform = densityGrid->getInvTransform() * data.invTransform;
                 }
-                mpGridVolumesBuffer->setElement(volumeIndex, data);
+                mGridVolumeData[volumeIndex] = data;
+                mGridVolumeDirtyRanges.markDirty(volumeIndex);
             }
             pGridVolume->clearUpdates();
             volumeIndex++;
         }
 
+        if (mpGridVolumesBuffer) mUploadedBytes += mGridVolumeDirtyRanges.upload(mpGridVolumesBuffer.get(), mGridVolumeData.data(), sizeof(GridVolumeData));
+
         mpSceneBlock["gridVolumeCount"] = (uint32_t)mGridVolumes.size();
 
         UpdateFlags flags = UpdateFlags::None;
@@ -1574,10 +1761,18 @@ namespace Falcor
             // Bind materials parameter block to scene.
             mpSceneBlock->setParameterBlock(kMaterialsBlockName, mpMaterials->getParameterBlock());
 
-            // If displacement parameters have changed, we need to trigger displacement update.
-            if (is_set(materialUpdates, Material::UpdateFlags::DisplacementChanged))
+            // If displacement parameters have changed, we need to update the AABBs of the meshes using the changed materials.
+            const auto& changedMaterialIDs = mpMaterials->getDisplacementChangedMaterialIDs();
+            if (!changedMaterialIDs.empty() && !mDisplacement.dirtyMeshes.empty())
             {
-                mDisplacement.needsUpdate = true;
+                for (uint32_t meshID = 0; meshID < (uint32_t)mMeshDesc.size(); ++meshID)
+                {
+                    const auto& mesh = mMeshDesc[meshID];
+                    if (mesh.isDisplaced() && std::binary_search(changedMaterialIDs.begin(), changedMaterialIDs.end(), mesh.materialID))
+                    {
+                        mDisplacement.dirtyMeshes[meshID] = true;
+                    }
+                }
             }
 
             updateMaterialStats();
@@ -1612,6 +1807,7 @@ namespace Falcor
         if (mUpdateCallback) mUpdateCallback(shared_from_this(), currentTime);
 
         mUpdates = UpdateFlags::None;
+        mUploadedBytes = 0;
 
         if (mpAnimationController->animate(pContext, currentTime))
         {
@@ -1651,6 +1847,14 @@ namespace Falcor
             updateGeometryInstances(false);
         }
 
+        // Update instance culling and LOD selection. Changes to the active instances require a TLAS rebuild.
+        const UpdateFlags viewFlags = UpdateFlags::CameraMoved | UpdateFlags::CameraPropertiesChanged | UpdateFlags::CameraSwitched | UpdateFlags::GeometryMoved;
+        if (updateInstanceCulling(is_set(mUpdates, viewFlags)))
+        {
+            invalidateTlasCache();
+            mUpdates |= UpdateFlags::GeometryMoved;
+        }
+
         // Update existing BLASes if skinned animation and/or procedural primitives moved.
         bool updateProcedural = is_set(mUpdates, UpdateFlags::CurvesMoved) || is_set(mUpdates, UpdateFlags::CustomPrimitivesMoved);
         bool blasUpdateRequired = is_set(mUpdates, UpdateFlags::MeshesChanged) || updateProcedural;
@@ -1684,6 +1888,8 @@ namespace Falcor
             mPrevSDFGridConfig = mSDFGridConfig;
         }
 
+        mSceneStats.uploadedBytes = mUploadedBytes;
+
         return mUpdates;
     }
 
@@ -1800,6 +2006,30 @@ namespace Falcor
             renderSettingsGroup.tooltip("This enables rendering of grid volumes.", true);
         }
 
+        if (!mMeshGroups.empty())
+        {
+            if (auto cullingGroup = widget.group("Instance Culling"))
+            {
+                cullingGroup.checkbox("Enable", mInstanceCullingSettings.enabled);
+                cullingGroup.tooltip("Cull mesh instances and select instance LODs before building the TLAS.\n"
+                    "Culled instances are also invisible to secondary rays. Disable for reference renders.", true);
+
+                if (mInstanceCullingSettings.enabled)
+                {
+                    cullingGroup.checkbox("Frustum culling", mInstanceCullingSettings.frustumCulling);
+                    cullingGroup.var("Max distance", mInstanceCullingSettings.maxDistance, 0.f, std::numeric_limits<float>::max());
+                    cullingGroup.tooltip("Instances farther away from the camera are culled. Zero disables distance culling.", true);
+                    cullingGroup.var("Min screen size", mInstanceCullingSettings.minScreenSize, 0.f, 1.f, 0.001f);
+                    cullingGroup.tooltip("Instances with a projected size smaller than this fraction of the frame height are culled.", true);
+                    cullingGroup.var("Hysteresis", mInstanceCullingSettings.hysteresis, 0.f, 1.f, 0.01f);
+                    cullingGroup.tooltip("Relative margin by which a visible instance has to fail a test before it is culled or switches LOD.", true);
+                }
+
+                cullingGroup.text("LOD chains: " + std::to_string(mInstanceLodChains.size()));
+                cullingGroup.text("Inactive instances: " + std::to_string(mSceneStats.tlasInactiveInstanceCount));
+            }
+        }
+
         if (mSDFGridConfig.implementation != SDFGrid::Type::None)
         {
             if (auto sdfGridConfigGroup = widget.group("SDF Grid Settings"))
@@ -1873,6 +2103,8 @@ namespace Falcor
 
         if (auto statsGroup = widget.group("Statistics"))
         {
+            updateBlasOverlapStats();
+
             const auto& s = mSceneStats;
             const double bytesPerTexel = s.materials.textureTexelCount > 0 ? (double)s.materials.textureMemoryInBytes / s.materials.textureTexelCount : 0.0;
 
@@ -1923,9 +2155,13 @@ namespace Falcor
                 << "  BLAS geometries (non-opaque): " << (s.blasGeometryCount - s.blasOpaqueGeometryCount) << std::endl
                 << "  BLAS memory (final): " << formatByteSize(s.blasMemoryInBytes) << std::endl
                 << "  BLAS memory (scratch): " << formatByteSize(s.blasScratchMemoryInBytes) << std::endl
+                << "  BLAS memory (transient build scratch): " << formatByteSize(s.blasTransientScratchMemoryInBytes) << std::endl
+                << "  BLAS SAH cost (meshes): " << s.blasSAHCost << std::endl
+                << "  BLAS overlap ratio (meshes): " << s.blasOverlapRatio << std::endl
                 << "  TLAS count: " << s.tlasCount << std::endl
                 << "  TLAS memory (final): " << formatByteSize(s.tlasMemoryInBytes) << std::endl
                 << "  TLAS memory (scratch): " << formatByteSize(s.tlasScratchMemoryInBytes) << std::endl
+                << "  TLAS inactive instance count: " << s.tlasInactiveInstanceCount << std::endl
                 << std::endl;
 
             // Material stats.
@@ -2004,6 +2240,20 @@ namespace Falcor
                 << "  Grid memory: " << formatByteSize(s.gridMemoryInBytes) << std::endl
                 << std::endl;
 
+            // Displacement stats.
+            if (s.displacedMeshCount > 0)
+            {
+                oss << "Displacement stats:" << std::endl
+                    << "  Displaced mesh count: " << s.displacedMeshCount << std::endl
+                    << "  Displaced meshes updated (last update): " << s.displacedMeshUpdateCount << std::endl
+                    << std::endl;
+            }
+
+            // Upload stats.
+            oss << "Upload stats:" << std::endl
+                << "  Uploaded bytes (last update): " << formatByteSize(s.uploadedBytes) << std::endl
+                << std::endl;
+
             if (statsGroup.button("Print to log")) logInfo("\n" + oss.str());
 
             statsGroup.text(oss.str());
@@ -2391,6 +2641,24 @@ namespace Falcor
         mBlasUpdateMode = mode;
     }
 
+    void Scene::setBlasCache(const SHA1::MD& key, bool readCache)
+    {
+        // Serialized BLASes are specific to the adapter and driver. Including them in the key keeps
+        // caches written on different machines or driver versions apart instead of overwriting each other.
+        auto deviceIdentifier = RtAccelerationStructure::getDeviceIdentifier();
+        if (deviceIdentifier.empty())
+        {
+            mBlasCacheKey.reset();
+            return;
+        }
+
+        SHA1 sha1;
+        sha1.update(key.data(), key.size());
+        sha1.update(deviceIdentifier.data(), deviceIdentifier.size());
+        mBlasCacheKey = sha1.finalize();
+        mReadBlasCache = readCache;
+    }
+
     void Scene::createDrawList()
     {
         // This function creates argument buffers for draw indirect calls to rasterize the scene.
@@ -2531,7 +2799,7 @@ namespace Falcor
                 auto& blas = mBlasData[i];
                 auto& geomDescs = blas.geomDescs;
                 geomDescs.resize(meshList.size());
-                blas.hasProceduralPrimitives = false;
+                blas.hasProceduralPrimitives = isDisplaced; // Displaced meshes are AABBs with custom intersection.
 
                 // Track what types of triangle winding exist in the final BLAS.
                 // The SceneBuilder should have ensured winding is consistent, but keeping the check here as a safeguard.
@@ -2763,7 +3031,8 @@ namespace Falcor
             // TODO: Add compaction on/off switch for profiling.
             // TODO: Disable compaction for skinned meshes if update performance becomes a problem.
             blas.updateMode = mBlasUpdateMode;
-            blas.useCompaction = (!blas.hasDynamicGeometry()) || blas.updateMode != UpdateMode::Rebuild;
+            // BLASes with procedural primitives are updated when their AABBs change, so they are handled like dynamic ones.
+            blas.useCompaction = (!blas.hasDynamicGeometry() && !blas.hasProceduralPrimitives) || blas.updateMode != UpdateMode::Rebuild;
 
             // Setup build parameters.
             RtAccelerationStructureBuildInputs& inputs = blas.buildInputs;
@@ -2835,6 +3104,13 @@ namespace Falcor
             group.resultByteSize += blas.resultByteSize;
             group.scratchByteSize += blas.scratchByteSize;
 
+            // Updatable BLASes are additionally packed into the persistent update scratch buffer.
+            if (blas.isUpdatable())
+            {
+                blas.updateScratchByteOffset = group.updateScratchByteSize;
+                group.updateScratchByteSize += blas.scratchByteSize;
+            }
+
             groupSize += blasSize;
         }
 
@@ -2945,6 +3221,8 @@ namespace Falcor
 
                 mBlasGroups.clear();
                 mBlasObjects.clear();
+                mpBlasUpdateScratch.reset();
+                mBlasTransientScratchByteSize = 0;
             }
             else
             {
@@ -2955,35 +3233,50 @@ namespace Falcor
                 preparePrebuildInfo(pContext);
                 computeBlasGroups();
 
+                // Load the BLASes from the BLAS cache if available. The cache is only used for the first build.
+                bool readCache = mBlasCacheKey && mReadBlasCache && readBlasCache(pContext);
+                bool writeCache = mBlasCacheKey && !readCache && isBlasCacheable();
+
+                if (readCache)
+                {
+                    mBlasCacheKey.reset();
+                    mpBlasUpdateScratch.reset();
+                    mBlasTransientScratchByteSize = 0;
+                    updateRaytracingBLASStats();
+                    mRebuildBlas = false;
+                    return;
+                }
+
                 logInfo("BLAS build split into {} groups", mBlasGroups.size());
 
                 // Compute the required maximum size of the result and scratch buffers.
                 uint64_t resultByteSize = 0;
                 uint64_t scratchByteSize = 0;
+                uint64_t updateScratchByteSize = 0;
                 size_t maxBlasCount = 0;
 
                 for (const auto& group : mBlasGroups)
                 {
                     resultByteSize = std::max(resultByteSize, group.resultByteSize);
                     scratchByteSize = std::max(scratchByteSize, group.scratchByteSize);
+                    updateScratchByteSize = std::max(updateScratchByteSize, group.updateScratchByteSize);
                     maxBlasCount = std::max(maxBlasCount, group.blasIndices.size());
                 }
                 FALCOR_ASSERT(resultByteSize > 0 && scratchByteSize > 0);
 
                 logInfo("BLAS build result buffer size: {}", formatByteSize(resultByteSize));
                 logInfo("BLAS build scratch buffer size: {}", formatByteSize(scratchByteSize));
+                logInfo("BLAS update scratch buffer size: {}", formatByteSize(updateScratchByteSize));
 
                 // Allocate result and scratch buffers.
-                // The scratch buffer we'll retain because it's needed for subsequent rebuilds and updates.
-                // TODO: Save memory by reducing the scratch buffer to the minimum required for the dynamic objects.
-                if (mpBlasScratch == nullptr || mpBlasScratch->getSize() < scratchByteSize)
-                {
-                    mpBlasScratch = Buffer::create(scratchByteSize, Buffer::BindFlags::UnorderedAccess, Buffer::CpuAccess::None);
-                    mpBlasScratch->setName("Scene::mpBlasScratch");
-                }
+                // The build scratch buffer is only needed for the initial build and released afterwards.
+                // Subsequent updates use a separate scratch buffer, which is only sized for the updatable BLASes.
+                Buffer::SharedPtr pScratchBuffer = Buffer::create(scratchByteSize, Buffer::BindFlags::UnorderedAccess, Buffer::CpuAccess::None);
+                pScratchBuffer->setName("Scene::buildBlas::pScratchBuffer");
+                mBlasTransientScratchByteSize = scratchByteSize;
 
                 Buffer::SharedPtr pResultBuffer = Buffer::create(resultByteSize, Buffer::BindFlags::AccelerationStructure, Buffer::CpuAccess::None);
-                FALCOR_ASSERT(pResultBuffer && mpBlasScratch);
+                FALCOR_ASSERT(pResultBuffer && pScratchBuffer);
 
                 // Create post-build info pool for readback.
                 RtAccelerationStructurePostBuildInfoPool::Desc compactedSizeInfoPoolDesc;
@@ -2996,6 +3289,16 @@ namespace Falcor
                 currentSizeInfoPoolDesc.elementCount = (uint32_t)maxBlasCount;
                 RtAccelerationStructurePostBuildInfoPool::SharedPtr currentSizeInfoPool = RtAccelerationStructurePostBuildInfoPool::create(currentSizeInfoPoolDesc);
 
+                // The serialized size is only needed when writing the BLAS cache.
+                RtAccelerationStructurePostBuildInfoPool::SharedPtr serializationSizeInfoPool;
+                if (writeCache)
+                {
+                    RtAccelerationStructurePostBuildInfoPool::Desc serializationSizeInfoPoolDesc;
+                    serializationSizeInfoPoolDesc.queryType = RtAccelerationStructurePostBuildInfoQueryType::SerializationSize;
+                    serializationSizeInfoPoolDesc.elementCount = (uint32_t)maxBlasCount;
+                    serializationSizeInfoPool = RtAccelerationStructurePostBuildInfoPool::create(serializationSizeInfoPoolDesc);
+                }
+
                 bool hasDynamicGeometry = false;
                 bool hasProceduralPrimitives = false;
 
@@ -3011,11 +3314,12 @@ namespace Falcor
 
                     // Insert barriers. The buffers are now ready to be written.
                     pContext->uavBarrier(pResultBuffer.get());
-                    pContext->uavBarrier(mpBlasScratch.get());
+                    pContext->uavBarrier(pScratchBuffer.get());
 
                     // Reset the post-build info pools to receive new info.
                     compactedSizeInfoPool->reset(pContext);
                     currentSizeInfoPool->reset(pContext);
+                    if (serializationSizeInfoPool) serializationSizeInfoPool->reset(pContext);
 
                     // Build the BLASes into the intermediate result buffer.
                     // We output post-build info in order to find out the final size requirements.
@@ -3035,25 +3339,33 @@ namespace Falcor
 
                         RtAccelerationStructure::BuildDesc asDesc = {};
                         asDesc.inputs = blas.buildInputs;
-                        asDesc.scratchData = mpBlasScratch->getGpuAddress() + blas.scratchByteOffset;
+                        asDesc.scratchData = pScratchBuffer->getGpuAddress() + blas.scratchByteOffset;
                         asDesc.dest = blasObject.get();
 
                         // Need to find out the post-build compacted BLAS size to know the final allocation size.
-                        RtAccelerationStructurePostBuildInfoDesc postbuildInfoDesc = {};
+                        RtAccelerationStructurePostBuildInfoDesc postbuildInfoDescs[2] = {};
                         if (blas.useCompaction)
                         {
-                            postbuildInfoDesc.type = RtAccelerationStructurePostBuildInfoQueryType::CompactedSize;
-                            postbuildInfoDesc.index = (uint32_t)i;
-                            postbuildInfoDesc.pool = compactedSizeInfoPool.get();
+                            postbuildInfoDescs[0].type = RtAccelerationStructurePostBuildInfoQueryType::CompactedSize;
+                            postbuildInfoDescs[0].index = (uint32_t)i;
+                            postbuildInfoDescs[0].pool = compactedSizeInfoPool.get();
                         }
                         else
                         {
-                            postbuildInfoDesc.type = RtAccelerationStructurePostBuildInfoQueryType::CurrentSize;
-                            postbuildInfoDesc.index = (uint32_t)i;
-                            postbuildInfoDesc.pool = currentSizeInfoPool.get();
+                            postbuildInfoDescs[0].type = RtAccelerationStructurePostBuildInfoQueryType::CurrentSize;
+                            postbuildInfoDescs[0].index = (uint32_t)i;
+                            postbuildInfoDescs[0].pool = currentSizeInfoPool.get();
                         }
 
-                        pContext->buildAccelerationStructure(asDesc, 1, &postbuildInfoDesc);
+                        // The serialized size of the uncompacted BLAS is an upper bound for the serialized size of the final BLAS.
+                        if (serializationSizeInfoPool)
+                        {
+                            postbuildInfoDescs[1].type = RtAccelerationStructurePostBuildInfoQueryType::SerializationSize;
+                            postbuildInfoDescs[1].index = (uint32_t)i;
+                            postbuildInfoDescs[1].pool = serializationSizeInfoPool.get();
+                        }
+
+                        pContext->buildAccelerationStructure(asDesc, serializationSizeInfoPool ? 2 : 1, postbuildInfoDescs);
                     }
 
                     // Read back the calculated final size requirements for each BLAS.
@@ -3085,6 +3397,8 @@ namespace Falcor
                         blas.blasByteSize = align_to(kAccelerationStructureByteAlignment, byteSize);
                         blas.blasByteOffset = group.finalByteSize;
                         group.finalByteSize += blas.blasByteSize;
+
+                        if (serializationSizeInfoPool) blas.serializedByteSize = serializationSizeInfoPool->getElement(pContext, (uint32_t)i);
                     }
                     FALCOR_ASSERT(group.finalByteSize > 0);
 
@@ -3128,8 +3442,23 @@ namespace Falcor
                     pContext->uavBarrier(pBlas.get());
                 }
 
-                // Release scratch buffer if there is no animated content. We will not need it.
-                if (!hasDynamicGeometry && !hasProceduralPrimitives) mpBlasScratch.reset();
+                // Allocate the persistent scratch buffer for updates. Release it if there is no animated content.
+                if (hasDynamicGeometry || hasProceduralPrimitives)
+                {
+                    FALCOR_ASSERT(updateScratchByteSize > 0);
+                    if (mpBlasUpdateScratch == nullptr || mpBlasUpdateScratch->getSize() != updateScratchByteSize)
+                    {
+                        mpBlasUpdateScratch = Buffer::create(updateScratchByteSize, Buffer::BindFlags::UnorderedAccess, Buffer::CpuAccess::None);
+                        mpBlasUpdateScratch->setName("Scene::mpBlasUpdateScratch");
+                    }
+                }
+                else
+                {
+                    mpBlasUpdateScratch.reset();
+                }
+
+                if (writeCache) writeBlasCache(pContext);
+                mBlasCacheKey.reset();
             }
 
             updateRaytracingBLASStats();
@@ -3160,9 +3489,9 @@ namespace Falcor
             // At least one BLAS in the group needs to be updated.
             // Insert barriers. The buffers are now ready to be written.
             auto& pBlas = group.pBlas;
-            FALCOR_ASSERT(pBlas && mpBlasScratch);
+            FALCOR_ASSERT(pBlas && mpBlasUpdateScratch);
             pContext->uavBarrier(pBlas.get());
-            pContext->uavBarrier(mpBlasScratch.get());
+            pContext->uavBarrier(mpBlasUpdateScratch.get());
 
             // Iterate over all BLASes in group.
             for (uint32_t blasId : group.blasIndices)
@@ -3176,7 +3505,7 @@ namespace Falcor
                 // Rebuild/update BLAS.
                 RtAccelerationStructure::BuildDesc asDesc = {};
                 asDesc.inputs = blas.buildInputs;
-                asDesc.scratchData = mpBlasScratch->getGpuAddress() + blas.scratchByteOffset;
+                asDesc.scratchData = mpBlasUpdateScratch->getGpuAddress() + blas.updateScratchByteOffset;
                 asDesc.dest = mBlasObjects[blasId].get();
 
                 if (blas.updateMode == UpdateMode::Refit)
@@ -3198,6 +3527,235 @@ namespace Falcor
         }
     }
 
+    bool Scene::isBlasCacheable() const
+    {
+        return !mBlasData.empty() && std::none_of(mBlasData.begin(), mBlasData.end(), [](const BlasData& blas) { return blas.hasDynamicGeometry() || blas.hasProceduralPrimitives; });
+    }
+
+    bool Scene::readBlasCache(RenderContext* pContext)
+    {
+        FALCOR_ASSERT(mBlasCacheKey && !mBlasGroups.empty());
+
+        if (!isBlasCacheable()) return false;
+
+        auto path = getBlasCachePath();
+        if (!std::filesystem::exists(path)) return false;
+
+        BinaryFileStream stream(path, BinaryFileStream::Mode::Read);
+        char magic[sizeof(kBlasCacheMagic)];
+        uint32_t version = 0;
+        uint64_t blasCount = 0;
+        stream.read(magic, sizeof(magic));
+        stream >> version >> blasCount;
+        if (stream.isFail() || std::memcmp(magic, kBlasCacheMagic, sizeof(kBlasCacheMagic)) != 0 || version != kBlasCacheVersion || blasCount != mBlasData.size())
+        {
+            logWarning("Ignoring invalid BLAS cache file '{}'.", path);
+            return false;
+        }
+
+        // Read the serialized BLASes. The prebuild size and the build and geometry flags are stored to detect changed build inputs.
+        std::vector<std::vector<uint8_t>> blobs(mBlasData.size());
+        for (size_t blasId = 0; blasId < mBlasData.size(); blasId++)
+        {
+            const auto& blas = mBlasData[blasId];
+            uint64_t resultDataMaxSize = 0;
+            uint32_t buildFlags = 0;
+            uint32_t geomCount = 0;
+            stream >> resultDataMaxSize >> buildFlags >> geomCount;
+            bool inputsMatch = !stream.isFail() && resultDataMaxSize == blas.prebuildInfo.resultDataMaxSize && buildFlags == (uint32_t)blas.buildInputs.flags && geomCount == blas.geomDescs.size();
+            for (uint32_t i = 0; inputsMatch && i < geomCount; i++)
+            {
+                uint32_t geomFlags = 0;
+                stream >> geomFlags;
+                inputsMatch = !stream.isFail() && geomFlags == (uint32_t)blas.geomDescs[i].flags;
+            }
+
+            uint64_t blobSize = 0;
+            if (inputsMatch) stream >> blobSize;
+            if (!inputsMatch || stream.isFail() || blobSize < sizeof(RtSerializedAccelerationStructureHeader))
+            {
+                logWarning("Ignoring invalid BLAS cache file '{}'.", path);
+                return false;
+            }
+            blobs[blasId].resize(blobSize);
+            stream.read(blobs[blasId].data(), blobSize);
+
+            RtSerializedAccelerationStructureHeader header;
+            std::memcpy(&header, blobs[blasId].data(), sizeof(header));
+            if (stream.isFail() || header.serializedSizeInBytesIncludingHeader != blobSize || header.deserializedSizeInBytes == 0)
+            {
+                logWarning("Ignoring invalid BLAS cache file '{}'.", path);
+                return false;
+            }
+        }
+
+        // All BLASes were serialized by the same driver, so it is sufficient to check the first one.
+        RtSerializedAccelerationStructureHeader header;
+        std::memcpy(&header, blobs[0].data(), sizeof(header));
+        if (!RtAccelerationStructure::isSerializedDataCompatible(header))
+        {
+            logInfo("BLAS cache file '{}' is not compatible with the current driver or device. Rebuilding BLASes.", path);
+            return false;
+        }
+
+        logInfo("Loading BLASes from cache file '{}'.", path);
+
+        mBlasObjects.resize(mBlasData.size());
+
+        for (size_t blasGroupIndex = 0; blasGroupIndex < mBlasGroups.size(); blasGroupIndex++)
+        {
+            auto& group = mBlasGroups[blasGroupIndex];
+
+            // Lay out the serialized data and the deserialized BLASes of the group.
+            std::vector<uint64_t> serializedOffsets(group.blasIndices.size());
+            uint64_t serializedByteSize = 0;
+            group.finalByteSize = 0;
+            for (size_t i = 0; i < group.blasIndices.size(); i++)
+            {
+                const uint32_t blasId = group.blasIndices[i];
+                auto& blas = mBlasData[blasId];
+                std::memcpy(&header, blobs[blasId].data(), sizeof(header));
+
+                serializedOffsets[i] = serializedByteSize;
+                serializedByteSize += align_to(kAccelerationStructureByteAlignment, (uint64_t)blobs[blasId].size());
+
+                blas.blasByteSize = align_to(kAccelerationStructureByteAlignment, header.deserializedSizeInBytes);
+                blas.blasByteOffset = group.finalByteSize;
+                group.finalByteSize += blas.blasByteSize;
+            }
+
+            // Upload the serialized data.
+            std::vector<uint8_t> serializedData(serializedByteSize);
+            for (size_t i = 0; i < group.blasIndices.size(); i++)
+            {
+                const auto& blob = blobs[group.blasIndices[i]];
+                std::memcpy(serializedData.data() + serializedOffsets[i], blob.data(), blob.size());
+            }
+            Buffer::SharedPtr pSerialized = Buffer::create(serializedByteSize, Buffer::BindFlags::ShaderResource, Buffer::CpuAccess::None, serializedData.data());
+            pContext->resourceBarrier(pSerialized.get(), Resource::State::NonPixelShader);
+
+            auto& pBlas = group.pBlas;
+            if (pBlas == nullptr || pBlas->getSize() < group.finalByteSize)
+            {
+                pBlas = Buffer::create(group.finalByteSize, Buffer::BindFlags::AccelerationStructure, Buffer::CpuAccess::None);
+                pBlas->setName("Scene::mBlasGroups[" + std::to_string(blasGroupIndex) + "].pBlas");
+            }
+            else
+            {
+                pContext->uavBarrier(pBlas.get());
+            }
+
+            // Deserialize the BLASes to their final location.
+            for (size_t i = 0; i < group.blasIndices.size(); i++)
+            {
+                const uint32_t blasId = group.blasIndices[i];
+                const auto& blas = mBlasData[blasId];
+
+                RtAccelerationStructure::Desc blasDesc = {};
+                blasDesc.setBuffer(pBlas, blas.blasByteOffset, blas.blasByteSize);
+                blasDesc.setKind(RtAccelerationStructureKind::BottomLevel);
+                mBlasObjects[blasId] = RtAccelerationStructure::create(blasDesc);
+
+                pContext->deserializeAccelerationStructure(mBlasObjects[blasId].get(), pSerialized->getGpuAddress() + serializedOffsets[i]);
+            }
+
+            // Insert barrier. The BLAS buffer is now ready for use.
+            pContext->uavBarrier(pBlas.get());
+
+            logInfo("BLAS group " + std::to_string(blasGroupIndex) + " final size: " + formatByteSize(group.finalByteSize));
+        }
+
+        // Wait for the deserialization before the upload buffers are released.
+        pContext->flush(true);
+
+        return true;
+    }
+
+    void Scene::writeBlasCache(RenderContext* pContext)
+    {
+        FALCOR_ASSERT(mBlasObjects.size() == mBlasData.size());
+
+        std::vector<std::vector<uint8_t>> blobs(mBlasData.size());
+
+        for (const auto& group : mBlasGroups)
+        {
+            std::vector<uint64_t> serializedOffsets(group.blasIndices.size());
+            uint64_t serializedByteSize = 0;
+            for (size_t i = 0; i < group.blasIndices.size(); i++)
+            {
+                const auto& blas = mBlasData[group.blasIndices[i]];
+                if (blas.serializedByteSize == 0)
+                {
+                    logWarning("Serialized BLAS size is not available. Skipping writing the BLAS cache.");
+                    return;
+                }
+                serializedOffsets[i] = serializedByteSize;
+                serializedByteSize += align_to(kAccelerationStructureByteAlignment, blas.serializedByteSize);
+            }
+
+            // Serialize the BLASes of the group and read them back.
+            Buffer::SharedPtr pSerialized = Buffer::create(serializedByteSize, Buffer::BindFlags::UnorderedAccess, Buffer::CpuAccess::None);
+            pContext->resourceBarrier(pSerialized.get(), Resource::State::UnorderedAccess);
+            for (size_t i = 0; i < group.blasIndices.size(); i++)
+            {
+                pContext->serializeAccelerationStructure(pSerialized->getGpuAddress() + serializedOffsets[i], mBlasObjects[group.blasIndices[i]].get());
+            }
+            pContext->uavBarrier(pSerialized.get());
+
+            Buffer::SharedPtr pReadback = Buffer::create(serializedByteSize, ResourceBindFlags::None, Buffer::CpuAccess::Read);
+            pContext->copyResource(pReadback.get(), pSerialized.get());
+            pContext->flush(true);
+
+            const uint8_t* pData = reinterpret_cast<const uint8_t*>(pReadback->map(Buffer::MapType::Read));
+            for (size_t i = 0; i < group.blasIndices.size(); i++)
+            {
+                const uint32_t blasId = group.blasIndices[i];
+                RtSerializedAccelerationStructureHeader header;
+                std::memcpy(&header, pData + serializedOffsets[i], sizeof(header));
+                if (header.serializedSizeInBytesIncludingHeader < sizeof(header) || header.serializedSizeInBytesIncludingHeader > mBlasData[blasId].serializedByteSize)
+                {
+                    pReadback->unmap();
+                    logWarning("Unexpected serialized size of BLAS {}. Skipping writing the BLAS cache.", blasId);
+                    return;
+                }
+                blobs[blasId].assign(pData + serializedOffsets[i], pData + serializedOffsets[i] + header.serializedSizeInBytesIncludingHeader);
+            }
+            pReadback->unmap();
+        }
+
+        auto path = getBlasCachePath();
+        std::filesystem::create_directories(path.parent_path());
+
+        logInfo("Writing BLAS cache to '{}'.", path);
+
+        BinaryFileStream stream(path, BinaryFileStream::Mode::Write);
+        stream.write(kBlasCacheMagic, sizeof(kBlasCacheMagic));
+        stream << kBlasCacheVersion << (uint64_t)mBlasData.size();
+        for (size_t blasId = 0; blasId < mBlasData.size(); blasId++)
+        {
+            const auto& blas = mBlasData[blasId];
+            stream << blas.prebuildInfo.resultDataMaxSize << (uint32_t)blas.buildInputs.flags << (uint32_t)blas.geomDescs.size();
+            for (const auto& geomDesc : blas.geomDescs) stream << (uint32_t)geomDesc.flags;
+            stream << (uint64_t)blobs[blasId].size();
+            stream.write(blobs[blasId].data(), blobs[blasId].size());
+        }
+        if (stream.isFail())
+        {
+            logWarning("Failed to write BLAS cache file '{}'.", path);
+            stream.remove();
+        }
+    }
+
+    std::filesystem::path Scene::getBlasCachePath() const
+    {
+        FALCOR_ASSERT(mBlasCacheKey);
+
+        std::stringstream ss;
+        ss << std::hex << std::setfill('0');
+        for (auto c : *mBlasCacheKey) ss << std::setw(2) << (int)c;
+        return SceneCache::getCacheDirectory() / kBlasCacheDirectory / ss.str();
+    }
+
     void Scene::fillInstanceDesc(std::vector<RtInstanceDesc>& instanceDescs, uint32_t rayTypeCount, bool perMeshHitEntry) const
     {
         instanceDescs.clear();
@@ -3213,8 +3771,10 @@ namespace Falcor
             const auto& pBlas = mBlasGroups[mBlasData[i].blasGroupIndex].pBlas;
             FALCOR_ASSERT(pBlas);
 
+            const uint64_t blasAddress = pBlas->getGpuAddress() + mBlasData[i].blasByteOffset;
+
             RtInstanceDesc desc = {};
-            desc.accelerationStructure = pBlas->getGpuAddress() + mBlasData[i].blasByteOffset;
+            desc.accelerationStructure = blasAddress;
             desc.instanceMask = 0xFF;
             desc.instanceContributionToHitGroupIndex = perMeshHitEntry ? instanceContributionToHitGroupIndex : 0;
 
@@ -3286,6 +3846,13 @@ namespace Falcor
                     FALCOR_ASSERT(geometryIndex == mGeometryInstanceData[desc.instanceID + geometryIndex].geometryIndex);
                 }
 
+                // Instances disabled by instance culling or LOD selection are made inactive by using a null BLAS address.
+                // This keeps the instance indices unchanged, so no other scene data has to be updated.
+                FALCOR_ASSERT(mTlasInstanceActive.empty() || instanceDescs.size() < mTlasInstanceActive.size());
+                const bool isActive = mTlasInstanceActive.empty() || mTlasInstanceActive[instanceDescs.size()];
+                desc.accelerationStructure = isActive ? blasAddress : 0;
+                desc.instanceMask = isActive ? 0xFF : 0;
+
                 instanceDescs.push_back(desc);
             }
         }
@@ -3409,6 +3976,206 @@ namespace Falcor
         }
     }
 
+    void Scene::addInstanceLodChain(const std::vector<InstanceLodLevel>& levels)
+    {
+        if (levels.size() < 2) throw ArgumentError("Instance LOD chain needs at least two levels");
+
+        InstanceLodChain chain;
+        chain.levels = levels;
+
+        for (const auto& level : levels)
+        {
+            if (level.meshID.get() >= mMeshDesc.size()) throw ArgumentError("'meshID' ({}) is out of range", level.meshID);
+
+            auto it = std::find_if(mMeshGroups.begin(), mMeshGroups.end(), [&](const MeshGroup& group) {
+                return std::find(group.meshList.begin(), group.meshList.end(), level.meshID) != group.meshList.end();
+                });
+            FALCOR_ASSERT(it != mMeshGroups.end());
+            const uint32_t groupIndex = (uint32_t)std::distance(mMeshGroups.begin(), it);
+
+            if (it->isStatic) throw ArgumentError("Mesh {} belongs to a static mesh group and cannot be used as instance LOD", level.meshID);
+            if (std::find(chain.meshGroups.begin(), chain.meshGroups.end(), groupIndex) != chain.meshGroups.end())
+            {
+                throw ArgumentError("Instance LOD levels must belong to distinct mesh groups");
+            }
+            for (const auto& other : mInstanceLodChains)
+            {
+                if (std::find(other.meshGroups.begin(), other.meshGroups.end(), groupIndex) != other.meshGroups.end())
+                {
+                    throw ArgumentError("Mesh {} is already part of an instance LOD chain", level.meshID);
+                }
+            }
+            if (mMeshIdToInstanceIds[level.meshID.get()].size() != mMeshIdToInstanceIds[levels[0].meshID.get()].size())
+            {
+                throw ArgumentError("All instance LOD levels must have the same number of instances");
+            }
+
+            chain.meshGroups.push_back(groupIndex);
+        }
+
+        chain.selectedLevels.resize(mMeshIdToInstanceIds[levels[0].meshID.get()].size(), 0);
+        mInstanceLodChains.push_back(std::move(chain));
+        mInstanceLodChainsChanged = true;
+    }
+
+    void Scene::clearInstanceLodChains()
+    {
+        mInstanceLodChains.clear();
+        mInstanceLodChainsChanged = true;
+    }
+
+    bool Scene::isInstanceActive(uint32_t instanceID) const
+    {
+        if (instanceID >= mGeometryInstanceData.size()) throw ArgumentError("'instanceID' ({}) is out of range", instanceID);
+
+        const auto& instance = mGeometryInstanceData[instanceID];
+        const GeometryType type = instance.getType();
+        if (mTlasInstanceActive.empty() || (type != GeometryType::TriangleMesh && type != GeometryType::DisplacedTriangleMesh)) return true;
+
+        // Mesh instances are the first TLAS instances, see fillInstanceDesc().
+        FALCOR_ASSERT(instance.instanceIndex < mTlasInstanceActive.size());
+        return mTlasInstanceActive[instance.instanceIndex] != 0;
+    }
+
+    bool Scene::updateInstanceCulling(bool viewChanged)
+    {
+        const auto& settings = mInstanceCullingSettings;
+        const bool forceUpdate = settings != mPrevInstanceCullingSettings || mInstanceLodChainsChanged;
+        mPrevInstanceCullingSettings = settings;
+        mInstanceLodChainsChanged = false;
+
+        // Without culling and LOD chains all instances are active.
+        if (!settings.enabled && mInstanceLodChains.empty())
+        {
+            bool changed = !mTlasInstanceActive.empty();
+            mTlasInstanceActive.clear();
+            return changed;
+        }
+
+        // The active instances only depend on the view when culling is enabled.
+        if (!forceUpdate && !(settings.enabled && viewChanged)) return false;
+
+        FALCOR_PROFILE("updateInstanceCulling");
+
+        // Compute the first TLAS instance and object space bounds of each mesh group.
+        // The instances of the first mesh identify the TLAS instances of the group (see fillInstanceDesc()).
+        std::vector<AABB> groupBBs(mMeshGroups.size());
+        std::vector<uint32_t> tlasInstanceOffsets(mMeshGroups.size());
+        uint32_t tlasInstanceCount = 0;
+        for (size_t i = 0; i < mMeshGroups.size(); i++)
+        {
+            const auto& meshList = mMeshGroups[i].meshList;
+            FALCOR_ASSERT(!meshList.empty());
+            for (auto meshID : meshList) groupBBs[i] |= mMeshBBs[meshID.get()];
+
+            tlasInstanceOffsets[i] = tlasInstanceCount;
+            tlasInstanceCount += (uint32_t)mMeshIdToInstanceIds[meshList[0].get()].size();
+        }
+
+        std::vector<uint8_t> prevActive = std::move(mTlasInstanceActive);
+        if (prevActive.size() != tlasInstanceCount) prevActive.assign(tlasInstanceCount, 1);
+        std::vector<uint8_t> active(tlasInstanceCount, 1);
+
+        const auto& pCamera = getCamera();
+        const float3 cameraPos = pCamera->getPosition();
+        const float tanHalfFovY = std::tan(0.5f * focalLengthToFovY(pCamera->getFocalLength(), pCamera->getFrameHeight()));
+        const float hysteresis = forceUpdate ? 0.f : settings.hysteresis;
+        const auto& globalMatrices = mpAnimationController->getGlobalMatrices();
+
+        struct InstanceView
+        {
+            AABB bounds;        ///< World space bounds.
+            float distance;     ///< Distance from the camera to the bounds.
+            float screenSize;   ///< Projected bounding sphere diameter relative to the frame height.
+        };
+
+        auto getInstanceView = [&](uint32_t groupIndex, uint32_t instanceIdx)
+        {
+            InstanceView view;
+            const auto& group = mMeshGroups[groupIndex];
+            const uint32_t instanceID = mMeshIdToInstanceIds[group.meshList[0].get()][instanceIdx];
+
+            // Static groups are pre-transformed to world space.
+            view.bounds = group.isStatic ? groupBBs[groupIndex] : groupBBs[groupIndex].transform(globalMatrices[mGeometryInstanceData[instanceID].globalMatrixID]);
+
+            const float3 d = glm::max(float3(0.f), glm::max(view.bounds.minPoint - cameraPos, cameraPos - view.bounds.maxPoint));
+            view.distance = glm::length(d);
+
+            const float radius = 0.5f * glm::length(view.bounds.extent());
+            const float centerDistance = glm::length(view.bounds.center() - cameraPos);
+            view.screenSize = centerDistance > radius ? radius / (centerDistance * tanHalfFovY) : std::numeric_limits<float>::max();
+            return view;
+        };
+
+        // Visible instances have to fail a test by the hysteresis margin before they are culled.
+        auto isCulled = [&](const InstanceView& view, bool wasActive)
+        {
+            const float h = wasActive ? hysteresis : 0.f;
+            if (settings.maxDistance > 0.f && view.distance > settings.maxDistance * (1.f + h)) return true;
+            if (settings.minScreenSize > 0.f && view.screenSize < settings.minScreenSize * (1.f - h)) return true;
+            if (settings.frustumCulling)
+            {
+                const float3 margin(h * view.distance * tanHalfFovY);
+                if (pCamera->isObjectCulled(AABB(view.bounds.minPoint - margin, view.bounds.maxPoint + margin))) return true;
+            }
+            return false;
+        };
+
+        // Cull instances of LOD chains and select their levels.
+        std::vector<bool> isLodGroup(mMeshGroups.size(), false);
+        for (auto& chain : mInstanceLodChains)
+        {
+            for (uint32_t groupIndex : chain.meshGroups) isLodGroup[groupIndex] = true;
+
+            const uint32_t levelCount = (uint32_t)chain.levels.size();
+            for (uint32_t instanceIdx = 0; instanceIdx < (uint32_t)chain.selectedLevels.size(); instanceIdx++)
+            {
+                uint32_t level = 0;
+                bool visible = true;
+
+                if (settings.enabled)
+                {
+                    // Level 0 defines the bounds of the instance.
+                    const InstanceView view = getInstanceView(chain.meshGroups[0], instanceIdx);
+                    const uint32_t prevLevel = chain.selectedLevels[instanceIdx];
+
+                    // Switch to a finer level if the instance grew sufficiently, or to a coarser level if it shrank sufficiently.
+                    level = forceUpdate ? 0 : prevLevel;
+                    while (level > 0 && view.screenSize >= chain.levels[level - 1].minScreenSize * (1.f + hysteresis)) level--;
+                    while (level + 1 < levelCount && view.screenSize < chain.levels[level].minScreenSize * (1.f - hysteresis)) level++;
+
+                    visible = !isCulled(view, prevActive[tlasInstanceOffsets[chain.meshGroups[prevLevel]] + instanceIdx]);
+                }
+
+                chain.selectedLevels[instanceIdx] = level;
+                for (uint32_t l = 0; l < levelCount; l++)
+                {
+                    active[tlasInstanceOffsets[chain.meshGroups[l]] + instanceIdx] = visible && l == level;
+                }
+            }
+        }
+
+        // Cull all other mesh instances.
+        if (settings.enabled)
+        {
+            for (uint32_t groupIndex = 0; groupIndex < (uint32_t)mMeshGroups.size(); groupIndex++)
+            {
+                if (isLodGroup[groupIndex]) continue;
+
+                const uint32_t offset = tlasInstanceOffsets[groupIndex];
+                const uint32_t instanceCount = (uint32_t)mMeshIdToInstanceIds[mMeshGroups[groupIndex].meshList[0].get()].size();
+                for (uint32_t instanceIdx = 0; instanceIdx < instanceCount; instanceIdx++)
+                {
+                    active[offset + instanceIdx] = !isCulled(getInstanceView(groupIndex, instanceIdx), prevActive[offset + instanceIdx]);
+                }
+            }
+        }
+
+        bool changed = active != prevActive;
+        mTlasInstanceActive = std::move(active);
+        return changed;
+    }
+
     void Scene::buildTlas(RenderContext* pContext, uint32_t rayTypeCount, bool perMeshHitEntry)
     {
         FALCOR_PROFILE("buildTlas");
@@ -3755,6 +4522,10 @@ namespace Falcor
 
         // Render settings.
         c += ScriptWriter::makeSetProperty(sceneVar, kRenderSettings, mRenderSettings);
+        if (mInstanceCullingSettings != InstanceCullingSettings())
+        {
+            c += ScriptWriter::makeSetProperty(sceneVar, kInstanceCulling, mInstanceCullingSettings);
+        }
 
         // Animations.
         if (hasAnimation() && !isAnimated())
@@ -3802,6 +4573,18 @@ namespace Falcor
         mpAnimationController->setNodeEdited(nodeID);
     }
 
+    pybind11::dict Scene::BlasMeshGroupStats::toPython() const
+    {
+        pybind11::dict d;
+        d["meshCount"] = meshCount;
+        d["triangleCount"] = triangleCount;
+        d["instanceCount"] = instanceCount;
+        d["surfaceArea"] = surfaceArea;
+        d["sahCost"] = sahCost;
+        d["overlapArea"] = overlapArea;
+        return d;
+    }
+
     pybind11::dict Scene::SceneStats::toPython() const
     {
         pybind11::dict d;
@@ -3857,9 +4640,16 @@ namespace Falcor
         d["blasOpaqueGeometryCount"] = blasOpaqueGeometryCount;
         d["blasMemoryInBytes"] = blasMemoryInBytes;
         d["blasScratchMemoryInBytes"] = blasScratchMemoryInBytes;
+        d["blasTransientScratchMemoryInBytes"] = blasTransientScratchMemoryInBytes;
+        d["blasSAHCost"] = blasSAHCost;
+        d["blasOverlapRatio"] = blasOverlapRatio;
+        pybind11::list blasMeshGroupList;
+        for (const auto& g : blasMeshGroups) blasMeshGroupList.append(g.toPython());
+        d["blasMeshGroups"] = blasMeshGroupList;
         d["tlasCount"] = tlasCount;
         d["tlasMemoryInBytes"] = tlasMemoryInBytes;
         d["tlasScratchMemoryInBytes"] = tlasScratchMemoryInBytes;
+        d["tlasInactiveInstanceCount"] = tlasInactiveInstanceCount;
 
         // Light stats
         d["activeLightCount"] = activeLightCount;
@@ -3883,6 +4673,13 @@ namespace Falcor
         d["gridVoxelCount"] = gridVoxelCount;
         d["gridMemoryInBytes"] = gridMemoryInBytes;
 
+        // Displacement stats
+        d["displacedMeshCount"] = displacedMeshCount;
+        d["displacedMeshUpdateCount"] = displacedMeshUpdateCount;
+
+        // Upload stats
+        d["uploadedBytes"] = uploadedBytes;
+
         return d;
     }
 
@@ -3892,7 +4689,7 @@ namespace Falcor
 
         pybind11::class_<Scene, Scene::SharedPtr> scene(m, "Scene");
 
-        scene.def_property_readonly(kStats.c_str(), [](const Scene* pScene) { return pScene->getSceneStats().toPython(); });
+        scene.def_property_readonly(kStats.c_str(), [](Scene* pScene) { pScene->updateBlasOverlapStats(); return pScene->getSceneStats().toPython(); });
         scene.def_property_readonly(kBounds.c_str(), &Scene::getSceneBounds, pybind11::return_value_policy::copy);
         scene.def_property(kCamera.c_str(), &Scene::getCamera, &Scene::setCamera);
         scene.def_property(kEnvMap.c_str(), &Scene::getEnvMap, &Scene::setEnvMap);
@@ -3906,6 +4703,14 @@ namespace Falcor
         scene.def_property(kAnimated.c_str(), &Scene::isAnimated, &Scene::setIsAnimated);
         scene.def_property(kLoopAnimations.c_str(), &Scene::isLooped, &Scene::setIsLooped);
         scene.def_property(kRenderSettings.c_str(), pybind11::overload_cast<>(&Scene::getRenderSettings, pybind11::const_), &Scene::setRenderSettings);
+        scene.def_property(kInstanceCulling.c_str(), &Scene::getInstanceCullingSettings, &Scene::setInstanceCullingSettings);
+        scene.def(kAddInstanceLodChain.c_str(), [](Scene* pScene, const std::vector<uint32_t>& meshIDs, const std::vector<float>& minScreenSizes) {
+            if (meshIDs.size() != minScreenSizes.size()) throw ArgumentError("'meshIDs' and 'minScreenSizes' must have the same length");
+            std::vector<Scene::InstanceLodLevel> levels(meshIDs.size());
+            for (size_t i = 0; i < levels.size(); i++) levels[i] = { MeshID{ meshIDs[i] }, minScreenSizes[i] };
+            pScene->addInstanceLodChain(levels);
+            }, "meshIDs"_a, "minScreenSizes"_a);
+        scene.def(kClearInstanceLodChains.c_str(), &Scene::clearInstanceLodChains);
         scene.def_property(kUpdateCallback.c_str(), &Scene::getUpdateCallback, &Scene::setUpdateCallback);
 
         scene.def(kSetEnvMap.c_str(), &Scene::loadEnvMap, "path"_a);
@@ -3935,5 +4740,15 @@ namespace Falcor
         renderSettings.field(useEmissiveLights);
         renderSettings.field(useGridVolumes);
 #undef field
+
+        // InstanceCullingSettings
+        ScriptBindings::SerializableStruct<Scene::InstanceCullingSettings> instanceCulling(m, "SceneInstanceCullingSettings");
+#define field(f_) field(#f_, &Scene::InstanceCullingSettings::f_)
+        instanceCulling.field(enabled);
+        instanceCulling.field(frustumCulling);
+        instanceCulling.field(maxDistance);
+        instanceCulling.field(minScreenSize);
+        instanceCulling.field(hysteresis);
+#undef field
     }
 }
@@ -46,6 +46,8 @@
 #include "Core/Macros.h"
 #include "Core/API/VAO.h"
 #include "Core/API/RtAccelerationStructure.h"
+#include "Utils/CryptoUtils.h"
+#include "Utils/DirtyRangeTracker.h"
 #include "Utils/Math/AABB.h"
 #include "Utils/Math/Vector.h"
 #include "Utils/Math/Matrix.h"
@@ -242,6 +244,41 @@ namespace Falcor
 
         static_assert(std::is_trivially_copyable<RenderSettings>() , "RenderSettings needs to be trivially copyable");
 
+        /** Settings for culling mesh instances and selecting instance LODs before building the TLAS.
+            Culled instances are kept in the TLAS as inactive instances so that instance indices are unaffected.
+            Culling is evaluated against the selected camera and only affects ray tracing, rasterization draws all instances.
+            Note that culled instances are also invisible to secondary rays, so culling should be disabled for reference renders.
+        */
+        struct InstanceCullingSettings
+        {
+            bool enabled = false;           ///< Enable instance culling and LOD selection.
+            bool frustumCulling = true;     ///< Cull instances outside the view frustum.
+            float maxDistance = 0.f;        ///< Cull instances farther away from the camera than this distance. Zero disables distance culling.
+            float minScreenSize = 0.f;      ///< Cull instances with a projected bounding sphere diameter smaller than this fraction of the frame height.
+            float hysteresis = 0.1f;        ///< Relative margin by which a visible instance has to fail a test before it is culled or switches LOD. Avoids TLAS rebuilds on small camera movements.
+
+            bool operator==(const InstanceCullingSettings& other) const
+            {
+                return (enabled == other.enabled) &&
+                    (frustumCulling == other.frustumCulling) &&
+                    (maxDistance == other.maxDistance) &&
+                    (minScreenSize == other.minScreenSize) &&
+                    (hysteresis == other.hysteresis);
+            }
+
+            bool operator!=(const InstanceCullingSettings& other) const { return !(*this == other); }
+        };
+
+        static_assert(std::is_trivially_copyable<InstanceCullingSettings>() , "InstanceCullingSettings needs to be trivially copyable");
+
+        /** Describes one level of an instance LOD chain.
+        */
+        struct InstanceLodLevel
+        {
+            MeshID meshID;                  ///< Mesh representing this level. All meshes in the same mesh group are switched together.
+            float minScreenSize = 0.f;      ///< Minimum projected screen size (fraction of the frame height) at which this level is used.
+        };
+
         /** Optional importer-provided rendering metadata
          */
         struct Metadata
@@ -324,6 +361,8 @@ namespace Falcor
             std::vector<uint32_t> meshIndexData;                    ///< Vertex indices for all meshes in either 32-bit or 16-bit format packed tightly, decided per mesh.
             std::vector<PackedStaticVertexData> meshStaticData;     ///< Vertex attributes for all meshes in packed format.
             std::vector<SkinningVertexData> meshSkinningData;       ///< Additional vertex attributes for skinned meshes.
+            Buffer::SharedPtr pMeshIndexBuffer;                     ///< GPU index buffer for all meshes if the data was streamed to the GPU by the scene builder. 'meshIndexData' is empty in that case.
+            Buffer::SharedPtr pMeshStaticBuffer;                    ///< GPU vertex buffer for all meshes if the data was streamed to the GPU by the scene builder. 'meshStaticData' is empty in that case.
 
             // Curve data
             std::vector<CurveDesc> curveDesc;                       ///< List of curve descriptors.
@@ -345,6 +384,22 @@ namespace Falcor
             std::vector<AABB> customPrimitiveAABBs;                 ///< List of AABBs for custom primitives in world space. Each custom primitive consists of one AABB.
         };
 
+        /** Spatial statistics of a mesh group BLAS, evaluated over all its TLAS instances in world space.
+        */
+        struct BlasMeshGroupStats
+        {
+            uint64_t meshCount = 0;                     ///< Number of meshes in the group.
+            uint64_t triangleCount = 0;                 ///< Number of triangles in the group.
+            uint64_t instanceCount = 0;                 ///< Number of TLAS instances of the group.
+            double surfaceArea = 0.0;                   ///< Summed bounding box surface area of the instances.
+            double sahCost = 0.0;                       ///< SAH cost of the instances, i.e., sum of area(instance) / area(scene) * triangleCount.
+            double overlapArea = 0.0;                   ///< Summed surface area of the intersections between the instance bounds and the bounds of other instances. Only valid after updateBlasOverlapStats().
+
+            /** Convert to python dict.
+            */
+            pybind11::dict toPython() const;
+        };
+
         /** Statistics.
         */
         struct SceneStats
@@ -394,9 +449,14 @@ namespace Falcor
             uint64_t blasOpaqueGeometryCount = 0;       ///< Number of geometries that are opaque.
             uint64_t blasMemoryInBytes = 0;             ///< Total memory in bytes used by the BLASes.
             uint64_t blasScratchMemoryInBytes = 0;      ///< Additional memory in bytes kept around for BLAS updates etc.
+            uint64_t blasTransientScratchMemoryInBytes = 0; ///< Scratch memory in bytes used temporarily during the last full BLAS build. Released after the build.
+            double blasSAHCost = 0.0;                   ///< Summed SAH cost of all mesh BLAS instances, i.e., sum of area(instance) / area(scene) * triangleCount.
+            double blasOverlapRatio = 0.0;              ///< Summed overlap area between mesh BLAS instances relative to their total surface area. Only valid after updateBlasOverlapStats().
+            std::vector<BlasMeshGroupStats> blasMeshGroups; ///< Spatial stats per mesh group BLAS.
             uint64_t tlasCount = 0;                     ///< Number of TLASes.
             uint64_t tlasMemoryInBytes = 0;             ///< Total memory in bytes used by the TLASes.
             uint64_t tlasScratchMemoryInBytes = 0;      ///< Additional memory in bytes kept around for TLAS updates etc.
+            uint64_t tlasInactiveInstanceCount = 0;     ///< Number of TLAS instances disabled by instance culling or LOD selection.
 
             // Light stats
             uint64_t activeLightCount = 0;              ///< Number of active lights.
@@ -420,6 +480,13 @@ namespace Falcor
             uint64_t gridVoxelCount = 0;                ///< Total number of voxels in all grids.
             uint64_t gridMemoryInBytes = 0;             ///< Total memory in bytes used by the grids.
 
+            // Displacement stats
+            uint64_t displacedMeshCount = 0;            ///< Number of meshes using displacement mapping.
+            uint64_t displacedMeshUpdateCount = 0;      ///< Number of displaced meshes whose AABBs were updated by the last scene update.
+
+            // Upload stats
+            uint64_t uploadedBytes = 0;                 ///< Number of bytes uploaded to the scene buffers by the last scene update.
+
             /** Get the total memory usage.
             */
             uint64_t getTotalMemory() const
@@ -484,6 +551,12 @@ namespace Falcor
         */
         const SceneStats& getSceneStats() const { return mSceneStats; }
 
+        /** Evaluate the BLAS overlap stats (SceneStats::blasOverlapRatio and BlasMeshGroupStats::overlapArea).
+            These are expensive for large scenes and are therefore not updated with the other stats, but on demand.
+            The result is cached until the BLASes change.
+        */
+        void updateBlasOverlapStats();
+
         /** Get the render settings.
         */
         const RenderSettings& getRenderSettings() const { return mRenderSettings; }
@@ -496,6 +569,34 @@ namespace Falcor
         */
         void setRenderSettings(const RenderSettings& renderSettings) { mRenderSettings = renderSettings; }
 
+        /** Get the instance culling settings.
+        */
+        const InstanceCullingSettings& getInstanceCullingSettings() const { return mInstanceCullingSettings; }
+
+        /** Set the instance culling settings.
+        */
+        void setInstanceCullingSettings(const InstanceCullingSettings& settings) { mInstanceCullingSettings = settings; }
+
+        /** Add a chain of LOD alternatives for mesh instances.
+            Each level is represented by a mesh, ordered from the finest to the coarsest level with decreasing minimum screen size.
+            The mesh groups of all levels must be distinct, non-static and have the same number of instances,
+            where instance i of each level represents the same object. Level 0 defines the bounds used for LOD selection.
+            When instance culling is disabled, only level 0 is put into the TLAS.
+            \param[in] levels LOD levels.
+        */
+        void addInstanceLodChain(const std::vector<InstanceLodLevel>& levels);
+
+        /** Remove all instance LOD chains.
+        */
+        void clearInstanceLodChains();
+
+        /** Check if a geometry instance is active in the TLAS after instance culling and LOD selection.
+            The state is updated by update(). Only mesh instances can be inactive.
+            \param[in] instanceID Geometry instance ID.
+            \return True if the instance is put into the TLAS with a valid BLAS.
+        */
+        bool isInstanceActive(uint32_t instanceID) const;
+
         /** Returns true if environment map is available and should be used as the background.
         */
         bool useEnvBackground() const;
@@ -911,6 +1012,16 @@ namespace Falcor
         */
         UpdateMode getBlasUpdateMode() { return mBlasUpdateMode; }
 
+        /** Enable caching of the BLASes across application runs.
+            Only scenes where all BLASes are static are cached. The serialized BLASes are stored in the scene cache directory,
+            and are deserialized instead of built if the driver and device match. Otherwise the BLASes are built as usual.
+            The cache is only used for the first BLAS build, as later rebuilds are due to changed geometry.
+            Cache entries are keyed by the scene cache key and the adapter and driver identity, caching is disabled if the device cannot provide one.
+            \param[in] key Scene cache key.
+            \param[in] readCache If true, load the BLASes from an existing cache. Otherwise the cache is rewritten after the build.
+        */
+        void setBlasCache(const SHA1::MD& key, bool readCache);
+
         /** Update the scene. Call this once per frame to update the camera location, animations, etc.
             \param[in] pContext
             \param[in] currentTime The current time in seconds
@@ -1069,12 +1180,16 @@ namespace Falcor
     private:
         friend class AnimationController;
         friend class AnimatedVertexCache;
+        friend class SceneBuilder;
 
         static constexpr uint32_t kStaticDataBufferIndex = 0;
         static constexpr uint32_t kDrawIdBufferIndex = kStaticDataBufferIndex + 1;
         static constexpr uint32_t kVertexBufferCount = kDrawIdBufferIndex + 1;
 
-        void createMeshVao(uint32_t drawCount, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData, const std::vector<SkinningVertexData>& skinningData);
+        static Buffer::SharedPtr createMeshIndexBuffer(size_t indexCount);
+        static Buffer::SharedPtr createMeshStaticBuffer(size_t vertexCount);
+
+        void createMeshVao(uint32_t drawCount, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData, Buffer::SharedPtr pIB, Buffer::SharedPtr pStaticBuffer);
         void createCurveVao(const std::vector<uint32_t>& indexData, const std::vector<StaticCurveVertexData>& staticData);
 
         Shader::DefineList getSceneSDFGridDefines() const;
@@ -1135,6 +1250,22 @@ namespace Falcor
         */
         void buildBlas(RenderContext* pContext);
 
+        /** Check if the BLASes can be written to the BLAS cache, i.e., none of them is ever updated.
+        */
+        bool isBlasCacheable() const;
+
+        /** Load all BLASes from the BLAS cache into their final location.
+            Must be called after the BLAS groups have been computed.
+            \return True if the BLASes were loaded, false if the cache is missing or incompatible.
+        */
+        bool readBlasCache(RenderContext* pContext);
+
+        /** Serialize all BLASes and write them to the BLAS cache.
+        */
+        void writeBlasCache(RenderContext* pContext);
+
+        std::filesystem::path getBlasCachePath() const;
+
         /** Generate data for creating a TLAS.
             #SCENE TODO: Add argument to build descs based off a draw list.
         */
@@ -1149,6 +1280,12 @@ namespace Falcor
         */
         void invalidateTlasCache();
 
+        /** Update which mesh instances are active in the TLAS based on the instance culling settings and LOD chains.
+            \param[in] viewChanged True if the camera or geometry moved since the last update.
+            \return True if the set of active instances changed.
+        */
+        bool updateInstanceCulling(bool viewChanged);
+
         /** Check whether scene has an index buffer.
         */
         bool hasIndexBuffer() const { return mpMeshVao && mpMeshVao->getIndexBuffer() != nullptr; }
@@ -1198,6 +1335,7 @@ namespace Falcor
         GeometryTypeFlags mGeometryTypes;                           ///< Set of geometry types that exist in the scene.
 
         std::vector<GeometryInstanceData> mGeometryInstanceData;    ///< Geometry instance data (for all types of geometry).
+        DirtyRangeTracker mGeometryInstanceDirtyRanges;             ///< Modified elements of mGeometryInstanceData not yet uploaded.
 
         bool mUseCompressedHitInfo = false;                         ///< True if scene should used compressed HitInfo (on scenes with triangles meshes only).
         bool mHas16BitIndices = false;                              ///< True if any meshes use 16-bit indices.
@@ -1217,11 +1355,12 @@ namespace Falcor
         // Displacement mapping.
         struct
         {
-            bool needsUpdate = true;                                ///< True if displacement data has changed and a AABB update is required.
             struct DisplacementMeshData { uint32_t AABBOffset = 0; uint32_t AABBCount = 0; };
             std::vector<DisplacementMeshData> meshData;             ///< List of displacement mesh data (reference to AABBs).
+            std::vector<bool> dirtyMeshes;                          ///< Per mesh flag set if the displacement parameters or geometry changed and the AABBs need an update. Indexed by mesh ID.
             std::vector<DisplacementUpdateTask> updateTasks;        ///< List of displacement AABB update tasks.
             Buffer::SharedPtr pUpdateTasksBuffer;                   ///< GPU Buffer with list of displacement AABB update tasks.
+            Buffer::SharedPtr pDirtyTaskIndicesBuffer;              ///< GPU Buffer with the indices of the update tasks to run in the next update.
             ComputePass::SharedPtr pUpdatePass;                     ///< Comput epass to update displacement AABB data.
             Buffer::SharedPtr pAABBBuffer;                          ///< GPU Buffer of raw displacement AABB data. Used for acceleration structure creation, and bound to the Scene for access in shaders.
         } mDisplacement;
@@ -1247,6 +1386,7 @@ namespace Falcor
 
         // The following array and buffer records the AABBs of all procedural primitives, including custom primitives, curves, etc.
         std::vector<RtAABB> mRtAABBRaw;                             ///< Raw AABB data (min, max) for all procedural primitives.
+        DirtyRangeTracker mRtAABBDirtyRanges;                       ///< Modified elements of mRtAABBRaw not yet uploaded.
         Buffer::SharedPtr mpRtAABBBuffer;                           ///< GPU Buffer of raw AABB data. Used for acceleration structure creation, and bound to the Scene for access in shaders.
 
         // Materials
@@ -1255,7 +1395,11 @@ namespace Falcor
         // Lights
         std::vector<Light::SharedPtr> mLights;                      ///< All analytic lights. Note that not all may be active.
         std::vector<Light::SharedPtr> mActiveLights;                ///< All active analytic lights.
+        std::vector<LightData> mActiveLightData;                    ///< CPU copy of the light data of all active analytic lights.
+        DirtyRangeTracker mActiveLightDirtyRanges;                  ///< Modified elements of mActiveLightData not yet uploaded.
         std::vector<GridVolume::SharedPtr> mGridVolumes;            ///< All loaded grid volumes.
+        std::vector<GridVolumeData> mGridVolumeData;                ///< CPU copy of the grid volume data.
+        DirtyRangeTracker mGridVolumeDirtyRanges;                   ///< Modified elements of mGridVolumeData not yet uploaded.
         std::vector<Grid::SharedPtr> mGrids;                        ///< All loaded grids.
         std::unordered_map<Grid::SharedPtr, SdfGridID> mGridIDs;    ///< Lookup table for grid IDs.
         LightCollection::SharedPtr mpLightCollection;               ///< Class for managing emissive geometry. This is created lazily upon first use.
@@ -1313,6 +1457,7 @@ namespace Falcor
         std::map<RasterizerState::CullMode, RasterizerState::SharedPtr> mFrontClockwiseRS;
         std::map<RasterizerState::CullMode, RasterizerState::SharedPtr> mFrontCounterClockwiseRS;
         UpdateFlags mUpdates = UpdateFlags::All;
+        uint64_t mUploadedBytes = 0;                                ///< Number of bytes uploaded to the scene buffers by the current scene update.
         AnimationController::UniquePtr mpAnimationController;
 
         // Raytracing data
@@ -1334,6 +1479,19 @@ namespace Falcor
         Buffer::SharedPtr mpTlasScratch;                    ///< Scratch buffer used for TLAS builds. Can be shared as long as instance desc count is the same, which for now it is.
         RtAccelerationStructurePrebuildInfo mTlasPrebuildInfo; ///< This can be reused as long as the number of instance descs doesn't change.
 
+        struct InstanceLodChain
+        {
+            std::vector<InstanceLodLevel> levels;
+            std::vector<uint32_t> meshGroups;               ///< Mesh group index per level.
+            std::vector<uint32_t> selectedLevels;           ///< Currently selected level per instance.
+        };
+
+        InstanceCullingSettings mInstanceCullingSettings;   ///< Instance culling settings.
+        InstanceCullingSettings mPrevInstanceCullingSettings;
+        std::vector<InstanceLodChain> mInstanceLodChains;   ///< Instance LOD chains.
+        bool mInstanceLodChainsChanged = false;             ///< Flag indicating that LOD chains were added/removed since last update.
+        std::vector<uint8_t> mTlasInstanceActive;           ///< Active flag per mesh TLAS instance. Empty if all instances are active.
+
         /** Describes one BLAS.
         */
         struct BlasData
@@ -1348,11 +1506,13 @@ namespace Falcor
             uint64_t resultByteOffset = 0;                  ///< Offset into the BLAS result buffer.
             uint64_t scratchByteSize = 0;                   ///< Maximum scratch data size for the BLAS build, including padding.
             uint64_t scratchByteOffset = 0;                 ///< Offset into the BLAS scratch buffer.
+            uint64_t updateScratchByteOffset = 0;           ///< Offset into the persistent BLAS update scratch buffer. Only valid if the BLAS is updated.
 
             uint64_t blasByteSize = 0;                      ///< Size of the final BLAS post-compaction, including padding.
             uint64_t blasByteOffset = 0;                    ///< Offset into the final BLAS buffer.
+            uint64_t serializedByteSize = 0;                ///< Maximum size of the serialized BLAS. Only valid when writing the BLAS cache.
 
-            bool hasProceduralPrimitives = false;           ///< True if the BLAS contains procedural primitives. Otherwise it is triangles.
+            bool hasProceduralPrimitives = false;           ///< True if the BLAS contains procedural primitives, including displaced meshes. Otherwise it is triangles.
             bool hasDynamicMesh = false;                    ///< Whether the BLAS contains a skinned or vertex-animated mesh, which means the BLAS may need to be updated.
             bool hasDynamicCurve = false;                   ///< Whether the BLAS contains an animated curve cache, which means the BLAS may need to be updated.
             bool useCompaction = false;                     ///< Whether the BLAS should be compacted after build.
@@ -1362,6 +1522,13 @@ namespace Falcor
             {
                 return hasDynamicMesh || hasDynamicCurve;
             }
+
+            /** Check if the BLAS may be updated or rebuilt after the initial build.
+            */
+            bool isUpdatable() const
+            {
+                return hasProceduralPrimitives || hasDynamicGeometry();
+            }
         };
 
         /** Describes a group of BLASes.
@@ -1372,6 +1539,7 @@ namespace Falcor
 
             uint64_t resultByteSize = 0;                    ///< Maximum result data size for all BLASes in the group, including padding.
             uint64_t scratchByteSize = 0;                   ///< Maximum scratch data size for all BLASes in the group, including padding.
+            uint64_t updateScratchByteSize = 0;             ///< Scratch data size for all updatable BLASes in the group, including padding.
             uint64_t finalByteSize = 0;                     ///< Size of the final BLASes in the group post-compaction, including padding.
 
             Buffer::SharedPtr pBlas;                        ///< Buffer containing all final BLASes in the group.
@@ -1381,10 +1549,16 @@ namespace Falcor
         std::vector<RtAccelerationStructure::SharedPtr> mBlasObjects; ///< BLAS API objects.
         std::vector<BlasData> mBlasData;                    ///< All data related to the scene's BLASes.
         std::vector<BlasGroup> mBlasGroups;                 ///< BLAS group data.
-        Buffer::SharedPtr mpBlasScratch;                    ///< Scratch buffer used for BLAS builds.
+        Buffer::SharedPtr mpBlasUpdateScratch;              ///< Scratch buffer used for BLAS updates. Only sized for the updatable BLASes, the initial build uses a transient scratch buffer.
+        uint64_t mBlasTransientScratchByteSize = 0;         ///< Size of the transient scratch buffer used for the last full BLAS build.
+        struct BlasInstanceBounds { AABB bounds; uint32_t groupIndex; };
+        std::vector<BlasInstanceBounds> mBlasInstanceBounds; ///< World space bounds of the mesh group BLAS instances, used for the overlap stats.
+        bool mBlasOverlapStatsValid = false;                ///< True if the BLAS overlap stats are up to date.
         Buffer::SharedPtr mpBlasStaticWorldMatrices;        ///< Object-to-world transform matrices in row-major format. Only valid for static meshes.
         bool mBlasDataValid = false;                        ///< Flag to indicate if the BLAS data is valid. This will be reset when geometry is changed.
         bool mRebuildBlas = true;                           ///< Flag to indicate BLASes need to be rebuilt.
+        std::optional<SHA1::MD> mBlasCacheKey;              ///< Key of the BLAS cache, or empty if BLASes are not cached.
+        bool mReadBlasCache = false;                        ///< Flag to indicate BLASes should be loaded from the BLAS cache.
 
         std::filesystem::path mPath;
         bool mFinalized = false;                            ///< True if scene is ready to be bound to the GPU.
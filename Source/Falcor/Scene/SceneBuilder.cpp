@@ -30,14 +30,22 @@
 #include "Importer.h"
 #include "Curves/CurveConfig.h"
 #include "Material/StandardMaterial.h"
+#include "Core/API/Device.h"
 #include "Utils/Logger.h"
+#include "Utils/StringUtils.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Image/TextureAnalyzer.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Math/MathHelpers.h"
+#include "Utils/Geometry/MeshOptimizer.h"
+#include "Utils/ChunkedBufferUploader.h"
+#include "Utils/NumericRange.h"
 #include <mikktspace.h>
+#include <array>
+#include <execution>
 #include <filesystem>
+#include <future>
 #include <cmath>
 
 namespace Falcor
@@ -48,6 +56,9 @@ namespace Falcor
         // The target is max 16M triangles per BLAS (= approx 0.5GB post-compaction). Note that this is not a strict limit.
         const size_t kMaxTrianglesPerBLAS = 1ull << 24;
 
+        // Number of bins per axis used when evaluating the SAH for mesh group splits.
+        const uint32_t kSAHBinCount = 16;
+
         // Texture coordinates for textured emissive materials are quantized for performance reasons.
         // We'll log a warning if the maximum quantization error exceeds this value.
         const float kMaxTexelError = 0.5f;
@@ -240,6 +251,7 @@ namespace Falcor
             try
             {
                 pBuilder->mpScene = Scene::create(SceneCache::readCache(pBuilder->mSceneCacheKey));
+                pBuilder->mpScene->setBlasCache(pBuilder->mSceneCacheKey, true);
                 return pBuilder;
             }
             catch (const std::exception& e)
@@ -286,29 +298,63 @@ namespace Falcor
         // or makes sure that normal maps are removed if displacement is in use.
         prepareDisplacementMaps();
 
+        // Mark displaced meshes. The geometry stages below need to know which meshes are displaced (see createMeshGroups()),
+        // so the flags are read from the materials here, before the material optimization starts modifying them.
+        for (auto& mesh : mMeshes)
+        {
+            mesh.isDisplaced = mSceneData.pMaterials->getMaterial(mesh.materialId)->isDisplaced();
+        }
+
+        // Material optimization and volume grid collection do not depend on the geometry post-processing
+        // and are run concurrently with it. The material optimization runs texture analysis on the GPU.
+        // The geometry stages below are CPU only and must not access the material system until the material task
+        // has finished, as it modifies the materials and their dirty state.
+        // The tasks are timed separately as their time overlaps with the geometry stages.
+        double materialTime = 0.0;
+        auto materialTask = std::async(std::launch::async, [this, &materialTime]() {
+            auto startTime = CpuTimer::getCurrentTimePoint();
+            optimizeMaterials();
+            materialTime = CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint()) * 1e-3;
+        });
+        auto volumeTask = std::async(std::launch::async, [this]() { collectVolumeGrids(); });
+
         prepareSceneGraph();
         prepareMeshes();
         removeUnusedMeshes();
+        timeReport.measure("Preparing meshes");
         flattenStaticMeshInstances();
+        timeReport.measure("Flattening instances");
         pretransformStaticMeshes();
         unifyTriangleWinding();
+        timeReport.measure("Pre-transforming meshes");
         optimizeSceneGraph();
+        timeReport.measure("Optimizing scene graph");
+        optimizeMeshVertexOrder();
+        timeReport.measure("Optimizing vertex order");
         calculateMeshBoundingBoxes();
         createMeshGroups();
+        timeReport.measure("Creating mesh groups");
         optimizeGeometry();
         sortMeshes();
-        createGlobalBuffers();
-        createCurveGlobalBuffers();
-        collectVolumeGrids();
+        timeReport.measure("Optimizing geometry");
         removeDuplicateSDFGrids();
 
-        timeReport.measure("Post processing geometry");
+        // Wait for the concurrent tasks. This rethrows any exception thrown by the tasks.
+        volumeTask.get();
+        materialTask.get();
+        timeReport.measure("Waiting for materials");
+        timeReport.addMeasurement("  Optimizing materials", materialTime);
 
-        optimizeMaterials();
         removeDuplicateMaterials();
         quantizeTexCoords();
 
-        timeReport.measure("Optimizing materials");
+        timeReport.measure("Finalizing materials");
+
+        // The global buffers are created after the material tasks have finished,
+        // as the mesh data may be streamed to the GPU using the render context.
+        createGlobalBuffers();
+        createCurveGlobalBuffers();
+        timeReport.measure("Creating global buffers");
 
         // Prepare scene resources.
         createSceneGraph();
@@ -337,7 +383,11 @@ namespace Falcor
         mpScene = Scene::create(std::move(mSceneData));
         mSceneData = {};
 
+        // Write the BLAS cache along with the scene cache.
+        if (mWriteSceneCache) mpScene->setBlasCache(mSceneCacheKey, false);
+
         timeReport.measure("Creating resources");
+        timeReport.measureMemory("Memory");
         timeReport.printToLog();
 
         return mpScene;
@@ -1532,7 +1582,9 @@ namespace Falcor
         NodeID identityNodeID = addNode(Node{ "Identity", rmcv::identity<rmcv::mat4>(), rmcv::identity<rmcv::mat4>() });
         auto& identityNode = mSceneGraph[identityNodeID.get()];
 
-        size_t transformedMeshCount = 0;
+        // The scene graph is updated serially, while the vertex transforms are deferred and applied in parallel below.
+        std::vector<std::pair<MeshID, rmcv::mat4>> meshTransforms;
+
         for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
         {
             auto& mesh = mMeshes[meshID.get()];
@@ -1566,23 +1618,7 @@ namespace Falcor
             {
                 FALCOR_ASSERT(!mesh.staticData.empty());
                 FALCOR_ASSERT((size_t)mesh.vertexCount == mesh.staticData.size());
-
-                rmcv::mat3 invTranspose3x3 = (rmcv::mat3)rmcv::transpose(rmcv::inverse(transform));
-                rmcv::mat3 transform3x3 = (rmcv::mat3)transform;
-
-                for (auto& v : mesh.staticData)
-                {
-                    float4 p = transform * float4(v.position, 1.f);
-                    v.position = p.xyz;
-                    v.normal = glm::normalize(invTranspose3x3 * v.normal);
-                    v.tangent.xyz = glm::normalize(transform3x3 * float3(v.tangent.xyz)); // TODO: This cast shouldn't be necessary
-                    // TODO: We should flip the sign of v.tangent.w if flippedWinding is true.
-                    // Leaving that out for now for consistency with the shader code that needs the same fix.
-
-                    v.curveRadius = glm::length(transform3x3 * float3(v.curveRadius, 0.f, 0.f));
-                }
-
-                transformedMeshCount++;
+                meshTransforms.push_back({ meshID, transform });
             }
 
             // Unlink mesh from its previous transform node.
@@ -1598,7 +1634,29 @@ namespace Falcor
             mesh.instances[0] = identityNodeID;
         }
 
-        if (transformedMeshCount > 0) logInfo("Pre-transformed {} static meshes to world space.", transformedMeshCount);
+        // Transform the vertices of all meshes in parallel.
+        auto range = NumericRange<size_t>(0, meshTransforms.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i) {
+            const auto& [meshID, transform] = meshTransforms[i];
+            auto& mesh = mMeshes[meshID.get()];
+
+            rmcv::mat3 invTranspose3x3 = (rmcv::mat3)rmcv::transpose(rmcv::inverse(transform));
+            rmcv::mat3 transform3x3 = (rmcv::mat3)transform;
+
+            for (auto& v : mesh.staticData)
+            {
+                float4 p = transform * float4(v.position, 1.f);
+                v.position = p.xyz;
+                v.normal = glm::normalize(invTranspose3x3 * v.normal);
+                v.tangent.xyz = glm::normalize(transform3x3 * float3(v.tangent.xyz)); // TODO: This cast shouldn't be necessary
+                // TODO: We should flip the sign of v.tangent.w if flippedWinding is true.
+                // Leaving that out for now for consistency with the shader code that needs the same fix.
+
+                v.curveRadius = glm::length(transform3x3 * float3(v.curveRadius, 0.f, 0.f));
+            }
+        });
+
+        if (!meshTransforms.empty()) logInfo("Pre-transformed {} static meshes to world space.", meshTransforms.size());
     }
 
     void SceneBuilder::flipTriangleWinding(MeshSpec& mesh)
@@ -1666,27 +1724,106 @@ namespace Falcor
         // Note that this pass needs to run *after* pre-transformation of static meshes to world space,
         // as those transforms may flip the winding.
 
-        size_t flippedMeshCount = 0;
+        // Collect the meshes to flip. Meshes that are already front face counter-clockwise are skipped.
+        std::vector<uint32_t> flippedMeshIDs;
         for (uint32_t meshID = 0; meshID < (uint32_t)mMeshes.size(); meshID++)
         {
-            auto& mesh = mMeshes[meshID];
-
-            // Skip meshes that are already front face counter-clockwise.
+            const auto& mesh = mMeshes[meshID];
             if (mesh.isFrontFaceCW == false) continue;
 
+            // Validate here as exceptions cannot propagate out of the parallel loop below.
+            if (mesh.indexCount == 0)
+            {
+                throw RuntimeError("SceneBuilder::flipTriangleWinding() is not implemented for non-indexed meshes");
+            }
+            flippedMeshIDs.push_back(meshID);
+        }
+
+        std::for_each(std::execution::par, flippedMeshIDs.begin(), flippedMeshIDs.end(), [&](uint32_t meshID) {
+            auto& mesh = mMeshes[meshID];
             flipTriangleWinding(mesh);
             FALCOR_ASSERT(!mesh.isFrontFaceCW);
+        });
+
+        if (!flippedMeshIDs.empty()) logInfo("Flipped triangle winding for {} out of {} meshes.", flippedMeshIDs.size(), mMeshes.size());
+    }
+
+    void SceneBuilder::optimizeMeshVertexOrder()
+    {
+        // This function optionally reorders the triangles of each mesh for post-transform vertex cache locality,
+        // followed by reordering the vertices in the order they are first referenced for vertex fetch locality.
+        // The vertex order of meshes with vertex animations is kept, as the cached vertex data refers to it.
+        // Note that this pass needs to run *after* unifyTriangleWinding(), which may flip the triangles.
+
+        if (!is_set(mFlags, Flags::OptimizeVertexCache)) return;
+
+        std::vector<MeshOptimizer::VertexCacheStats> statsBefore(mMeshes.size());
+        std::vector<MeshOptimizer::VertexCacheStats> statsAfter(mMeshes.size());
+
+        auto range = NumericRange<size_t>(0, mMeshes.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t meshID) {
+            auto& mesh = mMeshes[meshID];
+            if (mesh.indexCount == 0) return; // Skip non-indexed meshes.
+
+            // Unpack 16-bit indices.
+            std::vector<uint32_t> indices;
+            if (mesh.use16BitIndices)
+            {
+                const uint16_t* pIndices16 = reinterpret_cast<const uint16_t*>(mesh.indexData.data());
+                indices.assign(pIndices16, pIndices16 + mesh.indexCount);
+            }
+            else
+            {
+                indices = std::move(mesh.indexData);
+            }
+            FALCOR_ASSERT(indices.size() == mesh.indexCount);
+
+            statsBefore[meshID] = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), mesh.vertexCount);
+            MeshOptimizer::optimizeVertexCache(indices.data(), indices.size(), mesh.vertexCount);
+            statsAfter[meshID] = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), mesh.vertexCount);
+
+            if (!mesh.isAnimated)
+            {
+                auto remap = MeshOptimizer::optimizeVertexFetch(indices.data(), indices.size(), mesh.vertexCount);
+                MeshOptimizer::remapVertices(mesh.staticData, remap);
+
+                if (!mesh.skinningData.empty())
+                {
+                    // The skinning data references the local static vertex index, which is patched in createGlobalBuffers().
+                    MeshOptimizer::remapVertices(mesh.skinningData, remap);
+                    for (uint32_t i = 0; i < mesh.skinningData.size(); i++) mesh.skinningData[i].staticIndex = i;
+                }
+            }
+
+            mesh.indexData = mesh.use16BitIndices ? compact16BitIndices(indices) : std::move(indices);
+        });
 
-            flippedMeshCount++;
+        // Log the combined statistics over all meshes.
+        uint64_t triangleCount = 0;
+        uint64_t vertexCount = 0;
+        uint64_t transformedBefore = 0;
+        uint64_t transformedAfter = 0;
+        for (size_t meshID = 0; meshID < mMeshes.size(); meshID++)
+        {
+            if (mMeshes[meshID].indexCount == 0) continue;
+            triangleCount += mMeshes[meshID].indexCount / 3;
+            vertexCount += mMeshes[meshID].vertexCount;
+            transformedBefore += statsBefore[meshID].transformedVertexCount;
+            transformedAfter += statsAfter[meshID].transformedVertexCount;
         }
 
-        if (flippedMeshCount > 0) logInfo("Flipped triangle winding for {} out of {} meshes.", flippedMeshCount, mMeshes.size());
+        if (triangleCount > 0)
+        {
+            logInfo("Optimized vertex order of meshes: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f} (simulated {}-entry FIFO cache).",
+                (double)transformedBefore / triangleCount, (double)transformedAfter / triangleCount,
+                (double)transformedBefore / vertexCount, (double)transformedAfter / vertexCount,
+                MeshOptimizer::kDefaultVertexCacheSize);
+        }
     }
 
     void SceneBuilder::calculateMeshBoundingBoxes()
     {
-        for (auto& mesh : mMeshes)
-        {
+        std::for_each(std::execution::par, mMeshes.begin(), mMeshes.end(), [](MeshSpec& mesh) {
             FALCOR_ASSERT(!mesh.staticData.empty());
             FALCOR_ASSERT((size_t)mesh.vertexCount == mesh.staticData.size());
 
@@ -1697,7 +1834,7 @@ namespace Falcor
             }
 
             mesh.boundingBox = meshBB;
-        }
+        });
     }
 
     void SceneBuilder::createMeshGroups()
@@ -1738,10 +1875,6 @@ namespace Falcor
             FALCOR_ASSERT(mesh.instances.size() == 1);
             NodeID nodeID = mesh.instances[0];
 
-            // Mark displaced meshes.
-            const auto& pMaterial = mSceneData.pMaterials->getMaterial(mesh.materialId);
-            if (pMaterial->isDisplaced()) mesh.isDisplaced = true;
-
             if (mesh.isStatic && mesh.isDisplaced) staticDisplacedMeshes.push_back(meshID);
             else if (mesh.isStatic) staticMeshes.push_back(meshID);
             else if (!mesh.isStatic && mesh.isDisplaced) dynamicDisplacedMeshes.push_back(meshID);
@@ -1770,10 +1903,6 @@ namespace Falcor
             auto& mesh = mMeshes[meshID.get()];
             if (mesh.instances.size() <= 1) continue; // Only processing instanced meshes here
 
-            // Mark displaced meshes.
-            const auto& pMaterial = mSceneData.pMaterials->getMaterial(mesh.materialId);
-            if (pMaterial->isDisplaced()) mesh.isDisplaced = true;
-
             instances inst(mesh.instances.begin(), mesh.instances.end());
             if (mesh.isDisplaced) displacedInstancesToMeshList[inst].push_back(meshID);
             else instancesToMeshList[inst].push_back(meshID);
@@ -2190,6 +2319,113 @@ namespace Falcor
         return leftList;
     }
 
+    SceneBuilder::MeshGroupList SceneBuilder::splitMeshGroupSAH(MeshGroup& meshGroup) const
+    {
+        // This function implements a recursive top-down BVH builder to partition a mesh group
+        // into smaller groups using a binned surface area heuristic (SAH) over the mesh bounds.
+        // The split minimizing area(left) * triangles(left) + area(right) * triangles(right) is chosen,
+        // which favors spatially compact groups with little overlap between the resulting BLASes.
+        // Note that individual meshes are not split, so overlaps can still occur for large meshes.
+
+        // Early out if splitting is not needed or possible.
+        size_t triangleCount = 0;
+        if (!needsSplit(meshGroup, triangleCount)) return MeshGroupList{ std::move(meshGroup) };
+
+        // Compute the bounds of the mesh centroids. The bins are placed over this range.
+        AABB centroidBB;
+        for (auto meshID : meshGroup.meshList) centroidBB.include(mMeshes[meshID.get()].boundingBox.center());
+        const float3 centroidExtent = centroidBB.extent();
+
+        auto getBinIndex = [&](MeshID meshID, int axis)
+        {
+            float t = (mMeshes[meshID.get()].boundingBox.center()[axis] - centroidBB.minPoint[axis]) / centroidExtent[axis];
+            return std::min((uint32_t)(t * kSAHBinCount), kSAHBinCount - 1);
+        };
+
+        struct Bin
+        {
+            AABB bounds;
+            size_t meshCount = 0;
+            size_t triangleCount = 0;
+        };
+
+        // Evaluate the SAH cost of the split planes between bins along each axis.
+        double bestCost = std::numeric_limits<double>::infinity();
+        int bestAxis = -1;
+        uint32_t bestSplit = 0;
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (!(centroidExtent[axis] > 0.f)) continue;
+
+            std::array<Bin, kSAHBinCount> bins;
+            for (auto meshID : meshGroup.meshList)
+            {
+                const auto& mesh = mMeshes[meshID.get()];
+                auto& bin = bins[getBinIndex(meshID, axis)];
+                bin.bounds.include(mesh.boundingBox);
+                bin.meshCount++;
+                bin.triangleCount += mesh.getTriangleCount();
+            }
+
+            // Sweep from the right to compute the cost of the right side of each split plane.
+            std::array<double, kSAHBinCount> rightCost = {};
+            std::array<size_t, kSAHBinCount> rightMeshCount = {};
+            AABB rightBB;
+            size_t rightMeshes = 0, rightTriangles = 0;
+            for (uint32_t i = kSAHBinCount - 1; i > 0; i--)
+            {
+                rightBB.include(bins[i].bounds);
+                rightMeshes += bins[i].meshCount;
+                rightTriangles += bins[i].triangleCount;
+                rightMeshCount[i] = rightMeshes;
+                if (rightMeshes > 0) rightCost[i] = (double)rightBB.area() * rightTriangles;
+            }
+
+            // Sweep from the left and combine with the right side. Split plane i lies between bins i-1 and i.
+            AABB leftBB;
+            size_t leftMeshes = 0, leftTriangles = 0;
+            for (uint32_t i = 1; i < kSAHBinCount; i++)
+            {
+                leftBB.include(bins[i - 1].bounds);
+                leftMeshes += bins[i - 1].meshCount;
+                leftTriangles += bins[i - 1].triangleCount;
+                if (leftMeshes == 0 || rightMeshCount[i] == 0) continue;
+
+                double cost = (double)leftBB.area() * leftTriangles + rightCost[i];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = i;
+                }
+            }
+        }
+
+        // If all mesh centroids fall in the same bin, fall back on splitting at the median.
+        if (bestAxis < 0) return splitMeshGroupMedian(meshGroup);
+
+        // Partition the meshes by the best split plane.
+        std::vector<MeshID> meshes = std::move(meshGroup.meshList);
+        auto splitIter = std::partition(meshes.begin(), meshes.end(), [&](MeshID meshID) { return getBinIndex(meshID, bestAxis) < bestSplit; });
+        FALCOR_ASSERT(splitIter != meshes.begin() && splitIter != meshes.end());
+
+        // Recursively split the left and right mesh groups.
+        MeshGroup leftGroup{ std::vector<MeshID>(meshes.begin(), splitIter), meshGroup.isStatic };
+        MeshGroup rightGroup{ std::vector<MeshID>(splitIter, meshes.end()), meshGroup.isStatic };
+
+        MeshGroupList leftList = splitMeshGroupSAH(leftGroup);
+        MeshGroupList rightList = splitMeshGroupSAH(rightGroup);
+
+        // Move elements into a single list and return.
+        leftList.insert(
+            leftList.end(),
+            std::make_move_iterator(rightList.begin()),
+            std::make_move_iterator(rightList.end()));
+
+        return leftList;
+    }
+
     void SceneBuilder::optimizeGeometry()
     {
         // This function optimizes the geometry for raytracing performance and memory usage.
@@ -2202,16 +2438,43 @@ namespace Falcor
         //  - Split large mesh groups (BLASes) into multiple smaller ones.
         //  - Split large meshes into smaller to reduce spatial overlap between BLASes.
         //  - Sort meshes into BLASes based on spatial locality.
+        //
+        // The partitioning strategy is selected by the build flags. The default splits meshes at the spatial midpoint.
+        // The resulting per-group overlap and SAH cost are reported in the scene's raytracing stats.
 
         MeshGroupList optimizedGroups;
 
         for (auto& meshGroup : mMeshGroups)
         {
-            //auto groups = splitMeshGroupSimple(meshGroup);
-            //auto groups = splitMeshGroupMedian(meshGroup);
-            auto groups = splitMeshGroupMidpointMeshes(meshGroup);
+            const bool isStatic = meshGroup.isStatic;
+            const size_t triangleCount = countTriangles(meshGroup);
+
+            MeshGroupList groups;
+            if (is_set(mFlags, Flags::RTSplitMeshGroupsSAH)) groups = splitMeshGroupSAH(meshGroup);
+            else if (is_set(mFlags, Flags::RTSplitMeshGroupsMedian)) groups = splitMeshGroupMedian(meshGroup);
+            else groups = splitMeshGroupMidpointMeshes(meshGroup);
 
-            if (groups.size() > 1) logWarning("SceneBuilder::optimizeGeometry() performance warning - Mesh group was split into {} groups.", groups.size());
+            if (groups.size() > 1)
+            {
+                // Report the spatial overlap between the new groups relative to their total surface area.
+                // Overlapping pairs are found by sweeping along the x-axis to avoid testing all pairs of groups.
+                std::vector<AABB> groupBBs;
+                double totalArea = 0.0, overlapArea = 0.0;
+                for (const auto& group : groups) groupBBs.push_back(calculateBoundingBox(group));
+                std::sort(groupBBs.begin(), groupBBs.end(), [](const AABB& a, const AABB& b) { return a.minPoint.x < b.minPoint.x; });
+                for (size_t i = 0; i < groupBBs.size(); i++)
+                {
+                    totalArea += groupBBs[i].area();
+                    for (size_t j = i + 1; j < groupBBs.size() && groupBBs[j].minPoint.x <= groupBBs[i].maxPoint.x; j++)
+                    {
+                        AABB overlap = groupBBs[i] & groupBBs[j];
+                        if (overlap.valid()) overlapArea += overlap.area();
+                    }
+                }
+
+                logInfo("Split {} mesh group with {} triangles into {} groups (overlap ratio {:.3f}).",
+                    isStatic ? "static" : "non-static", triangleCount, groups.size(), totalArea > 0.0 ? overlapArea / totalArea : 0.0);
+            }
 
             optimizedGroups.insert(
                 optimizedGroups.end(),
@@ -2275,16 +2538,26 @@ namespace Falcor
 
         const bool isIndexed = !is_set(mFlags, Flags::NonIndexedVertices);
 
-        // Count total number of vertex and index data elements.
+        // Compute the offsets of each mesh's data in the global buffers.
+        // This is an exclusive prefix sum over the meshes, which preserves the mesh order.
         size_t totalIndexDataCount = 0;
         size_t totalStaticVertexCount = 0;
         size_t totalSkinningVertexCount = 0;
+        std::vector<size_t> indexDataOffsets(mMeshes.size());
 
-        for (const auto& mesh : mMeshes)
+        for (size_t meshID = 0; meshID < mMeshes.size(); ++meshID)
         {
-            totalIndexDataCount += mesh.indexData.size();
+            auto& mesh = mMeshes[meshID];
+
+            // The offsets are stored as 32-bit values. The range is checked before they are used below.
+            mesh.staticVertexOffset = (uint32_t)totalStaticVertexCount;
+            mesh.skinningVertexOffset = (uint32_t)totalSkinningVertexCount;
+            mesh.prevVertexOffset = mesh.skinningVertexOffset;
+            indexDataOffsets[meshID] = totalIndexDataCount;
+
+            if (isIndexed) totalIndexDataCount += mesh.indexData.size();
             totalStaticVertexCount += mesh.staticData.size();
-            totalSkinningVertexCount += mesh.skinningData.size();
+            if (mesh.isSkinned()) totalSkinningVertexCount += mesh.skinningData.size();
             mSceneData.prevVertexCount += mesh.prevVertexCount;
         }
 
@@ -2296,43 +2569,53 @@ namespace Falcor
             throw RuntimeError("Trying to build a scene that exceeds supported mesh data size.");
         }
 
-        mSceneData.meshIndexData.reserve(totalIndexDataCount);
-        mSceneData.meshStaticData.reserve(totalStaticVertexCount);
-        mSceneData.meshSkinningData.reserve(totalSkinningVertexCount);
-
-        // Copy all vertex and index data into the global buffers.
-        for (auto& mesh : mMeshes)
+        // The mesh data is streamed directly to the GPU if the host copy of the global buffers is not needed.
+        // The host copy is needed for writing the scene cache and for initializing the skinning and vertex animations.
+        // Streaming avoids holding both the mesh local data and the global buffers in memory.
+        if (!mWriteSceneCache && std::none_of(mMeshes.begin(), mMeshes.end(), [](const MeshSpec& mesh) { return mesh.isDynamic(); }))
         {
-            mesh.staticVertexOffset = (uint32_t)mSceneData.meshStaticData.size();
-            mesh.skinningVertexOffset = (uint32_t)mSceneData.meshSkinningData.size();
-            mesh.prevVertexOffset = mesh.skinningVertexOffset;
+            FALCOR_ASSERT(totalSkinningVertexCount == 0);
+            streamGlobalBuffers(indexDataOffsets, totalIndexDataCount, totalStaticVertexCount);
+        }
+        else
+        {
+            mSceneData.meshIndexData.resize(totalIndexDataCount);
+            mSceneData.meshStaticData.resize(totalStaticVertexCount);
+            mSceneData.meshSkinningData.resize(totalSkinningVertexCount);
 
-            // Insert the static vertex data in the global array.
-            // The vertices are automatically converted to their packed format in this step.
-            mSceneData.meshStaticData.insert(mSceneData.meshStaticData.end(), mesh.staticData.begin(), mesh.staticData.end());
+            // Copy all vertex and index data into the global buffers in parallel.
+            auto range = NumericRange<size_t>(0, mMeshes.size());
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t meshID) {
+                auto& mesh = mMeshes[meshID];
 
-            if (isIndexed)
-            {
-                mesh.indexOffset = (uint32_t)mSceneData.meshIndexData.size();
-                mSceneData.meshIndexData.insert(mSceneData.meshIndexData.end(), mesh.indexData.begin(), mesh.indexData.end());
-            }
+                // Copy the static vertex data to the global array.
+                // The vertices are automatically converted to their packed format in this step.
+                std::copy(mesh.staticData.begin(), mesh.staticData.end(), mSceneData.meshStaticData.begin() + mesh.staticVertexOffset);
 
-            if (mesh.isSkinned())
-            {
-                FALCOR_ASSERT(!mesh.skinningData.empty());
-                mSceneData.meshSkinningData.insert(mSceneData.meshSkinningData.end(), mesh.skinningData.begin(), mesh.skinningData.end());
+                if (isIndexed)
+                {
+                    mesh.indexOffset = (uint32_t)indexDataOffsets[meshID];
+                    std::copy(mesh.indexData.begin(), mesh.indexData.end(), mSceneData.meshIndexData.begin() + mesh.indexOffset);
+                }
 
-                // Patch vertex index references.
-                for (uint32_t i = 0; i < mesh.skinningData.size(); ++i)
+                if (mesh.isSkinned())
                 {
-                    mSceneData.meshSkinningData[mesh.skinningVertexOffset + i].staticIndex += mesh.staticVertexOffset;
+                    FALCOR_ASSERT(!mesh.skinningData.empty());
+                    auto dst = mSceneData.meshSkinningData.begin() + mesh.skinningVertexOffset;
+                    std::copy(mesh.skinningData.begin(), mesh.skinningData.end(), dst);
+
+                    // Patch vertex index references.
+                    for (uint32_t i = 0; i < mesh.skinningData.size(); ++i)
+                    {
+                        dst[i].staticIndex += mesh.staticVertexOffset;
+                    }
                 }
-            }
 
-            // Free the mesh local data.
-            mesh.indexData.clear();
-            mesh.staticData.clear();
-            mesh.skinningData.clear();
+                // Free the mesh local data.
+                mesh.indexData = {};
+                mesh.staticData = {};
+                mesh.skinningData = {};
+            });
         }
 
         // Initialize offsets for prev vertex data for vertex-animated meshes
@@ -2354,6 +2637,56 @@ namespace Falcor
         }
     }
 
+    void SceneBuilder::streamGlobalBuffers(const std::vector<size_t>& indexDataOffsets, size_t totalIndexDataCount, size_t totalStaticVertexCount)
+    {
+        // Create the GPU buffers and upload the mesh data through a small ring of upload chunks.
+        // The meshes are processed in order. The vertices are packed directly into the mapped chunks
+        // and the mesh local data is freed as soon as it has been written.
+        if (totalIndexDataCount > 0) mSceneData.pMeshIndexBuffer = Scene::createMeshIndexBuffer(totalIndexDataCount);
+        if (totalStaticVertexCount > 0) mSceneData.pMeshStaticBuffer = Scene::createMeshStaticBuffer(totalStaticVertexCount);
+
+        const bool isIndexed = !is_set(mFlags, Flags::NonIndexedVertices);
+        ChunkedBufferUploader uploader(gpDevice->getRenderContext());
+
+        for (size_t meshID = 0; meshID < mMeshes.size(); ++meshID)
+        {
+            auto& mesh = mMeshes[meshID];
+
+            if (isIndexed)
+            {
+                mesh.indexOffset = (uint32_t)indexDataOffsets[meshID];
+                if (!mesh.indexData.empty())
+                {
+                    uploader.write(mSceneData.pMeshIndexBuffer, mesh.indexOffset * sizeof(uint32_t), mesh.indexData.data(), mesh.indexData.size() * sizeof(uint32_t));
+                }
+            }
+
+            // Pack the vertices into the upload chunks. A mesh may span several chunks.
+            size_t vertexIndex = 0;
+            while (vertexIndex < mesh.staticData.size())
+            {
+                const size_t remaining = mesh.staticData.size() - vertexIndex;
+                auto [pData, size] = uploader.allocate(mSceneData.pMeshStaticBuffer, (mesh.staticVertexOffset + vertexIndex) * sizeof(PackedStaticVertexData),
+                    remaining * sizeof(PackedStaticVertexData), sizeof(PackedStaticVertexData));
+
+                PackedStaticVertexData* pDst = static_cast<PackedStaticVertexData*>(pData);
+                const StaticVertexData* pSrc = mesh.staticData.data() + vertexIndex;
+                const size_t count = size / sizeof(PackedStaticVertexData);
+                auto range = NumericRange<size_t>(0, count);
+                std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i) { pDst[i].pack(pSrc[i]); });
+
+                vertexIndex += count;
+            }
+
+            // Free the mesh local data.
+            mesh.indexData = {};
+            mesh.staticData = {};
+        }
+
+        uploader.flush();
+        logInfo("Streamed {} of mesh data to the GPU.", formatByteSize(uploader.getUploadedBytes()));
+    }
+
     void SceneBuilder::createCurveGlobalBuffers()
     {
         FALCOR_ASSERT(mSceneData.curveIndexData.empty());
@@ -2454,8 +2787,8 @@ namespace Falcor
         // Match texture coordinate quantization for textured emissives to format of PackedEmissiveTriangle.
         // This is to avoid mismatch when sampling and evaluating emissive triangles.
         // Note that non-emissive meshes are unmodified and use full precision texcoords.
-        for (auto& mesh : mMeshes)
-        {
+        // This operates on the mesh local vertex data before it is copied to the global buffers.
+        std::for_each(std::execution::par, mMeshes.begin(), mMeshes.end(), [this](MeshSpec& mesh) {
             const auto& pMaterial = mSceneData.pMaterials->getMaterial(mesh.materialId)->toBasicMaterial();
             if (pMaterial && pMaterial->getEmissiveTexture() != nullptr)
             {
@@ -2464,9 +2797,8 @@ namespace Falcor
                 float2 maxTexCrd = float2(-std::numeric_limits<float>::infinity());
                 float2 maxError = float2(0);
 
-                for (uint32_t i = 0; i < mesh.staticVertexCount; ++i)
+                for (auto& v : mesh.staticData)
                 {
-                    auto& v = mSceneData.meshStaticData[mesh.staticVertexOffset + i];
                     float2 texCrd = v.texCrd;
                     minTexCrd = min(minTexCrd, texCrd);
                     maxTexCrd = max(maxTexCrd, texCrd);
@@ -2499,7 +2831,7 @@ namespace Falcor
                     }
                 }
             }
-        }
+        });
     }
 
     void SceneBuilder::removeDuplicateSDFGrids()
@@ -2819,6 +3151,9 @@ namespace Falcor
         flags.value("DontUseDisplacement", SceneBuilder::Flags::DontUseDisplacement);
         flags.value("UseCompressedHitInfo", SceneBuilder::Flags::UseCompressedHitInfo);
         flags.value("TessellateCurvesIntoPolyTubes", SceneBuilder::Flags::TessellateCurvesIntoPolyTubes);
+        flags.value("OptimizeVertexCache", SceneBuilder::Flags::OptimizeVertexCache);
+        flags.value("RTSplitMeshGroupsMedian", SceneBuilder::Flags::RTSplitMeshGroupsMedian);
+        flags.value("RTSplitMeshGroupsSAH", SceneBuilder::Flags::RTSplitMeshGroupsSAH);
         flags.value("UseCache", SceneBuilder::Flags::UseCache);
         flags.value("RebuildCache", SceneBuilder::Flags::RebuildCache);
         ScriptBindings::addEnumBinaryOperators(flags);
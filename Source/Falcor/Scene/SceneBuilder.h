@@ -76,6 +76,9 @@ namespace Falcor
             DontUseDisplacement             = 0x4000,   ///< Don't use displacement mapping.
             UseCompressedHitInfo            = 0x8000,   ///< Use compressed hit info (on scenes with triangle meshes only).
             TessellateCurvesIntoPolyTubes   = 0x10000,  ///< Tessellate curves into poly-tubes (the default is linear swept spheres).
+            OptimizeVertexCache             = 0x20000,  ///< Reorder triangles and vertices of meshes for post-transform vertex cache and vertex fetch locality. This improves rasterization performance on meshes with poor index order.
+            RTSplitMeshGroupsMedian         = 0x40000,  ///< For raytracing, partition mesh groups that exceed the BLAS triangle limit by splitting at the median triangle count. Meshes are not split. The default splits meshes at the spatial midpoint.
+            RTSplitMeshGroupsSAH            = 0x80000,  ///< For raytracing, partition mesh groups that exceed the BLAS triangle limit using a binned SAH over the mesh bounds. Meshes are not split. Takes precedence over RTSplitMeshGroupsMedian.
 
             UseCache                        = 0x10000000, ///< Enable scene caching. This caches the runtime scene representation on disk to reduce load time.
             RebuildCache                    = 0x20000000, ///< Rebuild scene cache.
@@ -763,6 +766,7 @@ namespace Falcor
         MeshGroupList splitMeshGroupSimple(MeshGroup& meshGroup) const;
         MeshGroupList splitMeshGroupMedian(MeshGroup& meshGroup) const;
         MeshGroupList splitMeshGroupMidpointMeshes(MeshGroup& meshGroup);
+        MeshGroupList splitMeshGroupSAH(MeshGroup& meshGroup) const;
 
         // Post processing
         void prepareDisplacementMaps();
@@ -773,11 +777,13 @@ namespace Falcor
         void optimizeSceneGraph();
         void pretransformStaticMeshes();
         void unifyTriangleWinding();
+        void optimizeMeshVertexOrder();
         void calculateMeshBoundingBoxes();
         void createMeshGroups();
         void optimizeGeometry();
         void sortMeshes();
         void createGlobalBuffers();
+        void streamGlobalBuffers(const std::vector<size_t>& indexDataOffsets, size_t totalIndexDataCount, size_t totalStaticVertexCount);
         void createCurveGlobalBuffers();
         void optimizeMaterials();
         void removeDuplicateMaterials();
@@ -44,7 +44,7 @@ namespace Falcor
         /** Specfies the current cache file version.
             This needs to be incremented every time the file format changes!
         */
-        const uint32_t kVersion = 25;
+        const uint32_t kVersion = 26;
 
         /** Scene cache directory (subdirectory in the application data directory).
         */
@@ -256,12 +256,17 @@ namespace Falcor
         return sceneData;
     }
 
+    std::filesystem::path SceneCache::getCacheDirectory()
+    {
+        return getAppDataDirectory() / kDirectory;
+    }
+
     std::filesystem::path SceneCache::getCachePath(const Key& key)
     {
         std::stringstream ss;
         ss << std::hex << std::setfill('0') << std::setw(2);
         for (auto c : key) ss << (int)c;
-        return getAppDataDirectory() / kDirectory / ss.str();
+        return getCacheDirectory() / ss.str();
     }
 
     // SceneData
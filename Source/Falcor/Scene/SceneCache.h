@@ -73,6 +73,11 @@ namespace Falcor
         */
         static Scene::SceneData readCache(const Key& key);
 
+        /** Get the directory where scene cache files are stored.
+            Other cached scene assets (e.g. environment map importance data) are stored in subdirectories.
+        */
+        static std::filesystem::path getCacheDirectory();
+
     private:
         class OutputStream;
         class InputStream;
@@ -405,6 +405,13 @@ namespace Falcor
 #define GPU_TEST_VK(Name, ...) GPU_TEST(Name, "Not supported on D3D12.")
 #endif
 
+/** Define CPU_TEST_BENCHMARK and GPU_TEST_BENCHMARK macros that define benchmarks.
+    Benchmarks are skipped by default and are enabled by temporarily replacing the macro with CPU_TEST()/GPU_TEST().
+*/
+#define FALCOR_BENCHMARK_SKIP_MESSAGE "Benchmark, replace with CPU_TEST/GPU_TEST to run manually"
+#define CPU_TEST_BENCHMARK(Name) CPU_TEST(Name, FALCOR_BENCHMARK_SKIP_MESSAGE)
+#define GPU_TEST_BENCHMARK(Name) GPU_TEST(Name, FALCOR_BENCHMARK_SKIP_MESSAGE)
+
 /** Macro definitions for the GPU unit testing framework. Note that they
     are all a single statement (including any additional << printed
     values).  Thus, it's perfectly fine to write code like:
@@ -0,0 +1,200 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "RadixSort.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Core/API/RenderContext.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Timing/Profiler.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        const char kShaderFile[] = "Utils/Algorithm/RadixSort.cs.slang";
+        const uint32_t kGroupSize = 256;
+        const uint32_t kRadixBits = 4;
+        const uint32_t kRadixSize = 1 << kRadixBits;
+        const uint32_t kMaxGroupCount = 65535;
+
+        uint32_t getKeySize(RadixSort::KeyType keyType)
+        {
+            return keyType == RadixSort::KeyType::Uint64 ? 8 : 4;
+        }
+
+        Buffer::SharedPtr createScratchBuffer(size_t size)
+        {
+            return Buffer::create(size, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr);
+        }
+    }
+
+    const uint32_t RadixSort::kMaxElementCount = kMaxGroupCount * kGroupSize;
+
+    RadixSort::RadixSort()
+    {
+        mpPrefixSum = PrefixSum::create();
+        mpElementCount = Buffer::create(sizeof(uint32_t), ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, nullptr);
+    }
+
+    RadixSort::SharedPtr RadixSort::create()
+    {
+        return SharedPtr(new RadixSort());
+    }
+
+    void RadixSort::execute(RenderContext* pRenderContext, const Buffer::SharedPtr& pKeys, const Buffer::SharedPtr& pValues, uint32_t elementCount, KeyType keyType, uint32_t keyBitCount)
+    {
+        FALCOR_PROFILE("RadixSort::execute");
+
+        FALCOR_ASSERT(pRenderContext);
+        if (elementCount == 0) return;
+
+        pRenderContext->updateBuffer(mpElementCount.get(), &elementCount, 0, sizeof(uint32_t));
+        sort(pRenderContext, pKeys, pValues, elementCount, keyType, keyBitCount);
+    }
+
+    void RadixSort::executeIndirect(RenderContext* pRenderContext, const Buffer::SharedPtr& pKeys, const Buffer::SharedPtr& pValues, uint32_t maxElementCount,
+        const Buffer::SharedPtr& pElementCount, uint64_t elementCountOffset, KeyType keyType, uint32_t keyBitCount)
+    {
+        FALCOR_PROFILE("RadixSort::executeIndirect");
+
+        FALCOR_ASSERT(pRenderContext);
+        checkArgument(pElementCount && elementCountOffset + sizeof(uint32_t) <= pElementCount->getSize(), "'pElementCount' is too small.");
+        if (maxElementCount == 0) return;
+
+        pRenderContext->copyBufferRegion(mpElementCount.get(), 0, pElementCount.get(), elementCountOffset, sizeof(uint32_t));
+        sort(pRenderContext, pKeys, pValues, maxElementCount, keyType, keyBitCount);
+    }
+
+    void RadixSort::sort(RenderContext* pRenderContext, const Buffer::SharedPtr& pKeys, const Buffer::SharedPtr& pValues, uint32_t maxElementCount, KeyType keyType, uint32_t keyBitCount)
+    {
+        const uint32_t keySize = getKeySize(keyType);
+        if (keyBitCount == 0) keyBitCount = keySize * 8;
+
+        checkArgument(maxElementCount <= kMaxElementCount, "'elementCount' ({}) exceeds the maximum of {}.", maxElementCount, kMaxElementCount);
+        checkArgument(keyBitCount <= keySize * 8, "'keyBitCount' ({}) exceeds the key size.", keyBitCount);
+        checkArgument(pKeys && pKeys->getSize() >= (size_t)maxElementCount * keySize, "'pKeys' is too small.");
+        checkArgument(!pValues || pValues->getSize() >= (size_t)maxElementCount * sizeof(uint32_t), "'pValues' is too small.");
+
+        const bool hasValues = pValues != nullptr;
+        prepareResources(maxElementCount, keyType, hasValues);
+        const auto& passes = mPasses[(keyType == KeyType::Uint64 ? 2 : 0) + (hasValues ? 1 : 0)];
+
+        const uint32_t groupCount = div_round_up(maxElementCount, kGroupSize);
+        const uint32_t passCount = div_round_up(keyBitCount, kRadixBits);
+
+        Buffer::SharedPtr pSrcKeys = pKeys;
+        Buffer::SharedPtr pDstKeys = mpTempKeys;
+        Buffer::SharedPtr pSrcValues = pValues;
+        Buffer::SharedPtr pDstValues = hasValues ? mpTempValues : nullptr;
+
+        // With an odd number of passes, start from a copy in the temporary buffers so the result ends up in the input buffers.
+        // Elements beyond the element count are never written and keep their values.
+        if (passCount % 2 == 1)
+        {
+            pRenderContext->copyBufferRegion(mpTempKeys.get(), 0, pKeys.get(), 0, (size_t)maxElementCount * keySize);
+            if (hasValues) pRenderContext->copyBufferRegion(mpTempValues.get(), 0, pValues.get(), 0, (size_t)maxElementCount * sizeof(uint32_t));
+            std::swap(pSrcKeys, pDstKeys);
+            std::swap(pSrcValues, pDstValues);
+        }
+
+        for (uint32_t pass = 0; pass < passCount; pass++)
+        {
+            const uint32_t shift = pass * kRadixBits;
+
+            // Pass 1: count digits per thread group.
+            {
+                auto var = passes.pCountPass->getRootVar();
+                var["CB"]["gShift"] = shift;
+                var["CB"]["gNumGroups"] = groupCount;
+                var["CB"]["gMaxElementCount"] = maxElementCount;
+                var["gElementCount"] = mpElementCount;
+                var["gGroupHistograms"] = mpGroupHistograms;
+                var["gKeysIn"] = pSrcKeys;
+                passes.pCountPass->execute(pRenderContext, groupCount * kGroupSize, 1);
+            }
+
+            // Pass 2: exclusive scan over the digit-major histograms gives each group's output offset per digit.
+            pRenderContext->uavBarrier(mpGroupHistograms.get());
+            mpPrefixSum->execute(pRenderContext, mpGroupHistograms, groupCount * kRadixSize);
+            pRenderContext->uavBarrier(mpGroupHistograms.get());
+
+            // Pass 3: sort each tile locally by digit and scatter to the output offsets.
+            {
+                auto var = passes.pScatterPass->getRootVar();
+                var["CB"]["gShift"] = shift;
+                var["CB"]["gNumGroups"] = groupCount;
+                var["CB"]["gMaxElementCount"] = maxElementCount;
+                var["gElementCount"] = mpElementCount;
+                var["gGroupHistograms"] = mpGroupHistograms;
+                var["gKeysIn"] = pSrcKeys;
+                var["gKeysOut"] = pDstKeys;
+                if (hasValues)
+                {
+                    var["gValuesIn"] = pSrcValues;
+                    var["gValuesOut"] = pDstValues;
+                }
+                passes.pScatterPass->execute(pRenderContext, groupCount * kGroupSize, 1);
+            }
+
+            pRenderContext->uavBarrier(pDstKeys.get());
+            if (hasValues) pRenderContext->uavBarrier(pDstValues.get());
+
+            std::swap(pSrcKeys, pDstKeys);
+            std::swap(pSrcValues, pDstValues);
+        }
+
+        FALCOR_ASSERT(pSrcKeys == pKeys);
+    }
+
+    void RadixSort::prepareResources(uint32_t maxElementCount, KeyType keyType, bool hasValues)
+    {
+        const uint32_t variant = (keyType == KeyType::Uint64 ? 2 : 0) + (hasValues ? 1 : 0);
+        auto& passes = mPasses[variant];
+        if (!passes.pCountPass)
+        {
+            Program::DefineList defines =
+            {
+                { "GROUP_SIZE", std::to_string(kGroupSize) },
+                { "KEY_64BIT", keyType == KeyType::Uint64 ? "1" : "0" },
+                { "HAS_VALUES", hasValues ? "1" : "0" },
+            };
+            passes.pCountPass = ComputePass::create(kShaderFile, "countDigits", defines);
+            passes.pScatterPass = ComputePass::create(kShaderFile, "scatter", defines);
+        }
+
+        const uint32_t groupCount = div_round_up(maxElementCount, kGroupSize);
+        const size_t histogramSize = (size_t)groupCount * kRadixSize * sizeof(uint32_t);
+        if (!mpGroupHistograms || mpGroupHistograms->getSize() < histogramSize) mpGroupHistograms = createScratchBuffer(histogramSize);
+
+        const size_t keysSize = (size_t)maxElementCount * getKeySize(keyType);
+        if (!mpTempKeys || mpTempKeys->getSize() < keysSize) mpTempKeys = createScratchBuffer(keysSize);
+
+        const size_t valuesSize = (size_t)maxElementCount * sizeof(uint32_t);
+        if (hasValues && (!mpTempValues || mpTempValues->getSize() < valuesSize)) mpTempValues = createScratchBuffer(valuesSize);
+    }
+}
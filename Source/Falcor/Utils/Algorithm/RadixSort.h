@@ -0,0 +1,117 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Buffer.h"
+#include "RenderGraph/BasePasses/ComputePass.h"
+#include "PrefixSum.h"
+#include <array>
+#include <memory>
+
+namespace Falcor
+{
+    class RenderContext;
+
+    /** Key-value radix sort on the GPU.
+
+        The sort is a multi-pass least significant digit (LSD) radix sort with 4-bit digits.
+        Each pass counts the digits per thread group, computes the global digit offsets with PrefixSum,
+        and scatters the elements after a stable local sort of each group's tile in shared memory.
+        The sort is stable and uses only standard compute features, so it runs on any GPU and backend.
+
+        Keys are 32-bit or 64-bit unsigned integers. 64-bit keys are stored as two 32-bit words (low word first).
+        An optional buffer of 32-bit values is sorted along with the keys.
+        Sorting only the low bits of the keys (e.g. for Morton codes) reduces the number of passes.
+    */
+    class FALCOR_API RadixSort
+    {
+    public:
+        using SharedPtr = std::shared_ptr<RadixSort>;
+        using SharedConstPtr = std::shared_ptr<const RadixSort>;
+        virtual ~RadixSort() = default;
+
+        enum class KeyType
+        {
+            Uint32,
+            Uint64,
+        };
+
+        /** Maximum number of elements that can be sorted.
+        */
+        static const uint32_t kMaxElementCount;
+
+        /** Create a new radix sort object.
+            \return New object, or throws an exception if creation failed.
+        */
+        static SharedPtr create();
+
+        /** Sort keys and optional values in place in ascending key order.
+            \param[in] pRenderContext The render context.
+            \param[in] pKeys Key buffer. Must have the UnorderedAccess bind flag.
+            \param[in] pValues (Optional) Value buffer with one uint32_t per key. Must have the UnorderedAccess bind flag.
+            \param[in] elementCount Number of elements to sort.
+            \param[in] keyType Key type.
+            \param[in] keyBitCount Number of low key bits to sort by, or 0 to sort by all bits. Higher bits must be zero.
+        */
+        void execute(RenderContext* pRenderContext, const Buffer::SharedPtr& pKeys, const Buffer::SharedPtr& pValues, uint32_t elementCount, KeyType keyType = KeyType::Uint32, uint32_t keyBitCount = 0);
+
+        /** Sort keys and optional values in place, where the element count is read from a GPU buffer.
+            This avoids a GPU/CPU sync when the count is produced on the GPU. The cost is that of sorting maxElementCount elements.
+            \param[in] pRenderContext The render context.
+            \param[in] pKeys Key buffer. Must have the UnorderedAccess bind flag.
+            \param[in] pValues (Optional) Value buffer with one uint32_t per key. Must have the UnorderedAccess bind flag.
+            \param[in] maxElementCount Upper bound on the element count. The buffers must hold at least this many elements.
+            \param[in] pElementCount Buffer holding the element count (uint32_t). Counts larger than maxElementCount are clamped.
+            \param[in] elementCountOffset Byte offset into pElementCount.
+            \param[in] keyType Key type.
+            \param[in] keyBitCount Number of low key bits to sort by, or 0 to sort by all bits. Higher bits must be zero.
+        */
+        void executeIndirect(RenderContext* pRenderContext, const Buffer::SharedPtr& pKeys, const Buffer::SharedPtr& pValues, uint32_t maxElementCount,
+            const Buffer::SharedPtr& pElementCount, uint64_t elementCountOffset = 0, KeyType keyType = KeyType::Uint32, uint32_t keyBitCount = 0);
+
+    protected:
+        RadixSort();
+
+        void sort(RenderContext* pRenderContext, const Buffer::SharedPtr& pKeys, const Buffer::SharedPtr& pValues, uint32_t maxElementCount, KeyType keyType, uint32_t keyBitCount);
+        void prepareResources(uint32_t maxElementCount, KeyType keyType, bool hasValues);
+
+        struct Passes
+        {
+            ComputePass::SharedPtr pCountPass;
+            ComputePass::SharedPtr pScatterPass;
+        };
+
+        std::array<Passes, 4>   mPasses;                ///< Shader variants indexed by key type and whether values are sorted.
+        PrefixSum::SharedPtr    mpPrefixSum;
+
+        Buffer::SharedPtr       mpElementCount;         ///< Element count used by the shaders (uint32_t).
+        Buffer::SharedPtr       mpGroupHistograms;      ///< Per-group digit counts, scanned into global digit offsets.
+        Buffer::SharedPtr       mpTempKeys;             ///< Ping-pong key buffer.
+        Buffer::SharedPtr       mpTempValues;           ///< Ping-pong value buffer.
+    };
+}
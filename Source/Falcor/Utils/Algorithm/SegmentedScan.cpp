@@ -0,0 +1,118 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SegmentedScan.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Core/API/RenderContext.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Timing/Profiler.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        const char kShaderFile[] = "Utils/Algorithm/SegmentedScan.cs.slang";
+        const uint32_t kGroupSize = 256;
+        const uint32_t kMaxGroupCount = 65535;
+    }
+
+    const uint32_t SegmentedScan::kMaxElementCount = kMaxGroupCount * kGroupSize;
+
+    SegmentedScan::SegmentedScan()
+    {
+        Program::DefineList defines = { {"GROUP_SIZE", std::to_string(kGroupSize)} };
+        mpGroupScanPass = ComputePass::create(kShaderFile, "groupScan", defines);
+        mpAddCarryPass = ComputePass::create(kShaderFile, "addCarry", defines);
+    }
+
+    SegmentedScan::SharedPtr SegmentedScan::create()
+    {
+        return SharedPtr(new SegmentedScan());
+    }
+
+    void SegmentedScan::execute(RenderContext* pRenderContext, const Buffer::SharedPtr& pData, const Buffer::SharedPtr& pHeadFlags, uint32_t elementCount, Type type)
+    {
+        FALCOR_PROFILE("SegmentedScan::execute");
+
+        FALCOR_ASSERT(pRenderContext);
+        checkArgument(elementCount <= kMaxElementCount, "'elementCount' ({}) exceeds the maximum of {}.", elementCount, kMaxElementCount);
+        checkArgument(pData && pData->getSize() >= (size_t)elementCount * sizeof(uint32_t), "'pData' is too small.");
+        checkArgument(pHeadFlags && pHeadFlags->getSize() >= (size_t)elementCount * sizeof(uint32_t), "'pHeadFlags' is too small.");
+        if (elementCount == 0) return;
+
+        scanLevel(pRenderContext, 0, pData, pHeadFlags, elementCount, type == Type::Inclusive);
+    }
+
+    void SegmentedScan::scanLevel(RenderContext* pRenderContext, uint32_t level, const Buffer::SharedPtr& pData, const Buffer::SharedPtr& pHeadFlags, uint32_t elementCount, bool inclusive)
+    {
+        const uint32_t groupCount = div_round_up(elementCount, kGroupSize);
+
+        // Allocate the per-group sums and flags of this level.
+        // The level is copied as the recursion below may grow mLevels.
+        if (mLevels.size() <= level) mLevels.resize(level + 1);
+        const size_t groupDataSize = (size_t)groupCount * sizeof(uint32_t);
+        if (!mLevels[level].pGroupSums || mLevels[level].pGroupSums->getSize() < groupDataSize)
+        {
+            mLevels[level].pGroupSums = Buffer::create(groupDataSize, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr);
+            mLevels[level].pGroupFlags = Buffer::create(groupDataSize, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr);
+        }
+        const Level l = mLevels[level];
+
+        // Pass 1: scan each group in shared memory and output the group sums.
+        {
+            auto var = mpGroupScanPass->getRootVar();
+            var["CB"]["gElementCount"] = elementCount;
+            var["CB"]["gInclusive"] = inclusive;
+            var["gData"] = pData;
+            var["gFlags"] = pHeadFlags;
+            var["gGroupSums"] = l.pGroupSums;
+            var["gGroupFlags"] = l.pGroupFlags;
+            mpGroupScanPass->execute(pRenderContext, groupCount * kGroupSize, 1);
+        }
+
+        if (groupCount == 1) return;
+
+        // Pass 2: inclusive segmented scan over the group sums gives the carry into each group.
+        pRenderContext->uavBarrier(pData.get());
+        pRenderContext->uavBarrier(l.pGroupSums.get());
+        scanLevel(pRenderContext, level + 1, l.pGroupSums, l.pGroupFlags, groupCount, true);
+        pRenderContext->uavBarrier(l.pGroupSums.get());
+
+        // Pass 3: add the carry to the elements before the first segment head of each group, skipping the first group.
+        {
+            auto var = mpAddCarryPass->getRootVar();
+            var["CB"]["gElementCount"] = elementCount;
+            var["gData"] = pData;
+            var["gFlags"] = pHeadFlags;
+            var["gCarry"] = l.pGroupSums;
+            mpAddCarryPass->execute(pRenderContext, (groupCount - 1) * kGroupSize, 1);
+        }
+
+        pRenderContext->uavBarrier(pData.get());
+    }
+}
@@ -0,0 +1,96 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Buffer.h"
+#include "RenderGraph/BasePasses/ComputePass.h"
+#include <memory>
+#include <vector>
+
+namespace Falcor
+{
+    class RenderContext;
+
+    /** Computes segmented prefix sums on the GPU.
+
+        The input is split into segments by a buffer of head flags, where a nonzero flag marks the first element of a segment.
+        The scan restarts at each segment head. The first element always starts a segment.
+        For the exclusive scan each new element is y[i] = x[s] + ... + x[i-1], where s is the head of the segment containing i.
+        For the inclusive scan each new element is y[i] = x[s] + ... + x[i].
+
+        The scan is computed in place on uint32_t elements. Each level scans groups in shared memory,
+        the per-group sums are scanned recursively and added back to the elements before the first head of each group.
+    */
+    class FALCOR_API SegmentedScan
+    {
+    public:
+        using SharedPtr = std::shared_ptr<SegmentedScan>;
+        using SharedConstPtr = std::shared_ptr<const SegmentedScan>;
+        virtual ~SegmentedScan() = default;
+
+        enum class Type
+        {
+            Exclusive,
+            Inclusive,
+        };
+
+        /** Maximum number of elements that can be scanned.
+        */
+        static const uint32_t kMaxElementCount;
+
+        /** Create a new segmented scan object.
+            \return New object, or throws an exception if creation failed.
+        */
+        static SharedPtr create();
+
+        /** Computes the segmented prefix sum over an array of uint32_t elements.
+            \param[in] pRenderContext The render context.
+            \param[in] pData The buffer to compute the scan over. Must have the UnorderedAccess bind flag.
+            \param[in] pHeadFlags Buffer with one uint32_t per element, nonzero marks the first element of a segment. Must have the ShaderResource bind flag.
+            \param[in] elementCount Number of elements to scan.
+            \param[in] type Exclusive or inclusive scan.
+        */
+        void execute(RenderContext* pRenderContext, const Buffer::SharedPtr& pData, const Buffer::SharedPtr& pHeadFlags, uint32_t elementCount, Type type = Type::Exclusive);
+
+    protected:
+        SegmentedScan();
+
+        void scanLevel(RenderContext* pRenderContext, uint32_t level, const Buffer::SharedPtr& pData, const Buffer::SharedPtr& pHeadFlags, uint32_t elementCount, bool inclusive);
+
+        ComputePass::SharedPtr  mpGroupScanPass;
+        ComputePass::SharedPtr  mpAddCarryPass;
+
+        struct Level
+        {
+            Buffer::SharedPtr pGroupSums;       ///< Per group: sum of the elements after the last segment head in the group.
+            Buffer::SharedPtr pGroupFlags;      ///< Per group: nonzero if the group contains a segment head.
+        };
+
+        std::vector<Level>      mLevels;
+    };
+}
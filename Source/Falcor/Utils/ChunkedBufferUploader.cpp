@@ -0,0 +1,116 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ChunkedBufferUploader.h"
+#include "Core/Assert.h"
+#include "Core/API/RenderContext.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Falcor
+{
+    ChunkedBufferUploader::ChunkedBufferUploader(RenderContext* pRenderContext, size_t chunkSize)
+        : mpRenderContext(pRenderContext)
+        , mChunkSize(chunkSize)
+    {
+        checkArgument(pRenderContext != nullptr, "'pRenderContext' is missing");
+        checkArgument(chunkSize > 0, "'chunkSize' must be larger than zero");
+
+        mpFence = GpuFence::create();
+        mChunks.resize(kChunkCount);
+    }
+
+    ChunkedBufferUploader::~ChunkedBufferUploader()
+    {
+        flush();
+    }
+
+    std::pair<void*, size_t> ChunkedBufferUploader::allocate(const Buffer::SharedPtr& pDst, uint64_t dstOffset, size_t size, size_t elementSize)
+    {
+        FALCOR_ASSERT(pDst && dstOffset + size <= pDst->getSize());
+        FALCOR_ASSERT(elementSize > 0 && elementSize <= mChunkSize && size % elementSize == 0);
+
+        // Move on to the next chunk if not even a single element fits in the current one.
+        if (mChunkOffset + elementSize > mChunkSize) submitChunk();
+
+        // Create the chunk on first use. Upload heap buffers are persistently mapped.
+        auto& chunk = mChunks[mCurrentChunk];
+        if (!chunk.pBuffer)
+        {
+            chunk.pBuffer = Buffer::create(mChunkSize, Resource::BindFlags::None, Buffer::CpuAccess::Write, nullptr);
+            chunk.pBuffer->setName("ChunkedBufferUploader::chunk");
+            chunk.pData = static_cast<uint8_t*>(chunk.pBuffer->map(Buffer::MapType::Write));
+        }
+
+        size_t allocSize = std::min(size, (mChunkSize - mChunkOffset) / elementSize * elementSize);
+        void* pData = chunk.pData + mChunkOffset;
+
+        mPendingCopies.push_back({ pDst, dstOffset, mChunkOffset, allocSize });
+        mChunkOffset += allocSize;
+        mUploadedBytes += allocSize;
+
+        return { pData, allocSize };
+    }
+
+    void ChunkedBufferUploader::write(const Buffer::SharedPtr& pDst, uint64_t dstOffset, const void* pData, size_t size)
+    {
+        const uint8_t* pSrc = static_cast<const uint8_t*>(pData);
+        while (size > 0)
+        {
+            auto [pStaging, allocSize] = allocate(pDst, dstOffset, size);
+            std::memcpy(pStaging, pSrc, allocSize);
+            pSrc += allocSize;
+            dstOffset += allocSize;
+            size -= allocSize;
+        }
+    }
+
+    void ChunkedBufferUploader::flush()
+    {
+        if (!mPendingCopies.empty()) submitChunk();
+        mpFence->syncCpu();
+    }
+
+    void ChunkedBufferUploader::submitChunk()
+    {
+        // Issue the copies from the current chunk and signal the fence when they complete.
+        auto& chunk = mChunks[mCurrentChunk];
+        for (const auto& copy : mPendingCopies)
+        {
+            mpRenderContext->copyBufferRegion(copy.pDst.get(), copy.dstOffset, chunk.pBuffer.get(), copy.srcOffset, copy.size);
+        }
+        mPendingCopies.clear();
+
+        mpRenderContext->flush(false);
+        chunk.fenceValue = mpFence->gpuSignal(mpRenderContext->getLowLevelData()->getCommandQueue());
+
+        // Advance to the next chunk in the ring and wait until the GPU is done reading from it.
+        mCurrentChunk = (mCurrentChunk + 1) % kChunkCount;
+        mChunkOffset = 0;
+        mpFence->syncCpu(mChunks[mCurrentChunk].fenceValue);
+    }
+}
@@ -0,0 +1,126 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Buffer.h"
+#include "Core/API/GpuFence.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Falcor
+{
+    class RenderContext;
+
+    /** Helper class for streaming large amounts of data into GPU buffers.
+
+        The data is written into a small ring of persistently mapped upload chunks and
+        copied to the destination buffers whenever a chunk fills up. This bounds the
+        staging memory to the size of the ring, in contrast to Buffer::setBlob() which
+        allocates an upload buffer of the full size of the data.
+
+        The caller can either copy existing data with write(), or write processed data
+        directly into the mapped chunks using allocate(). All uploads are guaranteed to
+        have completed when flush() returns.
+    */
+    class FALCOR_API ChunkedBufferUploader
+    {
+    public:
+        static constexpr size_t kDefaultChunkSize = 64ull << 20;
+        static constexpr uint32_t kChunkCount = 2;
+
+        /** Constructor.
+            \param[in] pRenderContext The render context used for issuing the copies.
+            \param[in] chunkSize Size of each upload chunk in bytes.
+        */
+        ChunkedBufferUploader(RenderContext* pRenderContext, size_t chunkSize = kDefaultChunkSize);
+
+        /** Destructor. Flushes all pending uploads.
+        */
+        ~ChunkedBufferUploader();
+
+        ChunkedBufferUploader(const ChunkedBufferUploader&) = delete;
+        ChunkedBufferUploader& operator=(const ChunkedBufferUploader&) = delete;
+
+        /** Allocate staging memory for a range of a destination buffer.
+            The allocation may be smaller than requested if the range does not fit in the current chunk.
+            The caller is then expected to allocate the remainder of the range in subsequent calls.
+            The returned memory is valid for writing until the next call to allocate(), write() or flush().
+            \param[in] pDst Destination buffer.
+            \param[in] dstOffset Byte offset into the destination buffer.
+            \param[in] size Size of the range in bytes.
+            \param[in] elementSize The allocated size is a multiple of this, so that elements are not split between allocations.
+            \return Pointer to the mapped staging memory and the allocated size in bytes.
+        */
+        std::pair<void*, size_t> allocate(const Buffer::SharedPtr& pDst, uint64_t dstOffset, size_t size, size_t elementSize = 1);
+
+        /** Copy data to a range of a destination buffer.
+            \param[in] pDst Destination buffer.
+            \param[in] dstOffset Byte offset into the destination buffer.
+            \param[in] pData Pointer to the source data.
+            \param[in] size Size of the data in bytes.
+        */
+        void write(const Buffer::SharedPtr& pDst, uint64_t dstOffset, const void* pData, size_t size);
+
+        /** Submit all pending copies and wait for the uploads to complete.
+        */
+        void flush();
+
+        /** Get the total number of bytes uploaded.
+        */
+        uint64_t getUploadedBytes() const { return mUploadedBytes; }
+
+    private:
+        struct Copy
+        {
+            Buffer::SharedPtr pDst;
+            uint64_t dstOffset;
+            uint64_t srcOffset;
+            uint64_t size;
+        };
+
+        struct Chunk
+        {
+            Buffer::SharedPtr pBuffer;
+            uint8_t* pData = nullptr;
+            uint64_t fenceValue = 0;
+        };
+
+        void submitChunk();
+
+        RenderContext* mpRenderContext;
+        size_t mChunkSize;
+        GpuFence::SharedPtr mpFence;
+
+        std::vector<Chunk> mChunks;
+        uint32_t mCurrentChunk = 0;     ///< Index of the chunk currently being written.
+        size_t mChunkOffset = 0;        ///< Byte offset of the next allocation in the current chunk.
+        std::vector<Copy> mPendingCopies;
+        uint64_t mUploadedBytes = 0;
+    };
+}
@@ -0,0 +1,115 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "DirtyRangeTracker.h"
+#include "Core/Assert.h"
+#include "Core/API/Buffer.h"
+#include <algorithm>
+
+namespace Falcor
+{
+    void DirtyRangeTracker::markDirty(size_t begin, size_t end)
+    {
+        if (begin >= end) return;
+
+        // Elements are typically modified in order, so extend the last range when possible.
+        // This keeps the number of stored ranges small when marking many elements individually.
+        if (!mRanges.empty())
+        {
+            Range& last = mRanges.back();
+            if (begin >= last.begin && begin <= last.end + mMergeGap)
+            {
+                last.end = std::max(last.end, end);
+                return;
+            }
+            if (begin < last.begin) mIsMerged = false;
+        }
+
+        mRanges.push_back({ begin, end });
+    }
+
+    void DirtyRangeTracker::markAllDirty(size_t elementCount)
+    {
+        clear();
+        markDirty(0, elementCount);
+    }
+
+    const std::vector<DirtyRangeTracker::Range>& DirtyRangeTracker::getRanges()
+    {
+        merge();
+        return mRanges;
+    }
+
+    size_t DirtyRangeTracker::getDirtyElementCount()
+    {
+        merge();
+        size_t count = 0;
+        for (const auto& range : mRanges) count += range.size();
+        return count;
+    }
+
+    uint64_t DirtyRangeTracker::upload(Buffer* pBuffer, const void* pData, size_t elementSize)
+    {
+        if (mRanges.empty()) return 0;
+        FALCOR_ASSERT(pBuffer && pData);
+
+        merge();
+        uint64_t uploadedBytes = 0;
+        for (const auto& range : mRanges)
+        {
+            FALCOR_ASSERT((range.end * elementSize) <= pBuffer->getSize());
+            const size_t offset = range.begin * elementSize;
+            const size_t size = range.size() * elementSize;
+            pBuffer->setBlob(static_cast<const uint8_t*>(pData) + offset, offset, size);
+            uploadedBytes += size;
+        }
+        clear();
+        return uploadedBytes;
+    }
+
+    void DirtyRangeTracker::merge()
+    {
+        if (mIsMerged) return;
+
+        std::sort(mRanges.begin(), mRanges.end(), [](const Range& a, const Range& b) { return a.begin < b.begin; });
+
+        size_t count = 0;
+        for (const auto& range : mRanges)
+        {
+            if (count > 0 && range.begin <= mRanges[count - 1].end + mMergeGap)
+            {
+                mRanges[count - 1].end = std::max(mRanges[count - 1].end, range.end);
+            }
+            else
+            {
+                mRanges[count++] = range;
+            }
+        }
+        mRanges.resize(count);
+        mIsMerged = true;
+    }
+}
@@ -0,0 +1,111 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    class Buffer;
+
+    /** Helper class for tracking modified elements of a CPU-side array that is mirrored in a GPU buffer.
+
+        Elements are marked dirty as they are modified. Before uploading, the dirty elements are
+        sorted and merged into contiguous ranges, so that only the modified parts of the array are
+        uploaded, using as few copies as possible. Ranges separated by at most a configurable number
+        of clean elements are merged to further reduce the number of copies.
+    */
+    class FALCOR_API DirtyRangeTracker
+    {
+    public:
+        /** Range of dirty elements [begin, end).
+        */
+        struct Range
+        {
+            size_t begin = 0;
+            size_t end = 0;
+
+            size_t size() const { return end - begin; }
+        };
+
+        /** Constructor.
+            \param[in] mergeGap Ranges separated by at most this many clean elements are merged.
+        */
+        DirtyRangeTracker(size_t mergeGap = 0) : mMergeGap(mergeGap) {}
+
+        /** Mark a single element as dirty.
+            \param[in] index Element index.
+        */
+        void markDirty(size_t index) { markDirty(index, index + 1); }
+
+        /** Mark a range of elements as dirty.
+            \param[in] begin First element index.
+            \param[in] end One past the last element index.
+        */
+        void markDirty(size_t begin, size_t end);
+
+        /** Mark all elements of an array as dirty.
+            \param[in] elementCount Number of elements in the array.
+        */
+        void markAllDirty(size_t elementCount);
+
+        /** Check if any element is dirty.
+        */
+        bool isDirty() const { return !mRanges.empty(); }
+
+        /** Get the merged dirty ranges, sorted by element index.
+        */
+        const std::vector<Range>& getRanges();
+
+        /** Get the number of elements in the merged dirty ranges.
+        */
+        size_t getDirtyElementCount();
+
+        /** Mark all elements as clean.
+        */
+        void clear() { mRanges.clear(); mIsMerged = true; }
+
+        /** Upload the dirty ranges of an array to a buffer and mark all elements as clean.
+            The uploads go through the upload heap, one copy per merged range.
+            \param[in] pBuffer Destination buffer. Element i of the array is stored at byte offset i * elementSize.
+            \param[in] pData Pointer to the start of the array.
+            \param[in] elementSize Size of an element in bytes.
+            \return Number of bytes uploaded.
+        */
+        uint64_t upload(Buffer* pBuffer, const void* pData, size_t elementSize);
+
+    private:
+        void merge();
+
+        size_t mMergeGap = 0;
+        std::vector<Range> mRanges;
+        bool mIsMerged = true;          ///< True if mRanges is sorted and merged.
+    };
+}
@@ -0,0 +1,235 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+    namespace MeshOptimizer
+    {
+        namespace
+        {
+            // Parameters of the vertex scoring function, see Tom Forsyth, "Linear-Speed Vertex Cache Optimisation", 2006.
+            const uint32_t kModeledCacheSize = 32;
+            const float kCacheDecayPower = 1.5f;
+            const float kLastTriangleScore = 0.75f;
+            const float kValenceBoostScale = 2.f;
+            const float kValenceBoostPower = 0.5f;
+
+            const uint32_t kInvalidIndex = 0xffffffff;
+
+            float computeVertexScore(int cachePosition, uint32_t liveTriangleCount)
+            {
+                // Vertices without remaining triangles are not needed anymore.
+                if (liveTriangleCount == 0) return -1.f;
+
+                float score = 0.f;
+                if (cachePosition >= 0)
+                {
+                    // Vertices used by the last triangle get a fixed score to avoid favoring the triangle just emitted.
+                    if (cachePosition < 3) score = kLastTriangleScore;
+                    else
+                    {
+                        const float scale = 1.f / (kModeledCacheSize - 3);
+                        score = std::pow(1.f - (cachePosition - 3) * scale, kCacheDecayPower);
+                    }
+                }
+
+                // Boost vertices with few remaining triangles to get rid of them quickly.
+                score += kValenceBoostScale * std::pow((float)liveTriangleCount, -kValenceBoostPower);
+                return score;
+            }
+        }
+
+        VertexCacheStats analyzeVertexCache(const uint32_t* pIndices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+        {
+            FALCOR_ASSERT(indexCount % 3 == 0);
+            VertexCacheStats stats;
+            if (indexCount == 0 || vertexCount == 0) return stats;
+
+            // Simulate a FIFO cache by recording the time each vertex entered the cache.
+            // A vertex is in the cache if fewer than 'cacheSize' vertices were inserted after it.
+            std::vector<uint64_t> timestamps(vertexCount, 0);
+            uint64_t time = (uint64_t)cacheSize + 1;
+
+            for (size_t i = 0; i < indexCount; i++)
+            {
+                const uint32_t v = pIndices[i];
+                FALCOR_ASSERT(v < vertexCount);
+                if (time - timestamps[v] > cacheSize)
+                {
+                    timestamps[v] = time++;
+                    stats.transformedVertexCount++;
+                }
+            }
+
+            stats.acmr = (float)stats.transformedVertexCount / (indexCount / 3);
+            stats.atvr = (float)stats.transformedVertexCount / vertexCount;
+            return stats;
+        }
+
+        void optimizeVertexCache(uint32_t* pIndices, size_t indexCount, size_t vertexCount)
+        {
+            FALCOR_ASSERT(indexCount % 3 == 0);
+            const size_t triangleCount = indexCount / 3;
+            if (triangleCount == 0) return;
+
+            // Build vertex to triangle adjacency. The first 'liveTriangleCount' entries in the
+            // adjacency list of each vertex are the triangles that have not been emitted yet.
+            std::vector<uint32_t> liveTriangleCount(vertexCount, 0);
+            for (size_t i = 0; i < indexCount; i++)
+            {
+                FALCOR_ASSERT(pIndices[i] < vertexCount);
+                liveTriangleCount[pIndices[i]]++;
+            }
+
+            std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+            for (size_t v = 0; v < vertexCount; v++) adjacencyOffset[v + 1] = adjacencyOffset[v] + liveTriangleCount[v];
+
+            std::vector<uint32_t> adjacency(indexCount);
+            std::vector<uint32_t> fillOffset(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+            for (size_t i = 0; i < indexCount; i++) adjacency[fillOffset[pIndices[i]]++] = (uint32_t)(i / 3);
+
+            // Compute initial scores.
+            std::vector<int> cachePosition(vertexCount, -1);
+            std::vector<float> vertexScore(vertexCount);
+            for (size_t v = 0; v < vertexCount; v++) vertexScore[v] = computeVertexScore(-1, liveTriangleCount[v]);
+
+            std::vector<float> triangleScore(triangleCount);
+            for (size_t t = 0; t < triangleCount; t++)
+            {
+                triangleScore[t] = vertexScore[pIndices[3 * t]] + vertexScore[pIndices[3 * t + 1]] + vertexScore[pIndices[3 * t + 2]];
+            }
+
+            std::vector<bool> emitted(triangleCount, false);
+            std::vector<uint32_t> output(indexCount);
+            std::vector<uint32_t> cache, newCache;
+            cache.reserve(kModeledCacheSize + 3);
+            newCache.reserve(kModeledCacheSize + 3);
+
+            uint32_t bestTriangle = (uint32_t)std::distance(triangleScore.begin(), std::max_element(triangleScore.begin(), triangleScore.end()));
+            size_t nextUnemitted = 0;
+
+            for (size_t outputCount = 0; outputCount < triangleCount; outputCount++)
+            {
+                // If no triangle is connected to the cache, continue with the next triangle in input order.
+                if (bestTriangle == kInvalidIndex)
+                {
+                    while (emitted[nextUnemitted]) nextUnemitted++;
+                    bestTriangle = (uint32_t)nextUnemitted;
+                }
+
+                // Emit triangle.
+                const uint32_t t = bestTriangle;
+                const uint32_t tri[3] = { pIndices[3 * t], pIndices[3 * t + 1], pIndices[3 * t + 2] };
+                FALCOR_ASSERT(!emitted[t]);
+                emitted[t] = true;
+                std::copy(tri, tri + 3, output.begin() + 3 * outputCount);
+
+                // Remove the triangle from the live adjacency lists of its vertices.
+                for (uint32_t v : tri)
+                {
+                    auto begin = adjacency.begin() + adjacencyOffset[v];
+                    auto end = begin + liveTriangleCount[v];
+                    auto it = std::find(begin, end, t);
+                    FALCOR_ASSERT(it != end);
+                    std::iter_swap(it, end - 1);
+                    liveTriangleCount[v]--;
+                }
+
+                // Update the modeled LRU cache. The vertices of the emitted triangle move to the front.
+                newCache.clear();
+                for (uint32_t v : tri)
+                {
+                    if (std::find(newCache.begin(), newCache.end(), v) == newCache.end()) newCache.push_back(v);
+                }
+                for (uint32_t v : cache)
+                {
+                    if (v != tri[0] && v != tri[1] && v != tri[2]) newCache.push_back(v);
+                }
+
+                // Update the scores of all vertices that are in the cache or were just pushed out of it.
+                for (size_t i = 0; i < newCache.size(); i++)
+                {
+                    const uint32_t v = newCache[i];
+                    cachePosition[v] = i < kModeledCacheSize ? (int)i : -1;
+                    vertexScore[v] = computeVertexScore(cachePosition[v], liveTriangleCount[v]);
+                }
+
+                // Update the scores of the affected triangles and pick the best one as the next triangle.
+                float bestScore = -1.f;
+                bestTriangle = kInvalidIndex;
+                for (uint32_t v : newCache)
+                {
+                    const uint32_t* pAdjacent = adjacency.data() + adjacencyOffset[v];
+                    for (uint32_t j = 0; j < liveTriangleCount[v]; j++)
+                    {
+                        const uint32_t a = pAdjacent[j];
+                        FALCOR_ASSERT(!emitted[a]);
+                        float score = vertexScore[pIndices[3 * a]] + vertexScore[pIndices[3 * a + 1]] + vertexScore[pIndices[3 * a + 2]];
+                        triangleScore[a] = score;
+                        if (score > bestScore)
+                        {
+                            bestScore = score;
+                            bestTriangle = a;
+                        }
+                    }
+                }
+
+                if (newCache.size() > kModeledCacheSize) newCache.resize(kModeledCacheSize);
+                std::swap(cache, newCache);
+            }
+
+            std::copy(output.begin(), output.end(), pIndices);
+        }
+
+        std::vector<uint32_t> optimizeVertexFetch(uint32_t* pIndices, size_t indexCount, size_t vertexCount)
+        {
+            std::vector<uint32_t> remap(vertexCount, kInvalidIndex);
+            uint32_t nextVertex = 0;
+
+            for (size_t i = 0; i < indexCount; i++)
+            {
+                uint32_t& v = pIndices[i];
+                FALCOR_ASSERT(v < vertexCount);
+                if (remap[v] == kInvalidIndex) remap[v] = nextVertex++;
+                v = remap[v];
+            }
+
+            // Place unreferenced vertices last to keep the vertex count unchanged.
+            for (auto& r : remap)
+            {
+                if (r == kInvalidIndex) r = nextVertex++;
+            }
+
+            FALCOR_ASSERT(nextVertex == vertexCount);
+            return remap;
+        }
+    }
+}
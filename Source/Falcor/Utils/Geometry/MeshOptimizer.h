@@ -0,0 +1,97 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Assert.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Utilities for optimizing the memory access patterns of indexed triangle meshes.
+
+        The functions operate on triangle lists with 32-bit indices and are thread safe,
+        so multiple meshes can be optimized in parallel.
+    */
+    namespace MeshOptimizer
+    {
+        /** Default size of the simulated FIFO post-transform vertex cache used for the statistics.
+        */
+        constexpr uint32_t kDefaultVertexCacheSize = 16;
+
+        /** Post-transform vertex cache statistics.
+        */
+        struct VertexCacheStats
+        {
+            uint64_t transformedVertexCount = 0;    ///< Number of vertices transformed, i.e., number of cache misses.
+            float acmr = 0.f;                       ///< Average cache miss ratio. Transformed vertices per triangle (0.5 is ideal for large meshes, 3.0 is worst case).
+            float atvr = 0.f;                       ///< Average transformed vertex ratio. Transformed vertices per vertex (1.0 is ideal).
+        };
+
+        /** Compute post-transform vertex cache statistics by simulating a FIFO cache.
+            \param[in] pIndices Triangle list indices.
+            \param[in] indexCount Number of indices. Must be a multiple of 3.
+            \param[in] vertexCount Number of vertices referenced by the indices.
+            \param[in] cacheSize Number of entries in the simulated cache.
+            \return Cache statistics.
+        */
+        FALCOR_API VertexCacheStats analyzeVertexCache(const uint32_t* pIndices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = kDefaultVertexCacheSize);
+
+        /** Reorder triangles to improve post-transform vertex cache locality.
+            This uses the linear-speed vertex cache optimization by Tom Forsyth, which is not tuned to a particular cache size.
+            The winding of each triangle is preserved.
+            \param[in,out] pIndices Triangle list indices. These are reordered in place.
+            \param[in] indexCount Number of indices. Must be a multiple of 3.
+            \param[in] vertexCount Number of vertices referenced by the indices.
+        */
+        FALCOR_API void optimizeVertexCache(uint32_t* pIndices, size_t indexCount, size_t vertexCount);
+
+        /** Reorder vertices to improve vertex fetch locality.
+            The vertices are renumbered in the order they are first referenced by the index buffer.
+            This should run after optimizeVertexCache(). Unreferenced vertices are placed last.
+            \param[in,out] pIndices Triangle list indices. These are updated to reference the new vertex order.
+            \param[in] indexCount Number of indices.
+            \param[in] vertexCount Number of vertices referenced by the indices.
+            \return Table mapping each old vertex index to its new index. Use remapVertices() to apply it to the vertex data.
+        */
+        FALCOR_API std::vector<uint32_t> optimizeVertexFetch(uint32_t* pIndices, size_t indexCount, size_t vertexCount);
+
+        /** Reorder vertex data using a remap table returned by optimizeVertexFetch().
+            \param[in,out] vertices Vertex data. The size must match the size of the remap table.
+            \param[in] remap Table mapping each old vertex index to its new index.
+        */
+        template<typename T>
+        void remapVertices(std::vector<T>& vertices, const std::vector<uint32_t>& remap)
+        {
+            FALCOR_ASSERT(vertices.size() == remap.size());
+            std::vector<T> remapped(vertices.size());
+            for (size_t i = 0; i < vertices.size(); i++) remapped[remap[i]] = std::move(vertices[i]);
+            vertices = std::move(remapped);
+        }
+    }
+}
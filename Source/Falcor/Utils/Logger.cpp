@@ -29,6 +29,7 @@
 #include "Core/Assert.h"
 #include "Core/Platform/OS.h"
 #include <iostream>
+#include <mutex>
 
 namespace Falcor
 {
@@ -38,6 +39,9 @@ namespace Falcor
         Logger::OutputFlags sOutputs = Logger::OutputFlags::Console | Logger::OutputFlags::File | Logger::OutputFlags::DebugWindow;
         std::filesystem::path sLogFilePath;
 
+        // Messages may be logged from multiple threads, e.g., by the concurrent tasks of the scene builder.
+        std::mutex sMutex;
+
 #if FALCOR_ENABLE_LOGGER
         bool sInitialized = false;
         FILE* sLogFile = nullptr;
@@ -90,6 +94,7 @@ namespace Falcor
     void Logger::shutdown()
     {
 #if FALCOR_ENABLE_LOGGER
+        std::lock_guard<std::mutex> lock(sMutex);
         if(sLogFile)
         {
             fclose(sLogFile);
@@ -122,6 +127,7 @@ namespace Falcor
     void Logger::log(Level level, const std::string_view msg)
     {
 #if FALCOR_ENABLE_LOGGER
+        std::lock_guard<std::mutex> lock(sMutex);
         if (level <= sVerbosity)
         {
             std::string s = fmt::format("{} {}\n", getLogLevelString(level), msg);
@@ -151,6 +157,7 @@ namespace Falcor
     bool Logger::setLogFilePath(const std::filesystem::path& path)
     {
 #if FALCOR_ENABLE_LOGGER
+        std::lock_guard<std::mutex> lock(sMutex);
         if (sLogFile)
         {
             return false;
@@ -165,11 +172,11 @@ namespace Falcor
 #endif
     }
 
-    void Logger::setVerbosity(Level level) { sVerbosity = level; }
-    Logger::Level Logger::getVerbosity() { return sVerbosity; }
+    void Logger::setVerbosity(Level level) { std::lock_guard<std::mutex> lock(sMutex); sVerbosity = level; }
+    Logger::Level Logger::getVerbosity() { std::lock_guard<std::mutex> lock(sMutex); return sVerbosity; }
 
-    void Logger::setOutputs(OutputFlags outputs) { sOutputs = outputs; }
-    Logger::OutputFlags Logger::getOutputs() { return sOutputs; }
+    void Logger::setOutputs(OutputFlags outputs) { std::lock_guard<std::mutex> lock(sMutex); sOutputs = outputs; }
+    Logger::OutputFlags Logger::getOutputs() { std::lock_guard<std::mutex> lock(sMutex); return sOutputs; }
 
     const std::filesystem::path& Logger::getLogFilePath() { return sLogFilePath; }
 }
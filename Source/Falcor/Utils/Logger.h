@@ -38,6 +38,7 @@ namespace Falcor
     /** Container class for logging messages.
         To enable log messages, make sure FALCOR_ENABLE_LOGGER is set to `1` in FalcorConfig.h.
         Messages are only printed to the selected outputs if they match the verbosity level.
+        The logger is thread-safe, messages can be logged from any thread.
     */
     class FALCOR_API Logger
     {
@@ -28,6 +28,7 @@
 #include "TimeReport.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
+#include "Core/Platform/OS.h"
 #include <numeric>
 
 namespace Falcor
@@ -41,6 +42,7 @@ namespace Falcor
     {
         mLastMeasureTime = CpuTimer::getCurrentTimePoint();
         mMeasurements.clear();
+        mMemoryMeasurements.clear();
         mTotal = 0.0;
     }
 
@@ -56,6 +58,10 @@ namespace Falcor
         {
             logInfo(padStringToLength(task + ":", 25) + " " + std::to_string(duration) + " s" + (mTotal > 0.0 && !mMeasurements.empty() ? ", " + std::to_string(100.0 * duration / mTotal) + "% of total" : ""));
         }
+        for (const auto& [task, memory] : mMemoryMeasurements)
+        {
+            logInfo(padStringToLength(task + ":", 25) + " " + formatByteSize(memory.first) + " (peak " + formatByteSize(memory.second) + ")");
+        }
     }
 
     void TimeReport::measure(const std::string& name)
@@ -66,6 +72,16 @@ namespace Falcor
         mMeasurements.push_back({name, duration.count()});
     }
 
+    void TimeReport::addMeasurement(const std::string& name, double duration)
+    {
+        mMeasurements.push_back({name, duration});
+    }
+
+    void TimeReport::measureMemory(const std::string& name)
+    {
+        mMemoryMeasurements.push_back({name, {getCurrentRSS(), getPeakRSS()}});
+    }
+
     void TimeReport::addTotal(const std::string name)
     {
         mTotal = std::accumulate(mMeasurements.begin(), mMeasurements.end(), 0.0, [] (double t, auto &&m) { return t + m.second; });
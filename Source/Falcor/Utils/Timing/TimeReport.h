@@ -28,6 +28,7 @@
 #pragma once
 #include "CpuTimer.h"
 #include "Core/Macros.h"
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
@@ -60,6 +61,19 @@ namespace Falcor
         */
         void measure(const std::string& name);
 
+        /** Records a time measurement that was measured externally.
+            This is useful for recording tasks that run concurrently with the measured tasks. It does not affect the internal timer.
+            \param[in] name Name of the record.
+            \param[in] duration Duration in seconds.
+        */
+        void addMeasurement(const std::string& name, double duration);
+
+        /** Records the current and peak resident memory of the process.
+            Note that the peak is measured over the lifetime of the process, not since the last measurement.
+            \param[in] name Name of the record.
+        */
+        void measureMemory(const std::string& name = "Memory");
+
         /** Add a record containing the total of all measurements.
             \param[in] name Name of the record.
         */
@@ -68,6 +82,7 @@ namespace Falcor
     private:
         CpuTimer::TimePoint mLastMeasureTime;
         std::vector<std::pair<std::string, double>> mMeasurements;
+        std::vector<std::pair<std::string, std::pair<uint64_t, uint64_t>>> mMemoryMeasurements; ///< Current and peak resident memory in bytes.
         double mTotal = 0.0;
     };
 }
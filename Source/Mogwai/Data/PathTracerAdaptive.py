@@ -0,0 +1,31 @@
+from falcor import *
+
+def render_graph_PathTracerAdaptive():
+    g = RenderGraph("PathTracerAdaptive")
+    loadRenderPassLibrary("AccumulatePass.dll")
+    loadRenderPassLibrary("GBuffer.dll")
+    loadRenderPassLibrary("PathTracer.dll")
+    loadRenderPassLibrary("ToneMapper.dll")
+    loadRenderPassLibrary("Utils.dll")
+    AdaptiveSampling = createPass("AdaptiveSampling", {'averageSamplesPerPixel': 4.0, 'minSamplesPerPixel': 1, 'maxSamplesPerPixel': 16, 'useRelativeError': True})
+    g.addPass(AdaptiveSampling, "AdaptiveSampling")
+    PathTracer = createPass("PathTracer", {'samplesPerPixel': 1})
+    g.addPass(PathTracer, "PathTracer")
+    VBufferRT = createPass("VBufferRT", {'samplePattern': SamplePattern.Stratified, 'sampleCount': 16, 'useAlphaTest': True})
+    g.addPass(VBufferRT, "VBufferRT")
+    AccumulatePass = createPass("AccumulatePass", {'enabled': True, 'precisionMode': AccumulatePrecision.Single, 'computeVariance': True})
+    g.addPass(AccumulatePass, "AccumulatePass")
+    ToneMapper = createPass("ToneMapper", {'autoExposure': False, 'exposureCompensation': 0.0})
+    g.addPass(ToneMapper, "ToneMapper")
+    g.addEdge("VBufferRT.vbuffer", "PathTracer.vbuffer")
+    g.addEdge("VBufferRT.viewW", "PathTracer.viewW")
+    g.addEdge("VBufferRT.mvec", "PathTracer.mvec")
+    g.addEdge("AdaptiveSampling.sampleCount", "PathTracer.sampleCount")
+    g.addEdge("PathTracer.color", "AccumulatePass.input")
+    g.addEdge("AccumulatePass.output", "ToneMapper.src")
+    g.markOutput("ToneMapper.dst")
+    return g
+
+PathTracerAdaptive = render_graph_PathTracerAdaptive()
+try: m.addGraph(PathTracerAdaptive)
+except NameError: None
@@ -0,0 +1,49 @@
+from falcor import *
+
+def render_graph_PathTracerConvergence():
+    g = RenderGraph("PathTracerConvergence")
+    loadRenderPassLibrary("AccumulatePass.dll")
+    loadRenderPassLibrary("GBuffer.dll")
+    loadRenderPassLibrary("PathTracer.dll")
+    loadRenderPassLibrary("ToneMapper.dll")
+    PathTracer = createPass("PathTracer", {'samplesPerPixel': 1})
+    g.addPass(PathTracer, "PathTracer")
+    VBufferRT = createPass("VBufferRT", {'samplePattern': SamplePattern.Stratified, 'sampleCount': 16, 'useAlphaTest': True})
+    g.addPass(VBufferRT, "VBufferRT")
+    AccumulatePass = createPass("AccumulatePass", {'enabled': True, 'precisionMode': AccumulatePrecision.Single, 'convergenceThreshold': 0.01, 'convergenceTileSize': 16, 'convergenceMinFrames': 16, 'timeBudget': 600.0})
+    g.addPass(AccumulatePass, "AccumulatePass")
+    ToneMapper = createPass("ToneMapper", {'autoExposure': False, 'exposureCompensation': 0.0})
+    g.addPass(ToneMapper, "ToneMapper")
+    g.addEdge("VBufferRT.vbuffer", "PathTracer.vbuffer")
+    g.addEdge("VBufferRT.viewW", "PathTracer.viewW")
+    g.addEdge("VBufferRT.mvec", "PathTracer.mvec")
+    g.addEdge("PathTracer.color", "AccumulatePass.input")
+    g.addEdge("AccumulatePass.output", "ToneMapper.src")
+    g.markOutput("ToneMapper.dst")
+    return g
+
+PathTracerConvergence = render_graph_PathTracerConvergence()
+try: m.addGraph(PathTracerConvergence)
+except NameError: None
+
+def renderUntilFinished(baseFilename="PathTracerConvergence", maxFrames=100000):
+    """Render until all tiles have converged or the time budget has expired, then capture the result.
+    Load a scene first, then call this function, e.g., from the console or from a script passed with --script.
+    The clock is paused so that animations do not restart accumulation. The frame limit guards against
+    running forever when the convergence threshold is never met and no time budget is set.
+    """
+    m.clock.pause()
+    accumulatePass = m.activeGraph.getPass("AccumulatePass")
+    accumulatePass.reset()
+    frameCount = 0
+    while not accumulatePass.finished and frameCount < maxFrames:
+        m.renderFrame()
+        frameCount += 1
+    print(f"Rendered {frameCount} frames, converged tiles {accumulatePass.convergedTileCount}/{accumulatePass.tileCount}")
+    m.frameCapture.baseFilename = baseFilename
+    m.frameCapture.capture()
+    return accumulatePass.getConvergenceMap()
+
+# Example:
+# m.loadScene('Arcade/Arcade.pyscene')
+# convergenceMap = renderUntilFinished()
@@ -0,0 +1,42 @@
+from falcor import *
+
+def render_graph_ReSTIR_ReducedRate():
+    # Compares ReSTIR at reduced reservoir resolution against the full-rate reference.
+    # The per-frame error against the full-rate image is written to ReSTIR_ReducedRate_error.csv.
+    # Switch 'reservoirResolution' of ReSTIRPassReduced between Checkerboard and Quarter to compare both modes.
+    g = RenderGraph('ReSTIR_ReducedRate')
+    loadRenderPassLibrary('AccumulatePass.dll')
+    loadRenderPassLibrary('ErrorMeasurePass.dll')
+    loadRenderPassLibrary('GBuffer.dll')
+    loadRenderPassLibrary('ReSTIRPass.dll')
+    loadRenderPassLibrary('ToneMapper.dll')
+    loadRenderPassLibrary('Utils.dll')
+    VBufferRT = createPass('VBufferRT', {'outputSize': IOSize.Default, 'samplePattern': SamplePattern.Center, 'sampleCount': 16, 'useAlphaTest': True, 'adjustShadingNormals': True, 'forceCullMode': False, 'cull': CullMode.CullBack, 'useTraceRayInline': False, 'useDOF': True})
+    g.addPass(VBufferRT, 'VBufferRT')
+    ReSTIRPass = createPass('ReSTIRPass', {'reservoirResolution': ReSTIRReservoirResolution.Full})
+    g.addPass(ReSTIRPass, 'ReSTIRPass')
+    ReSTIRPassReduced = createPass('ReSTIRPass', {'reservoirResolution': ReSTIRReservoirResolution.Checkerboard})
+    g.addPass(ReSTIRPassReduced, 'ReSTIRPassReduced')
+    AccumulatePass = createPass('AccumulatePass', {'enabled': True, 'outputSize': IOSize.Default, 'autoReset': True, 'precisionMode': AccumulatePrecision.Single, 'subFrameCount': 0, 'maxAccumulatedFrames': 0})
+    g.addPass(AccumulatePass, 'AccumulatePass')
+    AccumulatePass0 = createPass('AccumulatePass', {'enabled': True, 'outputSize': IOSize.Default, 'autoReset': True, 'precisionMode': AccumulatePrecision.Single, 'subFrameCount': 0, 'maxAccumulatedFrames': 0})
+    g.addPass(AccumulatePass0, 'AccumulatePass0')
+    ErrorMeasurePass = createPass('ErrorMeasurePass', {'ReferenceImagePath': '', 'MeasurementsFilePath': 'ReSTIR_ReducedRate_error.csv', 'IgnoreBackground': True, 'ComputeSquaredDifference': True, 'ComputeAverage': False, 'UseLoadedReference': False, 'ReportRunningError': True, 'RunningErrorSigma': 0.995, 'SelectedOutputId': OutputId.Source})
+    g.addPass(ErrorMeasurePass, 'ErrorMeasurePass')
+    ToneMapper = createPass('ToneMapper', {'outputSize': IOSize.Default, 'useSceneMetadata': True, 'exposureCompensation': 9.0, 'autoExposure': False, 'filmSpeed': 100.0, 'whiteBalance': False, 'whitePoint': 6500.0, 'operator': ToneMapOp.Aces, 'clamp': True, 'whiteMaxLuminance': 1.0, 'whiteScale': 11.199999809265137, 'fNumber': 1.0, 'shutter': 1.0, 'exposureMode': ExposureMode.AperturePriority})
+    g.addPass(ToneMapper, 'ToneMapper')
+    g.addEdge('VBufferRT.vbuffer', 'ReSTIRPass.vbuffer')
+    g.addEdge('VBufferRT.mvec', 'ReSTIRPass.mvec')
+    g.addEdge('VBufferRT.vbuffer', 'ReSTIRPassReduced.vbuffer')
+    g.addEdge('VBufferRT.mvec', 'ReSTIRPassReduced.mvec')
+    g.addEdge('ReSTIRPass.color', 'AccumulatePass.input')
+    g.addEdge('ReSTIRPassReduced.color', 'AccumulatePass0.input')
+    g.addEdge('AccumulatePass0.output', 'ErrorMeasurePass.Source')
+    g.addEdge('AccumulatePass.output', 'ErrorMeasurePass.Reference')
+    g.addEdge('ErrorMeasurePass.Output', 'ToneMapper.src')
+    g.markOutput('ToneMapper.dst')
+    return g
+
+ReSTIR_ReducedRate = render_graph_ReSTIR_ReducedRate()
+try: m.addGraph(ReSTIR_ReducedRate)
+except NameError: None
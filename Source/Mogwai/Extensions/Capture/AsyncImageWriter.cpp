@@ -0,0 +1,101 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AsyncImageWriter.h"
+
+namespace Mogwai
+{
+    AsyncImageWriter::AsyncImageWriter(uint32_t threadCount, size_t maxQueuedImages)
+        : mMaxQueuedImages(std::max<size_t>(maxQueuedImages, 1))
+    {
+        threadCount = std::max(threadCount, 1u);
+        mWorkers.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; i++) mWorkers.emplace_back(&AsyncImageWriter::workerLoop, this);
+    }
+
+    AsyncImageWriter::~AsyncImageWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTerminate = true;
+        }
+        mWorkAvailable.notify_all();
+        for (auto& worker : mWorkers) worker.join();
+    }
+
+    void AsyncImageWriter::write(Image&& image)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mSpaceAvailable.wait(lock, [this] { return mQueue.size() < mMaxQueuedImages; });
+        mQueue.push_back(std::move(image));
+        lock.unlock();
+        mWorkAvailable.notify_one();
+    }
+
+    void AsyncImageWriter::flush()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mIdle.wait(lock, [this] { return mQueue.empty() && mActiveCount == 0; });
+    }
+
+    size_t AsyncImageWriter::getPendingCount() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mQueue.size() + mActiveCount;
+    }
+
+    void AsyncImageWriter::workerLoop()
+    {
+        while (true)
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            // Keep draining the queue after termination was requested so no captured image is lost.
+            mWorkAvailable.wait(lock, [this] { return mTerminate || !mQueue.empty(); });
+            if (mQueue.empty()) return;
+
+            Image image = std::move(mQueue.front());
+            mQueue.pop_front();
+            mActiveCount++;
+            lock.unlock();
+            mSpaceAvailable.notify_one();
+
+            try
+            {
+                Bitmap::saveImage(image.path, image.width, image.height, image.fileFormat, image.exportFlags, image.resourceFormat, true, image.data.data());
+            }
+            catch (const std::exception& e)
+            {
+                logError("Failed to write captured image '{}': {}", image.path.string(), e.what());
+            }
+
+            lock.lock();
+            mActiveCount--;
+            lock.unlock();
+            mIdle.notify_all();
+        }
+    }
+}
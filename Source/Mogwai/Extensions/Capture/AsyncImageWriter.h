@@ -0,0 +1,93 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Falcor.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+using namespace Falcor;
+
+namespace Mogwai
+{
+    /** Encodes and writes images to disk on a fixed set of worker threads.
+        The number of queued images is bounded. Adding an image to a full queue blocks the caller until a worker
+        picks up the next image, which bounds the memory held by images waiting to be written.
+    */
+    class AsyncImageWriter
+    {
+    public:
+        struct Image
+        {
+            std::filesystem::path path;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            Bitmap::FileFormat fileFormat = Bitmap::FileFormat::PngFile;
+            Bitmap::ExportFlags exportFlags = Bitmap::ExportFlags::None;
+            ResourceFormat resourceFormat = ResourceFormat::Unknown;
+            std::vector<uint8_t> data;
+        };
+
+        /** Create the writer and start the worker threads.
+            \param[in] threadCount Number of worker threads.
+            \param[in] maxQueuedImages Maximum number of images waiting to be written.
+        */
+        AsyncImageWriter(uint32_t threadCount, size_t maxQueuedImages);
+
+        /** Write all queued images and stop the worker threads.
+        */
+        ~AsyncImageWriter();
+
+        /** Queue an image for writing. Blocks while the queue is full.
+        */
+        void write(Image&& image);
+
+        /** Block until all queued images have been written.
+        */
+        void flush();
+
+        /** Get the number of images queued or currently being written.
+        */
+        size_t getPendingCount() const;
+
+    private:
+        void workerLoop();
+
+        std::vector<std::thread> mWorkers;
+        std::deque<Image> mQueue;
+        size_t mMaxQueuedImages;
+        size_t mActiveCount = 0;
+        bool mTerminate = false;
+
+        mutable std::mutex mMutex;
+        std::condition_variable mWorkAvailable;    ///< Signaled when an image is queued or the writer terminates.
+        std::condition_variable mSpaceAvailable;   ///< Signaled when a worker takes an image off the queue.
+        std::condition_variable mIdle;             ///< Signaled when a worker finishes writing an image.
+    };
+}
@@ -28,6 +28,7 @@
 #include "Falcor.h"
 #include "FrameCapture.h"
 #include "Utils/Scripting/ScriptWriter.h"
+#include <algorithm>
 #include <filesystem>
 
 namespace Mogwai
@@ -41,6 +42,11 @@ namespace Mogwai
         const std::string kUI = "ui";
         const std::string kOutputs = "outputs";
         const std::string kCapture = "capture";
+        const std::string kFlush = "flush";
+
+        const size_t kMaxPendingReadbacks = 8;  ///< Maximum number of texture readbacks in flight for asynchronous capture.
+        const size_t kMaxQueuedImages = 8;      ///< Maximum number of read back images waiting to be written.
+        const uint32_t kMaxWriterThreads = 4;
 
         template<typename T>
         std::vector<typename T::value_type::first_type> getFirstOfPair(const T& pair)
@@ -76,6 +82,9 @@ namespace Mogwai
             w.checkbox("Capture All Outputs", mCaptureAllOutputs);
             w.tooltip("Capture all available outputs instead of the marked ones only.");
 
+            w.checkbox("Async Capture", mAsyncCapture);
+            w.tooltip("Read back outputs asynchronously and write the images on background threads, so rendering continues while earlier frames are written.");
+
             if (w.button("Capture Current Frame")) capture();
         }
     }
@@ -95,6 +104,7 @@ namespace Mogwai
         auto printGraph = [](FrameCapture* pFC, RenderGraph* pGraph) { pybind11::print(pFC->graphFramesStr(pGraph)); };
         frameCapture.def(kPrintFrames.c_str(), printGraph, "graph"_a);
         frameCapture.def(kCapture.c_str(), &FrameCapture::capture);
+        frameCapture.def(kFlush.c_str(), &FrameCapture::flush);
         auto printAllGraphs = [](FrameCapture* pFC)
         {
             std::string s;
@@ -111,6 +121,10 @@ namespace Mogwai
         frameCapture.def_property("captureAllOutputs",
             [](FrameCapture* pFC){ return pFC->mCaptureAllOutputs;},
             [](FrameCapture* pFC, bool all){ pFC->mCaptureAllOutputs = all; });
+
+        frameCapture.def_property("asyncCapture",
+            [](FrameCapture* pFC){ return pFC->mAsyncCapture;},
+            [](FrameCapture* pFC, bool async){ if (!async) pFC->flush(); pFC->mAsyncCapture = async; });
     }
 
     std::string FrameCapture::getScriptVar() const
@@ -132,8 +146,16 @@ namespace Mogwai
         return s;
     }
 
+    void FrameCapture::shutdown()
+    {
+        flush();
+    }
+
     void FrameCapture::triggerFrame(RenderContext* pRenderContext, RenderGraph* pGraph, uint64_t frameID)
     {
+        // Hand off readbacks of earlier frames that have completed in the meantime.
+        retireReadbacks(kMaxPendingReadbacks);
+
         std::vector<std::string> unmarkedOutputs;
 
         if (mCaptureAllOutputs)
@@ -248,8 +270,89 @@ namespace Mogwai
             Bitmap::ExportFlags flags = Bitmap::ExportFlags::None;
             if (mask == TextureChannelFlags::RGBA) flags |= Bitmap::ExportFlags::ExportAlpha;
 
-            pTex->captureToFile(0, 0, filename, fileformat, flags);
+            captureTexture(pRenderContext, pTex, filename, fileformat, flags);
+        }
+    }
+
+    void FrameCapture::captureTexture(RenderContext* pRenderContext, const Texture::SharedPtr& pTex, const std::string& filename, Bitmap::FileFormat fileFormat, Bitmap::ExportFlags exportFlags)
+    {
+        if (!mAsyncCapture)
+        {
+            pTex->captureToFile(0, 0, filename, fileFormat, exportFlags);
+            return;
+        }
+
+        // Same as Texture::captureToFile(), HDR textures with less than 3 channels are expanded to RGBA32Float.
+        Texture::SharedPtr pSrc = pTex;
+        if (getFormatType(pTex->getFormat()) == FormatType::Float && getFormatChannelCount(pTex->getFormat()) < 3)
+        {
+            pSrc = Texture::create2D(pTex->getWidth(), pTex->getHeight(), ResourceFormat::RGBA32Float, 1, 1, nullptr, ResourceBindFlags::RenderTarget | ResourceBindFlags::ShaderResource);
+            pRenderContext->blit(pTex->getSRV(0, 1, 0, 1), pSrc->getRTV(0, 0, 1));
         }
+
+        // Make room in the ring. This only blocks if the GPU is more than kMaxPendingReadbacks readbacks behind.
+        retireReadbacks(kMaxPendingReadbacks - 1);
+
+        // Reuse the largest free readback buffer. The copy allocates a new one if it is too small.
+        Buffer::SharedPtr pReadbackBuffer;
+        if (!mFreeReadbackBuffers.empty())
+        {
+            auto it = std::max_element(mFreeReadbackBuffers.begin(), mFreeReadbackBuffers.end(), [](const auto& a, const auto& b) { return a->getSize() < b->getSize(); });
+            pReadbackBuffer = *it;
+            mFreeReadbackBuffers.erase(it);
+        }
+
+        PendingReadback readback;
+        readback.pTask = pRenderContext->asyncReadTextureSubresource(pSrc.get(), 0, pReadbackBuffer);
+        readback.image.path = filename;
+        readback.image.width = pSrc->getWidth();
+        readback.image.height = pSrc->getHeight();
+        readback.image.fileFormat = fileFormat;
+        readback.image.exportFlags = exportFlags;
+        readback.image.resourceFormat = pSrc->getFormat();
+        mPendingReadbacks.push_back(std::move(readback));
+    }
+
+    void FrameCapture::retireReadbacks(size_t maxPending)
+    {
+        while (!mPendingReadbacks.empty())
+        {
+            // Readbacks complete in submission order, so only the oldest one needs to be checked.
+            auto& readback = mPendingReadbacks.front();
+            if (mPendingReadbacks.size() <= maxPending && !readback.pTask->isReady()) break;
+
+            if (!mpImageWriter)
+            {
+                uint32_t threadCount = std::clamp(std::thread::hardware_concurrency() / 2, 1u, kMaxWriterThreads);
+                mpImageWriter = std::make_unique<AsyncImageWriter>(threadCount, kMaxQueuedImages);
+            }
+
+            readback.image.data = readback.pTask->getData();
+            if (mFreeReadbackBuffers.size() < kMaxPendingReadbacks) mFreeReadbackBuffers.push_back(readback.pTask->getBuffer());
+
+            // Blocks if the writer threads fall behind, which in turn throttles rendering.
+            mpImageWriter->write(std::move(readback.image));
+            mPendingReadbacks.pop_front();
+        }
+    }
+
+    void FrameCapture::endRange(RenderGraph* pGraph, const Range& r)
+    {
+        // Flush at the end of the capture sequence so all images are on disk before the script continues.
+        if (!hasFramesAfter(pGraph, r.first + r.second)) flush();
+    }
+
+    bool FrameCapture::hasFramesAfter(const RenderGraph* pGraph, uint64_t frameID) const
+    {
+        auto it = mGraphRanges.find(pGraph);
+        if (it == mGraphRanges.end()) return false;
+        return std::any_of(it->second.begin(), it->second.end(), [frameID](const Range& r) { return r.first >= frameID; });
+    }
+
+    void FrameCapture::flush()
+    {
+        retireReadbacks(0);
+        if (mpImageWriter) mpImageWriter->flush();
     }
 
     void FrameCapture::addFrames(const RenderGraph* pGraph, const uint64_vec& frames)
@@ -28,6 +28,7 @@
 #pragma once
 #include "../../Mogwai.h"
 #include "CaptureTrigger.h"
+#include "AsyncImageWriter.h"
 #include "Utils/Image/ImageProcessing.h"
 
 namespace Mogwai
@@ -36,13 +37,19 @@ namespace Mogwai
     {
     public:
         static UniquePtr create(Renderer* pRenderer);
+        virtual void shutdown() override;
         virtual void renderUI(Gui* pGui) override;
         virtual void registerScriptBindings(pybind11::module& m) override;
         virtual std::string getScriptVar() const override;
         virtual std::string getScript(const std::string& var) const override;
         virtual void triggerFrame(RenderContext* pRenderContext, RenderGraph* pGraph, uint64_t frameID) override;
+        virtual void endRange(RenderGraph* pGraph, const Range& r) override;
         void capture();
 
+        /** Wait until all pending readbacks have completed and all captured images have been written.
+        */
+        void flush();
+
     private:
         FrameCapture(Renderer* pRenderer);
 
@@ -51,8 +58,24 @@ namespace Mogwai
         void addFrames(const std::string& graphName, const uint64_vec& frames);
         std::string graphFramesStr(const RenderGraph* pGraph);
         void captureOutput(RenderContext* pRenderContext, RenderGraph* pGraph, const uint32_t outputIndex);
+        void captureTexture(RenderContext* pRenderContext, const Texture::SharedPtr& pTex, const std::string& filename, Bitmap::FileFormat fileFormat, Bitmap::ExportFlags exportFlags);
+        void retireReadbacks(size_t maxPending);
+        bool hasFramesAfter(const RenderGraph* pGraph, uint64_t frameID) const;
 
         bool mCaptureAllOutputs = false;
+        bool mAsyncCapture = false;
         ImageProcessing::SharedPtr mpImageProcessing;
+
+        /** Texture readback in flight for asynchronous capture.
+        */
+        struct PendingReadback
+        {
+            CopyContext::ReadTextureTask::SharedPtr pTask;
+            AsyncImageWriter::Image image;  ///< Image description, data is filled in once the readback completes.
+        };
+
+        std::deque<PendingReadback> mPendingReadbacks;          ///< Readbacks in submission order.
+        std::vector<Buffer::SharedPtr> mFreeReadbackBuffers;    ///< Readback buffers of retired readbacks, reused for new ones.
+        std::unique_ptr<AsyncImageWriter> mpImageWriter;        ///< Created on first asynchronous capture.
     };
 }
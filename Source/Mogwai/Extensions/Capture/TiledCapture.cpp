@@ -0,0 +1,219 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Falcor.h"
+#include "TiledCapture.h"
+#include <cstring>
+#include <optional>
+
+namespace Mogwai
+{
+    namespace
+    {
+        const std::string kScriptVar = "tiledCapture";
+        const std::string kRender = "render";
+        const std::string kTileSize = "tileSize";
+        const std::string kOverlap = "overlap";
+        const std::string kFramesPerTile = "framesPerTile";
+
+        /** Tile whose readback is in flight.
+        */
+        struct PendingTile
+        {
+            CopyContext::ReadTextureTask::SharedPtr pTask;
+            uint2 dstOffset;    ///< Offset of the tile interior in the output image.
+            uint2 size;         ///< Size of the tile interior in pixels.
+        };
+    }
+
+    MOGWAI_EXTENSION(TiledCapture);
+
+    TiledCapture::UniquePtr TiledCapture::create(Renderer* pRenderer)
+    {
+        return UniquePtr(new TiledCapture(pRenderer));
+    }
+
+    void TiledCapture::registerScriptBindings(pybind11::module& m)
+    {
+        using namespace pybind11::literals;
+
+        pybind11::class_<TiledCapture> tiledCapture(m, "TiledCapture");
+
+        // Members
+        tiledCapture.def(kRender.c_str(), &TiledCapture::render, "width"_a, "height"_a, "path"_a, "output"_a = "");
+
+        // Settings
+        tiledCapture.def_property(kTileSize.c_str(),
+            [](TiledCapture* pTC) { return pTC->mTileSize; },
+            [](TiledCapture* pTC, uint32_t size) { if (size == 0) throw ArgumentError("Tile size must be nonzero."); pTC->mTileSize = size; });
+        tiledCapture.def_property(kOverlap.c_str(),
+            [](TiledCapture* pTC) { return pTC->mOverlap; },
+            [](TiledCapture* pTC, uint32_t overlap) { pTC->mOverlap = overlap; });
+        tiledCapture.def_property(kFramesPerTile.c_str(),
+            [](TiledCapture* pTC) { return pTC->mFramesPerTile; },
+            [](TiledCapture* pTC, uint32_t frames) { if (frames == 0) throw ArgumentError("Frames per tile must be nonzero."); pTC->mFramesPerTile = frames; });
+    }
+
+    std::string TiledCapture::getScriptVar() const
+    {
+        return kScriptVar;
+    }
+
+    void TiledCapture::render(uint32_t width, uint32_t height, std::filesystem::path path, const std::string& output)
+    {
+        RenderGraph* pGraph = mpRenderer->getActiveGraph();
+        Scene::SharedPtr pScene = mpRenderer->getScene();
+        if (!pGraph) throw RuntimeError("TiledCapture: No active graph.");
+        if (!pScene) throw RuntimeError("TiledCapture: No scene loaded.");
+        if (width == 0 || height == 0) throw ArgumentError("TiledCapture: Invalid image size {}x{}.", width, height);
+
+        std::string outputName = output;
+        if (outputName.empty())
+        {
+            if (pGraph->getOutputCount() == 0) throw RuntimeError("TiledCapture: The active graph has no marked outputs.");
+            outputName = pGraph->getOutputName(0);
+        }
+
+        // Render the tiles at the tile size and with the aspect ratio of the full image.
+        // The clock is paused so that all tiles show the same point in time.
+        const uint32_t tileDim = mTileSize + 2 * mOverlap;
+        const auto& pTargetFbo = gpFramework->getTargetFbo();
+        auto pTileFbo = Fbo::create2D(tileDim, tileDim, pTargetFbo->getColorTexture(0)->getFormat());
+
+        auto pCamera = pScene->getCamera();
+        const float aspectRatio = pCamera->getAspectRatio();
+        auto& clock = gpFramework->getGlobalClock();
+        const bool paused = clock.isPaused();
+
+        pGraph->onResize(pTileFbo.get());
+        pCamera->setAspectRatio((float)width / (float)height);
+        clock.pause();
+
+        auto restore = [&]()
+        {
+            pCamera->resetCropWindow();
+            pCamera->setAspectRatio(aspectRatio);
+            if (!paused) clock.play();
+            pGraph->onResize(gpFramework->getTargetFbo().get());
+        };
+
+        try
+        {
+            renderTiles(pGraph, pCamera, uint2(width, height), outputName);
+        }
+        catch (...)
+        {
+            restore();
+            mImage = {};
+            throw;
+        }
+        restore();
+
+        // Write the image. Without a file extension, the format is derived from the output format.
+        std::string ext = path.extension().string();
+        if (ext.empty())
+        {
+            ext = Bitmap::getFileExtFromResourceFormat(mImageFormat);
+            path += "." + ext;
+        }
+        else
+        {
+            ext = ext.substr(1);
+        }
+        Bitmap::FileFormat fileFormat = Bitmap::getFormatFromFileExtension(ext);
+        Bitmap::saveImage(path, width, height, fileFormat, Bitmap::ExportFlags::None, mImageFormat, true, mImage.data());
+        logInfo("TiledCapture: Wrote {}x{} image to '{}'.", width, height, path);
+
+        mImage = {};
+    }
+
+    void TiledCapture::renderTiles(RenderGraph* pGraph, const Camera::SharedPtr& pCamera, const uint2& imageDim, const std::string& output)
+    {
+        RenderContext* pRenderContext = gpDevice->getRenderContext();
+        const uint32_t tileDim = mTileSize + 2 * mOverlap;
+        const uint2 tileCount = div_round_up(imageDim, uint2(mTileSize));
+        uint32_t bytesPerPixel = 0;
+
+        std::optional<PendingTile> pending;
+        Buffer::SharedPtr pFreeBuffer;
+
+        // Copy the interior of a tile into the output image and recycle its readback buffer.
+        auto retireTile = [&](PendingTile& tile)
+        {
+            const std::vector<uint8_t> data = tile.pTask->getData();
+            pFreeBuffer = tile.pTask->getBuffer();
+            for (uint32_t y = 0; y < tile.size.y; y++)
+            {
+                const size_t src = ((size_t)(mOverlap + y) * tileDim + mOverlap) * bytesPerPixel;
+                const size_t dst = ((size_t)(tile.dstOffset.y + y) * imageDim.x + tile.dstOffset.x) * bytesPerPixel;
+                std::memcpy(mImage.data() + dst, data.data() + src, (size_t)tile.size.x * bytesPerPixel);
+            }
+        };
+
+        for (uint32_t ty = 0; ty < tileCount.y; ty++)
+        {
+            for (uint32_t tx = 0; tx < tileCount.x; tx++)
+            {
+                // Crop the camera to the tile including the margin.
+                const uint2 dstOffset = uint2(tx, ty) * mTileSize;
+                const float2 cropOffset = (float2(dstOffset) - float2((float)mOverlap)) / float2(imageDim);
+                const float2 cropSize = float2((float)tileDim) / float2(imageDim);
+                pCamera->setCropWindow(cropOffset, cropSize);
+
+                logInfo("TiledCapture: Rendering tile {}/{}.", ty * tileCount.x + tx + 1, tileCount.x * tileCount.y);
+                for (uint32_t i = 0; i < mFramesPerTile; i++) gpFramework->renderFrame();
+
+                auto pOutput = std::dynamic_pointer_cast<Texture>(pGraph->getOutput(output));
+                if (!pOutput) throw RuntimeError("TiledCapture: Graph output '{}' is not a texture.", output);
+                FALCOR_ASSERT(pOutput->getWidth() == tileDim && pOutput->getHeight() == tileDim);
+
+                if (mImage.empty())
+                {
+                    mImageFormat = pOutput->getFormat();
+                    bytesPerPixel = getFormatBytesPerBlock(mImageFormat);
+                    mImage.resize((size_t)imageDim.x * imageDim.y * bytesPerPixel);
+                }
+                else if (pOutput->getFormat() != mImageFormat)
+                {
+                    throw RuntimeError("TiledCapture: Graph output '{}' changed format during capture.", output);
+                }
+
+                // Start the readback of this tile, then retire the previous one, which has completed in the meantime.
+                PendingTile tile;
+                tile.pTask = pRenderContext->asyncReadTextureSubresource(pOutput.get(), 0, pFreeBuffer);
+                tile.dstOffset = dstOffset;
+                tile.size = glm::min(uint2(mTileSize), imageDim - dstOffset);
+                pFreeBuffer = nullptr;
+
+                if (pending) retireTile(*pending);
+                pending = tile;
+            }
+        }
+
+        if (pending) retireTile(*pending);
+    }
+}
@@ -0,0 +1,71 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "../../Mogwai.h"
+
+namespace Mogwai
+{
+    /** Renders images that are larger than what fits in GPU memory by splitting them into tiles.
+
+        The active graph is resized to the tile size plus an overlap margin on each side, so all graph resources
+        and pass-internal buffers are sized to a tile. For each tile, the camera is cropped to the tile and the
+        graph is executed for a number of frames, e.g. to let AccumulatePass converge. The margin gives passes
+        with a spatial footprint (denoisers, reconstruction filters) valid data at the tile borders and is
+        discarded. The interior of each tile is copied into the output image in CPU memory.
+
+        Tiles are read back asynchronously, i.e., a tile is copied into the output image while the next tile renders.
+    */
+    class TiledCapture : public Extension
+    {
+    public:
+        static UniquePtr create(Renderer* pRenderer);
+
+        virtual void registerScriptBindings(pybind11::module& m) override;
+        virtual std::string getScriptVar() const override;
+
+        /** Render an image in tiles and write it to a file.
+            \param[in] width Image width in pixels.
+            \param[in] height Image height in pixels.
+            \param[in] path Output file. The file format is derived from the extension, or from the output format if there is none.
+            \param[in] output Name of the graph output to capture. If empty, the first marked output is used.
+        */
+        void render(uint32_t width, uint32_t height, std::filesystem::path path, const std::string& output);
+
+    private:
+        TiledCapture(Renderer* pRenderer) : Extension(pRenderer, "Tiled Capture") {}
+
+        void renderTiles(RenderGraph* pGraph, const Camera::SharedPtr& pCamera, const uint2& imageDim, const std::string& output);
+
+        uint32_t mTileSize = 1024;              ///< Size of the tile interior in pixels.
+        uint32_t mOverlap = 32;                 ///< Margin rendered around each tile in pixels. Should cover the footprint of spatial filters in the graph.
+        uint32_t mFramesPerTile = 1;            ///< Number of frames rendered per tile.
+
+        std::vector<uint8_t> mImage;            ///< Output image of the current render, tightly packed rows.
+        ResourceFormat mImageFormat = ResourceFormat::Unknown;
+    };
+}
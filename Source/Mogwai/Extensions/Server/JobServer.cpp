@@ -0,0 +1,366 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Falcor.h"
+#include "JobServer.h"
+#include "Utils/Scripting/Scripting.h"
+#include <json/json.hpp>
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+namespace Mogwai
+{
+    namespace
+    {
+        const std::string kScriptVar = "jobServer";
+        const std::string kStart = "start";
+        const std::string kStop = "stop";
+        const std::string kRunning = "running";
+        const std::string kJobsCompleted = "jobsCompleted";
+        const std::string kJobsFailed = "jobsFailed";
+
+        // Job fields
+        const std::string kScene = "scene";
+        const std::string kGraph = "graph";
+        const std::string kScript = "script";
+        const std::string kCamera = "camera";
+        const std::string kStartTime = "startTime";
+        const std::string kFramerate = "framerate";
+        const std::string kFrameCount = "frameCount";
+        const std::string kCaptureFrames = "captureFrames";
+        const std::string kOutputDir = "outputDir";
+        const std::string kBaseFilename = "baseFilename";
+
+        const std::string kJobExt = ".json";
+        const std::string kReportExt = ".report.json";
+
+        const double kPollInterval = 500.0;     ///< Interval between spool directory scans in ms.
+        const uint32_t kIdleSleep = 50;         ///< Time to sleep per frame in ms when idle in silent mode, to not spin the GPU.
+
+        void runScript(const std::filesystem::path& path)
+        {
+            // Add the script directory to the search paths, like Renderer::loadScript() does.
+            auto directory = path.parent_path();
+            addDataDirectory(directory, true);
+            try
+            {
+                Scripting::runScriptFromFile(path);
+            }
+            catch (...)
+            {
+                removeDataDirectory(directory);
+                throw;
+            }
+            removeDataDirectory(directory);
+        }
+
+        void renameFile(const std::filesystem::path& from, const std::filesystem::path& to)
+        {
+            std::error_code ec;
+            std::filesystem::rename(from, to, ec);
+            if (ec) logWarning("JobServer: Failed to rename '{}' to '{}'.", from, to);
+        }
+
+        void captureOutputs(RenderGraph* pGraph, const std::filesystem::path& outputDir, const std::string& baseFilename, uint32_t frame)
+        {
+            for (uint32_t i = 0; i < pGraph->getOutputCount(); i++)
+            {
+                const std::string outputName = pGraph->getOutputName(i);
+                const Texture::SharedPtr pOutput = pGraph->getOutput(i)->asTexture();
+                if (!pOutput)
+                {
+                    logWarning("JobServer: Graph output '{}' is not a texture. Ignoring it.", outputName);
+                    continue;
+                }
+
+                const std::string ext = Bitmap::getFileExtFromResourceFormat(pOutput->getFormat());
+                const auto path = outputDir / (baseFilename + "." + outputName + "." + std::to_string(frame) + "." + ext);
+                pOutput->captureToFile(0, 0, path, Bitmap::getFormatFromFileExtension(ext));
+            }
+        }
+    }
+
+    MOGWAI_EXTENSION(JobServer);
+
+    JobServer::UniquePtr JobServer::create(Renderer* pRenderer)
+    {
+        return UniquePtr(new JobServer(pRenderer));
+    }
+
+    JobServer::JobServer(Renderer* pRenderer)
+        : Extension(pRenderer, "Job Server")
+    {
+        if (!pRenderer->mOptions.jobSpoolDir.empty()) start(pRenderer->mOptions.jobSpoolDir);
+    }
+
+    void JobServer::registerScriptBindings(pybind11::module& m)
+    {
+        using namespace pybind11::literals;
+
+        pybind11::class_<JobServer> jobServer(m, "JobServer");
+
+        // Members
+        jobServer.def(kStart.c_str(), &JobServer::start, "spoolDir"_a);
+        jobServer.def(kStop.c_str(), &JobServer::stop);
+
+        jobServer.def_property_readonly(kRunning.c_str(), &JobServer::isRunning);
+        jobServer.def_property_readonly(kJobsCompleted.c_str(), [](JobServer* pJS) { return pJS->mJobsCompleted; });
+        jobServer.def_property_readonly(kJobsFailed.c_str(), [](JobServer* pJS) { return pJS->mJobsFailed; });
+    }
+
+    std::string JobServer::getScriptVar() const
+    {
+        return kScriptVar;
+    }
+
+    void JobServer::renderUI(Gui* pGui)
+    {
+        if (!mShowUI) return;
+
+        auto w = Gui::Window(pGui, mName.c_str(), mShowUI, {}, { 400, 200 });
+
+        if (isRunning())
+        {
+            w.text("Spool directory: " + mSpoolDir.string());
+            if (w.button("Stop")) stop();
+        }
+        else
+        {
+            w.text("Stopped");
+        }
+        w.text(fmt::format("Jobs completed: {}\nJobs failed: {}", mJobsCompleted, mJobsFailed));
+        if (!mLastJob.empty()) w.text("Last job: " + mLastJob);
+    }
+
+    void JobServer::start(const std::filesystem::path& spoolDir)
+    {
+        std::filesystem::create_directories(spoolDir);
+        mSpoolDir = std::filesystem::absolute(spoolDir);
+        mLastPoll = {};
+        logInfo("JobServer: Serving jobs from '{}'.", mSpoolDir);
+    }
+
+    void JobServer::endFrame(RenderContext* pRenderContext, const Fbo::SharedPtr& pTargetFbo)
+    {
+        // Jobs render frames themselves, so nested frames must not start another job.
+        if (mBusy || !isRunning()) return;
+
+        const auto now = CpuTimer::getCurrentTimePoint();
+        if (CpuTimer::calcDuration(mLastPoll, now) < kPollInterval)
+        {
+            if (mpRenderer->mOptions.silentMode) std::this_thread::sleep_for(std::chrono::milliseconds(kIdleSleep));
+            return;
+        }
+        mLastPoll = now;
+
+        auto jobs = findJobs();
+        if (!jobs.empty()) runJob(jobs.front());
+    }
+
+    std::vector<std::filesystem::path> JobServer::findJobs() const
+    {
+        std::vector<std::filesystem::path> jobs;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(mSpoolDir, ec))
+        {
+            // Jobs are written to temporary files and renamed once complete, so only complete jobs have the job extension.
+            if (!entry.is_regular_file()) continue;
+            const std::string filename = entry.path().filename().string();
+            if (hasSuffix(filename, kJobExt) && !hasSuffix(filename, kReportExt)) jobs.push_back(entry.path());
+        }
+        std::sort(jobs.begin(), jobs.end());
+        return jobs;
+    }
+
+    void JobServer::runJob(const std::filesystem::path& path)
+    {
+        const std::string jobName = path.stem().string();
+
+        // Claim the job. This fails if the file was removed in the meantime.
+        auto runningPath = path;
+        runningPath += ".running";
+        std::error_code ec;
+        std::filesystem::rename(path, runningPath, ec);
+        if (ec) return;
+
+        logInfo("JobServer: Running job '{}'.", jobName);
+        mBusy = true;
+        mLastJob = jobName;
+
+        auto& clock = gpFramework->getGlobalClock();
+        const bool paused = clock.isPaused();
+
+        nlohmann::json report;
+        report["job"] = jobName;
+        auto timePoint = CpuTimer::getCurrentTimePoint();
+        const auto startTimePoint = timePoint;
+        auto measure = [&](const std::string& name)
+        {
+            const auto now = CpuTimer::getCurrentTimePoint();
+            report["timings"][name] = CpuTimer::calcDuration(timePoint, now) * 1e-3;
+            timePoint = now;
+        };
+
+        auto resolve = [&](const std::filesystem::path& p) { return p.is_relative() ? mSpoolDir / p : p; };
+
+        bool success = false;
+        try
+        {
+            nlohmann::json job;
+            {
+                std::ifstream file(runningPath);
+                job = nlohmann::json::parse(file);
+            }
+
+            // Load the scene unless the last job's scene is still current.
+            bool sceneReused = true;
+            if (job.contains(kScene))
+            {
+                const std::filesystem::path scenePath = job[kScene].get<std::string>();
+                std::filesystem::path fullPath = resolve(scenePath);
+                if (!std::filesystem::exists(fullPath) && !findFileInDataDirectories(scenePath, fullPath))
+                {
+                    throw RuntimeError("Can't find scene file '{}'.", scenePath);
+                }
+                const auto writeTime = std::filesystem::last_write_time(fullPath);
+
+                if (!mpScene || mpRenderer->getScene() != mpScene || fullPath != mScenePath || writeTime != mSceneWriteTime)
+                {
+                    SceneBuilder::Flags buildFlags = SceneBuilder::Flags::Default;
+                    if (mpRenderer->mOptions.useSceneCache) buildFlags |= SceneBuilder::Flags::UseCache;
+                    if (mpRenderer->mOptions.rebuildSceneCache) buildFlags |= SceneBuilder::Flags::RebuildCache;
+
+                    mpScene = nullptr;
+                    mpRenderer->setScene(SceneBuilder::create(fullPath, buildFlags)->getScene());
+                    mpScene = mpRenderer->getScene();
+                    mScenePath = fullPath;
+                    mSceneWriteTime = writeTime;
+                    sceneReused = false;
+                }
+            }
+            report["sceneReused"] = sceneReused;
+            measure("loadScene");
+
+            // Run the graph script unless the graph it added last time is still active.
+            bool graphReused = true;
+            if (job.contains(kGraph))
+            {
+                const auto graphPath = resolve(job[kGraph].get<std::string>());
+                const auto writeTime = std::filesystem::last_write_time(graphPath);
+
+                RenderGraph* pActiveGraph = mpRenderer->getActiveGraph();
+                if (!mpGraph || pActiveGraph != mpGraph.get() || graphPath != mGraphPath || writeTime != mGraphWriteTime)
+                {
+                    mpGraph = nullptr;
+                    runScript(graphPath);
+                    pActiveGraph = mpRenderer->getActiveGraph();
+                    if (!pActiveGraph) throw RuntimeError("Graph script '{}' did not add a render graph.", graphPath);
+                    mpGraph = mpRenderer->getGraph(pActiveGraph->getName());
+                    mGraphPath = graphPath;
+                    mGraphWriteTime = writeTime;
+                    graphReused = false;
+                }
+            }
+            report["graphReused"] = graphReused;
+
+            if (job.contains(kScript)) runScript(resolve(job[kScript].get<std::string>()));
+            measure("loadGraph");
+
+            auto pScene = mpRenderer->getScene();
+            RenderGraph* pGraph = mpRenderer->getActiveGraph();
+            if (!pScene) throw RuntimeError("No scene loaded.");
+            if (!pGraph) throw RuntimeError("No active render graph.");
+
+            if (job.contains(kCamera)) pScene->selectCamera(job[kCamera].get<std::string>());
+
+            const double startTime = job.value(kStartTime, 0.0);
+            const uint32_t framerate = job.value(kFramerate, 60u);
+            const uint32_t frameCount = job.value(kFrameCount, 1u);
+            if (framerate == 0 || frameCount == 0) throw RuntimeError("'{}' and '{}' must be nonzero.", kFramerate, kFrameCount);
+            const std::vector<uint32_t> captureFrames = job.value(kCaptureFrames, std::vector<uint32_t>{ frameCount - 1 });
+
+            const auto outputDir = resolve(job.value(kOutputDir, jobName));
+            const std::string baseFilename = job.value(kBaseFilename, jobName);
+            std::filesystem::create_directories(outputDir);
+
+            // Render with a paused clock and set the animation time explicitly, so jobs are deterministic.
+            // The temporal state of a reused scene and graph is reset, so the output does not depend on the previous job.
+            clock.pause();
+            mpRenderer->mGraphRefreshFlags |= RenderPassRefreshFlags::RenderOptionsChanged;
+            double captureTime = 0.0;
+            for (uint32_t frame = 0; frame < frameCount; frame++)
+            {
+                clock.setTime(startTime + (double)frame / framerate);
+                gpFramework->renderFrame();
+
+                if (std::find(captureFrames.begin(), captureFrames.end(), frame) != captureFrames.end())
+                {
+                    const auto captureStart = CpuTimer::getCurrentTimePoint();
+                    captureOutputs(pGraph, outputDir, baseFilename, frame);
+                    captureTime += CpuTimer::calcDuration(captureStart, CpuTimer::getCurrentTimePoint());
+                }
+            }
+            gpDevice->flushAndSync();
+            measure("render");
+            report["timings"]["render"] = report["timings"]["render"].get<double>() - captureTime * 1e-3;
+            report["timings"]["capture"] = captureTime * 1e-3;
+            report["frameCount"] = frameCount;
+
+            const auto& stats = pScene->getSceneStats();
+            report["memory"]["geometryInBytes"] = stats.geometryMemoryInBytes;
+            report["memory"]["blasInBytes"] = stats.blasMemoryInBytes;
+            report["memory"]["tlasInBytes"] = stats.tlasMemoryInBytes;
+
+            success = true;
+        }
+        catch (const std::exception& e)
+        {
+            logError("JobServer: Job '{}' failed.\n{}", jobName, e.what());
+            report["error"] = e.what();
+        }
+
+        if (!paused) clock.play();
+
+        report["success"] = success;
+        report["timings"]["total"] = CpuTimer::calcDuration(startTimePoint, CpuTimer::getCurrentTimePoint()) * 1e-3;
+        report["memory"]["currentRSS"] = getCurrentRSS();
+        report["memory"]["peakRSS"] = getPeakRSS();
+
+        std::ofstream reportFile(mSpoolDir / (jobName + kReportExt));
+        reportFile << report.dump(4) << std::endl;
+
+        auto finishedPath = path;
+        finishedPath += success ? ".done" : ".failed";
+        renameFile(runningPath, finishedPath);
+
+        if (success) mJobsCompleted++;
+        else mJobsFailed++;
+        logInfo("JobServer: Job '{}' {} in {:.2f} s.", jobName, success ? "completed" : "failed", report["timings"]["total"].get<double>());
+        mBusy = false;
+    }
+}
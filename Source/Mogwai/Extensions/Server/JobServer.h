@@ -0,0 +1,111 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "../../Mogwai.h"
+
+namespace Mogwai
+{
+    /** Persistent render-job server.
+
+        Jobs are JSON files dropped into a spool directory. The server picks them up in filename order and
+        runs them one at a time, keeping the scene and render graph loaded between jobs. A job reloads the scene
+        only if it names a different file or the file changed on disk, and re-runs the graph script only if it
+        differs from the previous job's. Compiled programs and acceleration structures are therefore reused
+        across jobs that share a scene and graph.
+
+        A job file looks like this (all fields are optional):
+
+            {
+                "scene": "Arcade/Arcade.pyscene",   // Scene to render.
+                "graph": "Data/PathTracer.py",      // Script that adds the render graph.
+                "script": "setup.py",               // Script run before rendering each job, e.g. to configure passes.
+                "camera": "Camera0",                // Scene camera to render from.
+                "startTime": 0.0,                   // Animation time of the first frame in seconds.
+                "framerate": 60,                    // Frames per second of animation time.
+                "frameCount": 64,                   // Number of frames to render.
+                "captureFrames": [63],              // Frames whose marked graph outputs are written. Defaults to the last frame.
+                "outputDir": "out",                 // Output directory. Defaults to a directory named after the job.
+                "baseFilename": "arcade"            // Prefix of output files. Defaults to the job name.
+            }
+
+        Job files must appear atomically, as the server may scan the spool directory while a file is written.
+        Clients write the job to '<job>.tmp' in the spool directory and rename it to '<job>.json' once it is complete.
+        A rename within a directory is atomic, so the server never reads a partially written job. Only '.json' files are
+        picked up, temporary files and files with other extensions are ignored.
+
+        Relative paths of scripts and the output directory are relative to the spool directory.
+        While a job runs, its file is renamed to '<job>.json.running', and to '<job>.json.done' or '<job>.json.failed'
+        afterwards. A report with per-job timings, memory usage and the reuse state is written to '<job>.report.json'.
+    */
+    class JobServer : public Extension
+    {
+    public:
+        static UniquePtr create(Renderer* pRenderer);
+
+        virtual void endFrame(RenderContext* pRenderContext, const Fbo::SharedPtr& pTargetFbo) override;
+        virtual void renderUI(Gui* pGui) override;
+        virtual bool hasWindow() const override { return true; }
+        virtual bool isWindowShown() const override { return mShowUI; }
+        virtual void toggleWindow() override { mShowUI = !mShowUI; }
+        virtual void registerScriptBindings(pybind11::module& m) override;
+        virtual std::string getScriptVar() const override;
+
+        /** Start serving jobs from a spool directory. The directory is created if it doesn't exist.
+        */
+        void start(const std::filesystem::path& spoolDir);
+
+        /** Stop serving jobs. A running job is completed first.
+        */
+        void stop() { mSpoolDir.clear(); }
+
+        bool isRunning() const { return !mSpoolDir.empty(); }
+
+    private:
+        JobServer(Renderer* pRenderer);
+
+        std::vector<std::filesystem::path> findJobs() const;
+        void runJob(const std::filesystem::path& path);
+
+        std::filesystem::path mSpoolDir;                ///< Spool directory. Empty if the server is stopped.
+        CpuTimer::TimePoint mLastPoll;                  ///< Time of the last spool directory scan.
+        bool mBusy = false;                             ///< True while a job is running, the job renders frames itself.
+        bool mShowUI = false;
+
+        // State reused across jobs.
+        Scene::SharedPtr mpScene;                       ///< Scene loaded by the last job.
+        std::filesystem::path mScenePath;
+        std::filesystem::file_time_type mSceneWriteTime;
+        RenderGraph::SharedPtr mpGraph;                 ///< Active graph after running the graph script of the last job.
+        std::filesystem::path mGraphPath;
+        std::filesystem::file_time_type mGraphWriteTime;
+
+        uint32_t mJobsCompleted = 0;
+        uint32_t mJobsFailed = 0;
+        std::string mLastJob;
+    };
+}
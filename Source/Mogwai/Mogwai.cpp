@@ -76,6 +76,7 @@ namespace Mogwai
 
     void Renderer::onShutdown()
     {
+        for (auto& pe : mpExtensions) pe->shutdown();
         resetEditor();
         gpDevice->flushAndSync(); // Need to do that because clearing the graphs will try to release some state objects which might be in use
         mGraphs.clear();
@@ -607,7 +608,8 @@ namespace Mogwai
         auto& pGraph = mGraphs[mActiveGraph].pGraph;
 
         // Execute graph.
-        (*pGraph->getPassesDictionary())[kRenderPassRefreshFlags] = RenderPassRefreshFlags::None;
+        (*pGraph->getPassesDictionary())[kRenderPassRefreshFlags] = mGraphRefreshFlags;
+        mGraphRefreshFlags = RenderPassRefreshFlags::None;
         pGraph->execute(pRenderContext);
     }
 
@@ -785,6 +787,7 @@ int main(int argc, char** argv)
     args::ValueFlag<uint32_t> heightFlag(parser, "pixels", "Initial window height.", {"height"});
     args::Flag useSceneCacheFlag(parser, "", "Use scene cache to improve scene load times.", {'c', "use-cache"});
     args::Flag rebuildSceneCacheFlag(parser, "", "Rebuild the scene cache.", {"rebuild-cache"});
+    args::ValueFlag<std::string> serverFlag(parser, "path", "Run as a render-job server that picks up jobs from a spool directory. Combine with --silent for headless operation.", {"server"});
     args::Flag generateShaderDebugInfo(parser, "", "Generate shader debug info.", {'d', "debug-shaders"});
     args::Flag enableDebugLayer(parser, "", "Enable debug layer (enabled by default in Debug build).", {"enable-debug-layer"});
     args::Flag preciseProgram(parser, "", "Force all slang programs to run in precise mode", { "precise" });
@@ -843,6 +846,7 @@ int main(int argc, char** argv)
     if (useSceneCacheFlag) options.useSceneCache = true;
     if (rebuildSceneCacheFlag) options.rebuildSceneCache = true;
     if (generateShaderDebugInfo) options.generateShaderDebugInfo = true;
+    if (serverFlag) options.jobSpoolDir = args::get(serverFlag);
     options.generateShaderDebugInfo = true;
 
     try
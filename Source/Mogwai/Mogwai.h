@@ -29,6 +29,7 @@
 #include "Falcor.h"
 #include "AppData.h"
 #include "RenderGraph/RenderGraph.h"
+#include "RenderGraph/RenderPassStandardFlags.h"
 
 namespace Falcor
 {
@@ -66,6 +67,7 @@ namespace Mogwai
         virtual void removeGraph(RenderGraph* pGraph) {};
         virtual void activeGraphChanged(RenderGraph* pNewGraph, RenderGraph* pPrevGraph) {};
         virtual void onOptionsChange(const Properties& settings){}
+        virtual void shutdown() {};   ///< Called on application shutdown while the device is still alive.
 
     protected:
         Extension(Renderer* pRenderer, const std::string& name) : mpRenderer(pRenderer), mName(name) {}
@@ -86,6 +88,7 @@ namespace Mogwai
             bool useSceneCache = false;
             bool rebuildSceneCache = false;
             bool generateShaderDebugInfo = false;
+            std::string jobSpoolDir;
         };
 
         using KeyCallback = std::function<bool(bool pressed, uint32_t key)>;
@@ -183,6 +186,7 @@ namespace Mogwai
 
         std::vector<GraphData> mGraphs;
         uint32_t mActiveGraph = 0;
+        RenderPassRefreshFlags mGraphRefreshFlags = RenderPassRefreshFlags::None; ///< Refresh flags passed to the passes in the next execution of the active graph.
         Sampler::SharedPtr mpSampler = nullptr;
         std::filesystem::path mScriptPath;
 
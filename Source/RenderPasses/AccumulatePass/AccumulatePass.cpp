@@ -42,6 +42,40 @@ static void regAccumulatePass(pybind11::module& m)
     pybind11::class_<AccumulatePass, RenderPass, AccumulatePass::SharedPtr> pass(m, "AccumulatePass");
     pass.def_property("enabled", &AccumulatePass::isEnabled, &AccumulatePass::setEnabled);
     pass.def("reset", &AccumulatePass::reset);
+    pass.def_property_readonly("converged", &AccumulatePass::isConverged);
+    pass.def_property_readonly("timeBudgetExpired", &AccumulatePass::isTimeBudgetExpired);
+    pass.def_property_readonly("finished", &AccumulatePass::isFinished);
+    pass.def_property_readonly("convergedTileCount", &AccumulatePass::getConvergedTileCount);
+    pass.def_property_readonly("tileCount", [](const AccumulatePass& pass) { uint2 n = pass.getConvergenceTileCount(); return n.x * n.y; });
+
+    // Returns a dictionary with the per-tile relative error and converged flags, each as a list of rows.
+    auto getConvergenceMap = [](const AccumulatePass& pass)
+    {
+        const uint2 tileCount = pass.getConvergenceTileCount();
+        const auto& map = pass.getConvergenceMap();
+
+        pybind11::dict result;
+        pybind11::list errorRows, convergedRows;
+        if (map.size() == tileCount.x * tileCount.y)
+        {
+            for (uint32_t y = 0; y < tileCount.y; y++)
+            {
+                pybind11::list errorRow, convergedRow;
+                for (uint32_t x = 0; x < tileCount.x; x++)
+                {
+                    const float2 tile = map[y * tileCount.x + x];
+                    errorRow.append(tile.x);
+                    convergedRow.append(tile.y != 0.f);
+                }
+                errorRows.append(errorRow);
+                convergedRows.append(convergedRow);
+            }
+        }
+        result["error"] = errorRows;
+        result["converged"] = convergedRows;
+        return result;
+    };
+    pass.def("getConvergenceMap", getConvergenceMap);
 
     pybind11::enum_<AccumulatePass::Precision> precision(m, "AccumulatePrecision");
     precision.value("Double", AccumulatePass::Precision::Double);
@@ -61,6 +95,7 @@ namespace
 
     const char kInputChannel[] = "input";
     const char kOutputChannel[] = "output";
+    const char kOutputVariance[] = "variance";
 
     // Serialized parameters
     const char kEnabled[] = "enabled";
@@ -71,6 +106,11 @@ namespace
     const char kPrecisionMode[] = "precisionMode";
     const char kSubFrameCount[] = "subFrameCount";
     const char kMaxAccumulatedFrames[] = "maxAccumulatedFrames";
+    const char kComputeVariance[] = "computeVariance";
+    const char kConvergenceThreshold[] = "convergenceThreshold";
+    const char kConvergenceTileSize[] = "convergenceTileSize";
+    const char kConvergenceMinFrames[] = "convergenceMinFrames";
+    const char kTimeBudget[] = "timeBudget";
 
     const Gui::DropdownList kModeSelectorList =
     {
@@ -99,6 +139,11 @@ AccumulatePass::AccumulatePass(const Dictionary& dict)
         else if (key == kPrecisionMode) mPrecisionMode = value;
         else if (key == kSubFrameCount) mSubFrameCount = value;
         else if (key == kMaxAccumulatedFrames) mMaxAccumulatedFrames = value;
+        else if (key == kComputeVariance) mComputeVariance = value;
+        else if (key == kConvergenceThreshold) mConvergenceThreshold = value;
+        else if (key == kConvergenceTileSize) mConvergenceTileSize = value;
+        else if (key == kConvergenceMinFrames) mConvergenceMinFrames = value;
+        else if (key == kTimeBudget) mTimeBudget = value;
         else logWarning("Unknown field '{}' in AccumulatePass dictionary.", key);
     }
 
@@ -108,6 +153,13 @@ AccumulatePass::AccumulatePass(const Dictionary& dict)
         if (!dict.keyExists(kEnabled)) mEnabled = dict["enableAccumulation"];
     }
 
+    if (mConvergenceTileSize == 0)
+    {
+        logWarning("AccumulatePass: 'convergenceTileSize' must be nonzero. Using 1.");
+        mConvergenceTileSize = 1;
+    }
+    mConvergenceThreshold = std::max(mConvergenceThreshold, 0.f);
+
     mpState = ComputeState::create();
 }
 
@@ -122,6 +174,14 @@ Dictionary AccumulatePass::getScriptingDictionary()
     dict[kPrecisionMode] = mPrecisionMode;
     dict[kSubFrameCount] = mSubFrameCount;
     dict[kMaxAccumulatedFrames] = mMaxAccumulatedFrames;
+    dict[kComputeVariance] = mComputeVariance;
+    if (isConvergenceTrackingEnabled())
+    {
+        dict[kConvergenceThreshold] = mConvergenceThreshold;
+        dict[kConvergenceTileSize] = mConvergenceTileSize;
+        dict[kConvergenceMinFrames] = mConvergenceMinFrames;
+    }
+    if (mTimeBudget > 0.f) dict[kTimeBudget] = mTimeBudget;
     return dict;
 }
 
@@ -133,6 +193,7 @@ RenderPassReflection AccumulatePass::reflect(const CompileData& compileData)
 
     reflector.addInput(kInputChannel, "Input data to be temporally accumulated").bindFlags(ResourceBindFlags::ShaderResource);
     reflector.addOutput(kOutputChannel, "Output data that is temporally accumulated").bindFlags(ResourceBindFlags::RenderTarget | ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource).format(fmt).texture2D(sz.x, sz.y);
+    reflector.addOutput(kOutputVariance, "Per-pixel variance of the accumulated output in RGB, luminance of the accumulated output in alpha").bindFlags(ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource).format(ResourceFormat::RGBA32Float).texture2D(sz.x, sz.y).flags(RenderPassReflection::Field::Flags::Optional);
     return reflector;
 }
 
@@ -179,6 +240,7 @@ void AccumulatePass::execute(RenderContext* pRenderContext, const RenderData& re
     // Grab our input/output buffers.
     Texture::SharedPtr pSrc = renderData.getTexture(kInputChannel);
     Texture::SharedPtr pDst = renderData.getTexture(kOutputChannel);
+    Texture::SharedPtr pVarianceOutput = renderData.getTexture(kOutputVariance); // Can be nullptr
     FALCOR_ASSERT(pSrc && pDst);
 
     const uint2 resolution = uint2(pSrc->getWidth(), pSrc->getHeight());
@@ -198,7 +260,7 @@ void AccumulatePass::execute(RenderContext* pRenderContext, const RenderData& re
     if (mEnabled && !resolutionMatch)
     {
         logError("AccumulatePass I/O sizes don't match. The pass will be disabled.");
-        mEnabled = false;
+        setEnabled(false);
     }
 
     // Decide action based on current configuration:
@@ -211,18 +273,38 @@ void AccumulatePass::execute(RenderContext* pRenderContext, const RenderData& re
         // Only blit mip 0 and array slice 0, because that's what the accumulation uses otherwise.
         pRenderContext->blit(pSrc->getSRV(0, 1, 0, 1), pDst->getRTV(0, 0, 1));
     }
+    else if (resolutionMatch && mFrameCount == 0 && mConvergedTilesPossible && !isIntegerFormat(pSrc->getFormat()))
+    {
+        // After a reset, the input may still lack the tiles that passes earlier in the graph skipped based on the
+        // previous convergence state. Pass the frame through without accumulating it and clear the state.
+        pRenderContext->blit(pSrc->getSRV(0, 1, 0, 1), pDst->getRTV(0, 0, 1));
+        if (mpTileConvergence) pRenderContext->clearUAV(mpTileConvergence->getUAV().get(), float4(0.f));
+        mConvergedTilesPossible = false;
+    }
     else if (resolutionMatch)
     {
-        accumulate(pRenderContext, pSrc, pDst);
+        const bool trackConvergence = mEnabled && isConvergenceTrackingEnabled();
+        accumulate(pRenderContext, pSrc, pDst, mEnabled && (mComputeVariance || pVarianceOutput || trackConvergence));
+        if (trackConvergence) updateConvergence(pRenderContext);
     }
     else
     {
         logWarning("AccumulatePass unsupported I/O configuration. The output will be cleared.");
         pRenderContext->clearUAV(pDst->getUAV().get(), uint4(0));
     }
+
+    // Without accumulation there is no variance estimate.
+    if (mpVariance && (!mEnabled || !resolutionMatch)) pRenderContext->clearUAV(mpVariance->getUAV().get(), float4(0.f));
+    publish(renderData);
+
+    if (pVarianceOutput)
+    {
+        if (mpVariance) pRenderContext->copyResource(pVarianceOutput.get(), mpVariance.get());
+        else pRenderContext->clearUAV(pVarianceOutput->getUAV().get(), float4(0.f));
+    }
 }
 
-void AccumulatePass::accumulate(RenderContext* pRenderContext, const Texture::SharedPtr& pSrc, const Texture::SharedPtr& pDst)
+void AccumulatePass::accumulate(RenderContext* pRenderContext, const Texture::SharedPtr& pSrc, const Texture::SharedPtr& pDst, bool computeVariance)
 {
     FALCOR_ASSERT(pSrc && pDst);
     FALCOR_ASSERT(pSrc->getWidth() == mFrameDim.x && pSrc->getHeight() == mFrameDim.y);
@@ -256,21 +338,30 @@ void AccumulatePass::accumulate(RenderContext* pRenderContext, const Texture::Sh
     }
 
     // Setup accumulation.
-    prepareAccumulation(pRenderContext, mFrameDim.x, mFrameDim.y);
+    prepareAccumulation(pRenderContext, mFrameDim.x, mFrameDim.y, computeVariance);
 
     // Set shader parameters.
     mpVars["PerFrameCB"]["gResolution"] = mFrameDim;
     mpVars["PerFrameCB"]["gAccumCount"] = mFrameCount;
     mpVars["PerFrameCB"]["gAccumulate"] = mEnabled;
     mpVars["PerFrameCB"]["gMovingAverageMode"] = (mMaxAccumulatedFrames > 0);
+    mpVars["PerFrameCB"]["gComputeVariance"] = computeVariance;
+    mpVars["PerFrameCB"]["gTrackConvergence"] = mpTileConvergence != nullptr;
+    mpVars["PerFrameCB"]["gConvergenceTileSize"] = mConvergenceTileSize;
     mpVars["gCurFrame"] = pSrc;
     mpVars["gOutputFrame"] = pDst;
+    mpVars["gOutputVariance"] = mpVariance; // Can be nullptr
+    mpVars["gTileConvergence"] = mpTileConvergence; // Can be nullptr
 
     // Bind accumulation buffers. Some of these may be nullptr's.
     mpVars["gLastFrameSum"] = mpLastFrameSum;
     mpVars["gLastFrameCorr"] = mpLastFrameCorr;
     mpVars["gLastFrameSumLo"] = mpLastFrameSumLo;
     mpVars["gLastFrameSumHi"] = mpLastFrameSumHi;
+    mpVars["gLastFrameSumSq"] = mpLastFrameSumSq;
+
+    // Start the time budget with the first accumulated frame.
+    if (mFrameCount == 0) mStartTime = CpuTimer::getCurrentTimePoint();
 
     // Update the frame count.
     // The accumulation limit (mMaxAccumulatedFrames) has a special value of 0 (no limit) and is not supported in the SingleCompensated mode.
@@ -323,6 +414,27 @@ void AccumulatePass::renderUI(Gui::Widgets& widget)
             widget.tooltip("0 = no limit");
         }
 
+        if (widget.checkbox("Compute variance", mComputeVariance)) reset();
+        widget.tooltip("Estimate the per-pixel variance of the accumulated output and share it with other passes in the graph, e.g. for adaptive sampling.");
+
+        if (auto group = widget.group("Convergence"))
+        {
+            if (group.var("Threshold", mConvergenceThreshold, 0.f, 1.f, 0.001f)) reset();
+            group.tooltip("Relative standard error at which a tile is considered converged. Converged tiles stop accumulating and are skipped by the path tracer.\n\n0 = convergence tracking disabled");
+            if (group.var("Tile size", mConvergenceTileSize, 1u, 256u)) reset();
+            if (group.var("Min frames", mConvergenceMinFrames, 1u)) reset();
+            group.tooltip("Minimum number of accumulated frames before a tile can converge. The variance estimate is unreliable for few frames.");
+            group.var("Time budget", mTimeBudget, 0.f);
+            group.tooltip("Time in seconds after which rendering is reported as finished, whether or not all tiles have converged.\n\n0 = no limit");
+
+            if (isConvergenceTrackingEnabled())
+            {
+                const uint2 tileCount = getConvergenceTileCount();
+                group.text(fmt::format("Converged tiles {}/{}", mConvergedTileCount, tileCount.x * tileCount.y));
+            }
+            if (isFinished()) group.text("Finished");
+        }
+
         const std::string text = std::string("Frames accumulated ") + std::to_string(mFrameCount);
         widget.text(text);
     }
@@ -348,18 +460,34 @@ void AccumulatePass::setEnabled(bool enabled)
     {
         mEnabled = enabled;
         reset();
+
+        // Without accumulation there is no tile state, passes earlier in the graph must not skip any tiles.
+        if (!mEnabled)
+        {
+            mpTileConvergence = nullptr;
+            mpConvergenceReadbackBuffer = nullptr;
+            mConvergedTilesPossible = false;
+        }
     }
 }
 
 void AccumulatePass::reset()
 {
     mFrameCount = 0;
+
+    // Discard the tile state of the previous accumulation.
+    // The tile state is cleared right away, as passes earlier in the graph read it from the dictionary before this pass executes again.
+    if (mpTileConvergence) gpDevice->getRenderContext()->clearUAV(mpTileConvergence->getUAV().get(), float4(0.f));
+    mpConvergenceReadback = nullptr;
+    mConvergenceMap.clear();
+    mConvergedTileCount = 0;
 }
 
-void AccumulatePass::prepareAccumulation(RenderContext* pRenderContext, uint32_t width, uint32_t height)
+void AccumulatePass::prepareAccumulation(RenderContext* pRenderContext, uint32_t width, uint32_t height, bool computeVariance)
 {
-    // Allocate/resize/clear buffers for intermedate data. These are different depending on accumulation mode.
+    // Allocate/resize buffers for intermedate data. These are different depending on accumulation mode.
     // Buffers that are not used in the current mode are released.
+    // A new buffer restarts accumulation, so all buffers are allocated before any of them are cleared.
     auto prepareBuffer = [&](Texture::SharedPtr& pBuf, ResourceFormat format, bool bufUsed)
     {
         if (!bufUsed)
@@ -374,16 +502,127 @@ void AccumulatePass::prepareAccumulation(RenderContext* pRenderContext, uint32_t
             FALCOR_ASSERT(pBuf);
             reset();
         }
-        // Clear data if accumulation has been reset (either above or somewhere else).
-        if (mFrameCount == 0)
-        {
-            if (getFormatType(format) == FormatType::Float) pRenderContext->clearUAV(pBuf->getUAV().get(), float4(0.f));
-            else pRenderContext->clearUAV(pBuf->getUAV().get(), uint4(0));
-        }
     };
 
     prepareBuffer(mpLastFrameSum, ResourceFormat::RGBA32Float, mPrecisionMode == Precision::Single || mPrecisionMode == Precision::SingleCompensated);
     prepareBuffer(mpLastFrameCorr, ResourceFormat::RGBA32Float, mPrecisionMode == Precision::SingleCompensated);
     prepareBuffer(mpLastFrameSumLo, ResourceFormat::RGBA32Uint, mPrecisionMode == Precision::Double);
     prepareBuffer(mpLastFrameSumHi, ResourceFormat::RGBA32Uint, mPrecisionMode == Precision::Double);
+    prepareBuffer(mpLastFrameSumSq, ResourceFormat::RGBA32Float, computeVariance);
+    prepareBuffer(mpVariance, ResourceFormat::RGBA32Float, computeVariance);
+
+    // The tile state is stored at tile resolution.
+    if (mEnabled && isConvergenceTrackingEnabled())
+    {
+        const uint2 tileCount = getConvergenceTileCount();
+        if (!mpTileConvergence || mpTileConvergence->getWidth() != tileCount.x || mpTileConvergence->getHeight() != tileCount.y)
+        {
+            // Passes earlier in the graph may have skipped tiles that converged in the previous tile state, so accumulation restarts.
+            // Otherwise the accumulated data stays valid, e.g., when tracking is enabled during accumulation,
+            // and the new tile state starts with no converged tiles.
+            if (mpTileConvergence && mConvergedTilesPossible) reset();
+
+            mpTileConvergence = Texture::create2D(tileCount.x, tileCount.y, ResourceFormat::RG32Float, 1, 1, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+            mpTileConvergence->setName("AccumulatePass::TileConvergence");
+            pRenderContext->clearUAV(mpTileConvergence->getUAV().get(), float4(0.f));
+            mpConvergenceReadbackBuffer = nullptr;
+            mpConvergenceReadback = nullptr;
+            mConvergenceMap.clear();
+            mConvergedTileCount = 0;
+        }
+    }
+    else
+    {
+        mpTileConvergence = nullptr;
+        mpConvergenceReadbackBuffer = nullptr;
+    }
+
+    // Clear data if accumulation has been reset (either above or somewhere else).
+    if (mFrameCount == 0)
+    {
+        for (const auto& pBuf : { mpLastFrameSum, mpLastFrameCorr, mpLastFrameSumSq, mpVariance, mpTileConvergence })
+        {
+            if (pBuf) pRenderContext->clearUAV(pBuf->getUAV().get(), float4(0.f));
+        }
+        for (const auto& pBuf : { mpLastFrameSumLo, mpLastFrameSumHi })
+        {
+            if (pBuf) pRenderContext->clearUAV(pBuf->getUAV().get(), uint4(0));
+        }
+    }
+}
+
+void AccumulatePass::updateConvergence(RenderContext* pRenderContext)
+{
+    FALCOR_ASSERT(mpTileConvergence && mpVariance);
+    FALCOR_PROFILE("updateConvergence");
+
+    if (!mpConvergencePass)
+    {
+        Program::DefineList defines;
+        defines.add("_INPUT_FORMAT", "INPUT_FORMAT_FLOAT");
+        mpConvergencePass = ComputePass::create(kShaderFile, "updateConvergence", defines);
+    }
+
+    // Dispatched after the accumulation, so the frame count includes the current frame.
+    auto var = mpConvergencePass["PerFrameCB"];
+    var["gResolution"] = mFrameDim;
+    var["gAccumCount"] = mFrameCount;
+    var["gConvergenceTileSize"] = mConvergenceTileSize;
+    var["gConvergenceMinFrames"] = mConvergenceMinFrames;
+    var["gConvergenceThreshold"] = mConvergenceThreshold;
+    mpConvergencePass["gOutputVariance"] = mpVariance;
+    mpConvergencePass["gTileConvergence"] = mpTileConvergence;
+
+    const uint2 tileCount = getConvergenceTileCount();
+    mpConvergencePass->execute(pRenderContext, tileCount.x, tileCount.y);
+    if (mFrameCount >= mConvergenceMinFrames) mConvergedTilesPossible = true;
+
+    // Fetch the result of an earlier readback if it has completed, then start a new one.
+    // This never waits for the GPU, so the CPU side lags behind by a few frames.
+    if (mpConvergenceReadback && mpConvergenceReadback->isReady())
+    {
+        const std::vector<uint8_t> data = mpConvergenceReadback->getData();
+        mpConvergenceReadbackBuffer = mpConvergenceReadback->getBuffer();
+        mpConvergenceReadback = nullptr;
+
+        mConvergenceMap.resize(data.size() / sizeof(float2));
+        std::memcpy(mConvergenceMap.data(), data.data(), mConvergenceMap.size() * sizeof(float2));
+        mConvergedTileCount = (uint32_t)std::count_if(mConvergenceMap.begin(), mConvergenceMap.end(), [](const float2& tile) { return tile.y != 0.f; });
+    }
+    if (!mpConvergenceReadback)
+    {
+        mpConvergenceReadback = pRenderContext->asyncReadTextureSubresource(mpTileConvergence.get(), 0, mpConvergenceReadbackBuffer);
+    }
+}
+
+void AccumulatePass::publish(const RenderData& renderData)
+{
+    // Publish the variance estimate and convergence state. Passes earlier in the graph pick them up in the next frame.
+    // Entries are only written if this pass provides them, or to clear entries that it has provided before.
+    const bool publishVariance = mComputeVariance && mpVariance;
+    const bool publishConvergence = mEnabled && mpTileConvergence != nullptr;
+    if (!publishVariance && !publishConvergence && !mPublished) return;
+
+    auto& dict = renderData.getDictionary();
+    dict[kRenderPassVarianceEstimate] = publishVariance ? mpVariance : nullptr;
+    dict[kRenderPassConvergenceMask] = publishConvergence ? mpTileConvergence : nullptr;
+    dict[kRenderPassConvergenceTileSize] = mConvergenceTileSize;
+    mPublished = publishVariance || publishConvergence;
+}
+
+bool AccumulatePass::isConverged() const
+{
+    const uint2 tileCount = getConvergenceTileCount();
+    return mpTileConvergence && mConvergenceMap.size() == tileCount.x * tileCount.y && mConvergedTileCount == mConvergenceMap.size();
+}
+
+bool AccumulatePass::isTimeBudgetExpired() const
+{
+    if (mTimeBudget <= 0.f || mFrameCount == 0) return false;
+    return CpuTimer::calcDuration(mStartTime, CpuTimer::getCurrentTimePoint()) * 1e-3 >= mTimeBudget;
+}
+
+uint2 AccumulatePass::getConvergenceTileCount() const
+{
+    return div_round_up(mFrameDim, uint2(mConvergenceTileSize));
 }
@@ -28,6 +28,7 @@
 #pragma once
 #include "Falcor.h"
 #include "RenderGraph/RenderPassHelpers.h"
+#include "Utils/Timing/CpuTimer.h"
 
 using namespace Falcor;
 
@@ -39,6 +40,20 @@ using namespace Falcor;
     For accumulating many samples for ground truth rendering etc., fp32 precision
     is not always sufficient. The pass supports higher precision modes using
     either error compensation (Kahan summation) or double precision math.
+
+    When 'computeVariance' is enabled or the optional 'variance' output is
+    connected, the pass also accumulates the second moment and estimates the
+    per-pixel variance of the accumulated result. With 'computeVariance' the
+    estimate is published in the render data dictionary, so that passes
+    earlier in the graph (e.g. AdaptiveSampling) can use it in the next frame.
+
+    When a convergence threshold is set, the frame is divided into tiles and
+    the relative standard error of each tile is estimated from the variance.
+    Tiles whose error falls below the threshold are marked converged and stop
+    accumulating. The tile state is published in the render data dictionary
+    so that PathTracer can skip converged tiles, and is read back to the CPU
+    without stalling. Scripts can poll isFinished() to stop rendering once all
+    tiles have converged or the time budget has expired.
 */
 class AccumulatePass : public RenderPass
 {
@@ -66,6 +81,32 @@ public:
     // Scripting functions
     void reset();
 
+    /** Check if all tiles have converged. Always false when convergence tracking is disabled.
+        The tile state is read back asynchronously and lags the GPU by a few frames.
+    */
+    bool isConverged() const;
+
+    /** Check if the time budget since the last reset has expired. Always false when no time budget is set.
+    */
+    bool isTimeBudgetExpired() const;
+
+    /** Check if rendering can stop, i.e., all tiles have converged or the time budget has expired.
+    */
+    bool isFinished() const { return isConverged() || isTimeBudgetExpired(); }
+
+    /** Get the number of convergence tiles along x and y.
+    */
+    uint2 getConvergenceTileCount() const;
+
+    /** Get the number of converged tiles in the most recent readback.
+    */
+    uint32_t getConvergedTileCount() const { return mConvergedTileCount; }
+
+    /** Get the most recent readback of the tile state.
+        \return Per-tile relative error (x) and converged flag (y) in scanline order, or an empty vector if no data is available.
+    */
+    const std::vector<float2>& getConvergenceMap() const { return mConvergenceMap; }
+
     enum class Precision : uint32_t
     {
         Double,                 ///< Standard summation in double precision.
@@ -75,8 +116,11 @@ public:
 
 protected:
     AccumulatePass(const Dictionary& dict);
-    void prepareAccumulation(RenderContext* pRenderContext, uint32_t width, uint32_t height);
-    void accumulate(RenderContext* pRenderContext, const Texture::SharedPtr& pSrc, const Texture::SharedPtr& pDst);
+    void prepareAccumulation(RenderContext* pRenderContext, uint32_t width, uint32_t height, bool computeVariance);
+    void accumulate(RenderContext* pRenderContext, const Texture::SharedPtr& pSrc, const Texture::SharedPtr& pDst, bool computeVariance);
+    void updateConvergence(RenderContext* pRenderContext);
+    void publish(const RenderData& renderData);
+    bool isConvergenceTrackingEnabled() const { return mConvergenceThreshold > 0.f; }
 
     // Internal state
     Scene::SharedPtr            mpScene;                        ///< The current scene (or nullptr if no scene).
@@ -91,6 +135,18 @@ protected:
     Texture::SharedPtr          mpLastFrameCorr;                ///< Last frame running compensation term. Used in SingleKahan mode.
     Texture::SharedPtr          mpLastFrameSumLo;               ///< Last frame running sum (lo bits). Used in Double mode.
     Texture::SharedPtr          mpLastFrameSumHi;               ///< Last frame running sum (hi bits). Used in Double mode.
+    Texture::SharedPtr          mpLastFrameSumSq;               ///< Last frame running sum of squares. Used when the variance is computed.
+    Texture::SharedPtr          mpVariance;                     ///< Variance of the accumulated output in RGB, luminance of the accumulated output in alpha. Persists across frames.
+
+    ComputePass::SharedPtr      mpConvergencePass;              ///< Pass updating the per-tile convergence state.
+    Texture::SharedPtr          mpTileConvergence;              ///< Per-tile relative error (x) and converged flag (y). Used when convergence tracking is enabled.
+    CopyContext::ReadTextureTask::SharedPtr mpConvergenceReadback; ///< Pending readback of the tile state.
+    Buffer::SharedPtr           mpConvergenceReadbackBuffer;    ///< Staging buffer reused between readbacks.
+    std::vector<float2>         mConvergenceMap;                ///< Tile state of the most recent readback.
+    uint32_t                    mConvergedTileCount = 0;        ///< Number of converged tiles in the most recent readback.
+    CpuTimer::TimePoint         mStartTime;                     ///< Time of the first accumulated frame since the last reset.
+    bool                        mPublished = false;             ///< True if the pass has published data in the render data dictionary.
+    bool                        mConvergedTilesPossible = false; ///< True if the tile state may contain converged tiles, i.e., the input may lack skipped tiles.
 
     // UI variables
     bool                        mEnabled = true;                ///< True if accumulation is enabled.
@@ -98,6 +154,11 @@ protected:
     Precision                   mPrecisionMode = Precision::Single;
     uint32_t                    mSubFrameCount = 0;             ///< Number of frames to accumulate before reset. Useful for generating references.
     uint32_t                    mMaxAccumulatedFrames = 0;      ///< Number of frames to accumulate before weights become constant. Useful for noise comparisons.
+    bool                        mComputeVariance = false;       ///< Estimate the per-pixel variance and publish it to other passes.
+    float                       mConvergenceThreshold = 0.f;    ///< Relative standard error at which a tile is considered converged. Zero disables convergence tracking.
+    uint32_t                    mConvergenceTileSize = 16;      ///< Size of the convergence tiles in pixels.
+    uint32_t                    mConvergenceMinFrames = 16;     ///< Minimum number of accumulated frames before a tile can converge.
+    float                       mTimeBudget = 0.f;              ///< Time budget in seconds since the last reset. Zero means no limit.
 
     ResourceFormat              mOutputFormat = ResourceFormat::Unknown;                    ///< Output format (uses default when set to ResourceFormat::Unknown).
     RenderPassHelpers::IOSize   mOutputSizeSelection = RenderPassHelpers::IOSize::Default;  ///< Selected output size.
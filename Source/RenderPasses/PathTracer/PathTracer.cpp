@@ -42,6 +42,8 @@ namespace
 
     const std::string kShaderModel = "6_5";
 
+    static_assert(kMaxSamplesPerPixel == kRenderPassMaxSampleCount, "Sample count limit must match the limit of sample count producers");
+
     // Render pass inputs and outputs.
     const std::string kInputVBuffer = "vbuffer";
     const std::string kInputMotionVectors = "mvec";
@@ -1112,6 +1114,7 @@ void PathTracer::setShaderData(const ShaderVar& var, const RenderData& renderDat
     var["vbuffer"] = renderData.getTexture(kInputVBuffer);
     var["viewDir"] = pViewDir; // Can be nullptr
     var["sampleCount"] = pSampleCount; // Can be nullptr
+    var["convergenceMask"] = mpConvergenceMask; // Can be nullptr
     var["outputColor"] = renderData.getTexture(kOutputColor);
 
     if (useLightSampling && mpEmissiveSampler)
@@ -1175,8 +1178,11 @@ bool PathTracer::beginFrame(RenderContext* pRenderContext, const RenderData& ren
     prepareRTXDI(pRenderContext);
     if (mpRTXDI) mpRTXDI->beginFrame(pRenderContext, mParams.frameDim);
 
-    // Update refresh flag if changes that affect the output have occured.
+    // Restart the sample sequence if the application or passes earlier in the graph request a refresh.
     auto& dict = renderData.getDictionary();
+    if (dict.getValue(kRenderPassRefreshFlags, Falcor::RenderPassRefreshFlags::None) != Falcor::RenderPassRefreshFlags::None) mParams.frameCount = 0;
+
+    // Update refresh flag if changes that affect the output have occured.
     if (mOptionsChanged || lightingChanged)
     {
         auto flags = dict.getValue(kRenderPassRefreshFlags, Falcor::RenderPassRefreshFlags::None);
@@ -1194,6 +1200,15 @@ bool PathTracer::beginFrame(RenderContext* pRenderContext, const RenderData& ren
         mRecompile = true;
     }
 
+    // Check if the accumulation provides a convergence mask. Pixels in converged tiles are not path traced.
+    mpConvergenceMask = dict.getValue(kRenderPassConvergenceMask, Texture::SharedPtr());
+    mParams.convergenceTileSize = mpConvergenceMask ? dict.getValue(kRenderPassConvergenceTileSize, 0u) : 0;
+    if (mParams.convergenceTileSize == 0 || uint2(mpConvergenceMask->getWidth(), mpConvergenceMask->getHeight()) != div_round_up(mParams.frameDim, uint2(mParams.convergenceTileSize)))
+    {
+        mpConvergenceMask = nullptr;
+        mParams.convergenceTileSize = 0;
+    }
+
     // Check if fixed sample count should be used. When the sample count input is connected we load the count from there instead.
     mFixedSampleCount = renderData[kInputSampleCount] == nullptr;
 
@@ -177,6 +177,7 @@ private:
     std::unique_ptr<TracePass>      mpTraceDeltaReflectionPass; ///< Delta reflection trace pass (for NRD).
     std::unique_ptr<TracePass>      mpTraceDeltaTransmissionPass;   ///< Delta transmission trace pass (for NRD).
 
+    Texture::SharedPtr              mpConvergenceMask;          ///< Per-tile convergence state published by the accumulation, or nullptr. Pixels in converged tiles are not path traced.
     Texture::SharedPtr              mpSampleOffset;             ///< Output offset into per-sample buffers to where the samples for each pixel are stored (the offset is relative the start of the tile). Only used with non-fixed sample count.
     Buffer::SharedPtr               mpSampleColor;              ///< Compact per-sample color buffer. This is used only if spp > 1.
     Buffer::SharedPtr               mpSampleGuideData;          ///< Compact per-sample denoiser guide data.
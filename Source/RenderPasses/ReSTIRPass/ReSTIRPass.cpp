@@ -39,9 +39,42 @@ extern "C" FALCOR_API_EXPORT const char* getProjDir()
     return PROJECT_DIR;
 }
 
+static void regReSTIRPass(pybind11::module& m)
+{
+    pybind11::enum_<ReSTIRPass::ReservoirResolution> reservoirResolution(m, "ReSTIRReservoirResolution");
+    reservoirResolution.value("Full", ReSTIRPass::ReservoirResolution::Full);
+    reservoirResolution.value("Checkerboard", ReSTIRPass::ReservoirResolution::Checkerboard);
+    reservoirResolution.value("Quarter", ReSTIRPass::ReservoirResolution::Quarter);
+
+    // Only the parameters that can be changed without recompiling the shaders are exposed, plus the reservoir resolution and the GI secondary hit sorting.
+    pybind11::class_<ReSTIRPass::ReSTIRParams> params(m, "ReSTIRParams");
+    params.def(pybind11::init<>());
+    params.def_readwrite("emissiveLightCandidateCount", &ReSTIRPass::ReSTIRParams::emissiveLightCandidateCount);
+    params.def_readwrite("envLightCandidateCount", &ReSTIRPass::ReSTIRParams::envLightCandidateCount);
+    params.def_readwrite("analyticLightCandidateCount", &ReSTIRPass::ReSTIRParams::analyticLightCandidateCount);
+    params.def_readwrite("normalThreshold", &ReSTIRPass::ReSTIRParams::normalThreshold);
+    params.def_readwrite("depthThreshold", &ReSTIRPass::ReSTIRParams::depthThreshold);
+    params.def_readwrite("spatialIterationCount", &ReSTIRPass::ReSTIRParams::spatialIterationCount);
+    params.def_readwrite("spatialReuseSampleRadius", &ReSTIRPass::ReSTIRParams::spatialReuseSampleRadius);
+    params.def_readwrite("spatialVisibilityThreshold", &ReSTIRPass::ReSTIRParams::spatialVisibilityThreshold);
+    params.def_readwrite("temporalHistoryLength", &ReSTIRPass::ReSTIRParams::temporalHistoryLength);
+    params.def_readwrite("reservoirResolution", &ReSTIRPass::ReSTIRParams::reservoirResolution);
+    params.def_readwrite("giTemporalMCap", &ReSTIRPass::ReSTIRParams::giTemporalMCap);
+    params.def_readwrite("giSpatialMCap", &ReSTIRPass::ReSTIRParams::giSpatialMCap);
+    params.def_readwrite("giSpatialIterationCount", &ReSTIRPass::ReSTIRParams::giSpatialIterationCount);
+    params.def_readwrite("giNormalThreshold", &ReSTIRPass::ReSTIRParams::giNormalThreshold);
+    params.def_readwrite("giDepthThreshold", &ReSTIRPass::ReSTIRParams::giDepthThreshold);
+    params.def_readwrite("giSortSecondaryHits", &ReSTIRPass::ReSTIRParams::giSortSecondaryHits);
+
+    pybind11::class_<ReSTIRPass, RenderPass, ReSTIRPass::SharedPtr> pass(m, "ReSTIRPass");
+    // The parameters are returned as a copy, so changes only take effect when assigned back with 'pass.params = params'.
+    pass.def_property("params", &ReSTIRPass::getReSTIRParams, &ReSTIRPass::setReSTIRParams, pybind11::return_value_policy::copy);
+}
+
 extern "C" FALCOR_API_EXPORT void getPasses(Falcor::RenderPassLibrary& lib)
 {
     lib.registerPass(ReSTIRPass::kInfo, ReSTIRPass::create);
+    ScriptBindings::registerBinding(regReSTIRPass);
 }
 
 namespace
@@ -53,6 +86,7 @@ namespace
     const std::string kSpatialReusePassFilename = "RenderPasses/ReSTIRPass/SpatialReuse.cs.slang";
     const std::string kCreateDirectLightSampleFilename = "RenderPasses/ReSTIRPass/CreateDirectLightSamplesPass.cs.slang";
     const std::string kShadePassFilename = "RenderPasses/ReSTIRPass/Shade.cs.slang";
+    const std::string kReconstructPassFilename = "RenderPasses/ReSTIRPass/ReconstructPass.cs.slang";
     const std::string kTemporalReuseGIPassFilename = "RenderPasses/ReSTIRPass/TemporalReuseGI.cs.slang";
     const std::string kSpatialReuseGIPassFilename = "RenderPasses/ReSTIRPass/SpatialReuseGI.cs.slang";
     const std::string kShadingIndirectPassFilename = "RenderPasses/ReSTIRPass/ShadingIndirect.cs.slang";
@@ -67,6 +101,9 @@ namespace
     const uint32_t kMaxPayloadSizeBytes = 100u;// 72u;
     const uint32_t kMaxRecursionDepth = 2u;
 
+    // Number of low key bits holding the ray direction octant when sorting GI secondary hits.
+    const uint32_t kGISortOctantBits = 3u;
+
     const std::string kInputVBuffer = "vbuffer";
     const std::string kInputMotionVectors = "mvec";
 
@@ -92,6 +129,24 @@ namespace
     const char kComputeDirect[] = "computeDirect";
     const char kUseImportanceSampling[] = "useImportanceSampling";
     const std::string kEmissiveSampler = "emissiveSampler";
+    const char kReservoirResolution[] = "reservoirResolution";
+    const char kGISortSecondaryHits[] = "giSortSecondaryHits";
+
+    // Runtime parameters, these can be changed without recompiling the shaders.
+    const char kEmissiveLightCandidateCount[] = "emissiveLightCandidateCount";
+    const char kEnvLightCandidateCount[] = "envLightCandidateCount";
+    const char kAnalyticLightCandidateCount[] = "analyticLightCandidateCount";
+    const char kNormalThreshold[] = "normalThreshold";
+    const char kDepthThreshold[] = "depthThreshold";
+    const char kSpatialIterationCount[] = "spatialIterationCount";
+    const char kSpatialReuseSampleRadius[] = "spatialReuseSampleRadius";
+    const char kSpatialVisibilityThreshold[] = "spatialVisibilityThreshold";
+    const char kTemporalHistoryLength[] = "temporalHistoryLength";
+    const char kGITemporalMCap[] = "giTemporalMCap";
+    const char kGISpatialMCap[] = "giSpatialMCap";
+    const char kGISpatialIterationCount[] = "giSpatialIterationCount";
+    const char kGINormalThreshold[] = "giNormalThreshold";
+    const char kGIDepthThreshold[] = "giDepthThreshold";
 
 
     // ReSTIR Options
@@ -114,6 +169,13 @@ namespace
         { (uint32_t)ReSTIRPass::BiasCorrection::RayTraced, "RayTraced" },
     };
 
+    Gui::DropdownList kReservoirResolutionList =
+    {
+        { (uint32_t)ReSTIRPass::ReservoirResolution::Full, "Full" },
+        { (uint32_t)ReSTIRPass::ReservoirResolution::Checkerboard, "Checkerboard (1/2)" },
+        { (uint32_t)ReSTIRPass::ReservoirResolution::Quarter, "Quarter (1/4)" },
+    };
+
     Gui::DropdownList kLightTileScreenSize =
     {
         { 1, "1" },
@@ -188,11 +250,90 @@ ReSTIRPass::ReSTIRPass(const Dictionary& dict)
 
 void ReSTIRPass::parseDictionary(const Dictionary& dict)
 {
+    for (const auto& [key, value] : dict)
+    {
+        if (key == kReservoirResolution) mReSTIRParams.reservoirResolution = value;
+        else if (key == kGISortSecondaryHits) mReSTIRParams.giSortSecondaryHits = value;
+        else if (key == kEmissiveLightCandidateCount) mReSTIRParams.emissiveLightCandidateCount = value;
+        else if (key == kEnvLightCandidateCount) mReSTIRParams.envLightCandidateCount = value;
+        else if (key == kAnalyticLightCandidateCount) mReSTIRParams.analyticLightCandidateCount = value;
+        else if (key == kNormalThreshold) mReSTIRParams.normalThreshold = value;
+        else if (key == kDepthThreshold) mReSTIRParams.depthThreshold = value;
+        else if (key == kSpatialIterationCount) mReSTIRParams.spatialIterationCount = value;
+        else if (key == kSpatialReuseSampleRadius) mReSTIRParams.spatialReuseSampleRadius = value;
+        else if (key == kSpatialVisibilityThreshold) mReSTIRParams.spatialVisibilityThreshold = value;
+        else if (key == kTemporalHistoryLength) mReSTIRParams.temporalHistoryLength = value;
+        else if (key == kGITemporalMCap) mReSTIRParams.giTemporalMCap = value;
+        else if (key == kGISpatialMCap) mReSTIRParams.giSpatialMCap = value;
+        else if (key == kGISpatialIterationCount) mReSTIRParams.giSpatialIterationCount = value;
+        else if (key == kGINormalThreshold) mReSTIRParams.giNormalThreshold = value;
+        else if (key == kGIDepthThreshold) mReSTIRParams.giDepthThreshold = value;
+        else logWarning("Unknown field '{}' in ReSTIRPass dictionary.", key);
+    }
 }
 
 Dictionary ReSTIRPass::getScriptingDictionary()
 {
-    return Dictionary();
+    Dictionary d;
+    d[kReservoirResolution] = mReSTIRParams.reservoirResolution;
+    d[kGISortSecondaryHits] = mReSTIRParams.giSortSecondaryHits;
+    d[kEmissiveLightCandidateCount] = mReSTIRParams.emissiveLightCandidateCount;
+    d[kEnvLightCandidateCount] = mReSTIRParams.envLightCandidateCount;
+    d[kAnalyticLightCandidateCount] = mReSTIRParams.analyticLightCandidateCount;
+    d[kNormalThreshold] = mReSTIRParams.normalThreshold;
+    d[kDepthThreshold] = mReSTIRParams.depthThreshold;
+    d[kSpatialIterationCount] = mReSTIRParams.spatialIterationCount;
+    d[kSpatialReuseSampleRadius] = mReSTIRParams.spatialReuseSampleRadius;
+    d[kSpatialVisibilityThreshold] = mReSTIRParams.spatialVisibilityThreshold;
+    d[kTemporalHistoryLength] = mReSTIRParams.temporalHistoryLength;
+    d[kGITemporalMCap] = mReSTIRParams.giTemporalMCap;
+    d[kGISpatialMCap] = mReSTIRParams.giSpatialMCap;
+    d[kGISpatialIterationCount] = mReSTIRParams.giSpatialIterationCount;
+    d[kGINormalThreshold] = mReSTIRParams.giNormalThreshold;
+    d[kGIDepthThreshold] = mReSTIRParams.giDepthThreshold;
+    return d;
+}
+
+void ReSTIRPass::setReSTIRParams(const ReSTIRParams& params)
+{
+    const auto& prev = mReSTIRParams;
+
+    // Options that are compile-time constants in the shaders require a recompilation.
+    bool recompile =
+        prev.lightTileScreenSize != params.lightTileScreenSize ||
+        prev.lightTileSize != params.lightTileSize ||
+        prev.lightTileCount != params.lightTileCount ||
+        prev.testInitialSampleVisibility != params.testInitialSampleVisibility ||
+        prev.biasCorrection != params.biasCorrection ||
+        prev.spatialReuseSampleCount != params.spatialReuseSampleCount ||
+        prev.reservoirResolution != params.reservoirResolution ||
+        prev.mode != params.mode ||
+        prev.giUnbiased != params.giUnbiased ||
+        prev.giIndirectOnly != params.giIndirectOnly ||
+        prev.giSpatialReuseSampleCount != params.giSpatialReuseSampleCount ||
+        prev.giBounces != params.giBounces ||
+        prev.giSortSecondaryHits != params.giSortSecondaryHits;
+
+    // Clamp to the same ranges as the UI.
+    mReSTIRParams = params;
+    mReSTIRParams.emissiveLightCandidateCount = std::clamp(params.emissiveLightCandidateCount, kMinLightCandidateCount, kMaxLightCandidateCount);
+    mReSTIRParams.envLightCandidateCount = std::clamp(params.envLightCandidateCount, kMinLightCandidateCount, kMaxLightCandidateCount);
+    mReSTIRParams.analyticLightCandidateCount = std::clamp(params.analyticLightCandidateCount, kMinLightCandidateCount, kMaxLightCandidateCount);
+    mReSTIRParams.normalThreshold = std::clamp(params.normalThreshold, 0.f, 1.f);
+    mReSTIRParams.depthThreshold = std::clamp(params.depthThreshold, 0.f, 1.f);
+    mReSTIRParams.spatialIterationCount = std::clamp(params.spatialIterationCount, kMinSpatialIterationCount, kMaxSpatialIterationCount);
+    mReSTIRParams.spatialReuseSampleRadius = std::clamp(params.spatialReuseSampleRadius, kMinSpatialReuseSampleRadius, kMaxSpatialReuseSampleRadius);
+    mReSTIRParams.spatialVisibilityThreshold = std::clamp(params.spatialVisibilityThreshold, 0.f, mReSTIRParams.spatialReuseSampleRadius);
+    mReSTIRParams.temporalHistoryLength = std::clamp(params.temporalHistoryLength, kMinTemporalHistoryLength, kMaxTemporalHistoryLength);
+    mReSTIRParams.giTemporalMCap = std::clamp(params.giTemporalMCap, kMinGITemporalMCap, kMaxGITemporalMCap);
+    mReSTIRParams.giSpatialMCap = std::clamp(params.giSpatialMCap, kMinGISpatialMCap, kMaxGISpatialMCap);
+    mReSTIRParams.giSpatialIterationCount = std::clamp(params.giSpatialIterationCount, kMinGISpatialIterationCount, kMaxGISpatialIterationCount);
+    mReSTIRParams.giNormalThreshold = std::clamp(params.giNormalThreshold, 0.f, 1.f);
+    mReSTIRParams.giDepthThreshold = std::clamp(params.giDepthThreshold, 0.f, 1.f);
+
+    // The runtime parameters are derived from mReSTIRParams and uploaded every frame.
+    mOptionsChanged = true;
+    if (recompile) mRecompile = true;
 }
 
 RenderPassReflection ReSTIRPass::reflect(const CompileData& compileData)
@@ -219,6 +360,35 @@ void ReSTIRPass::setFrameDim(const uint2 frameDim)
     }
 }
 
+ReSTIRPass::ReservoirResolution ReSTIRPass::getReservoirResolution() const
+{
+    // ReSTIR GI and the decoupled pipeline work on per-pixel buffers.
+    switch (mReSTIRParams.mode)
+    {
+    case Mode::NoResampling:
+    case Mode::SpatialResampling:
+    case Mode::TemporalResampling:
+    case Mode::SpatiotemporalResampling:
+        return mReSTIRParams.reservoirResolution;
+    default:
+        return ReservoirResolution::Full;
+    }
+}
+
+uint2 ReSTIRPass::getReservoirDim() const
+{
+    // This must match getReservoirDim() in HelperFunctions.slang.
+    switch (getReservoirResolution())
+    {
+    case ReservoirResolution::Checkerboard:
+        return uint2((mFrameDim.x + 1) / 2, mFrameDim.y);
+    case ReservoirResolution::Quarter:
+        return (mFrameDim + 1u) / 2u;
+    default:
+        return mFrameDim;
+    }
+}
+
 void ReSTIRPass::setScene(RenderContext* pRenderContext, const Scene::SharedPtr& pScene)
 {
     // Set new scene.
@@ -227,8 +397,18 @@ void ReSTIRPass::setScene(RenderContext* pRenderContext, const Scene::SharedPtr&
     mFrameCount = 0;
     mFrameDim = {};
 
-    // Need to recreate the trace pass because the shader binding table changes.
+    // Report the sorting speedup measured on the previous scene.
+    if (mUnsortedTraceTime > 0.f && mSortedTraceTime > 0.f)
+    {
+        logInfo("ReSTIRPass: GI trace time unsorted {:.3f} ms, sorted {:.3f} ms (speedup {:.2f}x).", mUnsortedTraceTime, mSortedTraceTime, mUnsortedTraceTime / mSortedTraceTime);
+    }
+    mUnsortedTraceTime = 0.f;
+    mSortedTraceTime = 0.f;
+
+    // Need to recreate the trace passes because the shader binding table changes.
     mpTracePass = nullptr;
+    mpGIHitPass = nullptr;
+    mpGISortedShadePass = nullptr;
 
     resetLighting();
 
@@ -249,6 +429,9 @@ void ReSTIRPass::execute(RenderContext* pRenderContext, const RenderData& render
     // Update shader program specialization.
     updatePrograms();
 
+    // Update parameters that don't require recompilation.
+    updateRuntimeParams();
+
     // Prepare resources.
     prepareResources(pRenderContext, renderData);
 
@@ -264,6 +447,7 @@ void ReSTIRPass::execute(RenderContext* pRenderContext, const RenderData& render
         generateInitialCandidatesPass(pRenderContext, renderData);
         createDirectSamplesPass(pRenderContext, renderData);
         shadePass(pRenderContext, renderData);
+        reconstructPass(pRenderContext, renderData);
         break;
     case Mode::SpatialResampling:
         createLightTiles(pRenderContext);
@@ -271,6 +455,7 @@ void ReSTIRPass::execute(RenderContext* pRenderContext, const RenderData& render
         spatialReusePass(pRenderContext, renderData);
         createDirectSamplesPass(pRenderContext, renderData);
         shadePass(pRenderContext, renderData);
+        reconstructPass(pRenderContext, renderData);
         break;
     case Mode::TemporalResampling:
         createLightTiles(pRenderContext);
@@ -278,6 +463,7 @@ void ReSTIRPass::execute(RenderContext* pRenderContext, const RenderData& render
         temporalReusePass(pRenderContext, renderData);
         createDirectSamplesPass(pRenderContext, renderData);
         shadePass(pRenderContext, renderData);
+        reconstructPass(pRenderContext, renderData);
         break;
     case Mode::SpatiotemporalResampling:
         createLightTiles(pRenderContext);
@@ -286,6 +472,7 @@ void ReSTIRPass::execute(RenderContext* pRenderContext, const RenderData& render
         spatialReusePass(pRenderContext, renderData);
         createDirectSamplesPass(pRenderContext, renderData);
         shadePass(pRenderContext, renderData);
+        reconstructPass(pRenderContext, renderData);
         break;
     case Mode::DecoupledPipeline:
         decoupledPipelinePass(pRenderContext, renderData);
@@ -299,7 +486,8 @@ void ReSTIRPass::execute(RenderContext* pRenderContext, const RenderData& render
             spatialReusePass(pRenderContext, renderData);
             createDirectSamplesPass(pRenderContext, renderData);
         }
-        tracePass(pRenderContext, renderData, *mpTracePass);
+        if (mReSTIRParams.giSortSecondaryHits) sortedTracePass(pRenderContext, renderData);
+        else tracePass(pRenderContext, renderData, *mpTracePass);
         temporalReuseGIPass(pRenderContext, renderData);
         spatialReuseGIPass(pRenderContext, renderData);
         shadingIndirectPass(pRenderContext, renderData);
@@ -325,22 +513,23 @@ void ReSTIRPass::renderUI(Gui::Widgets& widget)
 bool ReSTIRPass::renderRenderingUI(Gui::Widgets& widget)
 {
     bool dirty = false;
+    bool recompile = false; // Set for options that are compile-time constants in the shaders.
 
     bool temporalResampling = (mReSTIRParams.mode == Mode::TemporalResampling || mReSTIRParams.mode == Mode::SpatiotemporalResampling || mReSTIRParams.mode == Mode::DecoupledPipeline || mReSTIRParams.mode == Mode::ReSTIRGI);
     bool spatialResampling = (mReSTIRParams.mode == Mode::SpatialResampling || mReSTIRParams.mode == Mode::SpatiotemporalResampling || mReSTIRParams.mode == Mode::DecoupledPipeline || mReSTIRParams.mode == Mode::ReSTIRGI);
 
-    dirty |= widget.dropdown("Mode", kModeList, reinterpret_cast<uint32_t&>(mReSTIRParams.mode));
+    recompile |= widget.dropdown("Mode", kModeList, reinterpret_cast<uint32_t&>(mReSTIRParams.mode));
 
     if (auto group = widget.group("Precomputed light tiles", false))
     {
 
-        dirty |= group.var("Light tile count", mReSTIRParams.lightTileCount, kMinLightTileCount, kMaxLightTileCount);
+        recompile |= group.var("Light tile count", mReSTIRParams.lightTileCount, kMinLightTileCount, kMaxLightTileCount);
         group.tooltip("The number of light tiles created in the presampling phase.");
 
-        dirty |= group.var("Light tile size", mReSTIRParams.lightTileSize, kMinLightTileSize, kMaxLightTileSize);
+        recompile |= group.var("Light tile size", mReSTIRParams.lightTileSize, kMinLightTileSize, kMaxLightTileSize);
         group.tooltip("The size of single light tile created in the presampling phase.");
 
-        dirty |= group.dropdown("Light tile screen size", kLightTileScreenSize, reinterpret_cast<uint32_t&>(mReSTIRParams.lightTileScreenSize));
+        recompile |= group.dropdown("Light tile screen size", kLightTileScreenSize, reinterpret_cast<uint32_t&>(mReSTIRParams.lightTileScreenSize));
         group.tooltip("The size of screen tile in pixels which form a group accessing the same light tile.");
     }
 
@@ -355,11 +544,14 @@ bool ReSTIRPass::renderRenderingUI(Gui::Widgets& widget)
         dirty |= group.var("Analytic light samples", mReSTIRParams.analyticLightCandidateCount, kMinLightCandidateCount, kMaxLightCandidateCount);
         group.tooltip("Number of initial analytic light candidate samples.");
 
-        dirty |= group.checkbox("Test initial candidate visibility", mReSTIRParams.testInitialSampleVisibility);
+        recompile |= group.checkbox("Test initial candidate visibility", mReSTIRParams.testInitialSampleVisibility);
         group.tooltip("Performs a visibility test for the selected initial candidate.");
 
-        dirty |= group.checkbox("Use Checkerboard Rendering", mReSTIRParams.useCheckerboarding);
-        group.tooltip("Create initial candidates in a checkerboard pattern.");
+        if (mReSTIRParams.mode != Mode::DecoupledPipeline && mReSTIRParams.mode != Mode::ReSTIRGI)
+        {
+            recompile |= group.dropdown("Reservoir resolution", kReservoirResolutionList, reinterpret_cast<uint32_t&>(mReSTIRParams.reservoirResolution));
+            group.tooltip("Resolution of the reservoirs relative to the frame. In the reduced modes only one pixel per reservoir is resampled and shaded each frame, the other pixels reuse the illumination of their neighbors.");
+        }
     }
 
     if (temporalResampling)
@@ -382,7 +574,7 @@ bool ReSTIRPass::renderRenderingUI(Gui::Widgets& widget)
                 group.tooltip("Number of spatial reuse iterations.");
             }
 
-            dirty |= group.var("Sample count", mReSTIRParams.spatialReuseSampleCount, kMinSpatialReuseSampleCount, kMaxSpatialReuseSampleCount);
+            recompile |= group.var("Sample count", mReSTIRParams.spatialReuseSampleCount, kMinSpatialReuseSampleCount, kMaxSpatialReuseSampleCount);
             group.tooltip("Number of neighbor samples considered for resampling.");
 
             dirty |= group.var("Sample radius", mReSTIRParams.spatialReuseSampleRadius, kMinSpatialReuseSampleRadius, kMaxSpatialReuseSampleRadius);
@@ -402,7 +594,7 @@ bool ReSTIRPass::renderRenderingUI(Gui::Widgets& widget)
         {
             if (mReSTIRParams.mode != Mode::DecoupledPipeline)
             {
-                dirty |= group.dropdown("Bias correction", kBiasCorrectionList, reinterpret_cast<uint32_t&>(mReSTIRParams.biasCorrection));
+                recompile |= group.dropdown("Bias correction", kBiasCorrectionList, reinterpret_cast<uint32_t&>(mReSTIRParams.biasCorrection));
                 group.tooltip("Type of correction to prevent the occurrence of bias.");
             }
 
@@ -418,15 +610,30 @@ bool ReSTIRPass::renderRenderingUI(Gui::Widgets& widget)
     {
         if (auto group = widget.group("ReSTIR GI", false))
         {
-            dirty |= group.checkbox("Indirect Only", mReSTIRParams.giIndirectOnly);
+            recompile |= group.checkbox("Indirect Only", mReSTIRParams.giIndirectOnly);
             group.tooltip("Compute only indirect light contribution.");
 
-            dirty |= group.checkbox("Unbiased", mReSTIRParams.giUnbiased);
+            recompile |= group.checkbox("Unbiased", mReSTIRParams.giUnbiased);
             group.tooltip("Perform bias correction when resampling.");
 
-            dirty |= group.var("Max. Bounces", mReSTIRParams.giBounces, kMinGIBounces, kMaxGIBounces);
+            recompile |= group.var("Max. Bounces", mReSTIRParams.giBounces, kMinGIBounces, kMaxGIBounces);
             group.tooltip("Maximum number of bounces.");
 
+            recompile |= group.checkbox("Sort Secondary Hits", mReSTIRParams.giSortSecondaryHits);
+            group.tooltip("Sort the first secondary hits by material and ray direction octant before shading them. This reduces divergence in hit shading at the cost of an extra trace and sort.");
+
+            if (mUnsortedTraceTime > 0.f || mSortedTraceTime > 0.f)
+            {
+                std::string timings = "Trace time (unsorted): " + (mUnsortedTraceTime > 0.f ? fmt::format("{:.3f} ms", mUnsortedTraceTime) : std::string("n/a")) + "\n";
+                timings += "Trace time (sorted): " + (mSortedTraceTime > 0.f ? fmt::format("{:.3f} ms", mSortedTraceTime) : std::string("n/a"));
+                if (mUnsortedTraceTime > 0.f && mSortedTraceTime > 0.f) timings += fmt::format("\nSpeedup: {:.2f}x", mUnsortedTraceTime / mSortedTraceTime);
+                group.text(timings);
+            }
+            else
+            {
+                group.text("Enable the profiler to compare sorted and unsorted trace times.");
+            }
+
             dirty |= group.var("Temporal M-cap", mReSTIRParams.giTemporalMCap, kMinGITemporalMCap, kMaxGITemporalMCap);
             group.tooltip("This cap helps to curtail the influence of temporal samples partially, providing new candidates with a better opportunity to be chosen during resampling. Implementing a reasonable M-cap is also necessary to limit correlations between frames.");
 
@@ -436,19 +643,19 @@ bool ReSTIRPass::renderRenderingUI(Gui::Widgets& widget)
             dirty |= group.var("Spatial Iterations", mReSTIRParams.giSpatialIterationCount, kMinGISpatialIterationCount, kMaxGISpatialIterationCount);
             group.tooltip("Number of spatial reuse iterations.");
 
-            dirty |= group.var("Spatial Sample Count", mReSTIRParams.giSpatialReuseSampleCount, kMinGISpatialReuseSampleCount, kMaxGISpatialReuseSampleCount);
+            recompile |= group.var("Spatial Sample Count", mReSTIRParams.giSpatialReuseSampleCount, kMinGISpatialReuseSampleCount, kMaxGISpatialReuseSampleCount);
             group.tooltip("Number of neighbor samples considered for resampling.");
 
-            dirty |= group.var("Depth threshold", mReSTIRParams.giNormalThreshold, 0.f, 1.f);
+            dirty |= group.var("Depth threshold", mReSTIRParams.giDepthThreshold, 0.f, 1.f);
             group.tooltip("Depth threshold for sample reuse.");
 
-            dirty |= group.var("Normal threshold", mReSTIRParams.giDepthThreshold, 0.f, 1.f);
+            dirty |= group.var("Normal threshold", mReSTIRParams.giNormalThreshold, 0.f, 1.f);
             group.tooltip("Normal threshold for sample reuse.");
         }
     }
 
-    if (dirty) mRecompile = true;
-    return dirty;
+    if (recompile) mRecompile = true;
+    return dirty || recompile;
 }
 
 void ReSTIRPass::prepareRenderPass(const RenderData& renderData)
@@ -456,6 +663,9 @@ void ReSTIRPass::prepareRenderPass(const RenderData& renderData)
     // Bind resources.
     auto var = mpTracePass->pVars->getRootVar();
     setShaderData(var, renderData);
+
+    if (mpGIHitPass) setShaderData(mpGIHitPass->pVars->getRootVar(), renderData);
+    if (mpGISortedShadePass) setShaderData(mpGISortedShadePass->pVars->getRootVar(), renderData);
 }
 
 void ReSTIRPass::setShaderData(const ShaderVar& var, const RenderData& renderData, bool useLightSampling) const
@@ -471,6 +681,42 @@ void ReSTIRPass::setShaderData(const ShaderVar& var, const RenderData& renderDat
     }
 }
 
+void ReSTIRPass::updateRuntimeParams()
+{
+    const auto& params = mReSTIRParams;
+
+    mRuntimeParams.normalThreshold = params.normalThreshold;
+    mRuntimeParams.depthThreshold = params.depthThreshold;
+    mRuntimeParams.giNormalThreshold = params.giNormalThreshold;
+    mRuntimeParams.giDepthThreshold = params.giDepthThreshold;
+
+    // Environment light sampling is skipped while the environment alias table is not yet available.
+    uint32_t envLightCandidateCount = mpEnvironmentAliasTable ? params.envLightCandidateCount : 0;
+
+    mRuntimeParams.emissiveLightCandidateCount = params.emissiveLightCandidateCount;
+    mRuntimeParams.envLightCandidateCount = envLightCandidateCount;
+    mRuntimeParams.analyticLightCandidateCount = params.analyticLightCandidateCount;
+    mRuntimeParams.temporalHistoryLength = params.temporalHistoryLength;
+
+    // Partition the light tiles proportionally to the number of candidates of each light type.
+    uint32_t totalCandidateCount = params.emissiveLightCandidateCount + envLightCandidateCount + params.analyticLightCandidateCount;
+    float portionOfEmissiveCandidates = totalCandidateCount > 0 ? float(params.emissiveLightCandidateCount) / float(totalCandidateCount) : 0.f;
+    float portionOfEnvironmentCandidates = totalCandidateCount > 0 ? float(envLightCandidateCount) / float(totalCandidateCount) : 0.f;
+    mRuntimeParams.lightTileEmissiveSampleCount = uint32_t(params.lightTileSize * portionOfEmissiveCandidates);
+    mRuntimeParams.lightTileEnvironmentSampleCount = uint32_t(params.lightTileSize * portionOfEnvironmentCandidates);
+    mRuntimeParams.lightTileAnalyticSampleCount = params.lightTileSize - mRuntimeParams.lightTileEmissiveSampleCount - mRuntimeParams.lightTileEnvironmentSampleCount;
+
+    mRuntimeParams.spatialReuseSampleRadius = params.spatialReuseSampleRadius;
+    mRuntimeParams.spatialVisibilityThreshold = params.spatialVisibilityThreshold;
+    mRuntimeParams.giTemporalMCap = params.giTemporalMCap;
+    mRuntimeParams.giSpatialMCap = params.giSpatialMCap;
+}
+
+void ReSTIRPass::setRuntimeParams(const ShaderVar& rootVar) const
+{
+    rootVar["ReSTIRParamsCB"]["gReSTIRParams"].setBlob(mRuntimeParams);
+}
+
 void ReSTIRPass::tracePass(RenderContext* pRenderContext, const RenderData& renderData, TracePass& tracePass)
 {
     FALCOR_PROFILE(tracePass.name);
@@ -484,10 +730,83 @@ void ReSTIRPass::tracePass(RenderContext* pRenderContext, const RenderData& rend
     if (mVarsChanged) mpSampleGenerator->setShaderData(var);
     var["gGIReservoirs"] = mpGIReservoirs;
     var["gDebug"] = renderData.getTexture(kDebug);
+    setRuntimeParams(var);
+
     // Full screen dispatch.
     mpScene->raytrace(pRenderContext, tracePass.pProgram.get(), tracePass.pVars, { mFrameDim, 1u });
 }
 
+void ReSTIRPass::sortedTracePass(RenderContext* pRenderContext, const RenderData& renderData)
+{
+    FALCOR_PROFILE("sortedTracePass");
+
+    FALCOR_ASSERT(mpGIHitPass && mpGISortedShadePass && mpRadixSort);
+
+    const uint32_t pixelCount = mFrameDim.x * mFrameDim.y;
+    const uint32_t materialCount = mpScene->getMaterialCount();
+
+    // Trace the first scatter ray per pixel and record the hit with its sort key.
+    {
+        FALCOR_PROFILE("traceFirstHit");
+
+        auto var = mpGIHitPass->pVars->getRootVar();
+        mpScene->setRaytracingShaderData(pRenderContext, var);
+
+        if (mVarsChanged) mpSampleGenerator->setShaderData(var);
+        var["CB"]["gMaterialCount"] = materialCount;
+        var["gGIHitRecords"] = mpGIHitRecords;
+        var["gGISortKeys"] = mpGISortKeys;
+        var["gGISortPixels"] = mpGISortPixels;
+        var["gDebug"] = renderData.getTexture(kDebug);
+        setRuntimeParams(var);
+
+        mpScene->raytrace(pRenderContext, mpGIHitPass->pProgram.get(), mpGIHitPass->pVars, { mFrameDim, 1u });
+    }
+
+    // Sort pixels by material ID and direction octant. Keys range up to the material count plus two (miss and inactive).
+    {
+        FALCOR_PROFILE("sortHits");
+
+        uint32_t keyBitCount = kGISortOctantBits;
+        while ((1ull << (keyBitCount - kGISortOctantBits)) < uint64_t(materialCount) + 2) keyBitCount++;
+        mpRadixSort->execute(pRenderContext, mpGISortKeys, mpGISortPixels, pixelCount, RadixSort::KeyType::Uint32, keyBitCount);
+    }
+
+    // Shade the hits in sorted order and write the reservoirs back to their pixels.
+    {
+        FALCOR_PROFILE("shadeSortedHits");
+
+        auto var = mpGISortedShadePass->pVars->getRootVar();
+        mpScene->setRaytracingShaderData(pRenderContext, var);
+
+        if (mVarsChanged) mpSampleGenerator->setShaderData(var);
+        var["gGIHitRecords"] = mpGIHitRecords;
+        var["gGISortPixels"] = mpGISortPixels;
+        var["gGIReservoirs"] = mpGIReservoirs;
+        var["gDebug"] = renderData.getTexture(kDebug);
+        setRuntimeParams(var);
+
+        mpScene->raytrace(pRenderContext, mpGISortedShadePass->pProgram.get(), mpGISortedShadePass->pVars, { mFrameDim, 1u });
+    }
+}
+
+void ReSTIRPass::updateTraceTimings()
+{
+    // The profiler only holds events when it is enabled, so timings are simply not updated otherwise.
+    for (const Profiler::Event* pEvent : Profiler::instance().getEvents())
+    {
+        const std::string& name = pEvent->getName();
+        auto endsWith = [&name](const std::string& suffix)
+        {
+            return name.size() >= suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+        };
+        float time = pEvent->getGpuTimeAverage();
+        if (time <= 0.f) continue;
+        if (endsWith("/tracePass")) mUnsortedTraceTime = time;
+        else if (endsWith("/sortedTracePass")) mSortedTraceTime = time;
+    }
+}
+
 void ReSTIRPass::createLightTiles(RenderContext* pRenderContext)
 {
     FALCOR_PROFILE("createLightTilesPass");
@@ -506,6 +825,7 @@ void ReSTIRPass::createLightTiles(RenderContext* pRenderContext)
     }
 
     mpCreateLightTiles["gScene"] = mpScene->getParameterBlock();
+    setRuntimeParams(mpCreateLightTiles->getRootVar());
 
     mpCreateLightTiles->execute(pRenderContext, uint3(mReSTIRParams.lightTileSize, mReSTIRParams.lightTileCount, 1));
 }
@@ -529,7 +849,8 @@ void ReSTIRPass::loadSurfaceDataPass(RenderContext* pRenderContext, const Render
 
 
     mpLoadSurfaceDataPass["gScene"] = mpScene->getParameterBlock();
-    mpLoadSurfaceDataPass->execute(pRenderContext, { mFrameDim.x, mFrameDim.y, 1u });
+    setRuntimeParams(mpLoadSurfaceDataPass->getRootVar());
+    mpLoadSurfaceDataPass->execute(pRenderContext, { getReservoirDim(), 1u });
 }
 
 void ReSTIRPass::generateInitialCandidatesPass(RenderContext* pRenderContext, const RenderData& renderData)
@@ -571,7 +892,8 @@ void ReSTIRPass::generateInitialCandidatesPass(RenderContext* pRenderContext, co
     }
 
     mpGenerateInitialCandidatesPass["gScene"] = mpScene->getParameterBlock();
-    mpGenerateInitialCandidatesPass->execute(pRenderContext, { !mReSTIRParams.useCheckerboarding ? mFrameDim.x : mFrameDim.x / 2, mFrameDim.y, 1u });
+    setRuntimeParams(mpGenerateInitialCandidatesPass->getRootVar());
+    mpGenerateInitialCandidatesPass->execute(pRenderContext, { getReservoirDim(), 1u });
 }
 
 void ReSTIRPass::temporalReusePass(RenderContext* pRenderContext, const RenderData& renderData)
@@ -609,8 +931,9 @@ void ReSTIRPass::temporalReusePass(RenderContext* pRenderContext, const RenderDa
     }
 
     mpTemporalReusePass["gScene"] = mpScene->getParameterBlock();
+    setRuntimeParams(mpTemporalReusePass->getRootVar());
 
-    mpTemporalReusePass->execute(pRenderContext, { mFrameDim, 1u });
+    mpTemporalReusePass->execute(pRenderContext, { getReservoirDim(), 1u });
 }
 
 void ReSTIRPass::spatialReusePass(RenderContext* pRenderContext, const RenderData& renderData)
@@ -650,8 +973,9 @@ void ReSTIRPass::spatialReusePass(RenderContext* pRenderContext, const RenderDat
         }
 
         mpSpatialReusePass["gScene"] = mpScene->getParameterBlock();
+        setRuntimeParams(mpSpatialReusePass->getRootVar());
 
-        mpSpatialReusePass->execute(pRenderContext, { mFrameDim, 1u });
+        mpSpatialReusePass->execute(pRenderContext, { getReservoirDim(), 1u });
     }
 
 }
@@ -697,6 +1021,7 @@ void ReSTIRPass::decoupledPipelinePass(RenderContext* pRenderContext, const Rend
     }
 
     mpDecoupledPipelinePass["gScene"] = mpScene->getParameterBlock();
+    setRuntimeParams(mpDecoupledPipelinePass->getRootVar());
 
     mpDecoupledPipelinePass->execute(pRenderContext, { mFrameDim, 1u });
 }
@@ -733,8 +1058,9 @@ void ReSTIRPass::createDirectSamplesPass(RenderContext* pRenderContext, const Re
     }
 
     mpCreateDirectLightSamplesPass["gScene"] = mpScene->getParameterBlock();
+    setRuntimeParams(mpCreateDirectLightSamplesPass->getRootVar());
 
-    mpCreateDirectLightSamplesPass->execute(pRenderContext, { mFrameDim, 1u });
+    mpCreateDirectLightSamplesPass->execute(pRenderContext, { getReservoirDim(), 1u });
 }
 
 void ReSTIRPass::shadePass(RenderContext* pRenderContext, const RenderData& renderData)
@@ -749,6 +1075,7 @@ void ReSTIRPass::shadePass(RenderContext* pRenderContext, const RenderData& rend
 
     var["gVBuffer"] = renderData.getTexture(kInputVBuffer);
     var["gDirectLightSamples"] = mpDirectLightSamples;
+    var["gReducedIllumination"] = mpReducedIllumination;
 
     var["gOutputColor"] = renderData.getTexture(kOutputColor);
     var["gOutputAlbedo"] = renderData.getTexture(kOutputAlbedo);
@@ -757,8 +1084,37 @@ void ReSTIRPass::shadePass(RenderContext* pRenderContext, const RenderData& rend
 
 
     mpShadePass["gScene"] = mpScene->getParameterBlock();
+    setRuntimeParams(mpShadePass->getRootVar());
+
+    mpShadePass->execute(pRenderContext, { getReservoirDim(), 1u });
+}
 
-    mpShadePass->execute(pRenderContext, { mFrameDim, 1u });
+void ReSTIRPass::reconstructPass(RenderContext* pRenderContext, const RenderData& renderData)
+{
+    // At full reservoir resolution the shade pass has written every pixel.
+    if (getReservoirResolution() == ReservoirResolution::Full) return;
+
+    FALCOR_PROFILE("reconstructPass");
+
+    // Bind resources.
+    auto var = mpReconstructPass->getRootVar()["CB"]["gReconstructPass"];
+
+    var["gFrameDim"] = mFrameDim;
+    var["gFrameCount"] = mFrameCount;
+
+    var["gVBuffer"] = renderData.getTexture(kInputVBuffer);
+    var["gNormalDepth"] = mpNormalDepth;
+    var["gReducedIllumination"] = mpReducedIllumination;
+
+    var["gOutputColor"] = renderData.getTexture(kOutputColor);
+    var["gOutputAlbedo"] = renderData.getTexture(kOutputAlbedo);
+
+    var["gDebug"] = renderData.getTexture(kDebug);
+
+    mpReconstructPass["gScene"] = mpScene->getParameterBlock();
+    setRuntimeParams(mpReconstructPass->getRootVar());
+
+    mpReconstructPass->execute(pRenderContext, { mFrameDim, 1u });
 }
 
 void ReSTIRPass::temporalReuseGIPass(RenderContext* pRenderContext, const RenderData& renderData)
@@ -781,6 +1137,7 @@ void ReSTIRPass::temporalReuseGIPass(RenderContext* pRenderContext, const Render
 
 
     mpTemporalReuseGIPass["gScene"] = mpScene->getParameterBlock();
+    setRuntimeParams(mpTemporalReuseGIPass->getRootVar());
 
     mpTemporalReuseGIPass->execute(pRenderContext, { mFrameDim, 1u });
 }
@@ -809,6 +1166,7 @@ void ReSTIRPass::spatialReuseGIPass(RenderContext* pRenderContext, const RenderD
 
 
         mpSpatialReuseGIPass["gScene"] = mpScene->getParameterBlock();
+        setRuntimeParams(mpSpatialReuseGIPass->getRootVar());
 
         mpSpatialReuseGIPass->execute(pRenderContext, { mFrameDim, 1u });
     }
@@ -841,6 +1199,7 @@ void ReSTIRPass::shadingIndirectPass(RenderContext* pRenderContext, const Render
     }
 
     mpShadingIndirect["gScene"] = mpScene->getParameterBlock();
+    setRuntimeParams(mpShadingIndirect->getRootVar());
 
     mpShadingIndirect->execute(pRenderContext, { mFrameDim, 1u });
 }
@@ -906,10 +1265,18 @@ void ReSTIRPass::updatePrograms()
 
     // Create trace passes lazily.
     if (!mpTracePass) mpTracePass = std::make_unique<TracePass>("tracePass", "", mpScene, defines, globalTypeConformances);
+    if (mReSTIRParams.giSortSecondaryHits)
+    {
+        if (!mpGIHitPass) mpGIHitPass = std::make_unique<TracePass>("traceFirstHit", "GI_TRACE_FIRST_HIT", mpScene, defines, globalTypeConformances);
+        if (!mpGISortedShadePass) mpGISortedShadePass = std::make_unique<TracePass>("shadeSortedHits", "GI_TRACE_SORTED_SHADE", mpScene, defines, globalTypeConformances);
+        if (!mpRadixSort) mpRadixSort = RadixSort::create();
+    }
 
     // Create program vars for trace programs.
     // We only need to set defines for program specialization here. Type conformances have already been setup on construction.
     mpTracePass->prepareProgram(defines);
+    if (mpGIHitPass) mpGIHitPass->prepareProgram(defines);
+    if (mpGISortedShadePass) mpGISortedShadePass->prepareProgram(defines);
 
     Program::Desc baseDesc;
     baseDesc.addShaderModules(mpScene->getShaderModules());
@@ -958,6 +1325,12 @@ void ReSTIRPass::updatePrograms()
         desc.addShaderLibrary(kShadePassFilename).csEntry("main");
         mpShadePass = ComputePass::create(desc, defines, false);
     }
+    if (!mpReconstructPass && mReSTIRParams.mode != Mode::DecoupledPipeline)
+    {
+        Program::Desc desc = baseDesc;
+        desc.addShaderLibrary(kReconstructPassFilename).csEntry("main");
+        mpReconstructPass = ComputePass::create(desc, defines, false);
+    }
     if (!mpTemporalReuseGIPass && mReSTIRParams.mode != Mode::DecoupledPipeline)
     {
         Program::Desc desc = baseDesc;
@@ -997,6 +1370,7 @@ void ReSTIRPass::updatePrograms()
     prepareProgram(mpSpatialReusePass->getProgram());
     prepareProgram(mpCreateDirectLightSamplesPass->getProgram());
     prepareProgram(mpShadePass->getProgram());
+    prepareProgram(mpReconstructPass->getProgram());
     prepareProgram(mpTemporalReuseGIPass->getProgram());
     prepareProgram(mpSpatialReuseGIPass->getProgram());
     prepareProgram(mpShadingIndirect->getProgram());
@@ -1009,6 +1383,7 @@ void ReSTIRPass::updatePrograms()
     mpSpatialReusePass->setVars(nullptr);
     mpCreateDirectLightSamplesPass->setVars(nullptr);
     mpShadePass->setVars(nullptr);
+    mpReconstructPass->setVars(nullptr);
     mpTemporalReuseGIPass->setVars(nullptr);
     mpSpatialReuseGIPass->setVars(nullptr);
     mpShadingIndirect->setVars(nullptr);
@@ -1022,34 +1397,38 @@ void ReSTIRPass::prepareResources(RenderContext* pRenderContext, const RenderDat
 {
     uint32_t pixelCount = mFrameDim.x * mFrameDim.y;
 
+    // Per-reservoir buffers are sized to the reservoir grid, which is smaller than the frame at reduced reservoir resolution.
+    const uint2 reservoirDim = getReservoirDim();
+    uint32_t reservoirCount = reservoirDim.x * reservoirDim.y;
+
     // Create reservoir buffers.
-    if (!mpReservoirs || mpReservoirs->getElementCount() < pixelCount)
+    if (!mpReservoirs || mpReservoirs->getElementCount() < reservoirCount)
     {
-        mpReservoirs = Buffer::createStructured(sizeof(uint4), pixelCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+        mpReservoirs = Buffer::createStructured(sizeof(uint4), reservoirCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
     }
-    if (!mpPrevReservoirs || mpPrevReservoirs->getElementCount() < pixelCount)
+    if (!mpPrevReservoirs || mpPrevReservoirs->getElementCount() < reservoirCount)
     {
-        mpPrevReservoirs = Buffer::createStructured(sizeof(uint4), pixelCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+        mpPrevReservoirs = Buffer::createStructured(sizeof(uint4), reservoirCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
     }
 
     // Create surface data buffers.
-    if (!mpSurfaceData || mpSurfaceData->getElementCount() < pixelCount)
+    if (!mpSurfaceData || mpSurfaceData->getElementCount() < reservoirCount)
     {
-        mpSurfaceData = Buffer::createStructured(sizeof(uint4) * 2, pixelCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+        mpSurfaceData = Buffer::createStructured(sizeof(uint4) * 2, reservoirCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
     }
-    if (!mpPrevSurfaceData || mpPrevSurfaceData->getElementCount() < pixelCount)
+    if (!mpPrevSurfaceData || mpPrevSurfaceData->getElementCount() < reservoirCount)
     {
-        mpPrevSurfaceData = Buffer::createStructured(sizeof(uint4) * 2, pixelCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+        mpPrevSurfaceData = Buffer::createStructured(sizeof(uint4) * 2, reservoirCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
     }
 
     // Create normal depth buffers.
-    if (!mpNormalDepth || mpNormalDepth->getElementCount() < pixelCount)
+    if (!mpNormalDepth || mpNormalDepth->getElementCount() < reservoirCount)
     {
-        mpNormalDepth = Buffer::createStructured(sizeof(uint2), pixelCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+        mpNormalDepth = Buffer::createStructured(sizeof(uint2), reservoirCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
     }
-    if (!mpPrevNormalDepth || mpPrevNormalDepth->getElementCount() < pixelCount)
+    if (!mpPrevNormalDepth || mpPrevNormalDepth->getElementCount() < reservoirCount)
     {
-        mpPrevNormalDepth = Buffer::createStructured(sizeof(uint2), pixelCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+        mpPrevNormalDepth = Buffer::createStructured(sizeof(uint2), reservoirCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
     }
 
     // Create light tile buffers.
@@ -1059,9 +1438,15 @@ void ReSTIRPass::prepareResources(RenderContext* pRenderContext, const RenderDat
         mpLightTiles = Buffer::createStructured(sizeof(uint4) * 2, elementCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
     }
 
-    if (mReSTIRParams.mode != Mode::DecoupledPipeline && (!mpDirectLightSamples || mpDirectLightSamples->getElementCount() < pixelCount))
+    if (mReSTIRParams.mode != Mode::DecoupledPipeline && (!mpDirectLightSamples || mpDirectLightSamples->getElementCount() < reservoirCount))
+    {
+        mpDirectLightSamples = Buffer::createStructured(sizeof(uint4), reservoirCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+    }
+
+    // Create the buffer for the illumination shared with the reconstructed pixels.
+    if (getReservoirResolution() != ReservoirResolution::Full && (!mpReducedIllumination || mpReducedIllumination->getElementCount() < reservoirCount))
     {
-        mpDirectLightSamples = Buffer::createStructured(sizeof(uint4), pixelCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+        mpReducedIllumination = Buffer::createStructured(sizeof(float4), reservoirCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
     }
 
     // Create GI reservoirs
@@ -1077,6 +1462,21 @@ void ReSTIRPass::prepareResources(RenderContext* pRenderContext, const RenderDat
     {
         mpSpatialGIReservoirs = Buffer::createStructured(sizeof(uint4) * 4, pixelCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
     }
+
+    // Create buffers for sorting the GI secondary hits.
+    if (mReSTIRParams.mode == Mode::ReSTIRGI && mReSTIRParams.giSortSecondaryHits)
+    {
+        FALCOR_ASSERT(mpGIHitPass);
+        if (!mpGIHitRecords || mpGIHitRecords->getElementCount() < pixelCount)
+        {
+            mpGIHitRecords = Buffer::createStructured(mpGIHitPass->pProgram.get(), "gGIHitRecords", pixelCount, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr, false);
+        }
+        if (!mpGISortKeys || mpGISortKeys->getSize() < pixelCount * sizeof(uint32_t))
+        {
+            mpGISortKeys = Buffer::create(pixelCount * sizeof(uint32_t), Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None);
+            mpGISortPixels = Buffer::create(pixelCount * sizeof(uint32_t), Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess, Buffer::CpuAccess::None);
+        }
+    }
 }
 
 bool ReSTIRPass::prepareLighting(RenderContext* pRenderContext)
@@ -1097,26 +1497,38 @@ bool ReSTIRPass::prepareLighting(RenderContext* pRenderContext)
 
     if (is_set(mpScene->getUpdates(), Scene::UpdateFlags::EnvMapChanged))
     {
+        mpEnvMapImportance = nullptr;
         mpEnvironmentAliasTable = nullptr;
+        mpEnvironmentLuminanceTable = nullptr;
         lightingChanged = true;
         mRecompile = true;
     }
 
     if (mpScene->useEnvLight())
     {
-        if (!mpEnvironmentAliasTable || !mpEnvironmentLuminanceTable)
+        // The importance data is shared with other passes and persisted in the scene cache.
+        // The first time an environment map is used, the alias table is built asynchronously and
+        // environment light sampling is disabled until it is ready (see updateRuntimeParams()).
+        if (!mpEnvMapImportance)
         {
-            const auto& environmentMapTex = mpScene->getEnvMap()->getEnvMap();
-            mpEnvironmentAliasTable = createEnvironmentAliasTable(pRenderContext, environmentMapTex);
+            mpEnvMapImportance = EnvMapImportance::get(pRenderContext, mpScene->getEnvMap()->getEnvMap());
+        }
+
+        if (!mpEnvironmentAliasTable && mpEnvMapImportance->isReady())
+        {
+            mpEnvironmentAliasTable = mpEnvMapImportance->getAliasTable();
+            mpEnvironmentLuminanceTable = mpEnvMapImportance->getLuminanceTable();
             lightingChanged = true;
             mRecompile = true;
         }
     }
     else
     {
-        if (mpEnvironmentAliasTable)
+        if (mpEnvMapImportance)
         {
+            mpEnvMapImportance = nullptr;
             mpEnvironmentAliasTable = nullptr;
+            mpEnvironmentLuminanceTable = nullptr;
             lightingChanged = true;
             mRecompile = true;
         }
@@ -1199,6 +1611,8 @@ bool ReSTIRPass::prepareLighting(RenderContext* pRenderContext)
         lightingChanged |= mpEmissiveSampler->update(pRenderContext);
         auto defines = mpEmissiveSampler->getDefines();
         if (mpTracePass && mpTracePass->pProgram->addDefines(defines)) mRecompile = true;
+        if (mpGIHitPass && mpGIHitPass->pProgram->addDefines(defines)) mRecompile = true;
+        if (mpGISortedShadePass && mpGISortedShadePass->pProgram->addDefines(defines)) mRecompile = true;
     }
 
     return lightingChanged;
@@ -1222,62 +1636,6 @@ AliasTable::SharedPtr ReSTIRPass::createEmissiveGeometryAliasTable(RenderContext
     return AliasTable::create(std::move(weights), mRnd);
 }
 
-AliasTable::SharedPtr ReSTIRPass::createEnvironmentAliasTable(RenderContext* pRenderContext, const Texture::SharedPtr& envTexture)
-{
-    assert(envTexture);
-
-    uint32_t width = envTexture->getWidth();
-    uint32_t height = envTexture->getHeight();
-    uint32_t texelCount = width * height;
-    uint32_t channelCount = getFormatChannelCount(envTexture->getFormat());
-
-    if (getFormatType(envTexture->getFormat()) != FormatType::Float) return nullptr;
-
-    std::vector<uint8_t> rawTexture = pRenderContext->readTextureSubresource(envTexture.get(), 0);
-    const float* texels = reinterpret_cast<const float*>(rawTexture.data());
-
-    std::vector<float> envMapLuminances(texelCount);
-
-    if (channelCount == 1)
-    {
-        for (size_t i = 0; i < texelCount; i++)
-        {
-            envMapLuminances[i] = texels[i * channelCount];
-        }
-    }
-    else if (channelCount == 3 || channelCount == 4)
-    {
-        for (size_t i = 0; i < texelCount; i++)
-        {
-            envMapLuminances[i] = luminance(float3(texels[i * channelCount], texels[i * channelCount + 1], texels[i * channelCount + 2]));
-        }
-    }
-    else
-    {
-        throw std::exception("FAILED TO BUILD ENV ALIAS TABLE: Invalid number of color channels in environment map texture.");
-    }
-
-    mpEnvironmentLuminanceTable = Buffer::createTyped<float>((uint32_t)envMapLuminances.size(), ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, envMapLuminances.data());
-
-    std::vector<float> weights(texelCount);
-
-    for (size_t y = 0; y < height; y++)
-    {
-        float theta = ((y + 0.5f) / height) * static_cast<float>(M_PI);
-        float dPhi = 2.f * static_cast<float>(M_PI) / width;
-        float dTheta = static_cast<float>(M_PI) / height;
-        float diffSolidAngle = dPhi * dTheta * std::sin(theta);
-
-        for (size_t x = 0; x < width; x++)
-        {
-            size_t index = y * width + x;
-            weights[index] = diffSolidAngle * envMapLuminances[index];
-        }
-    }
-
-    return AliasTable::create(std::move(weights), mRnd);
-}
-
 AliasTable::SharedPtr ReSTIRPass::createAnalyticLightsAliasTable(RenderContext* pRenderContext)
 {
     const auto& activeAnalyticLights = mpScene->getActiveLights();
@@ -1306,6 +1664,7 @@ void ReSTIRPass::resetLighting()
 {
     // Retain the options for the emissive sampler.
 
+    mpEnvMapImportance = nullptr;
     mpEnvironmentAliasTable = nullptr;
     mpEnvironmentLuminanceTable = nullptr;
     mpEmissiveGeometryAliasTable = nullptr;
@@ -1314,6 +1673,14 @@ void ReSTIRPass::resetLighting()
     mRecompile = true;
 }
 
+void ReSTIRPass::resetTemporalReuse(RenderContext* pRenderContext)
+{
+    // Restart the frame count used for seeding and drop the reservoirs of previous frames.
+    mFrameCount = 0;
+    if (mpPrevReservoirs) pRenderContext->clearUAV(mpPrevReservoirs->getUAV().get(), uint4(0));
+    if (mpPrevGIReservoirs) pRenderContext->clearUAV(mpPrevGIReservoirs->getUAV().get(), uint4(0));
+}
+
 bool ReSTIRPass::beginFrame(RenderContext* pRenderContext, const RenderData& renderData)
 {
     const auto& pOutputColor = renderData.getTexture(kOutputColor);
@@ -1365,8 +1732,11 @@ bool ReSTIRPass::beginFrame(RenderContext* pRenderContext, const RenderData& ren
     // Update the env map and emissive sampler to the current frame.
     bool lightingChanged = prepareLighting(pRenderContext);
 
-    // Update refresh flag if changes that affect the output have occured.
+    // Reset the temporal reuse if the application or passes earlier in the graph request a refresh.
     auto& dict = renderData.getDictionary();
+    if (dict.getValue(kRenderPassRefreshFlags, Falcor::RenderPassRefreshFlags::None) != Falcor::RenderPassRefreshFlags::None) resetTemporalReuse(pRenderContext);
+
+    // Update refresh flag if changes that affect the output have occured.
     if (mOptionsChanged || lightingChanged)
     {
         auto flags = dict.getValue(kRenderPassRefreshFlags, Falcor::RenderPassRefreshFlags::None);
@@ -1384,6 +1754,8 @@ void ReSTIRPass::endFrame(RenderContext* pRenderContext, const RenderData& rende
     mVarsChanged = false;
     mFrameCount++;
 
+    if (mReSTIRParams.mode == Mode::ReSTIRGI) updateTraceTimings();
+
     // Swap reservoir data.
     auto copyTexture = [pRenderContext](Texture* pDst, const Texture* pSrc)
     {
@@ -1424,18 +1796,11 @@ Program::DefineList ReSTIRPass::StaticParams::getDefines(const ReSTIRPass& owner
     defines.add("USE_ANALYTIC_LIGHTS", scene && scene->useAnalyticLights() ? "1" : "0");
     defines.add("USE_EMISSIVE_LIGHTS", scene && scene->useEmissiveLights() ? "1" : "0");
 
-    defines.add("EMISSIVE_LIGHT_CANDIDATE_COUNT", std::to_string(owner.mReSTIRParams.emissiveLightCandidateCount));
-    defines.add("ENV_LIGHT_CANDIDATE_COUNT", std::to_string(owner.mReSTIRParams.envLightCandidateCount));
-    defines.add("ANALYTIC_LIGHT_CANDIDATE_COUNT", std::to_string(owner.mReSTIRParams.analyticLightCandidateCount));
+    // ReSTIR configuration that changes the code structure.
+    // Tuning values such as thresholds and candidate counts are passed in ReSTIRRuntimeParams instead.
     defines.add("TEST_INITIAL_SAMPLE_VISIBILITY", std::to_string(owner.mReSTIRParams.testInitialSampleVisibility));
 
-    defines.add("DEPTH_THRESHOLD", std::to_string(owner.mReSTIRParams.depthThreshold));
-    defines.add("NORMAL_THRESHOLD", std::to_string(owner.mReSTIRParams.normalThreshold));
-
-    defines.add("TEMPORAL_MAX_HISTORY_LENGTH", std::to_string(owner.mReSTIRParams.temporalHistoryLength));
-
     defines.add("SPATIAL_REUSE_SAMPLE_COUNT", std::to_string(owner.mReSTIRParams.spatialReuseSampleCount));
-    defines.add("SPATIAL_REUSE_SAMPLE_RADIUS", std::to_string(owner.mReSTIRParams.spatialReuseSampleRadius));
 
     defines.add("UNBIASED_NAIVE", owner.mReSTIRParams.biasCorrection == ReSTIRPass::BiasCorrection::Naive ? "1" : "0");
     defines.add("UNBIASED_MIS", owner.mReSTIRParams.biasCorrection == ReSTIRPass::BiasCorrection::MIS || owner.mReSTIRParams.biasCorrection == ReSTIRPass::BiasCorrection::RayTraced ? "1" : "0");
@@ -1446,23 +1811,10 @@ Program::DefineList ReSTIRPass::StaticParams::getDefines(const ReSTIRPass& owner
     defines.add("LIGHT_TILE_COUNT", std::to_string(owner.mReSTIRParams.lightTileCount));
     defines.add("LIGHT_TILE_SCREEN_SIZE", std::to_string(owner.mReSTIRParams.lightTileScreenSize));
 
-    uint32_t totalCandidateCount = owner.mReSTIRParams.emissiveLightCandidateCount + owner.mReSTIRParams.envLightCandidateCount + owner.mReSTIRParams.analyticLightCandidateCount;
-    float portionOfEmissiveCandidates = float(owner.mReSTIRParams.emissiveLightCandidateCount) / float(totalCandidateCount);
-    float portionOfEnvironmentCandidates = float(owner.mReSTIRParams.envLightCandidateCount) / float(totalCandidateCount);
-    defines.add("LIGHT_TILE_EMISSIVE_SAMPLE_COUNT", std::to_string(uint32_t(owner.mReSTIRParams.lightTileSize * portionOfEmissiveCandidates)));
-    defines.add("LIGHT_TILE_ENVIRONMENT_SAMPLE_COUNT", std::to_string(uint32_t(owner.mReSTIRParams.lightTileSize * portionOfEnvironmentCandidates)));
-    uint32_t lightTileAnalyticSampleCount = owner.mReSTIRParams.lightTileSize - uint32_t(owner.mReSTIRParams.lightTileSize * portionOfEmissiveCandidates) - uint32_t(owner.mReSTIRParams.lightTileSize * portionOfEnvironmentCandidates);
-    defines.add("LIGHT_TILE_ANALYTIC_SAMPLE_COUNT", std::to_string(lightTileAnalyticSampleCount));
-
-    defines.add("USE_CHECKERBOARDING", owner.mReSTIRParams.useCheckerboarding ? "1" : "0");
-    defines.add("SPATIAL_VISIBILITY_THRESHOLD", std::to_string(owner.mReSTIRParams.spatialVisibilityThreshold));
+    defines.add("RESERVOIR_RESOLUTION", std::to_string((uint32_t)owner.getReservoirResolution()));
 
     // ReSTIR GI defines
-    defines.add("GI_TEMPORAL_MCAP", std::to_string(owner.mReSTIRParams.giTemporalMCap));
-    defines.add("GI_SPATIAL_MCAP", std::to_string(owner.mReSTIRParams.giSpatialMCap));
     defines.add("GI_SPATIAL_SAMPLE_COUNT", std::to_string(owner.mReSTIRParams.giSpatialReuseSampleCount));
-    defines.add("GI_DEPTH_THRESHOLD", std::to_string(owner.mReSTIRParams.giDepthThreshold));
-    defines.add("GI_NORMAL_THRESHOLD", std::to_string(owner.mReSTIRParams.giNormalThreshold));
     defines.add("GI_BOUNCES", std::to_string(owner.mReSTIRParams.giBounces));
     defines.add("GI_INDIRECT_ONLY", owner.mReSTIRParams.giIndirectOnly ? "1" : "0");
     defines.add("GI_UNBIASED", owner.mReSTIRParams.giUnbiased ? "1" : "0");
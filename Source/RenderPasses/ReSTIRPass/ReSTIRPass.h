@@ -27,10 +27,13 @@
  **************************************************************************/
 #pragma once
 #include "Falcor.h"
+#include "Params.slang"
 #include "Utils/Sampling/SampleGenerator.h"
 #include "Rendering/Lights/EmissivePowerSampler.h"
 #include "Rendering/Lights/EnvMapSampler.h"
+#include "Rendering/Lights/EnvMapImportance.h"
 #include "Utils/Sampling/AliasTable.h"
+#include "Utils/Algorithm/RadixSort.h"
 #include "RenderGraph/RenderPassHelpers.h"
 
 using namespace Falcor;
@@ -71,6 +74,73 @@ public:
         RayTraced,
     };
 
+    /** Resolution of the direct illumination reservoirs relative to the frame.
+        In the reduced modes only one pixel per reservoir cell is resampled and shaded each frame
+        and the remaining pixels are reconstructed from their neighbors.
+    */
+    enum class ReservoirResolution
+    {
+        Full,           ///< One reservoir per pixel.
+        Checkerboard,   ///< One reservoir per 2x1 pixels, shaded pixels alternate in a checkerboard pattern.
+        Quarter,        ///< One reservoir per 2x2 pixels, the shaded pixel cycles through the cell.
+    };
+
+    /*
+     * Configuration of the ReSTIR algorithm.
+     * Options that change the code structure are set as compile-time constants in the shaders,
+     * the remaining ones are copied to ReSTIRRuntimeParams and uploaded every frame.
+     */
+    struct ReSTIRParams
+    {
+        uint32_t    lightTileScreenSize = 8;                    ///< Screen size of the light tiles in pixels.
+        uint32_t    lightTileSize = 1024;                       ///< Total number of light samples in each light tile.
+        uint32_t    lightTileCount = 128;                       ///< Total number of light tiles.
+
+        bool        testInitialSampleVisibility = true;         ///< If true, initial samples' visibility is tested.
+        uint32_t    emissiveLightCandidateCount = 32 /*24*/;    ///< Number of candidate samples for emissive lights.
+        uint32_t    envLightCandidateCount = 0 /*8*/;           ///< Number of candidate samples for environment lights.
+        uint32_t    analyticLightCandidateCount = 0 /*1*/;      ///< Number of candidate samples for analytic lights.
+
+        BiasCorrection biasCorrection = BiasCorrection::Off;    ///< Bias correction method used.
+        float       normalThreshold = 0.9f;                     ///< Threshold for normal comparison.
+        float       depthThreshold = 0.1f;                      ///< Threshold for depth comparison.
+
+        uint32_t    spatialIterationCount = 1;                  ///< Number of spatial resampling iterations.
+        uint32_t    spatialReuseSampleCount = 1;                ///< Number of samples reused from the previous frame.
+        float       spatialReuseSampleRadius = 30.f;            ///< Radius within which to reuse samples.
+
+        uint32_t    temporalHistoryLength = 20;                 ///< Length of the temporal history for resampling.
+
+        ReservoirResolution reservoirResolution = ReservoirResolution::Full; ///< Resolution of the reservoirs relative to the frame.
+
+        float       spatialVisibilityThreshold = 0.f;           ///< Threshold for visibility during spatial resampling.
+
+        Mode        mode = Mode::SpatiotemporalResampling;      ///< The resampling mode of ReSTIR algorithm.
+
+        // ReSTIR GI params
+        bool        giUnbiased = false;                         ///< Perform bias correction when resampling.
+        bool        giIndirectOnly = false;                     ///< Compute only indirect light contribution.
+        uint32_t    giTemporalMCap = 30;                        ///< This cap helps to curtail the influence of temporal samples partially, providing new candidates with a better opportunity to be chosen during resampling.
+        uint32_t    giSpatialMCap = 300;                        ///< This cap helps to curtail the influence of spatial samples partially, providing new candidates with a better opportunity to be chosen during resampling.
+        uint32_t    giSpatialIterationCount = 1;                ///< Number of spatial resampling iterations.
+        uint32_t    giSpatialReuseSampleCount = 5;              ///< Number of neighbor samples considered for resampling.
+        float       giNormalThreshold = 0.5f;                   ///< Threshold for normal comparison.
+        float       giDepthThreshold = 0.2f;                    ///< Threshold for depth comparison.
+        uint32_t    giBounces = 2;                              ///< Maximum number of bounces
+        bool        giSortSecondaryHits = false;                ///< Sort the first secondary hits by material and direction before shading them.
+    };
+
+    /** Get the ReSTIR parameters.
+    */
+    const ReSTIRParams& getReSTIRParams() const { return mReSTIRParams; }
+
+    /** Set the ReSTIR parameters.
+        Parameters that are uploaded every frame take effect in the next frame without recompiling the shaders,
+        changes to the remaining ones trigger a recompilation.
+        \param[in] params The new parameters.
+    */
+    void setReSTIRParams(const ReSTIRParams& params);
+
 private:
 
     struct TracePass
@@ -94,21 +164,25 @@ private:
     bool prepareLighting(RenderContext* pRenderContext);
     
     void resetLighting();
+
+    void resetTemporalReuse(RenderContext* pRenderContext);
     
     AliasTable::SharedPtr createEmissiveGeometryAliasTable(RenderContext* pRenderContext, const LightCollection::SharedPtr& lightCollection);
-    AliasTable::SharedPtr createEnvironmentAliasTable(RenderContext* pRenderContext, const Texture::SharedPtr& envTexture);
     AliasTable::SharedPtr createAnalyticLightsAliasTable(RenderContext* pRenderContext);
 
     bool beginFrame(RenderContext* pRenderContext, const RenderData& renderData);
     void endFrame(RenderContext* pRenderContext, const RenderData& renderData);
     void setFrameDim(const uint2 frameDim);
     void updatePrograms();
+    void updateRuntimeParams();
     void prepareResources(RenderContext* pRenderContext, const RenderData& renderData);
 
     /*
      * Render passes.
      */
     void tracePass(RenderContext* pRenderContext, const RenderData& renderData, TracePass& tracePass);
+    void sortedTracePass(RenderContext* pRenderContext, const RenderData& renderData);
+    void updateTraceTimings();
     void createLightTiles(RenderContext* pRenderContext);
     void loadSurfaceDataPass(RenderContext* pRenderContext, const RenderData& renderData);
     void generateInitialCandidatesPass(RenderContext* pRenderContext, const RenderData& renderData);
@@ -116,6 +190,7 @@ private:
     void spatialReusePass(RenderContext* pRenderContext, const RenderData& renderData);
     void createDirectSamplesPass(RenderContext* pRenderContext, const RenderData& renderData);
     void shadePass(RenderContext* pRenderContext, const RenderData& renderData);
+    void reconstructPass(RenderContext* pRenderContext, const RenderData& renderData);
     void temporalReuseGIPass(RenderContext* pRenderContext, const RenderData& renderData);
     void spatialReuseGIPass(RenderContext* pRenderContext, const RenderData& renderData);
     void shadingIndirectPass(RenderContext* pRenderContext, const RenderData& renderData);
@@ -123,8 +198,17 @@ private:
 
     void prepareRenderPass(const RenderData& renderData);
     void setShaderData(const ShaderVar& var, const RenderData& renderData, bool useLightSampling = true) const;
+    void setRuntimeParams(const ShaderVar& rootVar) const;
     bool renderRenderingUI(Gui::Widgets& widget);
 
+    /** Get the reservoir resolution in effect. Reduced resolutions are only supported by the direct illumination modes.
+    */
+    ReservoirResolution getReservoirResolution() const;
+
+    /** Get the dimensions of the reservoir grid for the current frame.
+    */
+    uint2 getReservoirDim() const;
+
     /** Static configuration. Changing any of these options require shader recompilation.
     */
     struct StaticParams
@@ -136,48 +220,6 @@ private:
         Program::DefineList getDefines(const ReSTIRPass& owner) const;
     };
 
-    /*
-     * Static configuration of the ReSTIR algorithm.
-     */
-    struct ReSTIRParams
-    {
-        uint32_t    lightTileScreenSize = 8;                    ///< Screen size of the light tiles in pixels.
-        uint32_t    lightTileSize = 1024;                       ///< Total number of light samples in each light tile.
-        uint32_t    lightTileCount = 128;                       ///< Total number of light tiles.
-
-        bool        testInitialSampleVisibility = true;         ///< If true, initial samples' visibility is tested.
-        uint32_t    emissiveLightCandidateCount = 32 /*24*/;    ///< Number of candidate samples for emissive lights.
-        uint32_t    envLightCandidateCount = 0 /*8*/;           ///< Number of candidate samples for environment lights.
-        uint32_t    analyticLightCandidateCount = 0 /*1*/;      ///< Number of candidate samples for analytic lights.
-
-        BiasCorrection biasCorrection = BiasCorrection::Off;    ///< Bias correction method used.
-        float       normalThreshold = 0.9f;                     ///< Threshold for normal comparison.
-        float       depthThreshold = 0.1f;                      ///< Threshold for depth comparison.
-
-        uint32_t    spatialIterationCount = 1;                  ///< Number of spatial resampling iterations.
-        uint32_t    spatialReuseSampleCount = 1;                ///< Number of samples reused from the previous frame.
-        float       spatialReuseSampleRadius = 30.f;            ///< Radius within which to reuse samples.
-
-        uint32_t    temporalHistoryLength = 20;                 ///< Length of the temporal history for resampling.
-
-        bool        useCheckerboarding = false;                 ///< If true, checkerboard rendering is used.
-
-        float       spatialVisibilityThreshold = 0.f;           ///< Threshold for visibility during spatial resampling.
-
-        Mode        mode = Mode::SpatiotemporalResampling;      ///< The resampling mode of ReSTIR algorithm.
-
-        // ReSTIR GI params
-        bool        giUnbiased = false;                         ///< Perform bias correction when resampling.
-        bool        giIndirectOnly = false;                     ///< Compute only indirect light contribution.
-        uint32_t    giTemporalMCap = 30;                        ///< This cap helps to curtail the influence of temporal samples partially, providing new candidates with a better opportunity to be chosen during resampling.
-        uint32_t    giSpatialMCap = 300;                        ///< This cap helps to curtail the influence of spatial samples partially, providing new candidates with a better opportunity to be chosen during resampling.
-        uint32_t    giSpatialIterationCount = 1;                ///< Number of spatial resampling iterations.
-        uint32_t    giSpatialReuseSampleCount = 5;              ///< Number of neighbor samples considered for resampling.
-        float       giNormalThreshold = 0.5f;                   ///< Threshold for normal comparison.
-        float       giDepthThreshold = 0.2f;                    ///< Threshold for depth comparison.
-        uint32_t    giBounces = 2;                              ///< Maximum number of bounces
-    };
-
     // Configuration
     StaticParams                    mStaticParams;              ///< Static parameters. These are set as compile-time constants in the shaders.
     bool                            mEnabled = true;            ///< Switch to enable/disable the render pass. When disabled the pass outputs are cleared.
@@ -186,6 +228,7 @@ private:
 
 
     ReSTIRParams                    mReSTIRParams;              ///< Contains parameters for the ReSTIR algorithm.
+    ReSTIRRuntimeParams             mRuntimeParams;             ///< Runtime parameters shared with the shaders. Derived from mReSTIRParams every frame.
 
     // Internal state
     Scene::SharedPtr                mpScene;                    ///< The current scene, or nullptr if no scene loaded.
@@ -200,6 +243,7 @@ private:
     ComputePass::SharedPtr          mpSpatialReusePass;                 ///< Compute pass for spatial reuse.
     ComputePass::SharedPtr          mpCreateDirectLightSamplesPass;     ///< Compute pass for creating direct light samples.
     ComputePass::SharedPtr          mpShadePass;                        ///< Compute pass for shading.
+    ComputePass::SharedPtr          mpReconstructPass;                  ///< Compute pass for reconstructing the pixels not shaded at reduced reservoir resolution.
     ComputePass::SharedPtr          mpShadingIndirect;                  ///< Compute pass for indirect shading.
     ComputePass::SharedPtr          mpTemporalReuseGIPass;              ///< Compute pass for temporal reuse in global illumination.
     ComputePass::SharedPtr          mpSpatialReuseGIPass;               ///< Compute pass for spatial reuse in global illumination.
@@ -207,15 +251,21 @@ private:
     ComputePass::SharedPtr          mpDecoupledPipelinePass;            ///< Compute pass for decoupled pipeline.
 
     std::unique_ptr<TracePass>      mpTracePass;                        ///< Main trace pass.
+    std::unique_ptr<TracePass>      mpGIHitPass;                        ///< Trace pass recording the first secondary hits and their sort keys.
+    std::unique_ptr<TracePass>      mpGISortedShadePass;                ///< Trace pass shading the recorded hits in sorted order.
+    RadixSort::SharedPtr            mpRadixSort;                        ///< Sorts the secondary hits by their keys.
 
     // Runtime data
-    uint                            mFrameCount = 0;                    ///< Frame count since scene was loaded.
+    uint                            mFrameCount = 0;                    ///< Frame count since scene was loaded or the temporal reuse was reset.
     uint2                           mFrameDim = uint2(0, 0);      ///< Dimensions of the current frame.
 
     bool                            mOptionsChanged = false;    ///< Flag indicating whether the options have changed.
     bool                            mRecompile = false;         ///< Set to true when program specialization has changed.
     bool                            mVarsChanged = true;        ///< This is set to true whenever the program vars have changed and resources need to be rebound.
 
+    float                           mUnsortedTraceTime = 0.f;   ///< Average GPU time of unsorted GI tracing in ms for the current scene, or 0 if not measured.
+    float                           mSortedTraceTime = 0.f;     ///< Average GPU time of sorted GI tracing in ms for the current scene, or 0 if not measured.
+
     // Textures and buffer
     Buffer::SharedPtr mpReservoirs;                     ///< Pointer to the buffer for reservoirs.
     Buffer::SharedPtr mpDirectLightSamples;             ///< Pointer to the buffer for direct light samples.
@@ -225,17 +275,23 @@ private:
     Buffer::SharedPtr mpPrevSurfaceData;                ///< Pointer to the buffer for previous surface data.
     Buffer::SharedPtr mpPrevNormalDepth;                ///< Pointer to the buffer for previous normal depth.
     Buffer::SharedPtr mpPrevReservoirs;                 ///< Pointer to the buffer for previous reservoirs.
+    Buffer::SharedPtr mpReducedIllumination;            ///< Pointer to the buffer for demodulated direct light of the shaded pixels at reduced reservoir resolution.
 
     Buffer::SharedPtr mpGIReservoirs;                   ///< Pointer to the buffer for initial global illumination reservoirs.
     Buffer::SharedPtr mpPrevGIReservoirs;               ///< Pointer to the buffer for previous global illumination reservoirs.
     Buffer::SharedPtr mpSpatialGIReservoirs;            ///< Pointer to the buffer for spatial global illumination reservoirs.
 
+    Buffer::SharedPtr mpGIHitRecords;                   ///< Pointer to the buffer for the recorded first secondary hits.
+    Buffer::SharedPtr mpGISortKeys;                     ///< Pointer to the buffer for the secondary hit sort keys.
+    Buffer::SharedPtr mpGISortPixels;                   ///< Pointer to the buffer for the pixel indices in sorted order.
+
     // Emissive geometry sampling data
     AliasTable::SharedPtr mpEmissiveGeometryAliasTable; ///< Pointer to the alias table for emissive geometry.
     AliasTable::SharedPtr mpEnvironmentAliasTable;      ///< Pointer to the alias table for environment.
     AliasTable::SharedPtr mpAnalyticLightsAliasTable;   ///< Pointer to the alias table for analytic lights.
 
     Buffer::SharedPtr mpEnvironmentLuminanceTable;      ///< Pointer to the buffer for environment luminance table.
+    EnvMapImportance::SharedPtr mpEnvMapImportance;     ///< Environment map importance data shared with other passes. The alias and luminance tables are taken from here once ready.
 
     Buffer::SharedPtr mpLightTiles;                     ///< Pointer to the buffer for light tiles.
 
@@ -73,7 +73,7 @@ namespace
     const float kMaxOperationSmoothness = 0.05f;
 
     const FileDialogFilterVec kSDFFileExtensionFilters = { { "sdf", "SDF Files"} };
-    const FileDialogFilterVec kSDFGridFileExtensionFilters = { { "sdfg", "SDF Grid Files"} };
+    const FileDialogFilterVec kSDFGridFileExtensionFilters = { { "sdfg", "SDF Grid Files"}, { "sdfb", "Sparse SDF Brick Files"} };
 
     bool isOperationSmooth(SDFOperationType operationType)
     {
@@ -1059,7 +1059,7 @@ bool SDFEditor::handlePicking(const float2& currentMousePos, float3& localPos)
     float3 rayOrigin = mpCamera->getPosition();
 
     const CameraData& cameraData = mpCamera->getData();
-    float2 ndc = float2(-1.0f, 1.0f) + float2(2.0f, -2.0f) * (currentMousePos + float2(0.5f, 0.5f)) / float2(mFrameDim);
+    float2 ndc = float2(-1.0f, 1.0f) + float2(2.0f, -2.0f) * (currentMousePos + float2(0.5f, 0.5f)) / float2(mFrameDim) + cameraData.cropOffset;
     float3 rayDir = glm::normalize(ndc.x * cameraData.cameraU + ndc.y * cameraData.cameraV + cameraData.cameraW);
 
     float3 iSectPosition;
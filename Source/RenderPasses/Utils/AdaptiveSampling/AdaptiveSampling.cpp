@@ -0,0 +1,226 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AdaptiveSampling.h"
+#include "RenderGraph/RenderPassStandardFlags.h"
+
+const RenderPass::Info AdaptiveSampling::kInfo { "AdaptiveSampling", "Computes a per-pixel sample count from a variance estimate." };
+
+namespace
+{
+    const std::string kShaderFile("RenderPasses/Utils/AdaptiveSampling/AdaptiveSampling.cs.slang");
+
+    const std::string kOutputSampleCount = "sampleCount";
+
+    const std::string kAverageSamplesPerPixel = "averageSamplesPerPixel";
+    const std::string kMinSamplesPerPixel = "minSamplesPerPixel";
+    const std::string kMaxSamplesPerPixel = "maxSamplesPerPixel";
+    const std::string kUseRelativeError = "useRelativeError";
+
+    // Sample counts above the limit of the consumers (e.g. PathTracer) would be clamped and not spent.
+    const uint32_t kMaxSampleCount = kRenderPassMaxSampleCount;
+
+    // Number of iterations for redistributing the budget clipped at the maximum sample count.
+    const uint32_t kRedistributionIterations = 4;
+
+    uint32_t nextPowerOfTwo(uint32_t v)
+    {
+        uint32_t p = 1;
+        while (p < v) p <<= 1;
+        return p;
+    }
+}
+
+AdaptiveSampling::SharedPtr AdaptiveSampling::create(RenderContext* pRenderContext, const Dictionary& dict)
+{
+    return SharedPtr(new AdaptiveSampling(dict));
+}
+
+AdaptiveSampling::AdaptiveSampling(const Dictionary& dict)
+    : RenderPass(kInfo)
+{
+    // Parse dictionary.
+    for (const auto& [key, value] : dict)
+    {
+        if (key == kAverageSamplesPerPixel) mAverageSamplesPerPixel = value;
+        else if (key == kMinSamplesPerPixel) mMinSamplesPerPixel = value;
+        else if (key == kMaxSamplesPerPixel) mMaxSamplesPerPixel = value;
+        else if (key == kUseRelativeError) mUseRelativeError = value;
+        else logWarning("Unknown field '{}' in AdaptiveSampling pass dictionary.", key);
+    }
+
+    if (mMaxSamplesPerPixel < 1 || mMaxSamplesPerPixel > kMaxSampleCount)
+    {
+        logWarning("AdaptiveSampling: 'maxSamplesPerPixel' must be in the range [1, {}]. Clamping to this range.", kMaxSampleCount);
+        mMaxSamplesPerPixel = std::clamp(mMaxSamplesPerPixel, 1u, kMaxSampleCount);
+    }
+    // Every pixel needs at least one sample per frame, otherwise the accumulated result is biased.
+    mMinSamplesPerPixel = std::clamp(mMinSamplesPerPixel, 1u, mMaxSamplesPerPixel);
+    mAverageSamplesPerPixel = std::clamp(mAverageSamplesPerPixel, float(mMinSamplesPerPixel), float(mMaxSamplesPerPixel));
+
+    // Create resources.
+    mpComputeImportancePass = ComputePass::create(kShaderFile, "computeImportance", Program::DefineList(), false);
+    mpInitScalePass = ComputePass::create(kShaderFile, "initScale", Program::DefineList(), false);
+    mpComputeClippingPass = ComputePass::create(kShaderFile, "computeClipping", Program::DefineList(), false);
+    mpUpdateScalePass = ComputePass::create(kShaderFile, "updateScale", Program::DefineList(), false);
+    mpAllocateSamplesPass = ComputePass::create(kShaderFile, "allocateSamples", Program::DefineList(), false);
+
+    mpScale = Buffer::createTyped<float>(1, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess);
+    mpScale->setName("AdaptiveSampling::Scale");
+}
+
+Dictionary AdaptiveSampling::getScriptingDictionary()
+{
+    Dictionary dict;
+    dict[kAverageSamplesPerPixel] = mAverageSamplesPerPixel;
+    dict[kMinSamplesPerPixel] = mMinSamplesPerPixel;
+    dict[kMaxSamplesPerPixel] = mMaxSamplesPerPixel;
+    dict[kUseRelativeError] = mUseRelativeError;
+    return dict;
+}
+
+RenderPassReflection AdaptiveSampling::reflect(const CompileData& compileData)
+{
+    RenderPassReflection reflector;
+    reflector.addOutput(kOutputSampleCount, "Per-pixel sample count").bindFlags(ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource).format(ResourceFormat::R8Uint);
+    return reflector;
+}
+
+void AdaptiveSampling::compile(RenderContext* pRenderContext, const CompileData& compileData)
+{
+    mFrameDim = compileData.defaultTexDims;
+    mpImportance = nullptr;
+}
+
+void AdaptiveSampling::execute(RenderContext* pRenderContext, const RenderData& renderData)
+{
+    const auto& pSampleCount = renderData.getTexture(kOutputSampleCount);
+    FALCOR_ASSERT(pSampleCount);
+
+    // The variance estimate of the previous frame, or nullptr if no pass provides one.
+    // Without an estimate the importance is zero everywhere and the samples are distributed uniformly.
+    Texture::SharedPtr pVariance = renderData.getDictionary().getValue(kRenderPassVarianceEstimate, Texture::SharedPtr());
+    if (pVariance && (pVariance->getWidth() != mFrameDim.x || pVariance->getHeight() != mFrameDim.y)) pVariance = nullptr;
+
+    prepareImportance();
+
+    // Compute the per-pixel importance. The padding outside the frame stays zero.
+    {
+        FALCOR_PROFILE("computeImportance");
+
+        pRenderContext->clearUAV(mpImportance->getUAV(0).get(), float4(0.f));
+
+        auto var = mpComputeImportancePass["CB"];
+        var["gFrameDim"] = mFrameDim;
+        var["gUseRelativeError"] = mUseRelativeError;
+
+        mpComputeImportancePass["gVariance"] = pVariance; // Can be nullptr
+        mpComputeImportancePass["gImportance"] = mpImportance;
+        mpComputeImportancePass->execute(pRenderContext, mFrameDim.x, mFrameDim.y);
+    }
+
+    // Average the importance by reducing it down to a single texel.
+    mpImportance->generateMips(pRenderContext);
+
+    const uint32_t paddedPixelCount = mpImportance->getWidth() * mpImportance->getHeight();
+
+    auto setConstants = [&](const ComputePass::SharedPtr& pPass)
+    {
+        auto var = pPass["CB"];
+        var["gFrameDim"] = mFrameDim;
+        var["gFrameCount"] = mFrameCount;
+        var["gAverageSamplesPerPixel"] = mAverageSamplesPerPixel;
+        var["gMinSamplesPerPixel"] = mMinSamplesPerPixel;
+        var["gMaxSamplesPerPixel"] = mMaxSamplesPerPixel;
+        var["gImportanceMip"] = mpImportance->getMipCount() - 1;
+        var["gImportanceScale"] = float(paddedPixelCount) / float(mFrameDim.x * mFrameDim.y);
+
+        pPass["gImportanceMips"] = mpImportance;
+        pPass["gClipping"] = mpClipping;
+        pPass["gClippingMips"] = mpClipping;
+        pPass["gScale"] = mpScale;
+    };
+
+    // Compute the scale from importance to sample count that distributes the budget above the minimum sample count.
+    // Samples clipped at the maximum sample count are redistributed to the remaining pixels by increasing the scale.
+    {
+        FALCOR_PROFILE("redistributeSamples");
+
+        setConstants(mpInitScalePass);
+        mpInitScalePass->execute(pRenderContext, 1, 1);
+
+        for (uint32_t i = 0; i < kRedistributionIterations; i++)
+        {
+            pRenderContext->clearUAV(mpClipping->getUAV(0).get(), float4(0.f));
+
+            setConstants(mpComputeClippingPass);
+            mpComputeClippingPass->execute(pRenderContext, mFrameDim.x, mFrameDim.y);
+            mpClipping->generateMips(pRenderContext);
+
+            setConstants(mpUpdateScalePass);
+            mpUpdateScalePass->execute(pRenderContext, 1, 1);
+        }
+    }
+
+    // Distribute the sample budget.
+    {
+        FALCOR_PROFILE("allocateSamples");
+
+        setConstants(mpAllocateSamplesPass);
+        mpAllocateSamplesPass["gSampleCount"] = pSampleCount;
+        mpAllocateSamplesPass->execute(pRenderContext, mFrameDim.x, mFrameDim.y);
+    }
+
+    mFrameCount++;
+}
+
+void AdaptiveSampling::renderUI(Gui::Widgets& widget)
+{
+    widget.text("This pass distributes a fixed sample budget based on the variance estimate");
+
+    widget.var("Min samples/pixel", mMinSamplesPerPixel, 1u, mMaxSamplesPerPixel);
+    widget.var("Max samples/pixel", mMaxSamplesPerPixel, mMinSamplesPerPixel, kMaxSampleCount);
+    widget.var("Average samples/pixel", mAverageSamplesPerPixel, float(mMinSamplesPerPixel), float(mMaxSamplesPerPixel));
+    widget.tooltip("Total sample budget per frame divided by the number of pixels.");
+
+    widget.checkbox("Use relative error", mUseRelativeError);
+    widget.tooltip("Distribute samples based on the standard error relative to the accumulated pixel luminance.");
+}
+
+void AdaptiveSampling::prepareImportance()
+{
+    // The importance texture is padded to power-of-two dimensions so that each mip level is an exact 2x2 box filter of the previous one.
+    const uint2 dim = { nextPowerOfTwo(mFrameDim.x), nextPowerOfTwo(mFrameDim.y) };
+    if (!mpImportance || mpImportance->getWidth() != dim.x || mpImportance->getHeight() != dim.y)
+    {
+        mpImportance = Texture::create2D(dim.x, dim.y, ResourceFormat::R32Float, 1, Texture::kMaxPossible, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess | Resource::BindFlags::RenderTarget);
+        mpImportance->setName("AdaptiveSampling::Importance");
+
+        mpClipping = Texture::create2D(dim.x, dim.y, ResourceFormat::RG32Float, 1, Texture::kMaxPossible, nullptr, Resource::BindFlags::ShaderResource | Resource::BindFlags::UnorderedAccess | Resource::BindFlags::RenderTarget);
+        mpClipping->setName("AdaptiveSampling::Clipping");
+    }
+}
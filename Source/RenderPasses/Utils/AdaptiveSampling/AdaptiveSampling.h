@@ -0,0 +1,91 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Falcor.h"
+
+using namespace Falcor;
+
+/** Adaptive sampling pass.
+
+    Converts the per-pixel variance estimate produced by AccumulatePass into
+    a sample count map that can be fed to PathTracer's 'sampleCount' input.
+    The estimate is read from the render data dictionary (see
+    kRenderPassVarianceEstimate), as the accumulation runs later in the graph.
+    Enable 'computeVariance' on the AccumulatePass to produce it.
+
+    The total number of samples per frame is fixed by the average samples per
+    pixel. Each pixel receives the minimum sample count, and the remaining
+    budget is distributed proportionally to the estimated standard error of the
+    pixel, optionally relative to the pixel's accumulated luminance.
+    Samples exceeding the maximum sample count of a pixel are redistributed to
+    the remaining pixels. The maximum is limited by the sample count that
+    consumers support (see kRenderPassMaxSampleCount).
+    Fractional sample counts are rounded stochastically so that the budget is
+    met in expectation.
+
+    Until a variance estimate is available, the average sample count is used
+    for all pixels.
+*/
+class AdaptiveSampling : public RenderPass
+{
+public:
+    using SharedPtr = std::shared_ptr<AdaptiveSampling>;
+
+    static const Info kInfo;
+
+    static SharedPtr create(RenderContext* pRenderContext = nullptr, const Dictionary& dict = {});
+
+    virtual Dictionary getScriptingDictionary() override;
+    virtual RenderPassReflection reflect(const CompileData& compileData) override;
+    virtual void compile(RenderContext* pRenderContext, const CompileData& compileData) override;
+    virtual void execute(RenderContext* pRenderContext, const RenderData& renderData) override;
+    virtual void renderUI(Gui::Widgets& widget) override;
+
+private:
+    AdaptiveSampling(const Dictionary& dict);
+
+    void prepareImportance();
+
+    uint2                       mFrameDim = { 0, 0 };
+    uint32_t                    mFrameCount = 0;                ///< Frame counter used for stochastic rounding.
+
+    float                       mAverageSamplesPerPixel = 4.f;  ///< Average number of samples per pixel, i.e. the sample budget.
+    uint32_t                    mMinSamplesPerPixel = 1;        ///< Minimum number of samples per pixel.
+    uint32_t                    mMaxSamplesPerPixel = 16;       ///< Maximum number of samples per pixel.
+    bool                        mUseRelativeError = true;       ///< Use the standard error relative to the accumulated pixel luminance.
+
+    Texture::SharedPtr          mpImportance;                   ///< Per-pixel importance with a full mip chain. Padded to power-of-two dimensions.
+    Texture::SharedPtr          mpClipping;                     ///< Per-pixel clipped samples (x) and importance of unclipped pixels (y) with a full mip chain. Same dimensions as the importance.
+    Buffer::SharedPtr           mpScale;                        ///< Scale from importance to sample count above the minimum.
+
+    ComputePass::SharedPtr      mpComputeImportancePass;
+    ComputePass::SharedPtr      mpInitScalePass;
+    ComputePass::SharedPtr      mpComputeClippingPass;
+    ComputePass::SharedPtr      mpUpdateScalePass;
+    ComputePass::SharedPtr      mpAllocateSamplesPass;
+};
@@ -25,6 +25,7 @@
  # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
+#include "AdaptiveSampling/AdaptiveSampling.h"
 #include "Composite/Composite.h"
 #include "GaussianBlur/GaussianBlur.h"
 #include "RenderGraph/RenderPassLibrary.h"
@@ -37,6 +38,8 @@ extern "C" FALCOR_API_EXPORT const char* getProjDir()
 
 extern "C" FALCOR_API_EXPORT void getPasses(Falcor::RenderPassLibrary& lib)
 {
+    lib.registerPass(AdaptiveSampling::kInfo, AdaptiveSampling::create);
+
     lib.registerPass(Composite::kInfo, Composite::create);
     ScriptBindings::registerBinding(Composite::registerBindings);
 
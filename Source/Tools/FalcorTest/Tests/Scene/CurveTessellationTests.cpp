@@ -0,0 +1,132 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Curves/CurveTessellation.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        struct Strands
+        {
+            std::vector<uint32_t> vertexCounts;
+            std::vector<float3> points;
+            std::vector<float> widths;
+        };
+
+        // Straight strands along the y-axis with constant width.
+        Strands createStraightStrands(uint32_t strandCount, uint32_t vertexCount, float width)
+        {
+            Strands strands;
+            for (uint32_t i = 0; i < strandCount; i++)
+            {
+                strands.vertexCounts.push_back(vertexCount);
+                for (uint32_t j = 0; j < vertexCount; j++)
+                {
+                    strands.points.push_back(float3(float(i), float(j), 0.f));
+                    strands.widths.push_back(width);
+                }
+            }
+            return strands;
+        }
+    }
+
+    CPU_TEST(CurveTessellation_Stride)
+    {
+        Strands strands = createStraightStrands(3, 4, 0.1f);
+
+        auto result = CurveTessellation::convertToLinearSweptSphere(3, strands.vertexCounts.data(), strands.points.data(), strands.widths.data(), nullptr, 1, 2, 2, 1, 1.f, rmcv::identity<rmcv::mat4>());
+
+        // Strands 0 and 2 are kept, each with 3 segments subdivided twice.
+        EXPECT_EQ(result.points.size(), 14u);
+        EXPECT_EQ(result.radius.size(), 14u);
+        EXPECT_EQ(result.indices.size(), 12u);
+        EXPECT_EQ(result.indices[0], 0u);
+        EXPECT_EQ(result.indices[5], 5u);
+        EXPECT_EQ(result.indices[6], 7u);
+        EXPECT_EQ(result.points[7], float3(2.f, 0.f, 0.f));
+        EXPECT_LE(glm::length(result.points[13] - float3(2.f, 3.f, 0.f)), 1e-5f);
+        EXPECT_EQ(result.radius[0], 0.05f);
+
+        auto mesh = CurveTessellation::convertToPolytube(3, strands.vertexCounts.data(), strands.points.data(), strands.widths.data(), nullptr, 2, 2, 1, 1.f, 4);
+        EXPECT_EQ(mesh.vertices.size(), 4u * 14u);
+        EXPECT_EQ(mesh.faceVertexCounts.size(), 2u * 4u * 12u);
+        EXPECT_EQ(mesh.faceVertexIndices.size(), 3 * mesh.faceVertexCounts.size());
+        for (uint32_t index : mesh.faceVertexIndices) EXPECT_LT(index, mesh.vertices.size());
+    }
+
+    CPU_TEST(CurveTessellation_StrideVertexDecimation)
+    {
+        // The second strand has a duplicated control point and the third one collapses to a single point.
+        Strands strands = createStraightStrands(3, 4, 0.1f);
+        strands.vertexCounts[1] = 5;
+        strands.points.insert(strands.points.begin() + 5, strands.points[4]);
+        strands.widths.insert(strands.widths.begin() + 5, strands.widths[4]);
+        std::fill(strands.points.begin() + 9, strands.points.end(), float3(2.f, 0.f, 0.f));
+
+        // 3 unique segments subdivided 3 times, keeping every other vertex plus the last one.
+        auto result = CurveTessellation::convertToLinearSweptSphere(3, strands.vertexCounts.data(), strands.points.data(), strands.widths.data(), nullptr, 1, 3, 1, 2, 1.f, rmcv::identity<rmcv::mat4>());
+        EXPECT_EQ(result.points.size(), 12u);
+        EXPECT_EQ(result.indices.size(), 10u);
+        EXPECT_EQ(result.indices[5], 6u);
+        EXPECT_LE(glm::length(result.points[11] - float3(1.f, 3.f, 0.f)), 1e-5f);
+
+        auto mesh = CurveTessellation::convertToPolytube(3, strands.vertexCounts.data(), strands.points.data(), strands.widths.data(), nullptr, 3, 1, 2, 1.f, 4);
+        EXPECT_EQ(mesh.vertices.size(), 4u * 12u);
+        EXPECT_EQ(mesh.faceVertexCounts.size(), 2u * 4u * 10u);
+        for (uint32_t index : mesh.faceVertexIndices) EXPECT_LT(index, mesh.vertices.size());
+    }
+
+    CPU_TEST(CurveTessellation_ErrorDriven)
+    {
+        const uint32_t kStrandCount = 1000;
+        Strands strands = createStraightStrands(kStrandCount, 6, 0.1f);
+
+        CurveTessellation::StrandLOD lod;
+        lod.mode = CurveTessellation::StrandLODMode::ErrorDriven;
+        lod.tolerance = 1e-4f;
+
+        // Straight strands simplify to a single segment.
+        auto result = CurveTessellation::convertToLinearSweptSphere(kStrandCount, strands.vertexCounts.data(), strands.points.data(), strands.widths.data(), nullptr, 1, 4, lod, 1.f, rmcv::identity<rmcv::mat4>());
+        EXPECT_EQ(result.points.size(), 2u * kStrandCount);
+        EXPECT_EQ(result.indices.size(), kStrandCount);
+        EXPECT_LE(glm::length(result.points[1] - float3(0.f, 5.f, 0.f)), 1e-5f);
+
+        // Reducing the strand count widens the kept strands.
+        lod.strandFraction = 0.5f;
+        result = CurveTessellation::convertToLinearSweptSphere(kStrandCount, strands.vertexCounts.data(), strands.points.data(), strands.widths.data(), nullptr, 1, 4, lod, 1.f, rmcv::identity<rmcv::mat4>());
+        const uint32_t keptCount = (uint32_t)result.indices.size();
+        EXPECT_GT(keptCount, 400u);
+        EXPECT_LT(keptCount, 600u);
+        EXPECT_LE(std::abs(result.radius[0] - 0.05f * std::sqrt(float(kStrandCount) / keptCount)), 1e-6f);
+
+        auto mesh = CurveTessellation::convertToPolytube(kStrandCount, strands.vertexCounts.data(), strands.points.data(), strands.widths.data(), nullptr, 4, lod, 1.f, 4);
+        EXPECT_EQ(mesh.vertices.size(), 4u * 2u * keptCount);
+        EXPECT_EQ(mesh.faceVertexCounts.size(), 2u * 4u * keptCount);
+    }
+}
@@ -28,6 +28,12 @@
 #include "Testing/UnitTest.h"
 #include "Scene/Lights/EnvMap.h"
 #include "Rendering/Lights/EnvMapSampler.h"
+#include "Rendering/Lights/EnvMapImportance.h"
+#include "Scene/SceneCache.h"
+#include "Utils/Color/ColorHelpers.slang"
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
 
 namespace Falcor
 {
@@ -35,6 +41,24 @@ namespace Falcor
     {
         // This file is located in the media/ directory fetched by packman.
         const char kEnvMapFile[] = "LightProbes/20050806-03_hd.hdr";
+
+        std::filesystem::path getCachePath(const EnvMapImportance::Key& key)
+        {
+            std::stringstream ss;
+            ss << std::hex << std::setfill('0');
+            for (auto c : key) ss << std::setw(2) << (int)c;
+            return SceneCache::getCacheDirectory() / "EnvMap" / ss.str();
+        }
+
+        std::vector<std::vector<uint8_t>> readImportanceMips(RenderContext* pRenderContext, const Texture::SharedPtr& pImportanceMap)
+        {
+            std::vector<std::vector<uint8_t>> mips;
+            for (uint32_t mip = 0; mip < pImportanceMap->getMipCount(); mip++)
+            {
+                mips.push_back(pRenderContext->readTextureSubresource(pImportanceMap.get(), pImportanceMap->getSubresourceIndex(0, mip)));
+            }
+            return mips;
+        }
     }
 
     GPU_TEST(EnvMap)
@@ -64,4 +88,101 @@ namespace Falcor
         EXPECT_EQ(w, h);
         EXPECT_EQ(w, 1 << (mipCount - 1));
     }
+
+    GPU_TEST(EnvMapImportance)
+    {
+        EnvMap::SharedPtr pEnvMap = EnvMap::createFromFile(kEnvMapFile);
+        EXPECT_NE(pEnvMap, nullptr);
+        if (pEnvMap == nullptr) return;
+
+        // Check that the importance data is shared between samplers of the same environment map.
+        EnvMapSampler::SharedPtr pEnvMapSampler = EnvMapSampler::create(ctx.getRenderContext(), pEnvMap);
+        auto pImportance = EnvMapImportance::get(ctx.getRenderContext(), pEnvMap->getEnvMap());
+        EXPECT_EQ(pImportance, pEnvMapSampler->getImportance());
+
+        // Check that the data matches the environment map once the alias table is available.
+        pImportance->waitForData();
+        EXPECT(pImportance->isReady());
+
+        const auto& pTexture = pEnvMap->getEnvMap();
+        uint32_t texelCount = pTexture->getWidth() * pTexture->getHeight();
+        EXPECT(pImportance->getDimensions() == uint2(pTexture->getWidth(), pTexture->getHeight()));
+        EXPECT(pImportance->getKey().has_value());
+
+        auto pAliasTable = pImportance->getAliasTable();
+        EXPECT_NE(pAliasTable, nullptr);
+        if (pAliasTable == nullptr) return;
+        EXPECT_EQ(pAliasTable->getCount(), texelCount);
+        EXPECT_GT(pAliasTable->getWeightSum(), 0.0);
+        EXPECT_EQ(pImportance->getLuminanceTable()->getElementCount(), texelCount);
+    }
+
+    GPU_TEST(EnvMapImportanceLuminance)
+    {
+        EnvMap::SharedPtr pEnvMap = EnvMap::createFromFile(kEnvMapFile);
+        EXPECT_NE(pEnvMap, nullptr);
+        if (pEnvMap == nullptr) return;
+
+        const auto& pTexture = pEnvMap->getEnvMap();
+        ResourceFormat format = pTexture->getFormat();
+        uint32_t channelCount = getFormatChannelCount(format);
+
+        // The reference is computed from 32-bit float texels, which is what HDR light probes are loaded as.
+        EXPECT(getFormatType(format) == FormatType::Float && getFormatBytesPerBlock(format) == channelCount * sizeof(float));
+        if (getFormatType(format) != FormatType::Float || getFormatBytesPerBlock(format) != channelCount * sizeof(float)) return;
+
+        auto pImportance = EnvMapImportance::get(ctx.getRenderContext(), pTexture);
+        pImportance->waitForData();
+
+        // Compute the reference luminance on the CPU.
+        auto texels = ctx.getRenderContext()->readTextureSubresource(pTexture.get(), 0);
+        const float* pTexels = reinterpret_cast<const float*>(texels.data());
+        uint32_t texelCount = pTexture->getWidth() * pTexture->getHeight();
+        EXPECT_EQ(texels.size(), (size_t)texelCount * channelCount * sizeof(float));
+        if (texels.size() != (size_t)texelCount * channelCount * sizeof(float)) return;
+
+        const float* pLuminance = reinterpret_cast<const float*>(pImportance->getLuminanceTable()->map(Buffer::MapType::Read));
+        for (uint32_t i = 0; i < texelCount; i++)
+        {
+            const float* pTexel = pTexels + (size_t)i * channelCount;
+            float ref = channelCount == 1 ? pTexel[0] : luminance(float3(pTexel[0], pTexel[1], pTexel[2]));
+            EXPECT_LE(std::abs(pLuminance[i] - ref), 1e-5f * std::max(1.f, ref)) << "i = " << i;
+        }
+        pImportance->getLuminanceTable()->unmap();
+    }
+
+    GPU_TEST(EnvMapImportanceCache)
+    {
+        EnvMap::SharedPtr pEnvMap = EnvMap::createFromFile(kEnvMapFile);
+        EXPECT_NE(pEnvMap, nullptr);
+        if (pEnvMap == nullptr) return;
+
+        const auto& pTexture = pEnvMap->getEnvMap();
+        RenderContext* pRenderContext = ctx.getRenderContext();
+
+        // Remove a previously persisted entry so the importance data is computed on the GPU.
+        auto key = EnvMapImportance::get(pRenderContext, pTexture)->getKey();
+        EXPECT(key.has_value());
+        if (!key) return;
+        auto path = getCachePath(*key);
+        std::filesystem::remove(path);
+
+        std::vector<std::vector<uint8_t>> computedMips;
+        {
+            auto pImportance = EnvMapImportance::get(pRenderContext, pTexture);
+            pImportance->waitForData();
+            computedMips = readImportanceMips(pRenderContext, pImportance->getImportanceMap());
+        }
+        EXPECT(std::filesystem::exists(path));
+
+        // The data is released above, so this loads the importance map and luminance table from the cache.
+        auto pImportance = EnvMapImportance::get(pRenderContext, pTexture);
+        EXPECT(pImportance->isReady());
+        auto cachedMips = readImportanceMips(pRenderContext, pImportance->getImportanceMap());
+        EXPECT_EQ(cachedMips.size(), computedMips.size());
+        for (size_t mip = 0; mip < std::min(cachedMips.size(), computedMips.size()); mip++)
+        {
+            EXPECT(cachedMips[mip] == computedMips[mip]) << "mip = " << mip;
+        }
+    }
 }
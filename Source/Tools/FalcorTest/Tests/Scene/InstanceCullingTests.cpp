@@ -0,0 +1,200 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Material/StandardMaterial.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        // Instance positions along the view direction of the camera, which looks down the negative z-axis from the origin.
+        const float kNearZ = -2.f;
+        const float kFarZ = -100.f;
+        const float kBehindZ = 5.f;
+        const float kDistantZ = -1000.f;
+
+        TriangleMesh::SharedPtr createMesh(const TriangleMesh::SharedPtr& pMesh, const std::string& name)
+        {
+            pMesh->setName(name);
+            return pMesh;
+        }
+
+        /** Creates a scene with an instance LOD chain of two levels, each instanced near and far from the camera,
+            and a mesh instanced in front of, behind and far away from the camera.
+        */
+        Scene::SharedPtr createScene()
+        {
+            auto pBuilder = SceneBuilder::create();
+            auto pMaterial = StandardMaterial::create("Material");
+
+            MeshID lod0 = pBuilder->addTriangleMesh(createMesh(TriangleMesh::createSphere(0.5f, 32, 16), "Lod0"), pMaterial);
+            MeshID lod1 = pBuilder->addTriangleMesh(createMesh(TriangleMesh::createSphere(0.5f, 8, 4), "Lod1"), pMaterial);
+            MeshID cube = pBuilder->addTriangleMesh(createMesh(TriangleMesh::createCube(), "Cube"), pMaterial);
+
+            auto addInstance = [&](MeshID meshID, float z)
+            {
+                NodeID nodeID = pBuilder->addNode({ "Node", rmcv::translate(float3(0.f, 0.f, z)) });
+                pBuilder->addMeshInstance(nodeID, meshID);
+            };
+
+            for (MeshID meshID : { lod0, lod1 })
+            {
+                addInstance(meshID, kNearZ);
+                addInstance(meshID, kFarZ);
+            }
+            for (float z : { kNearZ * 2.f, kBehindZ, kDistantZ }) addInstance(cube, z);
+
+            auto pCamera = Camera::create("Camera");
+            pCamera->setPosition(float3(0.f));
+            pCamera->setTarget(float3(0.f, 0.f, -1.f));
+            pCamera->setUpVector(float3(0.f, 1.f, 0.f));
+            pBuilder->addCamera(pCamera);
+
+            return pBuilder->getScene();
+        }
+
+        /** Returns if the instance of a mesh at a position along the z-axis is active in the TLAS.
+        */
+        bool isInstanceActive(const Scene::SharedPtr& pScene, const std::string& meshName, float z)
+        {
+            const auto& globalMatrices = pScene->getAnimationController()->getGlobalMatrices();
+            for (uint32_t instanceID = 0; instanceID < pScene->getGeometryInstanceCount(); instanceID++)
+            {
+                const auto& instance = pScene->getGeometryInstance(instanceID);
+                if (pScene->getMeshName(instance.geometryID) != meshName) continue;
+                if (float3(globalMatrices[instance.globalMatrixID].getCol(3)).z == z) return pScene->isInstanceActive(instanceID);
+            }
+            throw RuntimeError("Instance of mesh '{}' at z = {} not found", meshName, z);
+        }
+
+        uint32_t getActiveInstanceCount(const Scene::SharedPtr& pScene)
+        {
+            uint32_t count = 0;
+            for (uint32_t instanceID = 0; instanceID < pScene->getGeometryInstanceCount(); instanceID++)
+            {
+                if (pScene->isInstanceActive(instanceID)) count++;
+            }
+            return count;
+        }
+
+        MeshID findMesh(const Scene::SharedPtr& pScene, const std::string& name)
+        {
+            for (uint32_t meshID = 0; meshID < pScene->getMeshCount(); meshID++)
+            {
+                if (pScene->getMeshName(meshID) == name) return MeshID{ meshID };
+            }
+            throw RuntimeError("Mesh '{}' not found", name);
+        }
+    }
+
+    GPU_TEST(InstanceCulling)
+    {
+        auto pScene = createScene();
+        RenderContext* pRenderContext = ctx.getRenderContext();
+        EXPECT_EQ(pScene->getGeometryInstanceCount(), 7u);
+
+        // Without culling and LOD chains all instances are active.
+        pScene->update(pRenderContext, 0.0);
+        EXPECT_EQ(getActiveInstanceCount(pScene), 7u);
+
+        // Enable frustum and distance culling.
+        auto settings = pScene->getInstanceCullingSettings();
+        settings.enabled = true;
+        settings.frustumCulling = true;
+        settings.maxDistance = 500.f;
+        pScene->setInstanceCullingSettings(settings);
+        pScene->update(pRenderContext, 0.0);
+
+        EXPECT(isInstanceActive(pScene, "Cube", kNearZ * 2.f));
+        EXPECT(!isInstanceActive(pScene, "Cube", kBehindZ));
+        EXPECT(!isInstanceActive(pScene, "Cube", kDistantZ));
+        EXPECT_EQ(getActiveInstanceCount(pScene), 5u);
+
+        // Cull instances that are small on screen. The far instances cover less than 2% of the frame height.
+        settings.minScreenSize = 0.05f;
+        pScene->setInstanceCullingSettings(settings);
+        pScene->update(pRenderContext, 0.0);
+
+        EXPECT(isInstanceActive(pScene, "Lod0", kNearZ));
+        EXPECT(!isInstanceActive(pScene, "Lod0", kFarZ));
+        EXPECT(!isInstanceActive(pScene, "Lod1", kFarZ));
+        EXPECT_EQ(getActiveInstanceCount(pScene), 3u);
+
+        // Disabling culling activates all instances again.
+        settings.enabled = false;
+        pScene->setInstanceCullingSettings(settings);
+        pScene->update(pRenderContext, 0.0);
+        EXPECT_EQ(getActiveInstanceCount(pScene), 7u);
+    }
+
+    GPU_TEST(InstanceLodSelection)
+    {
+        auto pScene = createScene();
+        RenderContext* pRenderContext = ctx.getRenderContext();
+
+        // The near instances cover most of the frame height and use level 0, the far instances use level 1.
+        pScene->addInstanceLodChain({ { findMesh(pScene, "Lod0"), 0.1f }, { findMesh(pScene, "Lod1"), 0.f } });
+
+        // Without culling, only level 0 is active.
+        pScene->update(pRenderContext, 0.0);
+        EXPECT(isInstanceActive(pScene, "Lod0", kNearZ));
+        EXPECT(isInstanceActive(pScene, "Lod0", kFarZ));
+        EXPECT(!isInstanceActive(pScene, "Lod1", kNearZ));
+        EXPECT(!isInstanceActive(pScene, "Lod1", kFarZ));
+        EXPECT_EQ(getActiveInstanceCount(pScene), 5u);
+
+        // With culling enabled, the level is selected by the screen size.
+        auto settings = pScene->getInstanceCullingSettings();
+        settings.enabled = true;
+        settings.frustumCulling = false;
+        pScene->setInstanceCullingSettings(settings);
+        pScene->update(pRenderContext, 0.0);
+
+        EXPECT(isInstanceActive(pScene, "Lod0", kNearZ));
+        EXPECT(!isInstanceActive(pScene, "Lod0", kFarZ));
+        EXPECT(!isInstanceActive(pScene, "Lod1", kNearZ));
+        EXPECT(isInstanceActive(pScene, "Lod1", kFarZ));
+        EXPECT_EQ(getActiveInstanceCount(pScene), 5u);
+
+        // Moving the camera away switches the near instances to level 1.
+        // The camera and the instances are far enough apart that the hysteresis margin does not matter.
+        pScene->getCamera()->setPosition(float3(0.f, 0.f, 50.f));
+        pScene->getCamera()->setTarget(float3(0.f, 0.f, 49.f));
+        pScene->update(pRenderContext, 0.0);
+
+        EXPECT(!isInstanceActive(pScene, "Lod0", kNearZ));
+        EXPECT(isInstanceActive(pScene, "Lod1", kNearZ));
+        EXPECT(isInstanceActive(pScene, "Lod1", kFarZ));
+
+        // Removing the chain activates all instances again.
+        pScene->clearInstanceLodChains();
+        pScene->update(pRenderContext, 0.0);
+        EXPECT_EQ(getActiveInstanceCount(pScene), 7u);
+    }
+}
@@ -0,0 +1,150 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SDFs/SDFBrickData.h"
+#include <algorithm>
+#include <fstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kGridWidth = 32;
+        const uint32_t kBrickWidth = 7; // Does not divide the grid width, so the last bricks extend past the grid.
+
+        std::vector<float> createSphereValues(uint32_t gridWidth, float radius)
+        {
+            uint32_t gridWidthInValues = gridWidth + 1;
+            std::vector<float> values(gridWidthInValues * gridWidthInValues * gridWidthInValues);
+            for (uint32_t z = 0; z < gridWidthInValues; z++)
+            {
+                for (uint32_t y = 0; y < gridWidthInValues; y++)
+                {
+                    for (uint32_t x = 0; x < gridWidthInValues; x++)
+                    {
+                        float3 p = float3(x, y, z) / float(gridWidth) - 0.5f;
+                        values[x + gridWidthInValues * (y + gridWidthInValues * z)] = glm::length(p) - radius;
+                    }
+                }
+            }
+            return values;
+        }
+
+        uint32_t getIndex(uint32_t x, uint32_t y, uint32_t z)
+        {
+            return x + (kGridWidth + 1) * (y + (kGridWidth + 1) * z);
+        }
+    }
+
+    CPU_TEST(SDFBrickData_CreateFromValues)
+    {
+        std::vector<float> values = createSphereValues(kGridWidth, 0.3f);
+
+        for (auto valueFormat : { SDFBrickData::ValueFormat::Int8, SDFBrickData::ValueFormat::Int16 })
+        {
+            SDFBrickData data = SDFBrickData::createFromValues(values.data(), kGridWidth, kBrickWidth, valueFormat);
+
+            const uint32_t bricksPerAxis = data.getBricksPerAxis();
+            EXPECT_EQ(bricksPerAxis, 5u);
+            EXPECT_GT(data.getBrickCount(), 0u);
+            EXPECT_LT(data.getBrickCount(), bricksPerAxis * bricksPerAxis * bricksPerAxis);
+            EXPECT(std::is_sorted(data.brickIDs.begin(), data.brickIDs.end()));
+            EXPECT_EQ(data.values.size(), size_t(data.getBrickCount()) * data.getBrickValueCount() * size_t(valueFormat));
+
+            // The brick containing the center of the sphere is empty and inside.
+            uint32_t centerBrick = (kGridWidth / 2) / kBrickWidth;
+            uint32_t centerBrickID = centerBrick + bricksPerAxis * (centerBrick + bricksPerAxis * centerBrick);
+            EXPECT_EQ(data.findBrick(centerBrickID), -1);
+            EXPECT(data.isBrickInside(centerBrickID));
+            EXPECT(!data.isBrickInside(0));
+
+            const float maxError = data.narrowBandWidth / (valueFormat == SDFBrickData::ValueFormat::Int8 ? 127.f : 32767.f);
+            const std::vector<float> denseValues = data.createDenseValues();
+
+            for (uint32_t z = 0; z <= kGridWidth; z++)
+            {
+                for (uint32_t y = 0; y <= kGridWidth; y++)
+                {
+                    for (uint32_t x = 0; x <= kGridWidth; x++)
+                    {
+                        float value = values[getIndex(x, y, z)];
+                        float decoded = data.getCornerValue(uint3(x, y, z));
+                        EXPECT_EQ(decoded, denseValues[getIndex(x, y, z)]);
+
+                        // Values close to the surface are exact up to quantization, all others keep their sign.
+                        if (std::abs(value) < 0.25f / kGridWidth)
+                        {
+                            EXPECT_LE(std::abs(decoded - value), maxError) << "corner (" << x << ", " << y << ", " << z << ")";
+                        }
+                        else if (std::abs(value) > maxError)
+                        {
+                            EXPECT_EQ(decoded < 0.f, value < 0.f) << "corner (" << x << ", " << y << ", " << z << ")";
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    CPU_TEST(SDFBrickData_FileRoundTrip)
+    {
+        std::vector<float> values = createSphereValues(kGridWidth, 0.25f);
+        SDFBrickData data = SDFBrickData::createFromValues(values.data(), kGridWidth, kBrickWidth, SDFBrickData::ValueFormat::Int16);
+
+        std::filesystem::path densePath = std::filesystem::temp_directory_path() / "SDFBrickDataTest.sdfg";
+        std::filesystem::path brickPath = std::filesystem::temp_directory_path() / "SDFBrickDataTest.sdfb";
+
+        // Write and read back the brick data.
+        EXPECT(data.write(brickPath));
+        SDFBrickData readData;
+        EXPECT(SDFBrickData::read(brickPath, readData));
+        EXPECT_EQ(readData.gridWidth, data.gridWidth);
+        EXPECT_EQ(readData.brickWidth, data.brickWidth);
+        EXPECT(readData.valueFormat == data.valueFormat);
+        EXPECT_EQ(readData.narrowBandWidth, data.narrowBandWidth);
+        EXPECT(readData.brickIDs == data.brickIDs);
+        EXPECT(readData.insideMask == data.insideMask);
+        EXPECT(readData.values == data.values);
+
+        // Converting a dense file streams it one brick layer at a time, the result must match converting the values in memory.
+        {
+            std::ofstream file(densePath, std::ios::out | std::ios::binary);
+            uint32_t gridWidth = kGridWidth;
+            file.write(reinterpret_cast<const char*>(&gridWidth), sizeof(uint32_t));
+            file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+        }
+        EXPECT(SDFBrickData::convertDenseFile(densePath, brickPath, kBrickWidth, SDFBrickData::ValueFormat::Int16));
+        EXPECT(SDFBrickData::read(brickPath, readData));
+        EXPECT(readData.brickIDs == data.brickIDs);
+        EXPECT(readData.insideMask == data.insideMask);
+        EXPECT(readData.values == data.values);
+
+        std::filesystem::remove(densePath);
+        std::filesystem::remove(brickPath);
+    }
+}
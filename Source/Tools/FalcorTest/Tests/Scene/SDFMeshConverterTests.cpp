@@ -0,0 +1,193 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SDFs/SDFMeshConverter.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <algorithm>
+#include <random>
+
+namespace Falcor
+{
+    namespace
+    {
+        using SignMethod = SDFMeshConverter::SignMethod;
+
+        const SignMethod kSignMethods[] = { SignMethod::WindingNumber, SignMethod::PseudoNormal };
+
+        // Distance to the unit cube centered at the origin.
+        float evalCubeDistance(const float3& p)
+        {
+            float3 q = glm::abs(p) - 0.5f;
+            return glm::length(glm::max(q, float3(0.f))) + std::min(std::max(q.x, std::max(q.y, q.z)), 0.f);
+        }
+
+        const char* getSignMethodName(SignMethod signMethod)
+        {
+            return signMethod == SignMethod::WindingNumber ? "winding number" : "pseudo normal";
+        }
+    }
+
+    CPU_TEST(SDFMeshConverter_SignedDistance)
+    {
+        auto pConverter = SDFMeshConverter::create(TriangleMesh::createCube());
+        EXPECT_EQ(pConverter->getTriangleCount(), 12u);
+
+        const float3 points[] =
+        {
+            float3(0.f), float3(0.2f, -0.1f, 0.3f), float3(1.f, 0.f, 0.f), float3(0.f, -0.7f, 0.f),
+            float3(0.6f, 0.6f, 0.f), float3(1.f, 1.f, 1.f), float3(-0.45f, 0.45f, 0.4f), float3(0.5f, 0.2f, -0.1f) + float3(1e-3f, 0.f, 0.f),
+        };
+
+        for (const float3& p : points)
+        {
+            const float expected = evalCubeDistance(p);
+            EXPECT_LE(std::abs(pConverter->evalDistance(p) - std::abs(expected)), 1e-5f);
+            for (auto signMethod : kSignMethods)
+            {
+                EXPECT_LE(std::abs(pConverter->evalSignedDistance(p, signMethod) - expected), 1e-5f) << "p = " << to_string(p) << ", sign method = " << getSignMethodName(signMethod);
+            }
+            EXPECT_LE(std::abs(pConverter->evalWindingNumber(p) - (expected < 0.f ? 1.f : 0.f)), 0.05f) << "p = " << to_string(p);
+        }
+
+        // Vertices are welded, so the sign is also correct for meshes with split vertices and clockwise winding.
+        std::vector<float3> positions;
+        std::vector<uint32_t> indices;
+        auto pMesh = TriangleMesh::createCube();
+        for (uint32_t i : pMesh->getIndices()) positions.push_back(pMesh->getVertices()[i].position);
+        for (uint32_t i = 0; i < (uint32_t)positions.size(); i += 3)
+        {
+            indices.push_back(i);
+            indices.push_back(i + 2);
+            indices.push_back(i + 1);
+        }
+        auto pConverterCW = SDFMeshConverter::create(positions, indices, true);
+        for (const float3& p : points)
+        {
+            EXPECT_LE(std::abs(pConverterCW->evalSignedDistance(p, SignMethod::PseudoNormal) - evalCubeDistance(p)), 1e-5f) << "p = " << to_string(p);
+        }
+    }
+
+    CPU_TEST(SDFMeshConverter_Convert)
+    {
+        auto pConverter = SDFMeshConverter::create(TriangleMesh::createCube());
+
+        SDFMeshConverter::Options options;
+        options.gridWidth = 32;
+        options.brickWidth = 7;
+        options.valueFormat = SDFBrickData::ValueFormat::Int16;
+
+        // The mesh is fitted to the grid with a margin, recover the scale from the grid transform.
+        const float scale = 1.f / pConverter->getGridTransform(options).getScaling().x;
+        EXPECT_LT(scale, 1.f);
+
+        std::vector<uint32_t> brickIDs;
+        for (auto signMethod : kSignMethods)
+        {
+            options.signMethod = signMethod;
+            SDFBrickData data = pConverter->convert(options);
+
+            const uint32_t bricksPerAxis = data.getBricksPerAxis();
+            EXPECT_EQ(data.gridWidth, options.gridWidth);
+            EXPECT_GT(data.getBrickCount(), 0u);
+            EXPECT_LT(data.getBrickCount(), bricksPerAxis * bricksPerAxis * bricksPerAxis);
+            EXPECT(std::is_sorted(data.brickIDs.begin(), data.brickIDs.end()));
+
+            // Both sign methods agree on closed meshes.
+            if (brickIDs.empty()) brickIDs = data.brickIDs;
+            EXPECT(brickIDs == data.brickIDs) << getSignMethodName(signMethod);
+
+            // The brick at the center of the grid is far inside the cube.
+            const uint32_t centerBrick = (options.gridWidth / 2) / options.brickWidth;
+            const uint32_t centerBrickID = centerBrick + bricksPerAxis * (centerBrick + bricksPerAxis * centerBrick);
+            EXPECT_EQ(data.findBrick(centerBrickID), -1);
+            EXPECT(data.isBrickInside(centerBrickID));
+            EXPECT(!data.isBrickInside(0));
+
+            // Compare the decoded corner values along a line through the center with the analytic distance.
+            const float tolerance = 1e-3f * data.narrowBandWidth;
+            for (uint32_t x = 0; x <= options.gridWidth; x++)
+            {
+                const uint3 coords = uint3(x, options.gridWidth / 2, options.gridWidth / 2);
+                const float3 meshPosition = (float3(coords) / float(options.gridWidth) - 0.5f) / scale;
+                const float expected = std::clamp(evalCubeDistance(meshPosition) * scale, -data.narrowBandWidth, data.narrowBandWidth);
+                const float value = data.getCornerValue(coords);
+
+                if (std::abs(value) < data.narrowBandWidth) EXPECT_LE(std::abs(value - expected), tolerance) << "x = " << x;
+                if (std::abs(expected) > tolerance) EXPECT_EQ(value < 0.f, expected < 0.f) << "x = " << x;
+            }
+        }
+    }
+
+    CPU_TEST_BENCHMARK(SDFMeshConverterBenchmark)
+    {
+        auto pConverter = SDFMeshConverter::create(TriangleMesh::createSphere(0.5f, 128, 64));
+        const uint32_t kQueryCount = 1 << 18;
+
+        for (uint32_t gridWidth : { 64u, 128u, 256u })
+        {
+            SDFMeshConverter::Options options;
+            options.gridWidth = gridWidth;
+
+            // Distance queries at random points in the narrow band, the band narrows and queries get cheaper with increasing grid width.
+            const float narrowBand = std::sqrt(3.f) / gridWidth / (1.f - 2.f * (std::sqrt(3.f) + 1.f) / gridWidth);
+            std::mt19937 rng(gridWidth);
+            std::uniform_real_distribution<float> dist(-1.f, 1.f);
+            std::vector<float3> points(kQueryCount);
+            for (auto& p : points)
+            {
+                float3 dir;
+                do dir = float3(dist(rng), dist(rng), dist(rng)); while (glm::dot(dir, dir) > 1.f || glm::dot(dir, dir) < 1e-6f);
+                p = glm::normalize(dir) * (0.5f + narrowBand * dist(rng));
+            }
+
+            for (auto signMethod : kSignMethods)
+            {
+                float sum = 0.f;
+                auto start = CpuTimer::getCurrentTimePoint();
+                for (const auto& p : points) sum += pConverter->evalSignedDistance(p, signMethod);
+                double ms = CpuTimer::calcDuration(start, CpuTimer::getCurrentTimePoint());
+                EXPECT(std::isfinite(sum));
+
+                logInfo("SDFMeshConverter: grid width {}, {} queries ({}) in {:.3f} ms ({:.2f} Mqueries/s on one thread)", gridWidth, kQueryCount, getSignMethodName(signMethod), ms, kQueryCount / (ms * 1e3));
+            }
+
+            // Full conversion, parallel over rows of bricks.
+            for (auto signMethod : kSignMethods)
+            {
+                options.signMethod = signMethod;
+                auto start = CpuTimer::getCurrentTimePoint();
+                SDFBrickData data = pConverter->convert(options);
+                double ms = CpuTimer::calcDuration(start, CpuTimer::getCurrentTimePoint());
+                EXPECT_GT(data.getBrickCount(), 0u);
+
+                const uint64_t cornerCount = uint64_t(data.getBrickCount()) * data.getBrickValueCount();
+                logInfo("SDFMeshConverter: grid width {}, {} bricks ({}) in {:.3f} ms ({:.2f} Mcorners/s)", gridWidth, data.getBrickCount(), getSignMethodName(signMethod), ms, cornerCount / (ms * 1e3));
+            }
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/ChunkedBufferUploader.h"
+#include <cstring>
+#include <random>
+
+namespace Falcor
+{
+    namespace
+    {
+        void testUpload(GPUUnitTestContext& ctx, size_t chunkSize, const std::vector<uint32_t>& sizes)
+        {
+            // Create one destination buffer per size and fill the data with a unique pattern.
+            std::vector<std::vector<uint32_t>> data(sizes.size());
+            std::vector<Buffer::SharedPtr> buffers(sizes.size());
+            for (size_t i = 0; i < sizes.size(); i++)
+            {
+                data[i].resize(sizes[i]);
+                for (uint32_t j = 0; j < sizes[i]; j++) data[i][j] = (uint32_t)(i << 24) + j * 7 + 3;
+                buffers[i] = Buffer::create(sizes[i] * sizeof(uint32_t), ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, nullptr);
+            }
+
+            // Upload the first half of each buffer with write() and the second half with allocate().
+            {
+                ChunkedBufferUploader uploader(ctx.getRenderContext(), chunkSize);
+                for (size_t i = 0; i < sizes.size(); i++)
+                {
+                    const uint32_t half = sizes[i] / 2;
+                    uploader.write(buffers[i], 0, data[i].data(), half * sizeof(uint32_t));
+
+                    uint32_t offset = half;
+                    while (offset < sizes[i])
+                    {
+                        auto [pData, size] = uploader.allocate(buffers[i], offset * sizeof(uint32_t), (sizes[i] - offset) * sizeof(uint32_t), sizeof(uint32_t));
+                        EXPECT_EQ(size % sizeof(uint32_t), 0);
+                        EXPECT_GT(size, 0);
+                        std::memcpy(pData, data[i].data() + offset, size);
+                        offset += (uint32_t)(size / sizeof(uint32_t));
+                    }
+                }
+                uploader.flush();
+
+                size_t totalSize = 0;
+                for (auto size : sizes) totalSize += size * sizeof(uint32_t);
+                EXPECT_EQ(uploader.getUploadedBytes(), totalSize);
+            }
+
+            // Verify the results.
+            for (size_t i = 0; i < sizes.size(); i++)
+            {
+                const uint32_t* result = (const uint32_t*)buffers[i]->map(Buffer::MapType::Read);
+                for (uint32_t j = 0; j < sizes[i]; j++)
+                {
+                    EXPECT_EQ(result[j], data[i][j]) << "i = " << i << " j = " << j;
+                }
+                buffers[i]->unmap();
+            }
+        }
+    }
+
+    GPU_TEST(ChunkedBufferUploader_SingleChunk)
+    {
+        testUpload(ctx, ChunkedBufferUploader::kDefaultChunkSize, { 1, 2, 100, 1000 });
+    }
+
+    GPU_TEST(ChunkedBufferUploader_MultipleChunks)
+    {
+        // Use a small chunk size so that the ring wraps around several times and buffers span multiple chunks.
+        std::mt19937 rng;
+        std::vector<uint32_t> sizes;
+        for (uint32_t i = 0; i < 50; i++) sizes.push_back(1 + rng() % 5000);
+        testUpload(ctx, 4096, sizes);
+    }
+}
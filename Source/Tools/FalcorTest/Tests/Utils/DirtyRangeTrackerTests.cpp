@@ -0,0 +1,133 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/DirtyRangeTracker.h"
+
+namespace Falcor
+{
+    CPU_TEST(DirtyRangeTracker_Merge)
+    {
+        DirtyRangeTracker tracker;
+        EXPECT(!tracker.isDirty());
+
+        // Consecutive and overlapping elements are merged into one range.
+        tracker.markDirty(3);
+        tracker.markDirty(4);
+        tracker.markDirty(5, 8);
+        tracker.markDirty(6, 7);
+        tracker.markDirty(12);
+        EXPECT(tracker.isDirty());
+
+        const auto& ranges = tracker.getRanges();
+        EXPECT_EQ(ranges.size(), 2);
+        EXPECT_EQ(ranges[0].begin, 3);
+        EXPECT_EQ(ranges[0].end, 8);
+        EXPECT_EQ(ranges[1].begin, 12);
+        EXPECT_EQ(ranges[1].end, 13);
+        EXPECT_EQ(tracker.getDirtyElementCount(), 6);
+
+        tracker.clear();
+        EXPECT(!tracker.isDirty());
+        EXPECT_EQ(tracker.getDirtyElementCount(), 0);
+    }
+
+    CPU_TEST(DirtyRangeTracker_Unsorted)
+    {
+        DirtyRangeTracker tracker;
+        tracker.markDirty(20, 25);
+        tracker.markDirty(2);
+        tracker.markDirty(10, 21);
+        tracker.markDirty(1);
+        tracker.markDirty(30, 30); // Empty range is ignored.
+
+        const auto& ranges = tracker.getRanges();
+        EXPECT_EQ(ranges.size(), 2);
+        EXPECT_EQ(ranges[0].begin, 1);
+        EXPECT_EQ(ranges[0].end, 3);
+        EXPECT_EQ(ranges[1].begin, 10);
+        EXPECT_EQ(ranges[1].end, 25);
+    }
+
+    CPU_TEST(DirtyRangeTracker_MergeGap)
+    {
+        DirtyRangeTracker tracker(2);
+        tracker.markDirty(0);
+        tracker.markDirty(3);   // Gap of 2 elements, merged.
+        tracker.markDirty(7);   // Gap of 3 elements, not merged.
+        tracker.markDirty(9);   // Gap of 1 element, merged.
+
+        const auto& ranges = tracker.getRanges();
+        EXPECT_EQ(ranges.size(), 2);
+        EXPECT_EQ(ranges[0].begin, 0);
+        EXPECT_EQ(ranges[0].end, 4);
+        EXPECT_EQ(ranges[1].begin, 7);
+        EXPECT_EQ(ranges[1].end, 10);
+
+        tracker.markAllDirty(16);
+        EXPECT_EQ(tracker.getRanges().size(), 1);
+        EXPECT_EQ(tracker.getDirtyElementCount(), 16);
+    }
+
+    GPU_TEST(DirtyRangeTracker_Upload)
+    {
+        const uint32_t kElementCount = 1000;
+
+        std::vector<uint32_t> data(kElementCount);
+        for (uint32_t i = 0; i < kElementCount; i++) data[i] = i;
+
+        auto pBuffer = Buffer::create(kElementCount * sizeof(uint32_t), ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, data.data());
+
+        // Modify a few scattered elements and ranges.
+        DirtyRangeTracker tracker;
+        std::vector<uint32_t> expected = data;
+        auto modify = [&](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; i++) data[i] = expected[i] = 0xbeef0000 + i;
+            tracker.markDirty(begin, end);
+        };
+        modify(500, 600);
+        modify(7, 8);
+        modify(990, 1000);
+        modify(595, 610);
+
+        // Elements outside the dirty ranges are modified on the CPU only and must not be uploaded.
+        data[100] = 0xdead;
+
+        uint64_t uploadedBytes = tracker.upload(pBuffer.get(), data.data(), sizeof(uint32_t));
+        EXPECT_EQ(uploadedBytes, (110 + 1 + 10) * sizeof(uint32_t));
+        EXPECT(!tracker.isDirty());
+        EXPECT_EQ(tracker.upload(pBuffer.get(), data.data(), sizeof(uint32_t)), 0);
+
+        const uint32_t* result = (const uint32_t*)pBuffer->map(Buffer::MapType::Read);
+        for (uint32_t i = 0; i < kElementCount; i++)
+        {
+            EXPECT_EQ(result[i], expected[i]) << "i = " << i;
+        }
+        pBuffer->unmap();
+    }
+}
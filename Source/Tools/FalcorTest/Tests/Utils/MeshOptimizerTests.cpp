@@ -0,0 +1,165 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Geometry/MeshOptimizer.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <array>
+#include <random>
+
+namespace Falcor
+{
+    namespace
+    {
+        using Triangle = std::array<uint32_t, 3>;
+
+        /** Create a regular grid mesh with the triangles in random order, similar to a scanned mesh.
+        */
+        std::vector<uint32_t> createShuffledGrid(uint32_t size, uint32_t& vertexCount)
+        {
+            std::vector<Triangle> triangles;
+            for (uint32_t y = 0; y < size; y++)
+            {
+                for (uint32_t x = 0; x < size; x++)
+                {
+                    uint32_t i0 = y * (size + 1) + x;
+                    uint32_t i1 = i0 + 1;
+                    uint32_t i2 = i0 + size + 1;
+                    uint32_t i3 = i2 + 1;
+                    triangles.push_back({ i0, i1, i2 });
+                    triangles.push_back({ i1, i3, i2 });
+                }
+            }
+            vertexCount = (size + 1) * (size + 1);
+
+            std::mt19937 rng;
+            std::shuffle(triangles.begin(), triangles.end(), rng);
+
+            std::vector<uint32_t> indices;
+            for (const auto& t : triangles) indices.insert(indices.end(), t.begin(), t.end());
+            return indices;
+        }
+
+        /** Return the sorted list of triangles, each rotated so the smallest index is first (preserves winding).
+        */
+        std::vector<Triangle> getCanonicalTriangles(const std::vector<uint32_t>& indices, const std::vector<uint32_t>* pRemap = nullptr)
+        {
+            std::vector<uint32_t> inverseRemap;
+            if (pRemap)
+            {
+                inverseRemap.resize(pRemap->size());
+                for (uint32_t i = 0; i < pRemap->size(); i++) inverseRemap[(*pRemap)[i]] = i;
+            }
+
+            std::vector<Triangle> triangles;
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                Triangle t = { indices[i], indices[i + 1], indices[i + 2] };
+                if (pRemap) for (auto& v : t) v = inverseRemap[v];
+                std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+                triangles.push_back(t);
+            }
+            std::sort(triangles.begin(), triangles.end());
+            return triangles;
+        }
+    }
+
+    CPU_TEST(MeshOptimizerAnalyze)
+    {
+        // Single triangle. All vertices are transformed once.
+        std::vector<uint32_t> indices = { 0, 1, 2 };
+        auto stats = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), 3);
+        EXPECT_EQ(stats.transformedVertexCount, 3);
+        EXPECT_EQ(stats.acmr, 3.f);
+        EXPECT_EQ(stats.atvr, 1.f);
+
+        // Two triangles sharing an edge. The shared vertices hit in the cache.
+        indices = { 0, 1, 2, 1, 3, 2 };
+        stats = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), 4);
+        EXPECT_EQ(stats.transformedVertexCount, 4);
+        EXPECT_EQ(stats.acmr, 2.f);
+        EXPECT_EQ(stats.atvr, 1.f);
+
+        // A cache of size 1 only holds the last vertex, so all vertices are transformed.
+        stats = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), 4, 1);
+        EXPECT_EQ(stats.transformedVertexCount, 6);
+    }
+
+    CPU_TEST(MeshOptimizerVertexCache)
+    {
+        uint32_t vertexCount = 0;
+        std::vector<uint32_t> indices = createShuffledGrid(256, vertexCount);
+        const auto refTriangles = getCanonicalTriangles(indices);
+
+        // Optimize the triangle order. The triangles must be unchanged apart from their order.
+        auto before = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), vertexCount);
+        MeshOptimizer::optimizeVertexCache(indices.data(), indices.size(), vertexCount);
+        auto after = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), vertexCount);
+        EXPECT(getCanonicalTriangles(indices) == refTriangles);
+
+        logInfo("MeshOptimizer: ACMR {} -> {}, ATVR {} -> {} ({} triangles, cache size {}).",
+            before.acmr, after.acmr, before.atvr, after.atvr, indices.size() / 3, MeshOptimizer::kDefaultVertexCacheSize);
+
+        // A randomly ordered grid is close to the worst case. The optimized order should be close to the
+        // ideal ACMR of 0.5 for a regular grid, we allow some slack as the optimizer is not tuned to the cache size.
+        EXPECT_GT(before.acmr, 2.5f);
+        EXPECT_LT(after.acmr, 0.8f);
+        EXPECT_LT(after.atvr, 1.6f);
+
+        // Optimize the vertex order. The vertex cache behavior is unaffected by renumbering the vertices.
+        auto remap = MeshOptimizer::optimizeVertexFetch(indices.data(), indices.size(), vertexCount);
+        EXPECT_EQ(remap.size(), vertexCount);
+        auto afterFetch = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), vertexCount);
+        EXPECT_EQ(afterFetch.transformedVertexCount, after.transformedVertexCount);
+        EXPECT(getCanonicalTriangles(indices, &remap) == refTriangles);
+
+        // Vertices must be numbered in order of first use.
+        uint32_t nextVertex = 0;
+        for (uint32_t v : indices)
+        {
+            EXPECT_LE(v, nextVertex);
+            if (v == nextVertex) nextVertex++;
+        }
+        EXPECT_EQ(nextVertex, vertexCount);
+
+        // Check that remapping vertex data matches the remapped indices.
+        std::vector<uint32_t> vertexData(vertexCount);
+        for (uint32_t i = 0; i < vertexCount; i++) vertexData[i] = i;
+        MeshOptimizer::remapVertices(vertexData, remap);
+        for (uint32_t i = 0; i < vertexCount; i++) EXPECT_EQ(vertexData[remap[i]], i);
+    }
+
+    CPU_TEST(MeshOptimizerUnreferencedVertices)
+    {
+        // Vertices 0 and 2 are unused and should be placed last.
+        std::vector<uint32_t> indices = { 3, 1, 4 };
+        auto remap = MeshOptimizer::optimizeVertexFetch(indices.data(), indices.size(), 5);
+        EXPECT(indices == std::vector<uint32_t>({ 0, 1, 2 }));
+        EXPECT(remap == std::vector<uint32_t>({ 3, 1, 4, 0, 2 }));
+    }
+}
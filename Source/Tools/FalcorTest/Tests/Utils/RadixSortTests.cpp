@@ -0,0 +1,204 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Algorithm/RadixSort.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace Falcor
+{
+    namespace
+    {
+        // Stable sort of keys and values by the low 'keyBitCount' bits of the keys. Reference for the GPU sort.
+        template<typename T>
+        void radixSortRef(std::vector<T>& keys, std::vector<uint32_t>& values, uint32_t keyBitCount)
+        {
+            const T mask = keyBitCount >= sizeof(T) * 8 ? ~T(0) : (T(1) << keyBitCount) - 1;
+            std::vector<uint32_t> order(keys.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return (keys[a] & mask) < (keys[b] & mask); });
+
+            std::vector<T> sortedKeys(keys.size());
+            std::vector<uint32_t> sortedValues(values.size());
+            for (size_t i = 0; i < order.size(); i++)
+            {
+                sortedKeys[i] = keys[order[i]];
+                if (!values.empty()) sortedValues[i] = values[order[i]];
+            }
+            keys = std::move(sortedKeys);
+            values = std::move(sortedValues);
+        }
+
+        template<typename T>
+        std::vector<T> createKeys(uint32_t elementCount, uint32_t keyBitCount, uint32_t seed)
+        {
+            // Use a small key range for part of the keys so there are many duplicates to test stability.
+            const T mask = keyBitCount >= sizeof(T) * 8 ? ~T(0) : (T(1) << keyBitCount) - 1;
+            std::mt19937_64 r(seed);
+            std::vector<T> keys(elementCount);
+            for (auto& k : keys) k = (r() % 4 == 0 ? T(r() % 16) : T(r())) & mask;
+            return keys;
+        }
+
+        template<typename T>
+        void testRadixSort(GPUUnitTestContext& ctx, RadixSort& sort, uint32_t elementCount, bool sortValues, uint32_t keyBitCount = 0)
+        {
+            const auto keyType = sizeof(T) == 8 ? RadixSort::KeyType::Uint64 : RadixSort::KeyType::Uint32;
+            const uint32_t sortBits = keyBitCount == 0 ? uint32_t(sizeof(T) * 8) : keyBitCount;
+
+            std::vector<T> keys = createKeys<T>(elementCount, sortBits, elementCount);
+            std::vector<uint32_t> values;
+            if (sortValues)
+            {
+                values.resize(elementCount);
+                std::iota(values.begin(), values.end(), 0);
+            }
+
+            auto pKeys = Buffer::create(elementCount * sizeof(T), ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, keys.data());
+            auto pValues = sortValues ? Buffer::create(elementCount * sizeof(uint32_t), ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, values.data()) : nullptr;
+
+            sort.execute(ctx.getRenderContext(), pKeys, pValues, elementCount, keyType, keyBitCount);
+            radixSortRef(keys, values, sortBits);
+
+            const T* pResultKeys = (const T*)pKeys->map(Buffer::MapType::Read);
+            for (uint32_t i = 0; i < elementCount; i++)
+            {
+                EXPECT(keys[i] == pResultKeys[i]) << "i = " << i;
+            }
+            pKeys->unmap();
+
+            if (sortValues)
+            {
+                const uint32_t* pResultValues = (const uint32_t*)pValues->map(Buffer::MapType::Read);
+                for (uint32_t i = 0; i < elementCount; i++)
+                {
+                    EXPECT_EQ(values[i], pResultValues[i]) << "i = " << i;
+                }
+                pValues->unmap();
+            }
+        }
+    }
+
+    CPU_TEST(RadixSortRef)
+    {
+        std::vector<uint32_t> keys = { 0x13, 0x02, 0x23, 0x01, 0x12 };
+        std::vector<uint32_t> values = { 0, 1, 2, 3, 4 };
+        radixSortRef(keys, values, 4);
+        EXPECT(keys == std::vector<uint32_t>({ 0x01, 0x02, 0x12, 0x13, 0x23 }));
+        EXPECT(values == std::vector<uint32_t>({ 3, 1, 4, 0, 2 }));
+    }
+
+    GPU_TEST(RadixSort)
+    {
+        RadixSort::SharedPtr pSort = RadixSort::create();
+
+        for (uint32_t n : { 1, 27, 256, 257, 2049, 100003, 1088921 })
+        {
+            testRadixSort<uint32_t>(ctx, *pSort, n, true);
+        }
+        testRadixSort<uint32_t>(ctx, *pSort, 10201, false);
+        testRadixSort<uint32_t>(ctx, *pSort, 10201, true, 12);
+        testRadixSort<uint32_t>(ctx, *pSort, 10201, true, 28);
+    }
+
+    GPU_TEST(RadixSort64)
+    {
+        RadixSort::SharedPtr pSort = RadixSort::create();
+
+        testRadixSort<uint64_t>(ctx, *pSort, 1, true);
+        testRadixSort<uint64_t>(ctx, *pSort, 2049, true);
+        testRadixSort<uint64_t>(ctx, *pSort, 231917, true);
+        testRadixSort<uint64_t>(ctx, *pSort, 10201, false);
+        testRadixSort<uint64_t>(ctx, *pSort, 10201, true, 36);
+    }
+
+    GPU_TEST(RadixSortIndirect)
+    {
+        RadixSort::SharedPtr pSort = RadixSort::create();
+
+        const uint32_t maxElementCount = 10000;
+        const uint32_t elementCount = 6151;
+
+        std::vector<uint32_t> keys = createKeys<uint32_t>(maxElementCount, 32, 1);
+        std::vector<uint32_t> values(maxElementCount);
+        std::iota(values.begin(), values.end(), 0);
+
+        auto pKeys = Buffer::create(maxElementCount * sizeof(uint32_t), ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, keys.data());
+        auto pValues = Buffer::create(maxElementCount * sizeof(uint32_t), ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, values.data());
+        uint32_t countData[2] = { 0, elementCount };
+        auto pCount = Buffer::create(sizeof(countData), ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, countData);
+
+        // Sort the first elementCount elements with an odd pass count, the remaining elements must be untouched.
+        pSort->executeIndirect(ctx.getRenderContext(), pKeys, pValues, maxElementCount, pCount, sizeof(uint32_t), RadixSort::KeyType::Uint32, 28);
+
+        std::vector<uint32_t> refKeys(keys.begin(), keys.begin() + elementCount);
+        std::vector<uint32_t> refValues(values.begin(), values.begin() + elementCount);
+        radixSortRef(refKeys, refValues, 28);
+        refKeys.insert(refKeys.end(), keys.begin() + elementCount, keys.end());
+        refValues.insert(refValues.end(), values.begin() + elementCount, values.end());
+
+        const uint32_t* pResultKeys = (const uint32_t*)pKeys->map(Buffer::MapType::Read);
+        const uint32_t* pResultValues = (const uint32_t*)pValues->map(Buffer::MapType::Read);
+        for (uint32_t i = 0; i < maxElementCount; i++)
+        {
+            EXPECT_EQ(refKeys[i], pResultKeys[i]) << "i = " << i;
+            EXPECT_EQ(refValues[i], pResultValues[i]) << "i = " << i;
+        }
+        pKeys->unmap();
+        pValues->unmap();
+    }
+
+    GPU_TEST_BENCHMARK(RadixSortBenchmark)
+    {
+        RadixSort::SharedPtr pSort = RadixSort::create();
+        RenderContext* pRenderContext = ctx.getRenderContext();
+        const uint32_t kIterations = 10;
+
+        for (uint32_t n : { 1u << 16, 1u << 20, 1u << 24 })
+        {
+            std::vector<uint32_t> keys = createKeys<uint32_t>(n, 32, n);
+            auto pKeys = Buffer::create(n * sizeof(uint32_t), ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, keys.data());
+            auto pValues = Buffer::create(n * sizeof(uint32_t), ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr);
+
+            const uint32_t elementCount = std::min(n, RadixSort::kMaxElementCount);
+
+            // Warm up to exclude shader compilation and allocations from the timing.
+            pSort->execute(pRenderContext, pKeys, pValues, elementCount);
+            pRenderContext->flush(true);
+
+            auto start = CpuTimer::getCurrentTimePoint();
+            for (uint32_t i = 0; i < kIterations; i++) pSort->execute(pRenderContext, pKeys, pValues, elementCount);
+            pRenderContext->flush(true);
+            double ms = CpuTimer::calcDuration(start, CpuTimer::getCurrentTimePoint()) / kIterations;
+
+            logInfo("RadixSort: {} 32-bit key/value pairs in {:.3f} ms ({:.1f} Mkeys/s)", elementCount, ms, elementCount / (ms * 1e3));
+        }
+    }
+}
@@ -0,0 +1,130 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Algorithm/SegmentedScan.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <random>
+
+namespace Falcor
+{
+    namespace
+    {
+        // Segmented scan in place. Reference for the GPU scan.
+        void segmentedScanRef(std::vector<uint32_t>& elems, const std::vector<uint32_t>& headFlags, bool inclusive)
+        {
+            uint32_t sum = 0;
+            for (size_t i = 0; i < elems.size(); i++)
+            {
+                if (headFlags[i] != 0) sum = 0;
+                uint32_t tmp = elems[i];
+                elems[i] = inclusive ? sum + tmp : sum;
+                sum += tmp;
+            }
+        }
+
+        void testSegmentedScan(GPUUnitTestContext& ctx, SegmentedScan& scan, uint32_t elementCount, uint32_t meanSegmentLength, SegmentedScan::Type type)
+        {
+            std::mt19937 r(elementCount);
+            std::vector<uint32_t> data(elementCount);
+            std::vector<uint32_t> headFlags(elementCount);
+            for (auto& it : data) it = r() % 1000;
+            for (auto& it : headFlags) it = r() % meanSegmentLength == 0 ? 1 : 0;
+
+            auto pData = Buffer::create(elementCount * sizeof(uint32_t), ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, data.data());
+            auto pHeadFlags = Buffer::create(elementCount * sizeof(uint32_t), ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, headFlags.data());
+
+            scan.execute(ctx.getRenderContext(), pData, pHeadFlags, elementCount, type);
+            segmentedScanRef(data, headFlags, type == SegmentedScan::Type::Inclusive);
+
+            const uint32_t* result = (const uint32_t*)pData->map(Buffer::MapType::Read);
+            for (uint32_t i = 0; i < elementCount; i++)
+            {
+                EXPECT_EQ(data[i], result[i]) << "i = " << i;
+            }
+            pData->unmap();
+        }
+    }
+
+    CPU_TEST(SegmentedScanRef)
+    {
+        std::vector<uint32_t> x = { 5, 17, 2, 9, 23 };
+        std::vector<uint32_t> flags = { 0, 0, 1, 0, 1 };
+        segmentedScanRef(x, flags, false);
+        EXPECT(x == std::vector<uint32_t>({ 0, 5, 0, 2, 0 }));
+
+        x = { 5, 17, 2, 9, 23 };
+        segmentedScanRef(x, flags, true);
+        EXPECT(x == std::vector<uint32_t>({ 5, 22, 2, 11, 23 }));
+    }
+
+    GPU_TEST(SegmentedScan)
+    {
+        SegmentedScan::SharedPtr pScan = SegmentedScan::create();
+
+        for (auto type : { SegmentedScan::Type::Exclusive, SegmentedScan::Type::Inclusive })
+        {
+            // Segment lengths range from shorter than a group to spanning many groups (and levels).
+            testSegmentedScan(ctx, *pScan, 1, 1, type);
+            testSegmentedScan(ctx, *pScan, 27, 4, type);
+            testSegmentedScan(ctx, *pScan, 2049, 1, type);
+            testSegmentedScan(ctx, *pScan, 10201, 7, type);
+            testSegmentedScan(ctx, *pScan, 231917, 1000, type);
+            testSegmentedScan(ctx, *pScan, 1088921, 100000, type);
+            testSegmentedScan(ctx, *pScan, 1088921, 1u << 30, type);
+        }
+    }
+
+    GPU_TEST_BENCHMARK(SegmentedScanBenchmark)
+    {
+        SegmentedScan::SharedPtr pScan = SegmentedScan::create();
+        RenderContext* pRenderContext = ctx.getRenderContext();
+        const uint32_t kIterations = 10;
+
+        for (uint32_t n : { 1u << 16, 1u << 20, 1u << 24 })
+        {
+            const uint32_t elementCount = std::min(n, SegmentedScan::kMaxElementCount);
+
+            std::mt19937 r;
+            std::vector<uint32_t> headFlags(elementCount);
+            for (auto& it : headFlags) it = r() % 64 == 0 ? 1 : 0;
+            auto pData = Buffer::create(elementCount * sizeof(uint32_t), ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, nullptr);
+            auto pHeadFlags = Buffer::create(elementCount * sizeof(uint32_t), ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, headFlags.data());
+
+            // Warm up to exclude shader compilation and allocations from the timing.
+            pScan->execute(pRenderContext, pData, pHeadFlags, elementCount);
+            pRenderContext->flush(true);
+
+            auto start = CpuTimer::getCurrentTimePoint();
+            for (uint32_t i = 0; i < kIterations; i++) pScan->execute(pRenderContext, pData, pHeadFlags, elementCount);
+            pRenderContext->flush(true);
+            double ms = CpuTimer::calcDuration(start, CpuTimer::getCurrentTimePoint()) / kIterations;
+
+            logInfo("SegmentedScan: {} elements in {:.3f} ms ({:.1f} Melems/s)", elementCount, ms, elementCount / (ms * 1e3));
+        }
+    }
+}